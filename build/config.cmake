@@ -177,6 +177,21 @@ IF (ESCARGOT_THREADING)
     SET (ESCARGOT_DEFINITIONS ${ESCARGOT_DEFINITIONS} -DENABLE_THREADING)
 ENDIF()
 
+IF (NOT DEFINED ESCARGOT_GC_PARALLEL_MARK)
+    SET (ESCARGOT_GC_PARALLEL_MARK OFF)
+ENDIF()
+
+IF (ESCARGOT_GC_PARALLEL_MARK)
+    IF (NOT ESCARGOT_THREADING)
+        MESSAGE (FATAL_ERROR "Error: ESCARGOT_GC_PARALLEL_MARK requires ESCARGOT_THREADING")
+    ENDIF()
+    SET (ESCARGOT_DEFINITIONS ${ESCARGOT_DEFINITIONS} -DENABLE_GC_PARALLEL_MARK)
+ENDIF()
+
+IF (ESCARGOT_JIT)
+    SET (ESCARGOT_DEFINITIONS ${ESCARGOT_DEFINITIONS} -DENABLE_JIT)
+ENDIF()
+
 #######################################################
 # flags for $(MODE) : debug/release
 #######################################################
@@ -86,6 +86,10 @@ IF (ESCARGOT_THREADING)
     SET (GCUTIL_ENABLE_THREADING 1)
     SET (GCUTIL_ENABLE_THREAD_LOCAL_ALLOC 1)
 ENDIF()
+IF (ESCARGOT_GC_PARALLEL_MARK)
+    # marker threads of bdwgc help the collecting thread while the world is stopped
+    SET (GCUTIL_CFLAGS ${GCUTIL_CFLAGS} -DPARALLEL_MARK)
+ENDIF()
 
 SET (GCUTIL_MODE ${ESCARGOT_MODE})
 
@@ -50,6 +50,10 @@
 #error "Code Cache does not support Debugger mode"
 #endif
 
+#if defined(ENABLE_JIT) && defined(ESCARGOT_DEBUGGER)
+#error "JIT does not support Debugger mode"
+#endif
+
 /* ALWAYS_INLINE */
 #ifndef ALWAYS_INLINE
 #if defined(ESCARGOT_SMALL_CONFIG)
@@ -197,6 +201,7 @@
 #endif
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <climits>
 #include <clocale>
@@ -386,6 +391,15 @@ typedef int32_t UChar32;
 #define FALLTHROUGH
 #endif
 
+#if defined(ENABLE_THREADING)
+#include <mutex>
+#include <thread>
+// each thread runs its own VMInstances, so process-wide runtime data should be kept per thread
+#define ESCARGOT_THREAD_LOCAL thread_local
+#else
+#define ESCARGOT_THREAD_LOCAL
+#endif
+
 #if defined(__BYTE_ORDER__) && __BYTE_ORDER == __LITTLE_ENDIAN || defined(__LITTLE_ENDIAN__) || defined(__i386) || defined(_M_IX86) || defined(__ia64) || defined(__ia64__) || defined(_M_IA64) || defined(__ARMEL__) || defined(__THUMBEL__) || defined(__AARCH64EL__) || defined(_MIPSEL) || defined(__MIPSEL) || defined(__MIPSEL__) || defined(ANDROID)
 #define ESCARGOT_LITTLE_ENDIAN
 // #pragma message "little endian"
@@ -442,6 +456,11 @@ typedef uint16_t LexicalBlockIndex;
 #define SCRIPT_FUNCTION_OBJECT_BYTECODE_SIZE_MAX 1024 * 256
 #endif
 
+// ByteCodeBlock which is not executed during this number of GC cycles can be flushed
+#ifndef SCRIPT_FUNCTION_OBJECT_BYTECODE_COLD_AGE
+#define SCRIPT_FUNCTION_OBJECT_BYTECODE_COLD_AGE 2
+#endif
+
 #ifndef REGEXP_CACHE_SIZE_MAX
 #define REGEXP_CACHE_SIZE_MAX 64
 #endif
@@ -450,6 +469,22 @@ typedef uint16_t LexicalBlockIndex;
 #define ROPE_STRING_MIN_LENGTH 24
 #endif
 
+#ifndef POLYMORPHIC_INLINE_CACHE_SIZE_MAX
+#define POLYMORPHIC_INLINE_CACHE_SIZE_MAX 6
+#endif
+
+#ifndef KEYED_INLINE_CACHE_SIZE
+#define KEYED_INLINE_CACHE_SIZE 8
+#endif
+
+#ifndef MEGAMORPHIC_INLINE_CACHE_SIZE
+#define MEGAMORPHIC_INLINE_CACHE_SIZE 1024
+#endif
+
+#ifndef JIT_HOTNESS_THRESHOLD
+#define JIT_HOTNESS_THRESHOLD 1000
+#endif
+
 #include "EscargotInfo.h"
 #include "heap/Heap.h"
 #include "util/Util.h"
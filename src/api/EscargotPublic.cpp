@@ -45,6 +45,7 @@
 #include "runtime/ProxyObject.h"
 #include "runtime/BackingStore.h"
 #include "runtime/ArrayBufferObject.h"
+#include "runtime/SharedArrayBufferObject.h"
 #include "runtime/TypedArrayObject.h"
 #include "runtime/SetObject.h"
 #include "runtime/WeakSetObject.h"
@@ -61,7 +62,12 @@
 #include "runtime/ExtendedNativeFunctionObject.h"
 #include "runtime/BigInt.h"
 #include "runtime/BigIntObject.h"
+#include "runtime/SerializedValue.h"
+#include "runtime/JSONStream.h"
+#include "runtime/AllocationProfiler.h"
 #include "interpreter/ByteCode.h"
+#include "interpreter/ByteCodeOptimizer.h"
+#include "heap/HeapSnapshot.h"
 #include "api/internal/ValueAdapter.h"
 #if defined(ENABLE_WASM)
 #include "wasm/WASMOperations.h"
@@ -123,6 +129,24 @@ void Globals::finalize()
     g_globalsInited = false;
 }
 
+void Globals::initializeThread()
+{
+    // initialize thread-local value of the current thread
+    // this function should be invoked once at the start of each non-main thread
+    RELEASE_ASSERT(!!g_globalsInited);
+    Heap::initializeThread();
+    VMInstance::initializeThread();
+}
+
+void Globals::finalizeThread()
+{
+    // finalize thread-local value of the current thread
+    // this function should be invoked once at the end of each non-main thread
+    RELEASE_ASSERT(!!g_globalsInited);
+    VMInstance::finalizeThread();
+    Heap::finalizeThread();
+}
+
 void* Memory::gcMalloc(size_t siz)
 {
     return GC_MALLOC(siz);
@@ -186,6 +210,37 @@ void Memory::setGCFrequency(size_t value)
     GC_set_free_space_divisor(value);
 }
 
+bool Memory::setGCMarkerThreadCount(size_t count)
+{
+    RELEASE_ASSERT(!Globals::g_globalsInited);
+    return Heap::setMarkerThreadCount(count);
+}
+
+void Memory::setGCPauseBudget(size_t microseconds)
+{
+    Heap::setPauseBudget(microseconds);
+}
+
+bool Memory::performIdleGCWork(std::chrono::steady_clock::time_point deadline)
+{
+    return Heap::performIdleWork(deadline);
+}
+
+bool Memory::takeHeapSnapshot(const char* path)
+{
+    return HeapSnapshot::write(path);
+}
+
+void Memory::startAllocationProfiler(size_t samplingInterval)
+{
+    AllocationProfiler::start(samplingInterval);
+}
+
+bool Memory::stopAllocationProfiler(const char* path)
+{
+    return AllocationProfiler::stop(path);
+}
+
 size_t Memory::heapSize()
 {
     return GC_get_heap_size();
@@ -211,7 +266,7 @@ void Memory::setGCEventListener(OnGCEventListener l)
     GC_add_event_callback(gcEventListener, nullptr);
 }
 
-// I store ref count as EncodedValue. this can prevent what bdwgc can see ref count as address (EncodedValue store integer value as odd)
+// I store ref count as EncodedValue. this can prevent what bdwgc can see ref count as address (EncodedValue never store integer value as address-like value)
 using PersistentValueRefMapImpl = std::unordered_map<ValueRef*, EncodedValue, std::hash<void*>, std::equal_to<void*>, GCUtil::gc_malloc_allocator<std::pair<ValueRef* const, EncodedValue>>>;
 
 PersistentRefHolder<PersistentValueRefMap> PersistentValueRefMap::create()
@@ -951,6 +1006,68 @@ void VMInstanceRef::clearCachesRelatedWithContext()
     toImpl(this)->clearCachesRelatedWithContext();
 }
 
+COMPILE_ASSERT((uint32_t)VMInstanceRef::JumpThreadingPass == (1u << JumpThreadingPassKind), "");
+COMPILE_ASSERT((uint32_t)VMInstanceRef::ConstantFoldingPass == (1u << ConstantFoldingPassKind), "");
+COMPILE_ASSERT((uint32_t)VMInstanceRef::CompareBranchFusionPass == (1u << CompareBranchFusionPassKind), "");
+COMPILE_ASSERT((uint32_t)VMInstanceRef::RedundantMoveEliminationPass == (1u << RedundantMoveEliminationPassKind), "");
+COMPILE_ASSERT((uint32_t)VMInstanceRef::DeadRegisterEliminationPass == (1u << DeadRegisterEliminationPassKind), "");
+COMPILE_ASSERT((uint32_t)VMInstanceRef::AllByteCodeOptimizationPasses == BYTECODE_OPTIMIZATION_ALL_PASSES, "");
+
+void VMInstanceRef::setEnabledByteCodeOptimizationPasses(uint32_t passes)
+{
+    toImpl(this)->setEnabledByteCodeOptimizationPasses(passes & BYTECODE_OPTIMIZATION_ALL_PASSES);
+}
+
+uint32_t VMInstanceRef::enabledByteCodeOptimizationPasses()
+{
+    return toImpl(this)->enabledByteCodeOptimizationPasses();
+}
+
+void VMInstanceRef::setMaxCompiledByteCodeSize(size_t size)
+{
+    toImpl(this)->setMaxCompiledByteCodeSize(size);
+}
+
+size_t VMInstanceRef::maxCompiledByteCodeSize()
+{
+    return toImpl(this)->maxCompiledByteCodeSize();
+}
+
+size_t VMInstanceRef::compiledByteCodeSize()
+{
+    return toImpl(this)->compiledByteCodeSize();
+}
+
+size_t VMInstanceRef::flushedByteCodeBlockCount()
+{
+    return toImpl(this)->flushedByteCodeBlockCount();
+}
+
+size_t VMInstanceRef::regeneratedByteCodeBlockCount()
+{
+    return toImpl(this)->regeneratedByteCodeBlockCount();
+}
+
+size_t VMInstanceRef::codeCacheLoadedByteCodeBlockCount()
+{
+    return toImpl(this)->codeCacheLoadedByteCodeBlockCount();
+}
+
+void VMInstanceRef::setContextSnapshotEnabled(bool enabled)
+{
+    toImpl(this)->setContextSnapshotEnabled(enabled);
+}
+
+bool VMInstanceRef::isContextSnapshotEnabled()
+{
+    return toImpl(this)->isContextSnapshotEnabled();
+}
+
+bool VMInstanceRef::hasContextSnapshot()
+{
+    return !!toImpl(this)->contextSnapshot();
+}
+
 #define DECLARE_GLOBAL_SYMBOLS(name)                      \
     SymbolRef* VMInstanceRef::name##Symbol()              \
     {                                                     \
@@ -1028,12 +1145,12 @@ size_t ValueVectorRef::size()
 
 void ValueVectorRef::pushBack(ValueRef* val)
 {
-    toImpl(this)->pushBack(EncodedValueVectorElement::fromPayload(val));
+    toImpl(this)->pushBack(EncodedValueVectorElement(toImpl(val)));
 }
 
 void ValueVectorRef::insert(size_t pos, ValueRef* val)
 {
-    toImpl(this)->insert(pos, EncodedValueVectorElement::fromPayload(val));
+    toImpl(this)->insert(pos, EncodedValueVectorElement(toImpl(val)));
 }
 
 void ValueVectorRef::erase(size_t pos)
@@ -1048,12 +1165,12 @@ void ValueVectorRef::erase(size_t start, size_t end)
 
 ValueRef* ValueVectorRef::at(const size_t idx)
 {
-    return reinterpret_cast<ValueRef*>((*toImpl(this))[idx].payload());
+    return toRef(Value((*toImpl(this))[idx]));
 }
 
 void ValueVectorRef::set(const size_t idx, ValueRef* newValue)
 {
-    toImpl(this)->data()[idx] = EncodedValueVectorElement::fromPayload(newValue);
+    toImpl(this)->data()[idx] = EncodedValueVectorElement(toImpl(newValue));
 }
 
 void ValueVectorRef::resize(size_t newSize)
@@ -2735,6 +2852,53 @@ RegExpObjectRef::RegExpObjectOption RegExpObjectRef::option()
     return (RegExpObjectRef::RegExpObjectOption)toImpl(this)->option();
 }
 
+SerializedValueRef* SerializedValueRef::serialize(ExecutionStateRef* state, ValueRef* value, OptionalRef<ValueVectorRef> transferList)
+{
+    ValueVector transfer;
+    if (transferList) {
+        transfer.resizeWithUninitializedValues(transferList->size());
+        for (size_t i = 0; i < transfer.size(); i++) {
+            transfer[i] = toImpl(transferList->at(i));
+        }
+    }
+    return toRef(SerializedValue::serialize(*toImpl(state), toImpl(value), transfer));
+}
+
+ValueRef* SerializedValueRef::deserialize(ExecutionStateRef* state)
+{
+    return toRef(toImpl(this)->deserialize(*toImpl(state)));
+}
+
+size_t SerializedValueRef::byteLength()
+{
+    return toImpl(this)->byteLength();
+}
+
+struct JSONRefParseData {
+    JSONRef::JSONInputCallback m_input;
+    JSONRef::JSONElementCallback m_callback;
+    void* m_data;
+};
+
+void JSONRef::parse(ExecutionStateRef* state, JSONInputCallback input, JSONElementCallback callback, void* data)
+{
+    JSONRefParseData parseData = { input, callback, data };
+    JSONStream::parse(*toImpl(state), [](char* buffer, size_t bufferSize, void* data) -> size_t {
+        JSONRefParseData* parseData = (JSONRefParseData*)data;
+        return parseData->m_input(buffer, bufferSize, parseData->m_data);
+    },
+                      [](ExecutionState& state, const Value& element, void* data) -> bool {
+                          JSONRefParseData* parseData = (JSONRefParseData*)data;
+                          return parseData->m_callback(toRef(&state), toRef(element), parseData->m_data);
+                      },
+                      &parseData);
+}
+
+bool JSONRef::stringify(ExecutionStateRef* state, ValueRef* value, JSONOutputCallback output, void* data)
+{
+    return JSONStream::stringify(*toImpl(state), toImpl(value), output, data);
+}
+
 BackingStoreRef* BackingStoreRef::create(size_t byteLength)
 {
     return toRef(new BackingStore(byteLength));
@@ -2777,6 +2941,9 @@ void ArrayBufferObjectRef::attachBuffer(BackingStoreRef* backingStore)
 
 void ArrayBufferObjectRef::detachArrayBuffer()
 {
+    if (toImpl(this)->isSharedArrayBufferObject()) {
+        return;
+    }
     toImpl(this)->detachArrayBuffer();
 }
 
@@ -2804,6 +2971,18 @@ bool ArrayBufferObjectRef::isDetachedBuffer()
     return toImpl(this)->isDetachedBuffer();
 }
 
+SharedArrayBufferObjectRef* SharedArrayBufferObjectRef::create(ExecutionStateRef* state, size_t byteLength)
+{
+    ExecutionState& s = *toImpl(state);
+    return toRef(SharedArrayBufferObject::allocateSharedArrayBuffer(s, s.context()->globalObject()->sharedArrayBuffer(), byteLength));
+}
+
+SharedArrayBufferObjectRef* SharedArrayBufferObjectRef::create(ExecutionStateRef* state, BackingStoreRef* backingStore)
+{
+    ExecutionState& s = *toImpl(state);
+    return toRef(new SharedArrayBufferObject(s, s.context()->globalObject()->sharedArrayBufferPrototype(), toImpl(backingStore)));
+}
+
 ArrayBufferObjectRef* ArrayBufferViewRef::buffer()
 {
     return toRef(toImpl(this)->buffer());
@@ -30,6 +30,7 @@
 
 #include <cstdlib>
 #include <cstddef>
+#include <chrono>
 #include <string>
 #include <vector>
 #include <functional>
@@ -64,6 +65,7 @@
     F(ProxyObject)                              \
     F(RegExpObject)                             \
     F(SetObject)                                \
+    F(SharedArrayBufferObject)                  \
     F(String)                                   \
     F(StringObject)                             \
     F(Symbol)                                   \
@@ -106,6 +108,7 @@
     F(Template)                             \
     F(VMInstance)                           \
     F(BackingStore)                         \
+    F(SerializedValue)                      \
     ESCARGOT_POINTERVALUE_CHILD_REF_LIST(F) \
     ESCARGOT_ERROR_REF_LIST(F)              \
     ESCARGOT_TYPEDARRAY_REF_LIST(F)
@@ -120,11 +123,19 @@ ESCARGOT_REF_LIST(DECLARE_REF_CLASS);
 #undef DECLARE_REF_CLASS
 
 class ESCARGOT_EXPORT Globals {
+    friend class Memory;
     static bool g_globalsInited;
 
 public:
     static void initialize();
     static void finalize();
+
+    // only available with threading support (ESCARGOT_THREADING)
+    // every thread except the one which called Globals::initialize should call initializeThread before using any API
+    // and finalizeThread after every VMInstance of the thread is gone
+    // each VMInstance (and its Contexts) should be used only by the thread that created it
+    static void initializeThread();
+    static void finalizeThread();
 };
 
 class ESCARGOT_EXPORT Memory {
@@ -160,6 +171,34 @@ public:
     // (Allocated memory by GC x 2) / (Frequency parameter value)
     // Increasing this value may use less space but there is more collection event
     static void setGCFrequency(size_t value = 1);
+    // only available with parallel marking support (ESCARGOT_GC_PARALLEL_MARK)
+    // should be called before Globals::initialize. 0 means default value (GC_MARKERS environment variable or the number of processors)
+    // returns false without doing anything if parallel marking is not supported (then gc always marks on the collecting thread)
+    static bool setGCMarkerThreadCount(size_t count);
+
+    // incremental gc
+    // with non-zero budget, gc marks the heap in slices between allocations and each slice stops the world for about `microseconds`
+    // incremental mode cannot be disabled once enabled. setting 0 only clears the time limit of each slice
+    // (gc stays in incremental mode and still tracks dirty pages, it does not return to the previous mode)
+    static void setGCPauseBudget(size_t microseconds);
+    // run slices of gc work until deadline. useful for idle time of event loop
+    // returns true if the current collection is not finished yet (you can continue it in next idle time)
+    // without pause budget, this runs a full collection only if one is already due
+    static bool performIdleGCWork(std::chrono::steady_clock::time_point deadline);
+
+    // write every reachable gc object and the references between them into a file (runs a full gc first)
+    // use tools/heap_snapshot.py to find objects which retain most of memory
+    // returns false if the file cannot be written
+    static bool takeHeapSnapshot(const char* path);
+
+    // sampling allocation profiler of the current thread
+    // whenever `samplingInterval` bytes are allocated, the JS stack of the next object creation or string concatenation is recorded
+    // NOTE allocations without a sampling point (e.g. strings made by String builtins) are counted in the next recorded stack,
+    // so bytes of such allocations can be attributed to an unrelated object creation
+    static void startAllocationProfiler(size_t samplingInterval = 512 * 1024);
+    // stop profiling and write allocated bytes per stack in folded stack format ("outer;inner;[class] bytes" per line)
+    // returns false if the profiler is not running or the file cannot be written
+    static bool stopAllocationProfiler(const char* path);
 };
 
 // NOTE only {stack, kinds of PersistentHolders} are root set. if you store the data you need on other space, you may lost your data
@@ -614,6 +653,39 @@ public:
     // you can call this function if you don't want to use every alive contexts
     void clearCachesRelatedWithContext();
 
+    // optimization passes applied to bytecode (every pass is enabled by default)
+    // set this before evaluating any script, because location info of an error
+    // is computed again later with the passes enabled at that time
+    enum ByteCodeOptimizationPass {
+        NoByteCodeOptimizationPass = 0,
+        JumpThreadingPass = 1 << 0,
+        ConstantFoldingPass = 1 << 1,
+        CompareBranchFusionPass = 1 << 2,
+        RedundantMoveEliminationPass = 1 << 3,
+        DeadRegisterEliminationPass = 1 << 4,
+        AllByteCodeOptimizationPasses = (1 << 5) - 1,
+    };
+    void setEnabledByteCodeOptimizationPasses(uint32_t passes);
+    uint32_t enabledByteCodeOptimizationPasses();
+
+    // when total size of compiled bytecode exceeds this value,
+    // bytecode of functions not executed recently is removed on GC (and generated again on the next call)
+    void setMaxCompiledByteCodeSize(size_t size);
+    size_t maxCompiledByteCodeSize();
+    size_t compiledByteCodeSize();
+    // number of removed and regenerated bytecode of functions
+    size_t flushedByteCodeBlockCount();
+    size_t regeneratedByteCodeBlockCount();
+    // number of function bytecode loaded from code cache instead of being generated (always 0 without code cache)
+    size_t codeCacheLoadedByteCodeBlockCount();
+
+    // builtin objects of the first Context are recorded and copied into every later Context (enabled by default)
+    // disabling it drops the recorded snapshot, so every Context installs its builtins from scratch
+    void setContextSnapshotEnabled(bool enabled);
+    bool isContextSnapshotEnabled();
+    // false until the first Context is created, or if builtins could not be recorded (then the snapshot is disabled)
+    bool hasContextSnapshot();
+
     PlatformRef* platform();
 
     SymbolRef* toStringTagSymbol();
@@ -1456,6 +1528,7 @@ public:
     static ArrayBufferObjectRef* create(ExecutionStateRef* state);
     void allocateBuffer(ExecutionStateRef* state, size_t bytelength);
     void attachBuffer(BackingStoreRef* backingStore);
+    // SharedArrayBufferObject is never detached
     void detachArrayBuffer();
 
     OptionalRef<BackingStoreRef> backingStore();
@@ -1464,6 +1537,13 @@ public:
     bool isDetachedBuffer();
 };
 
+class ESCARGOT_EXPORT SharedArrayBufferObjectRef : public ArrayBufferObjectRef {
+public:
+    static SharedArrayBufferObjectRef* create(ExecutionStateRef* state, size_t byteLength);
+    // share backingStore of another SharedArrayBufferObject, which can belong to another VMInstance
+    static SharedArrayBufferObjectRef* create(ExecutionStateRef* state, BackingStoreRef* backingStore);
+};
+
 class ESCARGOT_EXPORT ArrayBufferViewRef : public ObjectRef {
 public:
     ArrayBufferObjectRef* buffer();
@@ -1787,6 +1867,38 @@ public:
     ValueRef* moduleEvaluationError();
 };
 
+// structured clone of a value for passing it to another VMInstance (even on another thread)
+// supports primitives (except Symbol), plain objects, arrays, Map, Set, ArrayBuffer, Date and RegExp
+// SerializedValueRef is gc-allocated, so keep it with PersistentRefHolder while it is passed to other thread
+class ESCARGOT_EXPORT SerializedValueRef {
+public:
+    // throws TypeError if value contains an object which cannot be cloned (e.g. function, Proxy)
+    // ArrayBuffers in transferList are detached and their backing stores are moved without copy
+    static SerializedValueRef* serialize(ExecutionStateRef* state, ValueRef* value, OptionalRef<ValueVectorRef> transferList = nullptr);
+    // create the value in the Context of state
+    // transferred ArrayBuffers are handed over to the first deserialization only
+    ValueRef* deserialize(ExecutionStateRef* state);
+    size_t byteLength();
+};
+
+// JSON on UTF-8 text which is read or written in chunks, so large documents are never held in memory at once
+class ESCARGOT_EXPORT JSONRef {
+public:
+    // fill buffer with the next part of the text and return the number of bytes (0 at the end of the text)
+    typedef size_t (*JSONInputCallback)(char* buffer, size_t bufferSize, void* data);
+    // return false to stop parsing
+    typedef bool (*JSONElementCallback)(ExecutionStateRef* state, ValueRef* element, void* data);
+    typedef void (*JSONOutputCallback)(const char* chunk, size_t length, void* data);
+
+    // if the text is an array, callback receives its elements one by one and the array itself is never created
+    // otherwise callback receives the parsed value once
+    // throws SyntaxError like JSON.parse
+    static void parse(ExecutionStateRef* state, JSONInputCallback input, JSONElementCallback callback, void* data);
+    // same with JSON.stringify(value), but the result is given to output in chunks
+    // returns false if value is not serializable (like undefined)
+    static bool stringify(ExecutionStateRef* state, ValueRef* value, JSONOutputCallback output, void* data);
+};
+
 class ESCARGOT_EXPORT PlatformRef {
 public:
     virtual ~PlatformRef() {}
@@ -24,13 +24,17 @@
 #include "runtime/String.h"
 #include "codecache/CodeCache.h"
 #include "codecache/CodeCacheReaderWriter.h"
+#include "codecache/CodeCacheWorker.h"
 #include "parser/Script.h"
 #include "parser/CodeBlock.h"
+#include "interpreter/ByteCode.h"
 
 // file libraries
 #include <dirent.h>
 #include <sys/stat.h>
 #include <sys/file.h>
+#include <sys/mman.h>
+#include <fcntl.h>
 #include <unistd.h>
 
 #define CODE_CACHE_FILE_DIR "/Escargot-cache/"
@@ -38,6 +42,54 @@
 
 namespace Escargot {
 
+// FNV-1a hash of a function ByteCode record
+// header of the record can be valid even if its data is broken (e.g. disk error or modification by others)
+static size_t functionByteCodeChecksum(const char* data, size_t size)
+{
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= static_cast<uint8_t>(data[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+bool CodeCache::MappedCacheData::map(const std::string& filePath)
+{
+    ASSERT(!isMapped());
+
+    int fd = open(filePath.data(), O_RDONLY);
+    if (UNLIKELY(fd == -1)) {
+        return false;
+    }
+
+    struct stat statFile;
+    if (UNLIKELY(fstat(fd, &statFile) != 0 || statFile.st_size <= 0)) {
+        close(fd);
+        return false;
+    }
+
+    void* addr = mmap(nullptr, statFile.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // mapping remains valid after closing the file descriptor
+    close(fd);
+    if (UNLIKELY(addr == MAP_FAILED)) {
+        return false;
+    }
+
+    m_data = static_cast<const char*>(addr);
+    m_size = statFile.st_size;
+    return true;
+}
+
+void CodeCache::MappedCacheData::unmap()
+{
+    if (m_data) {
+        munmap(const_cast<char*>(m_data), m_size);
+        m_data = nullptr;
+        m_size = 0;
+    }
+}
+
 void CodeCache::CodeCacheContext::reset()
 {
     m_cacheFilePath.clear();
@@ -48,11 +100,14 @@ void CodeCache::CodeCacheContext::reset()
         m_cacheStringTable = nullptr;
     }
     m_cacheDataOffset = 0;
+    m_cacheData.clear();
+    m_mappedData.unmap();
 }
 
 CodeCache::CodeCache(const char* baseCacheDir)
     : m_cacheWriter(nullptr)
     , m_cacheReader(nullptr)
+    , m_worker(nullptr)
     , m_cacheDirFD(-1)
     , m_enabled(false)
     , m_status(Status::NONE)
@@ -89,6 +144,7 @@ void CodeCache::initialize(const char* baseCacheDir)
 
     m_cacheWriter = new CodeCacheWriter();
     m_cacheReader = new CodeCacheReader();
+    m_worker = new CodeCacheWorker();
     m_enabled = true;
     m_status = Status::READY;
 
@@ -260,6 +316,12 @@ void CodeCache::clearCacheDir()
 
 void CodeCache::clear()
 {
+    if (m_worker) {
+        // pending file operations are finished before releasing the lock of cache directory
+        delete m_worker;
+        m_worker = nullptr;
+    }
+
     m_currentContext.reset();
 
     unLockAndCloseCacheDir();
@@ -267,6 +329,11 @@ void CodeCache::clear()
     m_cacheDirPath.clear();
     m_cacheList.clear();
 
+    for (auto iter = m_functionCacheInfos.begin(); iter != m_functionCacheInfos.end(); iter++) {
+        delete iter->second;
+    }
+    m_functionCacheInfos.clear();
+
     if (m_cacheWriter) {
         delete m_cacheWriter;
         m_cacheWriter = nullptr;
@@ -285,6 +352,10 @@ void CodeCache::clearAll()
 {
     // clear CodeCache and all cache files
     ASSERT(m_status == Status::FAILED || m_status == Status::NONE);
+    if (m_worker) {
+        // worker should not access cache directory while clearing it
+        m_worker->stop();
+    }
     clearCacheDir();
     clear();
 }
@@ -362,11 +433,10 @@ bool CodeCache::removeCacheFile(size_t hash)
 
     std::string filePath = m_cacheDirPath + std::to_string(hash);
 
-    if (remove(filePath.data()) != 0) {
-        ESCARGOT_LOG_ERROR("[CodeCache] can`t remove a cache file %s\n", filePath.data());
-        return false;
-    }
+    // function ByteCodes are stored in the same data file
+    removeFunctionCacheInfo(hash);
 
+    m_worker->postTask(CodeCacheWorker::Task(CodeCacheWorker::TaskType::REMOVE_FILE, filePath));
     return true;
 }
 
@@ -397,6 +467,14 @@ void CodeCache::prepareCacheLoading(Context* context, size_t srcHash, const Code
 
     m_currentContext.m_cacheFilePath = m_cacheDirPath + std::to_string(srcHash);
     m_currentContext.m_cacheEntry = entry;
+
+    // cache data file could be still being written by the worker
+    m_worker->waitForIdle();
+    if (UNLIKELY(m_worker->hasFailed())) {
+        m_status = Status::FAILED;
+        return;
+    }
+
     m_currentContext.m_cacheStringTable = loadCacheStringTable(context);
 }
 
@@ -430,11 +508,12 @@ bool CodeCache::postCacheLoading()
     return false;
 }
 
-void CodeCache::postCacheWriting(size_t srcHash)
+bool CodeCache::postCacheWriting(size_t srcHash)
 {
     ASSERT(m_enabled);
 
-    if (LIKELY(m_status == Status::FINISH)) {
+    // file writing failure of the previous caching is also handled here
+    if (LIKELY(m_status == Status::FINISH && !m_worker->hasFailed())) {
         CodeCacheEntry& entry = m_currentContext.m_cacheEntry;
         ASSERT(entry.m_lastWrittenTimeStamp == 0);
 
@@ -442,17 +521,30 @@ void CodeCache::postCacheWriting(size_t srcHash)
         entry.m_lastWrittenTimeStamp = fastTickCount();
 
         if (addCacheEntry(srcHash, m_currentContext.m_cacheEntry)) {
-            if (writeCacheList()) {
-                reset();
-                m_status = Status::READY;
-
-                return;
-            }
+            // cache data file is written before the cache list refers to it
+            CodeCacheWorker::Task task(CodeCacheWorker::TaskType::WRITE_FILE, m_currentContext.m_cacheFilePath);
+            task.m_data.swap(m_currentContext.m_cacheData);
+            m_worker->postTask(std::move(task));
+            writeCacheList();
+
+            // function ByteCodes will be appended right after the cache data
+            removeFunctionCacheInfo(srcHash);
+            FunctionCacheInfo* info = new FunctionCacheInfo();
+            info->m_dataFileSize = m_currentContext.m_cacheDataOffset;
+            m_functionCacheInfos.insert(std::make_pair(srcHash, info));
+
+            reset();
+            m_status = Status::READY;
+
+            return true;
         }
     }
 
     // failed to write cache
+    m_status = Status::FAILED;
     clearAll();
+
+    return false;
 }
 
 void CodeCache::storeStringTable()
@@ -466,11 +558,7 @@ void CodeCache::storeStringTable()
 
     m_cacheWriter->setStringTable(m_currentContext.m_cacheStringTable);
     m_cacheWriter->storeStringTable();
-
-    if (UNLIKELY(!writeCacheData(CodeCacheType::CACHE_STRING))) {
-        m_status = Status::FAILED;
-        return;
-    }
+    writeCacheData(CodeCacheType::CACHE_STRING);
 
     // the last stage of writing cache done
     m_status = Status::FINISH;
@@ -493,10 +581,7 @@ void CodeCache::storeCodeBlockTree(InterpretedCodeBlock* topCodeBlock, CodeBlock
 
     size_t nodeCount = 0;
     storeCodeBlockTreeNode(topCodeBlock, nodeCount);
-
-    if (UNLIKELY(!writeCacheData(CodeCacheType::CACHE_CODEBLOCK, nodeCount))) {
-        m_status = Status::FAILED;
-    }
+    writeCacheData(CodeCacheType::CACHE_CODEBLOCK, nodeCount);
 }
 
 void CodeCache::storeCodeBlockTreeNode(InterpretedCodeBlock* codeBlock, size_t& nodeCount)
@@ -527,9 +612,7 @@ void CodeCache::storeByteCodeBlock(ByteCodeBlock* block)
     m_cacheWriter->setStringTable(m_currentContext.m_cacheStringTable);
 
     m_cacheWriter->storeByteCodeBlock(block);
-    if (UNLIKELY(!writeCacheData(CodeCacheType::CACHE_BYTECODE))) {
-        m_status = Status::FAILED;
-    }
+    writeCacheData(CodeCacheType::CACHE_BYTECODE);
 }
 
 CacheStringTable* CodeCache::loadCacheStringTable(Context* context)
@@ -588,6 +671,7 @@ InterpretedCodeBlock* CodeCache::loadCodeBlockTree(Context* context, Script* scr
     tempCodeBlockVector.resizeWithUninitializedValues(nodeCount);
     for (size_t i = 0; i < nodeCount; i++) {
         InterpretedCodeBlock* codeBlock = m_cacheReader->loadInterpretedCodeBlock(context, script);
+        codeBlock->m_codeCacheIndex = i;
         tempCodeBlockVector[i] = codeBlock;
 
         if (i == 0) {
@@ -658,70 +742,263 @@ ByteCodeBlock* CodeCache::loadByteCodeBlock(Context* context, InterpretedCodeBlo
     return block;
 }
 
-bool CodeCache::writeCacheList()
+bool CodeCache::isCachedCodeBlock(InterpretedCodeBlock* codeBlock)
+{
+    ASSERT(m_enabled);
+    return codeBlock->m_codeCacheIndex != SIZE_MAX && codeBlock->script()->codeCacheSourceHash();
+}
+
+CodeCache::FunctionCacheInfo* CodeCache::ensureFunctionCacheInfo(size_t srcHash)
+{
+    ASSERT(m_enabled);
+
+    auto iter = m_functionCacheInfos.find(srcHash);
+    if (iter != m_functionCacheInfos.end()) {
+        return iter->second;
+    }
+
+    auto entryIter = m_cacheList.find(srcHash);
+    if (entryIter == m_cacheList.end()) {
+        // cache entry has been removed
+        return nullptr;
+    }
+
+    // function ByteCodes are appended after the StringTable which is the last data of cache entry
+    const CodeCacheMetaInfo& stringMetaInfo = entryIter->second.m_metaInfos[(size_t)CodeCacheType::CACHE_STRING];
+    ASSERT(stringMetaInfo.cacheType == CodeCacheType::CACHE_STRING);
+    size_t dataOffset = stringMetaInfo.dataOffset + stringMetaInfo.dataSize;
+
+    // scan the data file after all pending writings are done
+    m_worker->waitForIdle();
+
+    std::string filePath = m_cacheDirPath + std::to_string(srcHash);
+    struct stat statFile;
+    if (UNLIKELY(stat(filePath.data(), &statFile) != 0 || (size_t)statFile.st_size < dataOffset)) {
+        ESCARGOT_LOG_ERROR("[CodeCache] invalid cache data file %s\n", filePath.data());
+        return nullptr;
+    }
+    size_t fileSize = statFile.st_size;
+
+    FunctionCacheInfo* info = new FunctionCacheInfo();
+    if (fileSize > dataOffset) {
+        if (UNLIKELY(!info->m_mappedData.map(filePath) || info->m_mappedData.m_size != fileSize)) {
+            ESCARGOT_LOG_ERROR("[CodeCache] can't map the cache data file %s\n", filePath.data());
+            delete info;
+            return nullptr;
+        }
+
+        // scan the header of each function ByteCode
+        CodeCacheMetaInfo meta;
+        while (dataOffset + sizeof(CodeCacheMetaInfo) <= fileSize) {
+            memcpy(&meta, info->m_mappedData.m_data + dataOffset, sizeof(CodeCacheMetaInfo));
+            if (meta.cacheType != CodeCacheType::CACHE_FUNCTION_BYTECODE || meta.dataSize > fileSize - dataOffset - sizeof(CodeCacheMetaInfo)) {
+                break;
+            }
+
+            // later record wins, a function whose record was rejected by its checksum is appended again
+            info->m_metaInfos[meta.codeBlockIndex] = CodeCacheMetaInfo(CodeCacheType::CACHE_FUNCTION_BYTECODE, dataOffset + sizeof(CodeCacheMetaInfo), meta.dataSize);
+            dataOffset += sizeof(CodeCacheMetaInfo) + meta.dataSize;
+        }
+
+        if (UNLIKELY(dataOffset != fileSize)) {
+            // discard the broken tail (e.g. writing was interrupted) so that new data is appended right after the valid one
+            // the mapping is released first because its pages beyond the new end of file become inaccessible
+            info->m_mappedData.unmap();
+            if (truncate(filePath.data(), dataOffset) != 0) {
+                ESCARGOT_LOG_ERROR("[CodeCache] can't truncate the cache data file %s\n", filePath.data());
+                delete info;
+                return nullptr;
+            }
+        }
+    }
+    info->m_dataFileSize = dataOffset;
+
+    m_functionCacheInfos.insert(std::make_pair(srcHash, info));
+    return info;
+}
+
+void CodeCache::removeFunctionCacheInfo(size_t srcHash)
+{
+    auto iter = m_functionCacheInfos.find(srcHash);
+    if (iter != m_functionCacheInfos.end()) {
+        delete iter->second;
+        m_functionCacheInfos.erase(iter);
+    }
+}
+
+void CodeCache::storeFunctionByteCodeBlock(ByteCodeBlock* block)
+{
+    ASSERT(m_enabled);
+
+    if (m_status != Status::READY) {
+        // another Script is being cached now
+        return;
+    }
+
+    InterpretedCodeBlock* codeBlock = block->codeBlock();
+    ASSERT(isCachedCodeBlock(codeBlock) && !codeBlock->isGlobalCodeBlock());
+
+    size_t srcHash = codeBlock->script()->codeCacheSourceHash();
+    FunctionCacheInfo* info = ensureFunctionCacheInfo(srcHash);
+    if (!info || info->m_metaInfos.find(codeBlock->m_codeCacheIndex) != info->m_metaInfos.end()) {
+        return;
+    }
+
+    // each function ByteCode has its own StringTable because the StringTable of the Script is already stored
+    CacheStringTable stringTable;
+    m_cacheWriter->setStringTable(&stringTable);
+
+    // StringTable is filled while storing ByteCodeBlock, but should be loaded before ByteCodeBlock
+    m_cacheWriter->storeByteCodeBlock(block);
+    std::vector<char> byteCodeData(m_cacheWriter->bufferData(), m_cacheWriter->bufferData() + m_cacheWriter->bufferSize());
+    m_cacheWriter->clearBuffer();
+
+    m_cacheWriter->storeStringTable();
+    size_t stringTableSize = m_cacheWriter->bufferSize();
+
+    // [CodeCacheMetaInfo][checksum][StringTable size][StringTable][ByteCodeBlock]
+    // checksum covers everything after itself
+    CodeCacheMetaInfo meta(CodeCacheType::CACHE_FUNCTION_BYTECODE, 0, sizeof(size_t) * 2 + stringTableSize + byteCodeData.size());
+    meta.codeBlockIndex = codeBlock->m_codeCacheIndex;
+
+    CodeCacheWorker::Task task(CodeCacheWorker::TaskType::APPEND_FILE, m_cacheDirPath + std::to_string(srcHash));
+    std::vector<char>& data = task.m_data;
+    data.reserve(sizeof(CodeCacheMetaInfo) + meta.dataSize);
+    data.insert(data.end(), reinterpret_cast<char*>(&meta), reinterpret_cast<char*>(&meta) + sizeof(CodeCacheMetaInfo));
+    size_t checksumOffset = data.size();
+    data.resize(data.size() + sizeof(size_t));
+    data.insert(data.end(), reinterpret_cast<char*>(&stringTableSize), reinterpret_cast<char*>(&stringTableSize) + sizeof(size_t));
+    data.insert(data.end(), m_cacheWriter->bufferData(), m_cacheWriter->bufferData() + stringTableSize);
+    data.insert(data.end(), byteCodeData.begin(), byteCodeData.end());
+    m_cacheWriter->clearBuffer();
+
+    size_t checksum = functionByteCodeChecksum(data.data() + checksumOffset + sizeof(size_t), data.size() - checksumOffset - sizeof(size_t));
+    memcpy(data.data() + checksumOffset, &checksum, sizeof(size_t));
+
+    // appending could fail on the worker, each record is validated by its header when it is loaded
+    m_worker->postTask(std::move(task));
+
+    info->m_metaInfos.insert(std::make_pair(meta.codeBlockIndex, CodeCacheMetaInfo(CodeCacheType::CACHE_FUNCTION_BYTECODE, info->m_dataFileSize + sizeof(CodeCacheMetaInfo), meta.dataSize)));
+    info->m_dataFileSize += sizeof(CodeCacheMetaInfo) + meta.dataSize;
+}
+
+ByteCodeBlock* CodeCache::loadFunctionByteCodeBlock(Context* context, InterpretedCodeBlock* codeBlock)
+{
+    ASSERT(m_enabled);
+    ASSERT(isCachedCodeBlock(codeBlock) && !codeBlock->isGlobalCodeBlock());
+
+    if (m_status != Status::READY) {
+        // another Script is being cached now
+        return nullptr;
+    }
+
+    size_t srcHash = codeBlock->script()->codeCacheSourceHash();
+    FunctionCacheInfo* info = ensureFunctionCacheInfo(srcHash);
+    if (!info) {
+        return nullptr;
+    }
+
+    auto iter = info->m_metaInfos.find(codeBlock->m_codeCacheIndex);
+    if (iter == info->m_metaInfos.end()) {
+        return nullptr;
+    }
+
+    const CodeCacheMetaInfo& metaInfo = iter->second;
+    MappedCacheData& mappedData = info->m_mappedData;
+    if (metaInfo.dataOffset + metaInfo.dataSize > mappedData.m_size) {
+        // data file has grown by appending function ByteCodes after the last mapping
+        std::string filePath = m_cacheDirPath + std::to_string(srcHash);
+        m_worker->waitForIdle();
+        mappedData.unmap();
+        if (UNLIKELY(!mappedData.map(filePath) || metaInfo.dataOffset + metaInfo.dataSize > mappedData.m_size)) {
+            ESCARGOT_LOG_ERROR("[CodeCache] can't map the cache data file %s\n", filePath.data());
+            mappedData.unmap();
+            return nullptr;
+        }
+    }
+
+    // check the header because appending by the worker could have failed
+    CodeCacheMetaInfo header;
+    memcpy(&header, mappedData.m_data + metaInfo.dataOffset - sizeof(CodeCacheMetaInfo), sizeof(CodeCacheMetaInfo));
+    if (UNLIKELY(header.cacheType != CodeCacheType::CACHE_FUNCTION_BYTECODE || header.codeBlockIndex != codeBlock->m_codeCacheIndex || header.dataSize != metaInfo.dataSize)) {
+        ESCARGOT_LOG_ERROR("[CodeCache] invalid function ByteCode of cache data file %zu\n", srcHash);
+        return nullptr;
+    }
+
+    // [checksum][StringTable size][StringTable][ByteCodeBlock]
+    const char* data = mappedData.m_data + metaInfo.dataOffset;
+    size_t checksum;
+    size_t stringTableSize;
+    if (UNLIKELY(metaInfo.dataSize < sizeof(size_t) * 2)) {
+        ESCARGOT_LOG_ERROR("[CodeCache] invalid function ByteCode of cache data file %zu\n", srcHash);
+        return nullptr;
+    }
+    memcpy(&checksum, data, sizeof(size_t));
+    data += sizeof(size_t);
+    size_t remainSize = metaInfo.dataSize - sizeof(size_t);
+    if (UNLIKELY(checksum != functionByteCodeChecksum(data, remainSize))) {
+        // corrupted record, the function is compiled from source and stored again
+        ESCARGOT_LOG_ERROR("[CodeCache] checksum mismatch of function ByteCode of cache data file %zu\n", srcHash);
+        info->m_metaInfos.erase(iter);
+        return nullptr;
+    }
+
+    memcpy(&stringTableSize, data, sizeof(size_t));
+    data += sizeof(size_t);
+    remainSize -= sizeof(size_t);
+    if (UNLIKELY(stringTableSize > remainSize)) {
+        ESCARGOT_LOG_ERROR("[CodeCache] invalid function ByteCode of cache data file %zu\n", srcHash);
+        return nullptr;
+    }
+
+    m_cacheReader->setData(data, stringTableSize);
+    CacheStringTable* stringTable = m_cacheReader->loadStringTable(context);
+    m_cacheReader->clearBuffer();
+
+    m_cacheReader->setData(data + stringTableSize, remainSize - stringTableSize);
+    m_cacheReader->setStringTable(stringTable);
+    ByteCodeBlock* block = m_cacheReader->loadByteCodeBlock(context, codeBlock);
+    m_cacheReader->clearBuffer();
+
+    delete stringTable;
+    return block;
+}
+
+void CodeCache::writeCacheList()
 {
     ASSERT(m_enabled);
     ASSERT(m_cacheList.size() > 0 && m_cacheList.size() <= CODE_CACHE_MAX_CACHE_NUM);
     ASSERT(m_cacheDirPath.length());
 
-    std::string cacheListFilePath = m_cacheDirPath + CODE_CACHE_LIST_FILE_NAME;
-    FILE* listFile = fopen(cacheListFilePath.data(), "wb");
-    if (UNLIKELY(!listFile)) {
-        ESCARGOT_LOG_ERROR("[CodeCache] can't open the cache list file %s\n", cacheListFilePath.data());
-        return false;
-    }
+    CodeCacheWorker::Task task(CodeCacheWorker::TaskType::WRITE_FILE, m_cacheDirPath + CODE_CACHE_LIST_FILE_NAME);
+    std::vector<char>& data = task.m_data;
 
     // first write Escargot version
     std::string version = ESCARGOT_VERSION;
     ASSERT(version.length() > 0);
     size_t versionHash = std::hash<std::string>{}(version);
-    if (UNLIKELY(fwrite(&versionHash, sizeof(size_t), 1, listFile) != 1)) {
-        ESCARGOT_LOG_ERROR("[CodeCache] fwrite of %s failed\n", cacheListFilePath.data());
-        fclose(listFile);
-        return false;
-    }
+    data.insert(data.end(), reinterpret_cast<char*>(&versionHash), reinterpret_cast<char*>(&versionHash) + sizeof(size_t));
 
     size_t listSize = m_cacheList.size();
     // write the number of cache entries
-    if (UNLIKELY(fwrite(&listSize, sizeof(size_t), 1, listFile) != 1)) {
-        ESCARGOT_LOG_ERROR("[CodeCache] fwrite of %s failed\n", cacheListFilePath.data());
-        fclose(listFile);
-        return false;
-    }
-
-    size_t entryCount = 0;
-    auto iter = m_cacheList.begin();
-    while (entryCount < listSize) {
-        ASSERT(iter != m_cacheList.end());
+    data.insert(data.end(), reinterpret_cast<char*>(&listSize), reinterpret_cast<char*>(&listSize) + sizeof(size_t));
 
+    data.reserve(data.size() + listSize * sizeof(CodeCacheEntryChunk));
+    for (auto iter = m_cacheList.begin(); iter != m_cacheList.end(); iter++) {
         CodeCacheEntryChunk entryChunk(iter->first, iter->second);
-        if (UNLIKELY(fwrite(&entryChunk, sizeof(CodeCacheEntryChunk), 1, listFile) != 1)) {
-            ESCARGOT_LOG_ERROR("[CodeCache] fwrite of %s failed\n", cacheListFilePath.data());
-            fclose(listFile);
-            return false;
-        }
-
-        entryCount++;
-        iter++;
+        data.insert(data.end(), reinterpret_cast<char*>(&entryChunk), reinterpret_cast<char*>(&entryChunk) + sizeof(CodeCacheEntryChunk));
     }
-    ASSERT(iter == m_cacheList.end());
 
-    fflush(listFile);
-    // FIXME frequent fsync calls can slow down the overall performance
-    /* for performance issue, fsync is skipped for now
-    fsync(fileno(listFile));
-    */
-    fclose(listFile);
-    return true;
+    // list file is written by the worker
+    m_worker->postTask(std::move(task));
 }
 
-bool CodeCache::writeCacheData(CodeCacheType type, size_t extraCount)
+void CodeCache::writeCacheData(CodeCacheType type, size_t extraCount)
 {
     ASSERT(m_enabled);
     ASSERT(type == CodeCacheType::CACHE_CODEBLOCK || type == CodeCacheType::CACHE_BYTECODE || type == CodeCacheType::CACHE_STRING);
     ASSERT(m_currentContext.m_cacheFilePath.length());
-
-    FILE* dataFile = nullptr;
+    ASSERT(m_currentContext.m_cacheDataOffset == m_currentContext.m_cacheData.size());
 
     // meta info
     CodeCacheMetaInfo meta(type, m_currentContext.m_cacheDataOffset, m_cacheWriter->bufferSize());
@@ -729,35 +1006,15 @@ bool CodeCache::writeCacheData(CodeCacheType type, size_t extraCount)
         ASSERT(m_currentContext.m_cacheDataOffset == 0);
         // extraCount represents the total count of CodeBlocks used only for CodeBlockTree caching
         meta.codeBlockCount = extraCount;
-        dataFile = fopen(m_currentContext.m_cacheFilePath.data(), "wb");
-    } else {
-        dataFile = fopen(m_currentContext.m_cacheFilePath.data(), "ab");
     }
     m_currentContext.m_cacheEntry.m_metaInfos[(size_t)type] = meta;
 
-    if (UNLIKELY(!dataFile)) {
-        ESCARGOT_LOG_ERROR("[CodeCache] can't open the cache data file %s\n", m_currentContext.m_cacheFilePath.data());
-        return false;
-    }
-
-    // write cache data
-    if (UNLIKELY(fwrite(m_cacheWriter->bufferData(), sizeof(char), m_cacheWriter->bufferSize(), dataFile) != m_cacheWriter->bufferSize())) {
-        ESCARGOT_LOG_ERROR("[CodeCache] fwrite of %s failed\n", m_currentContext.m_cacheFilePath.data());
-        fclose(dataFile);
-        m_cacheWriter->clearBuffer();
-        return false;
-    }
-
-    fflush(dataFile);
-    // FIXME frequent fsync calls can slow down the overall performance
-    /* for performance issue, fsync is skipped for now
-    fsync(fileno(dataFile));
-    */
-    fclose(dataFile);
+    // cache data is accumulated in memory and written by the worker in postCacheWriting
+    std::vector<char>& data = m_currentContext.m_cacheData;
+    data.insert(data.end(), m_cacheWriter->bufferData(), m_cacheWriter->bufferData() + m_cacheWriter->bufferSize());
 
     m_currentContext.m_cacheDataOffset += m_cacheWriter->bufferSize();
     m_cacheWriter->clearBuffer();
-    return true;
 }
 
 bool CodeCache::readCacheData(CodeCacheMetaInfo& metaInfo)
@@ -767,26 +1024,20 @@ bool CodeCache::readCacheData(CodeCacheMetaInfo& metaInfo)
     ASSERT(!!m_currentContext.m_cacheFilePath.length());
 
     size_t dataOffset = metaInfo.cacheType == CodeCacheType::CACHE_CODEBLOCK ? 0 : metaInfo.dataOffset;
-    FILE* dataFile = fopen(m_currentContext.m_cacheFilePath.data(), "rb");
-
-    if (UNLIKELY(!dataFile)) {
-        ESCARGOT_LOG_ERROR("[CodeCache] can't open the cache data file %s\n", m_currentContext.m_cacheFilePath.data());
-        return false;
-    }
 
-    if (UNLIKELY(fseek(dataFile, dataOffset, SEEK_SET) != 0)) {
-        ESCARGOT_LOG_ERROR("[CodeCache] can't seek the cache data file %s\n", m_currentContext.m_cacheFilePath.data());
-        fclose(dataFile);
+    // cache data file is mapped once per loading and read in place without copying
+    MappedCacheData& mappedData = m_currentContext.m_mappedData;
+    if (!mappedData.isMapped() && UNLIKELY(!mappedData.map(m_currentContext.m_cacheFilePath))) {
+        ESCARGOT_LOG_ERROR("[CodeCache] can't map the cache data file %s\n", m_currentContext.m_cacheFilePath.data());
         return false;
     }
 
-    if (UNLIKELY(!m_cacheReader->loadData(dataFile, metaInfo.dataSize))) {
+    if (UNLIKELY(dataOffset + metaInfo.dataSize > mappedData.m_size)) {
         ESCARGOT_LOG_ERROR("[CodeCache] load cache data of %s failed\n", m_currentContext.m_cacheFilePath.data());
-        fclose(dataFile);
         return false;
     }
 
-    fclose(dataFile);
+    m_cacheReader->setData(mappedData.m_data + dataOffset, metaInfo.dataSize);
     return true;
 }
 } // namespace Escargot
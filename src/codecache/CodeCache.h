@@ -34,12 +34,19 @@
 #define CODE_CACHE_MAX_CACHE_NUM 32
 #endif
 
+// maximum number of pending file operations of CodeCacheWorker
+#define CODE_CACHE_WORKER_QUEUE_SIZE 16
+// consecutive appends to the same file are merged into one task up to this data size
+// (the queue limit counts tasks, so merging without a limit could hold any amount of data)
+#define CODE_CACHE_WORKER_MERGED_TASK_SIZE_MAX (1024 * 256)
+
 namespace Escargot {
 
 class Script;
 class Context;
 class CodeCacheWriter;
 class CodeCacheReader;
+class CodeCacheWorker;
 class CacheStringTable;
 class ByteCodeBlock;
 class InterpretedCodeBlock;
@@ -59,7 +66,10 @@ enum class CodeCacheType : uint8_t {
     CACHE_BYTECODE = 1,
     CACHE_STRING = 2,
     CACHE_INVALID = 3,
-    CACHE_TYPE_NUM = CACHE_INVALID
+    CACHE_TYPE_NUM = CACHE_INVALID,
+    // ByteCode of each function is appended to the cache data file after its first compilation
+    // it is not recorded in CodeCacheEntry, instead each one is preceded by its own CodeCacheMetaInfo
+    CACHE_FUNCTION_BYTECODE = 4,
 };
 
 struct CodeCacheMetaInfo {
@@ -81,6 +91,7 @@ struct CodeCacheMetaInfo {
     union {
         size_t dataOffset; // data offset in cache data file
         size_t codeBlockCount; // total count of CodeBlocks used only for CodeBlockTree caching
+        size_t codeBlockIndex; // index of CodeBlock in CodeBlockTree used only for function ByteCode caching
     };
     size_t dataSize;
 };
@@ -113,6 +124,32 @@ public:
         FAILED,
     };
 
+    // read-only memory mapping of a cache data file
+    // CodeCacheReader reads cache data in place through this mapping
+    struct MappedCacheData {
+        MappedCacheData()
+            : m_data(nullptr)
+            , m_size(0)
+        {
+        }
+
+        ~MappedCacheData()
+        {
+            unmap();
+        }
+
+        bool isMapped() const { return !!m_data; }
+        bool map(const std::string& filePath);
+        void unmap();
+
+        const char* m_data;
+        size_t m_size;
+
+    private:
+        MappedCacheData(const MappedCacheData&) = delete;
+        MappedCacheData& operator=(const MappedCacheData&) = delete;
+    };
+
     struct CodeCacheContext {
         CodeCacheContext()
             : m_cacheStringTable(nullptr)
@@ -126,6 +163,8 @@ public:
         CodeCacheEntry m_cacheEntry; // current cache entry
         CacheStringTable* m_cacheStringTable; // current CacheStringTable
         size_t m_cacheDataOffset; // current offset in cache data file
+        std::vector<char> m_cacheData; // current cache data serialized for writing
+        MappedCacheData m_mappedData; // current cache data file mapped for loading
     };
 
     struct CodeCacheEntryChunk {
@@ -144,6 +183,20 @@ public:
         CodeCacheEntry m_entry;
     };
 
+    typedef std::unordered_map<size_t, CodeCacheMetaInfo, std::hash<size_t>, std::equal_to<size_t>, std::allocator<std::pair<size_t const, CodeCacheMetaInfo>>> FunctionByteCodeMetaMap;
+
+    // function ByteCode infos of each cached Script
+    struct FunctionCacheInfo {
+        FunctionCacheInfo()
+            : m_dataFileSize(0)
+        {
+        }
+
+        size_t m_dataFileSize; // end offset of the last valid function ByteCode in cache data file
+        FunctionByteCodeMetaMap m_metaInfos; // CodeBlock index -> CodeCacheMetaInfo of function ByteCode
+        MappedCacheData m_mappedData; // cache data file mapped for loading function ByteCode
+    };
+
     CodeCache(const char* baseCacheDir);
     ~CodeCache();
 
@@ -153,7 +206,7 @@ public:
     void prepareCacheLoading(Context* context, size_t srcHash, const CodeCacheEntry& entry);
     void prepareCacheWriting(size_t srcHash);
     bool postCacheLoading();
-    void postCacheWriting(size_t srcHash);
+    bool postCacheWriting(size_t srcHash);
 
     void storeStringTable();
     void storeCodeBlockTree(InterpretedCodeBlock* topCodeBlock, CodeBlockCacheInfo* codeBlockCacheInfo);
@@ -163,6 +216,11 @@ public:
     InterpretedCodeBlock* loadCodeBlockTree(Context* context, Script* script);
     ByteCodeBlock* loadByteCodeBlock(Context* context, InterpretedCodeBlock* topCodeBlock);
 
+    // ByteCode of each function is lazily stored and loaded after its CodeBlockTree is cached
+    bool isCachedCodeBlock(InterpretedCodeBlock* codeBlock);
+    void storeFunctionByteCodeBlock(ByteCodeBlock* block);
+    ByteCodeBlock* loadFunctionByteCodeBlock(Context* context, InterpretedCodeBlock* codeBlock);
+
     void clear();
 
 private:
@@ -173,8 +231,12 @@ private:
     typedef std::unordered_map<size_t, CodeCacheEntry, std::hash<size_t>, std::equal_to<size_t>, std::allocator<std::pair<size_t const, CodeCacheEntry>>> CodeCacheListMap;
     CodeCacheListMap m_cacheList;
 
+    typedef std::unordered_map<size_t, FunctionCacheInfo*, std::hash<size_t>, std::equal_to<size_t>, std::allocator<std::pair<size_t const, FunctionCacheInfo*>>> FunctionCacheInfoMap;
+    FunctionCacheInfoMap m_functionCacheInfos;
+
     CodeCacheWriter* m_cacheWriter;
     CodeCacheReader* m_cacheReader;
+    CodeCacheWorker* m_worker; // background worker for file writing
 
     int m_cacheDirFD; // CodeCache directory file descriptor
     bool m_enabled; // CodeCache enabled
@@ -198,8 +260,11 @@ private:
     void storeCodeBlockTreeNode(InterpretedCodeBlock* codeBlock, size_t& nodeCount);
     InterpretedCodeBlock* loadCodeBlockTreeNode(Script* script);
 
-    bool writeCacheList();
-    bool writeCacheData(CodeCacheType type, size_t extraCount = 0);
+    FunctionCacheInfo* ensureFunctionCacheInfo(size_t srcHash);
+    void removeFunctionCacheInfo(size_t srcHash);
+
+    void writeCacheList();
+    void writeCacheData(CodeCacheType type, size_t extraCount = 0);
     bool readCacheData(CodeCacheMetaInfo& metaInfo);
 };
 } // namespace Escargot
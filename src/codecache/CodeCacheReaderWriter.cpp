@@ -601,34 +601,21 @@ void CodeCacheWriter::storeByteCodeStream(ByteCodeBlock* block)
     }
 }
 
-void CodeCacheReader::CacheBuffer::resize(size_t size)
+void CodeCacheReader::CacheBuffer::setData(const char* data, size_t size)
 {
     ASSERT(!m_buffer && m_capacity == 0 && m_index == 0);
 
-    m_buffer = static_cast<char*>(malloc(size));
+    m_buffer = data;
     m_capacity = size;
 }
 
 void CodeCacheReader::CacheBuffer::reset()
 {
-    free(m_buffer);
-
     m_buffer = nullptr;
     m_capacity = 0;
     m_index = 0;
 }
 
-bool CodeCacheReader::loadData(FILE* file, size_t size)
-{
-    m_buffer.resize(size);
-    if (UNLIKELY(fread((void*)bufferData(), sizeof(char), size, file) != size)) {
-        clearBuffer();
-        return false;
-    }
-
-    return true;
-}
-
 InterpretedCodeBlock* CodeCacheReader::loadInterpretedCodeBlock(Context* context, Script* script)
 {
     ASSERT(!!context);
@@ -846,16 +833,15 @@ CacheStringTable* CodeCacheReader::loadStringTable(Context* context)
     CacheStringTable* table = new CacheStringTable();
 
     bool has16BitString = m_buffer.get<bool>();
-    size_t maxLength = m_buffer.get<size_t>();
+    // maxLength is not used because strings are read in place
+    // only the strings which are not in AtomicStringMap yet are copied
+    m_buffer.get<size_t>();
     size_t tableSize = m_buffer.get<size_t>();
 
     if (LIKELY(!has16BitString)) {
-        size_t length;
-        LChar* buffer = new LChar[maxLength + 1];
         for (size_t i = 0; i < tableSize; i++) {
-            length = m_buffer.get<size_t>();
-            m_buffer.getData(buffer, length);
-            buffer[length] = '\0';
+            size_t length = m_buffer.get<size_t>();
+            const LChar* buffer = m_buffer.getDataInPlace<LChar>(length);
 
             if (UNLIKELY(length == 0)) {
                 table->initAdd(AtomicString());
@@ -863,36 +849,26 @@ CacheStringTable* CodeCacheReader::loadStringTable(Context* context)
                 table->initAdd(AtomicString(context, buffer, length));
             }
         }
-
-        delete[] buffer;
-
     } else {
-        LChar* lBuffer = new LChar[maxLength + 1];
-        UChar* uBuffer = new UChar[maxLength + 1];
         for (size_t i = 0; i < tableSize; i++) {
             bool is8Bit = m_buffer.get<bool>();
             size_t length = m_buffer.get<size_t>();
 
             if (is8Bit) {
-                m_buffer.getData(lBuffer, length);
-                lBuffer[length] = '\0';
+                const LChar* buffer = m_buffer.getDataInPlace<LChar>(length);
 
                 if (UNLIKELY(length == 0)) {
                     table->initAdd(AtomicString());
                 } else {
-                    table->initAdd(AtomicString(context, lBuffer, length));
+                    table->initAdd(AtomicString(context, buffer, length));
                 }
             } else {
                 ASSERT(length > 0);
-                m_buffer.getData(uBuffer, length);
-                uBuffer[length] = '\0';
+                UTF16StringData buffer = m_buffer.getUTF16StringData(length);
 
-                table->initAdd(AtomicString(context, uBuffer, length));
+                table->initAdd(AtomicString(context, buffer.data(), length));
             }
         }
-
-        delete[] lBuffer;
-        delete[] uBuffer;
     }
 
     ASSERT(table->table().size() == tableSize);
@@ -914,16 +890,12 @@ void CodeCacheReader::loadByteCodeStream(Context* context, ByteCodeBlock* block)
         m_buffer.getData(byteCodeStream.data(), codeSize);
     }
 
-    Vector<ByteCodeRelocInfo, std::allocator<ByteCodeRelocInfo>> relocInfoVector;
     ByteCodeStringLiteralData& stringLiteralData = block->m_stringLiteralData;
     ByteCodeOtherLiteralData& bigIntData = block->m_otherLiteralData;
 
-    // load relocInfoVector
-    {
-        size_t relocSize = m_buffer.get<size_t>();
-        relocInfoVector.resizeWithUninitializedValues(relocSize);
-        m_buffer.getData(relocInfoVector.data(), relocSize);
-    }
+    // ByteCodeRelocInfo array is read in place from the cache data
+    size_t relocSize = m_buffer.get<size_t>();
+    const char* relocInfoData = m_buffer.getDataInPlace<char>(relocSize * sizeof(ByteCodeRelocInfo));
 
     // relocate ByteCodeStream
     {
@@ -935,8 +907,10 @@ void CodeCacheReader::loadByteCodeStream(Context* context, ByteCodeBlock* block)
         // mark for LoadRegExp bytecode
         bool bodyStringForLoadRegExp = true;
 
-        for (size_t i = 0; i < relocInfoVector.size(); i++) {
-            ByteCodeRelocInfo& info = relocInfoVector[i];
+        for (size_t i = 0; i < relocSize; i++) {
+            // cache data may not be aligned for ByteCodeRelocInfo
+            ByteCodeRelocInfo info;
+            memcpy(&info, relocInfoData + i * sizeof(ByteCodeRelocInfo), sizeof(ByteCodeRelocInfo));
             ByteCode* currentCode = (ByteCode*)(code + info.codeOffset);
 
 #if defined(COMPILER_GCC) || defined(COMPILER_CLANG)
@@ -227,6 +227,8 @@ private:
 
 class CodeCacheReader {
 public:
+    // CacheBuffer of CodeCacheReader does not own its data
+    // it refers to the memory-mapped cache data file directly
     class CacheBuffer {
     public:
         CacheBuffer()
@@ -241,19 +243,21 @@ public:
             reset();
         }
 
-        char* data() const { return m_buffer; }
+        const char* data() const { return m_buffer; }
         size_t size() const { return m_index; }
         size_t index() const { return m_index; }
-        void resize(size_t size);
+        void setData(const char* data, size_t size);
         void reset();
 
         template <typename IntegralType>
         IntegralType get()
         {
-            ASSERT(m_index < m_capacity);
-            IntegralType value = *(reinterpret_cast<IntegralType*>(m_buffer + m_index));
+            ASSERT(m_index + sizeof(IntegralType) <= m_capacity);
+            // mapped data is not aligned, so copy it into aligned storage first
+            typename std::aligned_storage<sizeof(IntegralType), alignof(IntegralType)>::type value;
+            memcpy(&value, m_buffer + m_index, sizeof(IntegralType));
             m_index += sizeof(IntegralType);
-            return value;
+            return *reinterpret_cast<IntegralType*>(&value);
         }
 
         template <typename IntegralType>
@@ -263,29 +267,41 @@ public:
                 return;
             }
             size_t dataSize = size * sizeof(IntegralType);
+            ASSERT(m_index + dataSize <= m_capacity);
             memcpy(data, m_buffer + m_index, dataSize);
             m_index += dataSize;
         }
 
-        // FIXME
+        // returns the address of data in place and skips it
+        // mapped data is not aligned, so only byte data can be read in place
+        template <typename IntegralType>
+        const IntegralType* getDataInPlace(size_t size)
+        {
+            static_assert(alignof(IntegralType) == 1, "only byte data can be read in place");
+            const IntegralType* data = reinterpret_cast<const IntegralType*>(m_buffer + m_index);
+            ASSERT(m_index + size * sizeof(IntegralType) <= m_capacity);
+            m_index += size * sizeof(IntegralType);
+            return data;
+        }
+
         String* getString()
         {
-            String* str = nullptr;
             bool is8Bit = get<bool>();
             size_t length = get<size_t>();
             ASSERT(length);
             if (LIKELY(is8Bit)) {
-                LChar* buffer = ALLOCA(sizeof(LChar) * (length + 1), LChar, nullptr);
-                buffer[length] = '\0';
-                getData(buffer, length);
-                str = new Latin1String(buffer, length);
-            } else {
-                UChar* buffer = ALLOCA(sizeof(UChar) * (length + 1), UChar, nullptr);
-                buffer[length] = '\0';
-                getData(buffer, length);
-                str = new UTF16String(buffer, length);
+                return new Latin1String(getDataInPlace<LChar>(length), length);
             }
-            return str;
+            return new UTF16String(getUTF16StringData(length));
+        }
+
+        // char16_t data is copied into an aligned buffer because mapped data is not aligned
+        UTF16StringData getUTF16StringData(size_t length)
+        {
+            UTF16StringData buffer;
+            buffer.resizeWithUninitializedValues(length);
+            getData(buffer.data(), length);
+            return buffer;
         }
 
         bf_t getBF(bf_context_t* bfContext)
@@ -302,7 +318,7 @@ public:
         }
 
     private:
-        char* m_buffer;
+        const char* m_buffer;
         size_t m_capacity;
         size_t m_index;
     };
@@ -329,10 +345,10 @@ public:
         return m_stringTable;
     }
 
-    char* bufferData() { return m_buffer.data(); }
+    const char* bufferData() { return m_buffer.data(); }
     size_t bufferIndex() const { return m_buffer.index(); }
     void clearBuffer() { m_buffer.reset(); }
-    bool loadData(FILE*, size_t);
+    void setData(const char* data, size_t size) { m_buffer.setData(data, size); }
 
     InterpretedCodeBlock* loadInterpretedCodeBlock(Context* context, Script* script);
     ByteCodeBlock* loadByteCodeBlock(Context* context, InterpretedCodeBlock* topCodeBlock);
@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2021-present Samsung Electronics Co., Ltd
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+ */
+
+#if defined(ENABLE_CODE_CACHE)
+
+#include "Escargot.h"
+#include "codecache/CodeCache.h"
+#include "codecache/CodeCacheWorker.h"
+
+#include <unistd.h>
+
+namespace Escargot {
+
+static std::mutex g_runningWorkersMutex;
+
+static std::vector<CodeCacheWorker*>& runningWorkers()
+{
+    static std::vector<CodeCacheWorker*> workers;
+    return workers;
+}
+
+void CodeCacheWorker::joinAllAtExit()
+{
+    std::vector<CodeCacheWorker*> workers;
+    {
+        std::lock_guard<std::mutex> lock(g_runningWorkersMutex);
+        workers.swap(runningWorkers());
+    }
+
+    for (size_t i = 0; i < workers.size(); i++) {
+        workers[i]->join();
+    }
+}
+
+void CodeCacheWorker::postTask(Task&& task)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    if (!m_running) {
+        // worker thread is lazily launched by the first task
+        ASSERT(m_tasks.empty() && !m_busy);
+        m_running = true;
+        m_thread = std::thread(&CodeCacheWorker::run, this);
+
+        std::lock_guard<std::mutex> workersLock(g_runningWorkersMutex);
+        static bool atExitRegistered = false;
+        if (!atExitRegistered) {
+            runningWorkers();
+            atexit(joinAllAtExit);
+            atExitRegistered = true;
+        }
+        runningWorkers().push_back(this);
+    }
+
+    if (task.m_type == TaskType::APPEND_FILE && !m_tasks.empty()) {
+        // merge consecutive appends to the same file (e.g. ByteCode of each function)
+        Task& lastTask = m_tasks.back();
+        if (lastTask.m_type == TaskType::APPEND_FILE && lastTask.m_filePath == task.m_filePath
+            && lastTask.m_data.size() + task.m_data.size() <= CODE_CACHE_WORKER_MERGED_TASK_SIZE_MAX) {
+            lastTask.m_data.insert(lastTask.m_data.end(), task.m_data.begin(), task.m_data.end());
+            return;
+        }
+    }
+
+    m_doneCondition.wait(lock, [this] { return m_tasks.size() < CODE_CACHE_WORKER_QUEUE_SIZE; });
+    m_tasks.push_back(std::move(task));
+    m_taskCondition.notify_one();
+}
+
+void CodeCacheWorker::waitForIdle()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_doneCondition.wait(lock, [this] { return m_tasks.empty() && !m_busy; });
+}
+
+void CodeCacheWorker::stop()
+{
+    {
+        std::lock_guard<std::mutex> workersLock(g_runningWorkersMutex);
+        std::vector<CodeCacheWorker*>& workers = runningWorkers();
+        auto iter = std::find(workers.begin(), workers.end(), this);
+        if (iter != workers.end()) {
+            workers.erase(iter);
+        }
+    }
+
+    join();
+}
+
+void CodeCacheWorker::join()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_running) {
+            return;
+        }
+        m_running = false;
+    }
+    m_taskCondition.notify_one();
+
+    // remaining tasks are processed before the worker thread terminates
+    m_thread.join();
+    ASSERT(m_tasks.empty() && !m_busy);
+}
+
+bool CodeCacheWorker::hasFailed()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_failed;
+}
+
+void CodeCacheWorker::run()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        m_taskCondition.wait(lock, [this] { return !m_tasks.empty() || !m_running; });
+        if (m_tasks.empty()) {
+            ASSERT(!m_running);
+            break;
+        }
+
+        Task task = std::move(m_tasks.front());
+        m_tasks.pop_front();
+        m_busy = true;
+
+        // file I/O is done without holding the lock
+        lock.unlock();
+        bool result = processTask(task);
+        lock.lock();
+
+        m_busy = false;
+        m_failed |= !result;
+        m_doneCondition.notify_all();
+    }
+}
+
+bool CodeCacheWorker::processTask(Task& task)
+{
+    switch (task.m_type) {
+    case TaskType::WRITE_FILE: {
+        // write into a temporal file and rename it
+        // so that the original file remains intact for readers (e.g. memory-mapped) until it is replaced
+        std::string tempFilePath = task.m_filePath + ".tmp";
+        if (UNLIKELY(!writeFile(tempFilePath, task.m_data, false))) {
+            remove(tempFilePath.data());
+            return false;
+        }
+        if (UNLIKELY(rename(tempFilePath.data(), task.m_filePath.data()) != 0)) {
+            ESCARGOT_LOG_ERROR("[CodeCache] can't rename the cache file %s\n", tempFilePath.data());
+            remove(tempFilePath.data());
+            return false;
+        }
+        return true;
+    }
+    case TaskType::APPEND_FILE:
+        return writeFile(task.m_filePath, task.m_data, true);
+    case TaskType::REMOVE_FILE:
+        if (UNLIKELY(remove(task.m_filePath.data()) != 0)) {
+            ESCARGOT_LOG_ERROR("[CodeCache] can`t remove a cache file %s\n", task.m_filePath.data());
+            return false;
+        }
+        return true;
+    default:
+        RELEASE_ASSERT_NOT_REACHED();
+        return false;
+    }
+}
+
+bool CodeCacheWorker::writeFile(const std::string& filePath, const std::vector<char>& data, bool append)
+{
+    FILE* file = fopen(filePath.data(), append ? "ab" : "wb");
+    if (UNLIKELY(!file)) {
+        ESCARGOT_LOG_ERROR("[CodeCache] can't open the cache file %s\n", filePath.data());
+        return false;
+    }
+
+    if (UNLIKELY(fwrite(data.data(), sizeof(char), data.size(), file) != data.size())) {
+        ESCARGOT_LOG_ERROR("[CodeCache] fwrite of %s failed\n", filePath.data());
+        fclose(file);
+        return false;
+    }
+
+    fflush(file);
+    if (!append) {
+        // replaced files (cache data and cache list) are synchronized before renaming
+        // because the cache list should not refer to a cache data which is not on the disk yet
+        // appended function ByteCodes are validated when they are scanned, so fsync is skipped for them
+        fsync(fileno(file));
+    }
+    fclose(file);
+    return true;
+}
+} // namespace Escargot
+
+#endif // ENABLE_CODE_CACHE
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2021-present Samsung Electronics Co., Ltd
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+ */
+
+#ifndef __CodeCacheWorker__
+#define __CodeCacheWorker__
+
+#if defined(ENABLE_CODE_CACHE)
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace Escargot {
+
+// CodeCacheWorker performs file I/O of CodeCache on a background thread
+// cache data is serialized into memory by the mutator thread and handed over as a task
+// tasks are processed in posted order, so a file is always written before it is appended or referred by the cache list
+// NOTE tasks never refer to GC-managed memory because the worker thread is not registered to GC
+// NOTE running workers are finished at exit too, because VMInstance may not be destroyed before exit
+class CodeCacheWorker {
+public:
+    enum class TaskType : uint8_t {
+        WRITE_FILE, // replace a file with the task data atomically
+        APPEND_FILE, // append the task data to a file
+        REMOVE_FILE, // remove a file
+    };
+
+    struct Task {
+        Task(TaskType type, const std::string& filePath)
+            : m_type(type)
+            , m_filePath(filePath)
+        {
+        }
+
+        TaskType m_type;
+        std::string m_filePath;
+        std::vector<char> m_data;
+    };
+
+    CodeCacheWorker()
+        : m_running(false)
+        , m_busy(false)
+        , m_failed(false)
+    {
+    }
+
+    ~CodeCacheWorker()
+    {
+        stop();
+    }
+
+    // post a task and wake up the worker
+    // it blocks while the task queue is full (CODE_CACHE_WORKER_QUEUE_SIZE)
+    // an append is merged into the last queued append to the same file while their data is small (CODE_CACHE_WORKER_MERGED_TASK_SIZE_MAX)
+    void postTask(Task&& task);
+    // wait until all posted tasks are done
+    void waitForIdle();
+    // finish all posted tasks and terminate the worker thread
+    void stop();
+
+    // true if any file operation has failed
+    bool hasFailed();
+
+private:
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_taskCondition; // signaled when a task is posted or stop is requested
+    std::condition_variable m_doneCondition; // signaled when a task is done
+    std::deque<Task> m_tasks;
+    bool m_running;
+    bool m_busy; // worker thread is processing a task out of the queue
+    bool m_failed;
+
+    void run();
+    void join();
+    static void joinAllAtExit();
+    static bool processTask(Task& task);
+    static bool writeFile(const std::string& filePath, const std::vector<char>& data, bool append);
+};
+} // namespace Escargot
+
+#endif // ENABLE_CODE_CACHE
+
+#endif
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2021-present Samsung Electronics Co., Ltd
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+ */
+
+#include "Escargot.h"
+#include "AllocationCache.h"
+
+namespace Escargot {
+
+int AllocationCache::s_gcKinds[NumberOfKind];
+#if !defined(ENABLE_THREADING)
+void* AllocationCache::s_freeLists[NumberOfKind][MaxGranules];
+#endif
+
+void AllocationCache::initialize()
+{
+    s_gcKinds[NormalKind] = GC_I_NORMAL;
+    s_gcKinds[PointerFreeKind] = GC_I_PTRFREE;
+    s_gcKinds[ArrayObjectKind] = gcKindOf(HeapObjectKind::ArrayObjectKind);
+}
+
+void AllocationCache::drop()
+{
+#if !defined(ENABLE_THREADING)
+    memset(s_freeLists, 0, sizeof(s_freeLists));
+#endif
+}
+
+void* AllocationCache::allocateDirectly(Kind kind, size_t size)
+{
+    switch (kind) {
+    case NormalKind:
+        return GC_MALLOC(size);
+    case PointerFreeKind:
+        return GC_MALLOC_ATOMIC(size);
+    default:
+        return GC_GENERIC_MALLOC(size, s_gcKinds[kind]);
+    }
+}
+
+#if !defined(ENABLE_THREADING)
+void* AllocationCache::refillAndAllocate(Kind kind, size_t granules)
+{
+    void* list = nullptr;
+    // this can trigger gc which drops every list
+    GC_generic_malloc_many(granules * GranuleBytes, s_gcKinds[kind], &list);
+    if (UNLIKELY(list == nullptr)) {
+        return allocateDirectly(kind, granules * GranuleBytes);
+    }
+
+    void* result = list;
+    s_freeLists[kind][granules - 1] = *reinterpret_cast<void**>(result);
+    if (kind != PointerFreeKind) {
+        *reinterpret_cast<void**>(result) = nullptr;
+    }
+    return result;
+}
+#endif
+} // namespace Escargot
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2021-present Samsung Electronics Co., Ltd
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+ */
+
+#ifndef __EscargotAllocationCache__
+#define __EscargotAllocationCache__
+
+namespace Escargot {
+
+// Free lists of small objects for the most frequently allocated kinds
+// A list is refilled from bdwgc in a batch (GC_generic_malloc_many), then allocation is just a pop of the list.
+// Objects on the lists are allocated already from the view of bdwgc, and some kinds do not trace the link word,
+// so every list is dropped when marking starts and the remaining objects are reclaimed by the collection.
+// With threading, a collection can stop other threads in the middle of a pop, so the lists are not used.
+// bdwgc has its own thread-local free lists (THREAD_LOCAL_ALLOC) in that case.
+class AllocationCache {
+public:
+    enum Kind : unsigned {
+        NormalKind, // GC_MALLOC
+        PointerFreeKind, // GC_MALLOC_ATOMIC
+        ArrayObjectKind, // HeapObjectKind::ArrayObjectKind
+        NumberOfKind,
+    };
+
+    static constexpr size_t GranuleBytes = sizeof(void*) * 2;
+    // bigger objects are allocated without cache
+    static constexpr size_t MaxGranules = 16;
+
+    static void initialize();
+    // called when marking starts
+    static void drop();
+
+    template <Kind kind>
+    static ALWAYS_INLINE void* allocate(size_t size)
+    {
+#if defined(ENABLE_THREADING)
+        return allocateDirectly(kind, size);
+#else
+        size_t granules = (size + GranuleBytes - 1) / GranuleBytes;
+        if (UNLIKELY(granules == 0 || granules > MaxGranules)) {
+            return allocateDirectly(kind, size);
+        }
+
+        void** list = &s_freeLists[kind][granules - 1];
+        void* result = *list;
+        if (LIKELY(result != nullptr)) {
+            *list = *reinterpret_cast<void**>(result);
+            if (kind != PointerFreeKind) {
+                // other words are cleared by bdwgc already
+                *reinterpret_cast<void**>(result) = nullptr;
+            }
+            return result;
+        }
+        return refillAndAllocate(kind, granules);
+#endif
+    }
+
+private:
+    static void* allocateDirectly(Kind kind, size_t size);
+#if !defined(ENABLE_THREADING)
+    static void* refillAndAllocate(Kind kind, size_t granules);
+
+    static void* s_freeLists[NumberOfKind][MaxGranules];
+#endif
+    static int s_gcKinds[NumberOfKind];
+};
+} // namespace Escargot
+
+#endif
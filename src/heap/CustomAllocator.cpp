@@ -306,6 +306,11 @@ void initializeCustomAllocators()
 #endif
 }
 
+int gcKindOf(HeapObjectKind kind)
+{
+    return s_gcKinds[kind];
+}
+
 void iterateSpecificKindOfObject(ExecutionState& state, HeapObjectKind kind, HeapObjectIteratorCallback callback)
 {
     struct HeapObjectIteratorData {
@@ -66,6 +66,8 @@ enum HeapObjectKind : unsigned {
 };
 
 void initializeCustomAllocators();
+// bdwgc kind of HeapObjectKind. only valid after initializeCustomAllocators
+int gcKindOf(HeapObjectKind kind);
 
 typedef std::function<void(ExecutionState& state, void* obj)> HeapObjectIteratorCallback;
 
@@ -26,12 +26,38 @@
 
 namespace Escargot {
 
+#if defined(ENABLE_GC_PARALLEL_MARK)
+static size_t g_markerThreadCount;
+#endif
+
+static void gcEventCallback(GC_EventType t, void* data)
+{
+    if (t == GC_EventType::GC_EVENT_MARK_START) {
+        AllocationCache::drop();
+    }
+}
+
 void Heap::initialize()
 {
     RELEASE_ASSERT(GC_get_all_interior_pointers() == 0);
 
+#if defined(ENABLE_GC_PARALLEL_MARK)
+    // marker threads are created when bdwgc is initialized
+    // every Escargot hook called during marking is safe with them
+    // - gc event callbacks are called only by the collecting thread
+    // - mark procedures of custom kinds keep their state on the stack
+    // - descriptors from GC_make_descriptor are never modified after creation
+    if (g_markerThreadCount) {
+        GC_set_markers_count(g_markerThreadCount);
+    }
+#endif
     GC_set_force_unmap_on_gcollect(1);
+#if defined(ENABLE_THREADING)
+    GC_allow_register_threads();
+#endif
     initializeCustomAllocators();
+    AllocationCache::initialize();
+    GC_add_event_callback(gcEventCallback, nullptr);
 
 #ifdef PROFILE_BDWGC
     GCUtil::HeapUsageVisualizer::initialize();
@@ -40,11 +66,78 @@ void Heap::initialize()
 
 void Heap::finalize()
 {
+    GC_remove_event_callback(gcEventCallback, nullptr);
+    AllocationCache::drop();
     for (size_t i = 0; i < 5; i++) {
         GC_gcollect_and_unmap();
     }
 }
 
+void Heap::initializeThread()
+{
+#if defined(ENABLE_THREADING)
+    struct GC_stack_base stackBase;
+    RELEASE_ASSERT(GC_get_stack_base(&stackBase) == GC_SUCCESS);
+    RELEASE_ASSERT(GC_register_my_thread(&stackBase) == GC_SUCCESS);
+#else
+    RELEASE_ASSERT_NOT_REACHED();
+#endif
+}
+
+void Heap::finalizeThread()
+{
+#if defined(ENABLE_THREADING)
+    GC_unregister_my_thread();
+#else
+    RELEASE_ASSERT_NOT_REACHED();
+#endif
+}
+
+bool Heap::setMarkerThreadCount(size_t count)
+{
+#if defined(ENABLE_GC_PARALLEL_MARK)
+    g_markerThreadCount = count;
+    return true;
+#else
+    UNUSED_PARAMETER(count);
+    return false;
+#endif
+}
+
+void Heap::setPauseBudget(size_t microseconds)
+{
+    if (microseconds) {
+        if (!GC_is_incremental_mode()) {
+            GC_enable_incremental();
+        }
+        struct GC_timeval_s limit;
+        limit.tv_ms = microseconds / 1000;
+        limit.tv_nsec = (microseconds % 1000) * 1000;
+        GC_set_time_limit_tv(limit);
+    } else {
+        GC_set_time_limit(GC_TIME_UNLIMITED);
+    }
+}
+
+bool Heap::performIdleWork(std::chrono::steady_clock::time_point deadline)
+{
+    if (GC_is_incremental_mode() && GC_get_bytes_since_gc() > GC_get_heap_size() / (2 * GC_get_free_space_divisor())) {
+        // start the next collection in idle time instead of in the middle of busy period
+        // this does nothing if there is a collection in progress already
+        GC_start_incremental_collection();
+    }
+
+    // without incremental mode, GC_collect_a_little runs a full collection only if it is already due
+    bool inProgress = false;
+    while (std::chrono::steady_clock::now() < deadline) {
+        inProgress = GC_collect_a_little();
+        if (!inProgress) {
+            break;
+        }
+    }
+    return inProgress;
+}
+
 void Heap::printGCHeapUsage()
 {
 #ifdef ESCARGOT_MEM_STATS
@@ -21,16 +21,35 @@
 #define __EscargotHeap__
 #include "GCUtil.h"
 
+#include <chrono>
+
 namespace Escargot {
 
 class Heap {
 public:
     static void initialize();
     static void finalize();
+    // register or unregister the current thread to GC
+    // every thread except the one which called initialize should be registered before allocating
+    static void initializeThread();
+    static void finalizeThread();
     static void printGCHeapUsage();
+
+    // number of threads marking the heap in parallel (including the collecting thread)
+    // only effective with ENABLE_GC_PARALLEL_MARK and before initialize, returns false without it
+    // 0 leaves the decision to bdwgc (GC_MARKERS environment variable or the number of processors)
+    static bool setMarkerThreadCount(size_t count);
+
+    // incremental collection
+    // with non-zero budget, marking is done in slices and each slice stops the world for about `microseconds`
+    // bdwgc cannot leave incremental mode once entered, so 0 only removes the limit of each slice
+    static void setPauseBudget(size_t microseconds);
+    // do gc work until deadline, returns true if the current collection is not finished yet
+    static bool performIdleWork(std::chrono::steady_clock::time_point deadline);
 };
 } // namespace Escargot
 
 #include "CustomAllocator.h"
+#include "AllocationCache.h"
 
 #endif
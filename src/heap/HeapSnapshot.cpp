@@ -0,0 +1,247 @@
+/*
+ * Copyright (c) 2021-present Samsung Electronics Co., Ltd
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+ */
+
+#include "Escargot.h"
+#include "HeapSnapshot.h"
+#include "runtime/Object.h"
+#include "runtime/FunctionObject.h"
+#include "runtime/ObjectStructure.h"
+#include "parser/CodeBlock.h"
+
+namespace Escargot {
+
+struct HeapSnapshotNode {
+    void* base;
+    size_t size;
+    int kind;
+};
+
+struct HeapSnapshotData {
+    std::vector<HeapSnapshotNode> nodes;
+    std::unordered_map<void*, size_t> indexOfObject;
+    // bdwgc does not expose these kind numbers
+    int uncollectableKind;
+    int atomicUncollectableKind;
+    size_t objectStructureVTables[3];
+};
+
+static const char* heapObjectKindName(HeapObjectKind kind)
+{
+    switch (kind) {
+    case ValueVectorKind:
+        return "ValueVector";
+    case GetObjectInlineCacheDataVectorKind:
+        return "GetObjectInlineCacheDataVector";
+#if defined(ESCARGOT_64) && defined(ESCARGOT_USE_32BIT_IN_64BIT)
+    case EncodedSmallValueVectorKind:
+        return "EncodedSmallValueVector";
+#endif
+    case ArrayObjectKind:
+        return "ArrayObject";
+#if !defined(NDEBUG)
+    case ArrayBufferObjectKind:
+        return "ArrayBufferObject";
+    case InterpretedCodeBlockKind:
+        return "InterpretedCodeBlock";
+    case InterpretedCodeBlockWithRareDataKind:
+        return "InterpretedCodeBlockWithRareData";
+    case WeakMapObjectDataItemKind:
+        return "WeakMapObjectDataItem";
+    case WeakRefObjectKind:
+        return "WeakRefObject";
+    case FinalizationRegistryObjectItemKind:
+        return "FinalizationRegistryObjectItem";
+#endif
+    default:
+        RELEASE_ASSERT_NOT_REACHED();
+    }
+}
+
+static const char* gcKindName(HeapSnapshotData& data, int kind)
+{
+    if (kind == GC_I_PTRFREE) {
+        return "Atomic";
+    } else if (kind == GC_I_NORMAL) {
+        return "Normal";
+    } else if (kind == data.uncollectableKind) {
+        return "Uncollectable";
+    } else if (kind == data.atomicUncollectableKind) {
+        return "AtomicUncollectable";
+    }
+
+    for (unsigned i = 0; i < HeapObjectKind::NumberOfKind; i++) {
+        if (gcKindOf((HeapObjectKind)i) == kind) {
+            return heapObjectKindName((HeapObjectKind)i);
+        }
+    }
+    // allocated by GC_MALLOC_EXPLICITLY_TYPED
+    return "Typed";
+}
+
+static Object* asObjectIfPossible(HeapSnapshotData& data, const HeapSnapshotNode& node)
+{
+    if (node.kind == GC_I_PTRFREE || node.size < sizeof(Object)) {
+        return nullptr;
+    }
+
+    // every data area of Object starts with [<vtable>, m_structure...] (see PointerValue.h)
+    void* object = GC_USR_PTR_FROM_BASE(node.base);
+    void* structure = reinterpret_cast<void**>(object)[1];
+    if (data.indexOfObject.find(structure) == data.indexOfObject.end()) {
+        return nullptr;
+    }
+    size_t vtable = *reinterpret_cast<size_t*>(structure);
+    for (size_t i = 0; i < 3; i++) {
+        if (vtable == data.objectStructureVTables[i]) {
+            return reinterpret_cast<Object*>(object);
+        }
+    }
+    return nullptr;
+}
+
+// line breaks separate records of the snapshot file
+static std::string nodeName(String* name)
+{
+    std::string str = name->toNonGCUTF8StringData();
+    std::replace(str.begin(), str.end(), '\n', ' ');
+    return str;
+}
+
+static std::string functionName(FunctionObject* fn)
+{
+    return nodeName(fn->codeBlock()->functionName().string());
+}
+
+static std::string className(Object* obj)
+{
+    Optional<Object*> proto = obj->rawInternalPrototypeObject();
+    String* name = proto ? proto->constructorNameWithoutState() : nullptr;
+    return name ? nodeName(name) : "Object";
+}
+
+static void writeEdges(HeapSnapshotData& data, FILE* fp, size_t from, std::vector<size_t>& edges)
+{
+#if defined(ESCARGOT_64) && defined(ESCARGOT_USE_32BIT_IN_64BIT)
+    // gc heap is placed under 4GB, and EncodedSmallValue holds a pointer in 32-bit
+    typedef uint32_t ScanUnit;
+#else
+    typedef size_t ScanUnit;
+#endif
+    const HeapSnapshotNode& node = data.nodes[from];
+    ScanUnit* begin = reinterpret_cast<ScanUnit*>(node.base);
+    ScanUnit* end = begin + node.size / sizeof(ScanUnit);
+
+    edges.clear();
+    for (ScanUnit* p = begin; p < end; p++) {
+        if (!*p) {
+            continue;
+        }
+        // interior pointers are resolved to the object like bdwgc does
+        void* base = GC_base(reinterpret_cast<void*>(static_cast<size_t>(*p)));
+        if (!base) {
+            continue;
+        }
+        auto iter = data.indexOfObject.find(GC_USR_PTR_FROM_BASE(base));
+        if (iter != data.indexOfObject.end() && iter->second != from) {
+            edges.push_back(iter->second);
+        }
+    }
+
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+    for (size_t to : edges) {
+        fprintf(fp, "edge %zu %zu\n", from, to);
+    }
+}
+
+bool HeapSnapshot::write(const char* path)
+{
+    FILE* fp = fopen(path, "w");
+    if (!fp) {
+        return false;
+    }
+
+    HeapSnapshotData data;
+    void* probe = GC_MALLOC_UNCOLLECTABLE(sizeof(void*));
+    data.uncollectableKind = GC_get_kind_and_size(GC_base(probe), nullptr);
+    GC_FREE(probe);
+    probe = GC_MALLOC_ATOMIC_UNCOLLECTABLE(sizeof(void*));
+    data.atomicUncollectableKind = GC_get_kind_and_size(GC_base(probe), nullptr);
+    GC_FREE(probe);
+
+    {
+        // vtable address identifies each ObjectStructure class (like tag values of PointerValue)
+        ObjectStructureWithoutTransition withoutTransition(nullptr, false, false);
+        ObjectStructureWithTransition withTransition(ObjectStructureItemTightVector(), false, false);
+        ObjectStructureWithMap withMap(nullptr, nullptr, false);
+        data.objectStructureVTables[0] = *reinterpret_cast<size_t*>(&withoutTransition);
+        data.objectStructureVTables[1] = *reinterpret_cast<size_t*>(&withTransition);
+        data.objectStructureVTables[2] = *reinterpret_cast<size_t*>(&withMap);
+    }
+
+    ASSERT(!GC_is_disabled());
+    GC_gcollect(); // update mark status
+    GC_disable();
+    GC_enumerate_reachable_objects_inner([](void* obj, size_t bytes, void* cd) {
+        HeapSnapshotData* data = (HeapSnapshotData*)cd;
+        data->nodes.push_back(HeapSnapshotNode{ obj, bytes, GC_get_kind_and_size(obj, nullptr) });
+    },
+                                         &data);
+
+    data.indexOfObject.reserve(data.nodes.size());
+    for (size_t i = 0; i < data.nodes.size(); i++) {
+        data.indexOfObject[GC_USR_PTR_FROM_BASE(data.nodes[i].base)] = i;
+    }
+
+    fprintf(fp, "escargot-heap-snapshot 1\n");
+    for (size_t i = 0; i < data.nodes.size(); i++) {
+        const HeapSnapshotNode& node = data.nodes[i];
+        void* ptr = GC_USR_PTR_FROM_BASE(node.base);
+        Object* obj = asObjectIfPossible(data, node);
+        if (obj && obj->isFunctionObject()) {
+            fprintf(fp, "node %zu %p %zu Function %s\n", i, ptr, node.size, functionName(obj->asFunctionObject()).data());
+        } else if (obj) {
+            fprintf(fp, "node %zu %p %zu Object %s\n", i, ptr, node.size, className(obj).data());
+        } else {
+            fprintf(fp, "node %zu %p %zu %s\n", i, ptr, node.size, gcKindName(data, node.kind));
+        }
+    }
+
+    // uncollectable objects are roots of gc (PersistentRefHolder, VMInstance...)
+    // objects referred only by stack or static data are not known, tools/heap_snapshot.py guesses them
+    for (size_t i = 0; i < data.nodes.size(); i++) {
+        int kind = data.nodes[i].kind;
+        if (kind == data.uncollectableKind || kind == data.atomicUncollectableKind) {
+            fprintf(fp, "root %zu\n", i);
+        }
+    }
+
+    std::vector<size_t> edges;
+    for (size_t i = 0; i < data.nodes.size(); i++) {
+        int kind = data.nodes[i].kind;
+        if (kind != GC_I_PTRFREE && kind != data.atomicUncollectableKind) {
+            writeEdges(data, fp, i, edges);
+        }
+    }
+    GC_enable();
+
+    bool succeeded = !ferror(fp);
+    return !fclose(fp) && succeeded;
+}
+} // namespace Escargot
@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2021-present Samsung Electronics Co., Ltd
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+ */
+
+#ifndef __EscargotHeapSnapshot__
+#define __EscargotHeapSnapshot__
+
+namespace Escargot {
+
+// Text dump of every reachable gc object and the references between them
+// Most gc objects have no precise type information,
+// so references are found by scanning each object conservatively as the bdwgc marker does.
+// JS objects are recognized by their ObjectStructure and named after the constructor on their prototype chain.
+// Other objects are named after their bdwgc kind.
+// File format and the offline retained size analysis are in tools/heap_snapshot.py
+class HeapSnapshot {
+public:
+    // runs a full collection first
+    // returns false if the file cannot be written
+    static bool write(const char* path);
+};
+} // namespace Escargot
+
+#endif
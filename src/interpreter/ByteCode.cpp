@@ -26,6 +26,7 @@
 #include "parser/ScriptParser.h"
 #include "parser/ast/AST.h"
 #include "parser/esprima_cpp/esprima.h"
+#include "jit/JITCode.h"
 
 namespace Escargot {
 
@@ -80,8 +81,17 @@ void SetGlobalVariable::dump(const char* byteCodeStart)
 ByteCodeBlock::ByteCodeBlock()
     : m_shouldClearStack(false)
     , m_isOwnerMayFreed(false)
+    , m_isExecutedSinceLastGC(false)
+#if defined(ENABLE_JIT)
+    , m_jitDisabled(false)
+#endif
     , m_requiredRegisterFileSizeInValueSize(2)
     , m_inlineCacheDataSize(0)
+    , m_lastExecutedEpoch(0)
+#if defined(ENABLE_JIT)
+    , m_jitHotness(0)
+    , m_jitCode(nullptr)
+#endif
     , m_codeBlock(nullptr)
 {
     // This constructor is used to allocate a ByteCodeBlock on the stack
@@ -90,12 +100,26 @@ ByteCodeBlock::ByteCodeBlock()
 ByteCodeBlock::ByteCodeBlock(InterpretedCodeBlock* codeBlock)
     : m_shouldClearStack(false)
     , m_isOwnerMayFreed(false)
+    , m_isExecutedSinceLastGC(false)
+#if defined(ENABLE_JIT)
+    , m_jitDisabled(false)
+#endif
     , m_requiredRegisterFileSizeInValueSize(2)
     , m_inlineCacheDataSize(0)
+    , m_lastExecutedEpoch(0)
+#if defined(ENABLE_JIT)
+    , m_jitHotness(0)
+    , m_jitCode(nullptr)
+#endif
     , m_codeBlock(codeBlock)
 {
-    auto& v = m_codeBlock->context()->vmInstance()->compiledByteCodeBlocks();
-    v.push_back(this);
+    VMInstance* vmInstance = m_codeBlock->context()->vmInstance();
+    m_lastExecutedEpoch = vmInstance->compiledByteCodeEpoch();
+    {
+        VMInstance::RegistryLocker locker(vmInstance);
+        auto& v = vmInstance->compiledByteCodeBlocks();
+        v.push_back(this);
+    }
     GC_REGISTER_FINALIZER_NO_ORDER(this, [](void* obj, void*) {
         ByteCodeBlock* self = (ByteCodeBlock*)obj;
 
@@ -110,9 +134,19 @@ ByteCodeBlock::ByteCodeBlock(InterpretedCodeBlock* codeBlock)
         self->m_numeralLiteralData.clear();
         self->m_jumpFlowRecordData.clear();
 
+#if defined(ENABLE_JIT)
+        delete self->m_jitCode;
+        self->m_jitCode = nullptr;
+#endif
+
         if (!self->m_isOwnerMayFreed) {
-            auto& v = self->m_codeBlock->context()->vmInstance()->compiledByteCodeBlocks();
-            v.erase(std::find(v.begin(), v.end(), self));
+            VMInstance* vmInstance = self->m_codeBlock->context()->vmInstance();
+            VMInstance::RegistryLocker locker(vmInstance);
+            // ~VMInstance can be running on another thread
+            if (!self->m_isOwnerMayFreed) {
+                auto& v = vmInstance->compiledByteCodeBlocks();
+                v.erase(std::find(v.begin(), v.end(), self));
+            }
         }
     },
                                    nullptr, nullptr, nullptr);
@@ -294,6 +328,12 @@ void ByteCodeBlock::pushPauseStatementExtraData(ByteCodeGenerateContext* context
     }
 }
 
+void* KeyedObjectInlineCache::operator new(size_t size)
+{
+    // every cache entry holds pointers
+    return GC_MALLOC(size);
+}
+
 void* GetObjectInlineCache::operator new(size_t size)
 {
     static bool typeInited = false;
@@ -313,8 +353,7 @@ void* SetObjectInlineCache::operator new(size_t size)
     static GC_descr descr;
     if (!typeInited) {
         GC_word obj_bitmap[GC_BITMAP_SIZE(SetObjectInlineCache)] = { 0 };
-        GC_set_bit(obj_bitmap, GC_WORD_OFFSET(SetObjectInlineCache, m_cachedHiddenClassChainData));
-        GC_set_bit(obj_bitmap, GC_WORD_OFFSET(SetObjectInlineCache, m_hiddenClassWillBe));
+        GC_set_bit(obj_bitmap, GC_WORD_OFFSET(SetObjectInlineCache, m_cache));
         descr = GC_make_descriptor(obj_bitmap, GC_WORD_LEN(SetObjectInlineCache));
         typeInited = true;
     }
@@ -28,6 +28,7 @@ namespace Escargot {
 class Node;
 class ObjectStructure;
 struct GlobalVariableAccessCacheItem;
+enum class TypedArrayType : unsigned;
 
 // <OpcodeName, PushCount, PopCount>
 #define FOR_EACH_BYTECODE_OP(F)                             \
@@ -153,7 +154,7 @@ struct OpcodeTable {
     OpcodeTable();
 
     void* m_addressTable[OpcodeKindEnd];
-#if defined(ENABLE_CODE_CACHE)
+#if defined(ENABLE_CODE_CACHE) || defined(ENABLE_JIT)
     std::unordered_map<void*, size_t, std::hash<void*>, std::equal_to<void*>, std::allocator<std::pair<void* const, size_t>>> m_opcodeMap;
 #endif
 };
@@ -825,6 +826,56 @@ public:
 #endif
 };
 
+struct KeyedObjectInlineCacheData {
+    // String or Symbol used as a computed key
+    PointerValue* m_cachedKey;
+    ObjectStructure* m_cachedHiddenClass;
+    size_t m_cachedIndex;
+};
+
+// inline cache of GetObject and SetObjectOperation
+// caches own properties of object accessed by string or symbol keys,
+// and the class of TypedArray accessed by index
+struct KeyedObjectInlineCache {
+    KeyedObjectInlineCache()
+        : m_typedArrayTag(0)
+        , m_nextFillIndex(0)
+    {
+        memset(m_cache, 0, sizeof(m_cache));
+    }
+
+    Optional<KeyedObjectInlineCacheData*> find(PointerValue* key, ObjectStructure* structure)
+    {
+        for (size_t i = 0; i < KEYED_INLINE_CACHE_SIZE; i++) {
+            if (m_cache[i].m_cachedKey == key && m_cache[i].m_cachedHiddenClass == structure) {
+                return &m_cache[i];
+            }
+        }
+        return nullptr;
+    }
+
+    void add(PointerValue* key, ObjectStructure* structure, size_t index)
+    {
+        // replace the oldest entry
+        KeyedObjectInlineCacheData& data = m_cache[m_nextFillIndex];
+        data.m_cachedKey = key;
+        data.m_cachedHiddenClass = structure;
+        data.m_cachedIndex = index;
+        m_nextFillIndex = (m_nextFillIndex + 1) & (KEYED_INLINE_CACHE_SIZE - 1);
+    }
+
+    void* operator new(size_t size);
+    void* operator new[](size_t size) = delete;
+
+    // virtual table address of TypedArray class. see PointerValue::getTag
+    size_t m_typedArrayTag;
+    TypedArrayType m_typedArrayType;
+    uint32_t m_nextFillIndex;
+    KeyedObjectInlineCacheData m_cache[KEYED_INLINE_CACHE_SIZE];
+};
+
+COMPILE_ASSERT((KEYED_INLINE_CACHE_SIZE & (KEYED_INLINE_CACHE_SIZE - 1)) == 0, "");
+
 class GetObject : public ByteCode {
 public:
     GetObject(const ByteCodeLOC& loc, const size_t objectRegisterIndex, const size_t propertyRegisterIndex, const size_t storeRegisterIndex)
@@ -832,12 +883,16 @@ public:
         , m_objectRegisterIndex(objectRegisterIndex)
         , m_propertyRegisterIndex(propertyRegisterIndex)
         , m_storeRegisterIndex(storeRegisterIndex)
+        , m_cacheMissCount(0)
+        , m_inlineCache(nullptr)
     {
     }
 
     ByteCodeRegisterIndex m_objectRegisterIndex;
     ByteCodeRegisterIndex m_propertyRegisterIndex;
     ByteCodeRegisterIndex m_storeRegisterIndex;
+    uint16_t m_cacheMissCount;
+    KeyedObjectInlineCache* m_inlineCache;
 
 #ifndef NDEBUG
     void dump(const char* byteCodeStart)
@@ -854,12 +909,16 @@ public:
         , m_objectRegisterIndex(objectRegisterIndex)
         , m_propertyRegisterIndex(propertyRegisterIndex)
         , m_loadRegisterIndex(loadRegisterIndex)
+        , m_cacheMissCount(0)
+        , m_inlineCache(nullptr)
     {
     }
 
     ByteCodeRegisterIndex m_objectRegisterIndex;
     ByteCodeRegisterIndex m_propertyRegisterIndex;
     ByteCodeRegisterIndex m_loadRegisterIndex;
+    uint16_t m_cacheMissCount;
+    KeyedObjectInlineCache* m_inlineCache;
 
 #ifndef NDEBUG
     void dump(const char* byteCodeStart)
@@ -983,6 +1042,16 @@ public:
 #endif
 };
 
+// inline cache of GetObjectPreComputedCase and SetObjectPreComputedCase only moves forward
+// Uninitialized -> Monomorphic -> Polymorphic (up to POLYMORPHIC_INLINE_CACHE_SIZE_MAX structures) -> Megamorphic
+// Megamorphic sites give up their own cache and use VM-wide MegamorphicInlineCache
+enum class InlineCacheState : uint8_t {
+    Uninitialized,
+    Monomorphic,
+    Polymorphic,
+    Megamorphic,
+};
+
 struct GetObjectInlineCacheData {
     GetObjectInlineCacheData()
     {
@@ -1019,6 +1088,7 @@ public:
         : ByteCode(Opcode::GetObjectPreComputedCaseOpcode, loc)
         , m_isLength(propertyName.plainString()->equals("length"))
         , m_cacheMissCount(0)
+        , m_inlineCacheState(InlineCacheState::Uninitialized)
         , m_inlineCache(nullptr)
         , m_objectRegisterIndex(objectRegisterIndex)
         , m_storeRegisterIndex(storeRegisterIndex)
@@ -1028,6 +1098,7 @@ public:
 
     bool m_isLength : 1;
     uint16_t m_cacheMissCount : 16;
+    InlineCacheState m_inlineCacheState;
     GetObjectInlineCache* m_inlineCache;
 
     ByteCodeRegisterIndex m_objectRegisterIndex;
@@ -1041,7 +1112,13 @@ public:
 #endif
 };
 
-struct SetObjectInlineCache {
+struct SetObjectInlineCacheData {
+    SetObjectInlineCacheData()
+    {
+        m_cachedHiddenClass = m_hiddenClassWillBe = nullptr;
+        m_cachedhiddenClassChainLength = 0;
+    }
+
     union {
         ObjectStructure** m_cachedHiddenClassChainData;
         ObjectStructure* m_cachedHiddenClass;
@@ -1051,21 +1128,19 @@ struct SetObjectInlineCache {
         size_t m_cachedIndex;
         ObjectStructure* m_hiddenClassWillBe;
     };
+};
 
-    SetObjectInlineCache()
-    {
-        m_cachedHiddenClass = m_hiddenClassWillBe = nullptr;
-        m_cachedhiddenClassChainLength = 0;
-    }
+typedef Vector<SetObjectInlineCacheData, GCUtil::gc_malloc_allocator<SetObjectInlineCacheData>, ComputeReservedCapacityFunctionWithLog2<>> SetObjectInlineCacheDataVector;
 
-    void invalidateCache()
+struct SetObjectInlineCache {
+    SetObjectInlineCache()
     {
-        m_cachedHiddenClass = m_hiddenClassWillBe = nullptr;
-        m_cachedhiddenClassChainLength = 0;
     }
 
     void* operator new(size_t size);
     void* operator new[](size_t size) = delete;
+
+    SetObjectInlineCacheDataVector m_cache;
 };
 
 class SetObjectPreComputedCase : public ByteCode {
@@ -1078,6 +1153,7 @@ public:
         , m_inlineCache(nullptr)
         , m_isLength(propertyName.plainString()->equals("length"))
         , m_missCount(0)
+        , m_inlineCacheState(InlineCacheState::Uninitialized)
     {
     }
 
@@ -1087,6 +1163,7 @@ public:
     SetObjectInlineCache* m_inlineCache;
     bool m_isLength : 1;
     uint16_t m_missCount : 16;
+    InlineCacheState m_inlineCacheState;
 #ifndef NDEBUG
     void dump(const char* byteCodeStart)
     {
@@ -2615,6 +2692,10 @@ typedef Vector<void*, GCUtil::gc_malloc_allocator<void*>> ByteCodeOtherLiteralDa
 typedef std::vector<std::pair<size_t, size_t>, std::allocator<std::pair<size_t, size_t>>> ByteCodeLOCData;
 typedef std::unordered_map<ByteCodeBlock*, ByteCodeLOCData*, std::hash<void*>, std::equal_to<void*>, std::allocator<std::pair<ByteCodeBlock* const, ByteCodeLOCData*>>> ByteCodeLOCDataMap;
 
+#if defined(ENABLE_JIT)
+class JITCode;
+#endif
+
 class ByteCodeBlock : public gc {
 public:
     explicit ByteCodeBlock();
@@ -2725,8 +2806,20 @@ public:
 
     bool m_shouldClearStack : 1;
     bool m_isOwnerMayFreed : 1;
+    // set on function entry and collected into m_lastExecutedEpoch on every GC
+    bool m_isExecutedSinceLastGC : 1;
+#if defined(ENABLE_JIT)
+    bool m_jitDisabled : 1;
+#endif
     ByteCodeRegisterIndex m_requiredRegisterFileSizeInValueSize : REGISTER_INDEX_IN_BIT;
     size_t m_inlineCacheDataSize;
+    // GC epoch(VMInstance::compiledByteCodeEpoch) when this block was executed lastly
+    size_t m_lastExecutedEpoch;
+#if defined(ENABLE_JIT)
+    // counts function entries and backward jumps until JIT_HOTNESS_THRESHOLD
+    size_t m_jitHotness;
+    JITCode* m_jitCode;
+#endif
 
     ByteCodeBlockData m_code;
     ByteCodeNumeralLiteralData m_numeralLiteralData;
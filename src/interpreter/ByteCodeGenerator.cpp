@@ -20,6 +20,7 @@
 #include "Escargot.h"
 #include "ByteCodeGenerator.h"
 #include "interpreter/ByteCode.h"
+#include "interpreter/ByteCodeOptimizer.h"
 #include "parser/ast/AST.h"
 #include "parser/CodeBlock.h"
 #include "debugger/Debugger.h"
@@ -221,6 +222,10 @@ ByteCodeBlock* ByteCodeGenerator::generateByteCode(Context* context, Interpreted
         memcpy(block->m_numeralLiteralData.data(), nData->data(), sizeof(Value) * nData->size());
     }
 
+    // optimize before caching so that cached bytecode is also optimized
+    ByteCodeOptimizer optimizer(block, block->m_numeralLiteralData.data(), block->m_numeralLiteralData.size());
+    optimizer.optimize(nullptr, context->vmInstance()->byteCodeOptimizerStatistics(), context->vmInstance()->enabledByteCodeOptimizationPasses());
+
     if (block->m_code.capacity() - block->m_code.size() > 1024 * 4) {
         block->m_code.shrinkToFit();
     }
@@ -228,8 +233,12 @@ ByteCodeBlock* ByteCodeGenerator::generateByteCode(Context* context, Interpreted
 #if defined(ENABLE_CODE_CACHE)
     // cache bytecode right before relocation
     if (UNLIKELY(cacheByteCode)) {
-        context->vmInstance()->codeCache()->storeByteCodeBlock(block);
-        context->vmInstance()->codeCache()->storeStringTable();
+        if (codeBlock->isGlobalCodeBlock()) {
+            context->vmInstance()->codeCache()->storeByteCodeBlock(block);
+            context->vmInstance()->codeCache()->storeStringTable();
+        } else {
+            context->vmInstance()->codeCache()->storeFunctionByteCodeBlock(block);
+        }
     }
 #endif
 
@@ -305,6 +314,15 @@ void ByteCodeGenerator::collectByteCodeLOCData(Context* context, InterpretedCode
         ast->generateStatementByteCode(&block, &ctx);
     }
 
+    // apply the same optimization with generateByteCode to get the same code positions
+    {
+        ByteCodeOptimizerStatistics statistics;
+        const Value* numeralLiteralData = ctx.m_keepNumberalLiteralsInRegisterFile ? nData->data() : nullptr;
+        size_t numeralLiteralCount = ctx.m_keepNumberalLiteralsInRegisterFile ? nData->size() : 0;
+        ByteCodeOptimizer optimizer(&block, numeralLiteralData, numeralLiteralCount);
+        optimizer.optimize(locData, statistics, context->vmInstance()->enabledByteCodeOptimizationPasses());
+    }
+
     // reset ASTAllocator
     context->astAllocator().reset();
     GC_enable();
@@ -32,6 +32,8 @@
 #include "runtime/EnumerateObject.h"
 #include "runtime/ErrorObject.h"
 #include "runtime/ArrayObject.h"
+#include "runtime/TypedArrayObject.h"
+#include "runtime/TypedArrayInlines.h"
 #include "runtime/VMInstance.h"
 #include "runtime/IteratorObject.h"
 #include "runtime/GeneratorObject.h"
@@ -46,12 +48,26 @@
 #include "runtime/ScriptAsyncFunctionObject.h"
 #include "runtime/ScriptAsyncGeneratorFunctionObject.h"
 #include "parser/ScriptParser.h"
+#include "jit/JITCompiler.h"
 #include "CheckedArithmetic.h"
 
 namespace Escargot {
 
 #define ADD_PROGRAM_COUNTER(CodeType) programCounter += sizeof(CodeType);
 
+#if defined(ENABLE_JIT)
+// entering a function and every backward jump make the ByteCodeBlock hotter
+// the counter stops at the threshold, and blocks which cannot be compiled are not counted
+#define TIER_UP_IF_NEEDED()                                                       \
+    if (LIKELY(!byteCodeBlock->m_jitDisabled)                                     \
+        && UNLIKELY(byteCodeBlock->m_jitHotness >= JIT_HOTNESS_THRESHOLD          \
+                    || ++byteCodeBlock->m_jitHotness >= JIT_HOTNESS_THRESHOLD)) { \
+        JITCompiler::tierUp(state, byteCodeBlock, programCounter, registerFile);  \
+    }
+#else
+#define TIER_UP_IF_NEEDED()
+#endif
+
 ALWAYS_INLINE size_t jumpTo(char* codeBuffer, const size_t jumpPosition)
 {
     return (size_t)&codeBuffer[jumpPosition];
@@ -81,6 +97,59 @@ private:
     size_t* m_oldAddress;
 };
 
+// defined before interpret so that the compiler can inline them into the interpreter loop
+ALWAYS_INLINE Value ByteCodeInterpreter::getGlobalVariableOperation(ExecutionState& state, GlobalVariableAccessCacheItem* slot, ByteCodeBlock* block)
+{
+    Context* ctx = state.context();
+    GlobalObject* globalObject = ctx->globalObject();
+    auto idx = slot->m_lexicalIndexCache;
+
+    if (LIKELY(idx != std::numeric_limits<size_t>::max())) {
+        if (LIKELY(ctx->globalDeclarativeStorage()->size() == slot->m_lexicalIndexCache && globalObject->structure() == slot->m_cachedStructure)) {
+            ASSERT(globalObject->m_values.data() <= slot->m_cachedAddress);
+            ASSERT(slot->m_cachedAddress < (globalObject->m_values.data() + globalObject->structure()->propertyCount()));
+            return *((ObjectPropertyValue*)slot->m_cachedAddress);
+        } else if (slot->m_cachedStructure == nullptr) {
+            const EncodedValueVectorElement& val = ctx->globalDeclarativeStorage()->at(idx);
+            if (UNLIKELY(val.isEmpty())) {
+                ErrorObject::throwBuiltinError(state, ErrorObject::ReferenceError, ctx->globalDeclarativeRecord()->at(idx).m_name.string(), false, String::emptyString, ErrorObject::Messages::IsNotInitialized);
+            }
+            return val;
+        }
+    }
+
+    return getGlobalVariableSlowCase(state, globalObject, slot, block);
+}
+
+ALWAYS_INLINE void ByteCodeInterpreter::setGlobalVariableOperation(ExecutionState& state, GlobalVariableAccessCacheItem* slot, const Value& value, ByteCodeBlock* block)
+{
+    Context* ctx = state.context();
+    GlobalObject* globalObject = ctx->globalObject();
+    auto idx = slot->m_lexicalIndexCache;
+
+    if (LIKELY(idx != std::numeric_limits<size_t>::max())) {
+        if (LIKELY(ctx->globalDeclarativeStorage()->size() == slot->m_lexicalIndexCache && globalObject->structure() == slot->m_cachedStructure)) {
+            ASSERT(globalObject->m_values.data() <= slot->m_cachedAddress);
+            ASSERT(slot->m_cachedAddress < (globalObject->m_values.data() + globalObject->structure()->propertyCount()));
+            *((ObjectPropertyValue*)slot->m_cachedAddress) = value;
+            return;
+        } else if (slot->m_cachedStructure == nullptr) {
+            const auto& record = ctx->globalDeclarativeRecord()->at(idx);
+            auto& storage = ctx->globalDeclarativeStorage()->at(idx);
+            if (UNLIKELY(storage.isEmpty())) {
+                ErrorObject::throwBuiltinError(state, ErrorObject::ReferenceError, record.m_name.string(), false, String::emptyString, ErrorObject::Messages::IsNotInitialized);
+            }
+            if (UNLIKELY(!record.m_isMutable)) {
+                ErrorObject::throwBuiltinError(state, ErrorObject::TypeError, record.m_name.string(), false, String::emptyString, ErrorObject::Messages::AssignmentToConstantVariable);
+            }
+            storage = value;
+            return;
+        }
+    }
+
+    setGlobalVariableSlowCase(state, globalObject, slot, value, block);
+}
+
 Value ByteCodeInterpreter::interpret(ExecutionState* state, ByteCodeBlock* byteCodeBlock, size_t programCounter, Value* registerFile)
 {
 #if defined(COMPILER_GCC) || defined(COMPILER_CLANG)
@@ -96,6 +165,7 @@ Value ByteCodeInterpreter::interpret(ExecutionState* state, ByteCodeBlock* byteC
         ExecutionStateProgramCounterBinder binder(*state, &programCounter);
         char* codeBuffer = byteCodeBlock->m_code.data();
         programCounter = (size_t)(codeBuffer + programCounter);
+        TIER_UP_IF_NEEDED();
 
 #if defined(COMPILER_GCC) || defined(COMPILER_CLANG)
 #define DEFINE_OPCODE(codeName) codeName##OpcodeLbl
@@ -152,30 +222,7 @@ Value ByteCodeInterpreter::interpret(ExecutionState* state, ByteCodeBlock* byteC
         {
             GetGlobalVariable* code = (GetGlobalVariable*)programCounter;
             ASSERT(byteCodeBlock->m_codeBlock->context() == state->context());
-            Context* ctx = state->context();
-            GlobalObject* globalObject = ctx->globalObject();
-            auto slot = code->m_slot;
-            auto idx = slot->m_lexicalIndexCache;
-            bool isCacheWork = false;
-
-            if (LIKELY(idx != std::numeric_limits<size_t>::max())) {
-                if (LIKELY(ctx->globalDeclarativeStorage()->size() == slot->m_lexicalIndexCache && globalObject->structure() == slot->m_cachedStructure)) {
-                    ASSERT(globalObject->m_values.data() <= slot->m_cachedAddress);
-                    ASSERT(slot->m_cachedAddress < (globalObject->m_values.data() + globalObject->structure()->propertyCount()));
-                    registerFile[code->m_registerIndex] = *((ObjectPropertyValue*)slot->m_cachedAddress);
-                    isCacheWork = true;
-                } else if (slot->m_cachedStructure == nullptr) {
-                    const EncodedValueVectorElement& val = ctx->globalDeclarativeStorage()->at(idx);
-                    isCacheWork = true;
-                    if (UNLIKELY(val.isEmpty())) {
-                        ErrorObject::throwBuiltinError(*state, ErrorObject::ReferenceError, ctx->globalDeclarativeRecord()->at(idx).m_name.string(), false, String::emptyString, ErrorObject::Messages::IsNotInitialized);
-                    }
-                    registerFile[code->m_registerIndex] = val;
-                }
-            }
-            if (UNLIKELY(!isCacheWork)) {
-                registerFile[code->m_registerIndex] = getGlobalVariableSlowCase(*state, globalObject, slot, byteCodeBlock);
-            }
+            registerFile[code->m_registerIndex] = getGlobalVariableOperation(*state, code->m_slot, byteCodeBlock);
             ADD_PROGRAM_COUNTER(GetGlobalVariable);
             NEXT_INSTRUCTION();
         }
@@ -185,36 +232,7 @@ Value ByteCodeInterpreter::interpret(ExecutionState* state, ByteCodeBlock* byteC
         {
             SetGlobalVariable* code = (SetGlobalVariable*)programCounter;
             ASSERT(byteCodeBlock->m_codeBlock->context() == state->context());
-            Context* ctx = state->context();
-            GlobalObject* globalObject = ctx->globalObject();
-            auto slot = code->m_slot;
-            auto idx = slot->m_lexicalIndexCache;
-
-            bool isCacheWork = false;
-            if (LIKELY(idx != std::numeric_limits<size_t>::max())) {
-                if (LIKELY(ctx->globalDeclarativeStorage()->size() == slot->m_lexicalIndexCache && globalObject->structure() == slot->m_cachedStructure)) {
-                    ASSERT(globalObject->m_values.data() <= slot->m_cachedAddress);
-                    ASSERT(slot->m_cachedAddress < (globalObject->m_values.data() + globalObject->structure()->propertyCount()));
-                    *((ObjectPropertyValue*)slot->m_cachedAddress) = registerFile[code->m_registerIndex];
-                    isCacheWork = true;
-                } else if (slot->m_cachedStructure == nullptr) {
-                    isCacheWork = true;
-                    const auto& record = ctx->globalDeclarativeRecord()->at(idx);
-                    auto& storage = ctx->globalDeclarativeStorage()->at(idx);
-                    if (UNLIKELY(storage.isEmpty())) {
-                        ErrorObject::throwBuiltinError(*state, ErrorObject::ReferenceError, record.m_name.string(), false, String::emptyString, ErrorObject::Messages::IsNotInitialized);
-                    }
-                    if (UNLIKELY(!record.m_isMutable)) {
-                        ErrorObject::throwBuiltinError(*state, ErrorObject::TypeError, record.m_name.string(), false, String::emptyString, ErrorObject::Messages::AssignmentToConstantVariable);
-                    }
-                    storage = registerFile[code->m_registerIndex];
-                }
-            }
-
-            if (UNLIKELY(!isCacheWork)) {
-                setGlobalVariableSlowCase(*state, globalObject, slot, registerFile[code->m_registerIndex], byteCodeBlock);
-            }
-
+            setGlobalVariableOperation(*state, code->m_slot, registerFile[code->m_registerIndex], byteCodeBlock);
             ADD_PROGRAM_COUNTER(SetGlobalVariable);
             NEXT_INSTRUCTION();
         }
@@ -467,7 +485,7 @@ Value ByteCodeInterpreter::interpret(ExecutionState* state, ByteCodeBlock* byteC
                 if (LIKELY(arr->isFastModeArray())) {
                     uint32_t idx = property.tryToUseAsArrayIndex(*state);
                     if (LIKELY(idx != Value::InvalidArrayIndexValue) && LIKELY(idx < arr->arrayLength(*state))) {
-                        const Value& v = arr->m_fastModeData[idx];
+                        Value v = arr->getFastModeValue(idx);
                         if (LIKELY(!v.isEmpty())) {
                             registerFile[code->m_storeRegisterIndex] = v;
                             ADD_PROGRAM_COUNTER(GetObject);
@@ -475,6 +493,15 @@ Value ByteCodeInterpreter::interpret(ExecutionState* state, ByteCodeBlock* byteC
                         }
                     }
                 }
+            } else if (code->m_inlineCache && willBeObject.isObject() && v->getTag() == code->m_inlineCache->m_typedArrayTag && property.isUInt32()) {
+                TypedArrayObject* arr = (TypedArrayObject*)v;
+                uint32_t idx = property.asUInt32();
+                if (LIKELY(idx < arr->arrayLength() && !arr->buffer()->isDetachedBuffer())) {
+                    TypedArrayType type = code->m_inlineCache->m_typedArrayType;
+                    registerFile[code->m_storeRegisterIndex] = TypedArrayHelper::rawBytesToNumber(*state, type, arr->rawBuffer() + idx * TypedArrayHelper::elementSize(type));
+                    ADD_PROGRAM_COUNTER(GetObject);
+                    NEXT_INSTRUCTION();
+                }
             }
             JUMP_INSTRUCTION(GetObjectOpcodeSlowCase);
         }
@@ -499,11 +526,22 @@ Value ByteCodeInterpreter::interpret(ExecutionState* state, ByteCodeBlock* byteC
                                 JUMP_INSTRUCTION(SetObjectOpcodeSlowCase);
                             }
                         }
-                        arr->m_fastModeData[idx] = registerFile[code->m_loadRegisterIndex];
+                        arr->setFastModeValue(idx, registerFile[code->m_loadRegisterIndex]);
                         ADD_PROGRAM_COUNTER(SetObjectOperation);
                         NEXT_INSTRUCTION();
                     }
                 }
+            } else if (code->m_inlineCache && willBeObject.isObject() && willBeObject.asPointerValue()->getTag() == code->m_inlineCache->m_typedArrayTag
+                       && property.isUInt32() && registerFile[code->m_loadRegisterIndex].isNumber()) {
+                // converting number value into element type has no side effect
+                TypedArrayObject* arr = willBeObject.asPointerValue()->asTypedArrayObject();
+                uint32_t idx = property.asUInt32();
+                if (LIKELY(idx < arr->arrayLength() && !arr->buffer()->isDetachedBuffer())) {
+                    TypedArrayType type = code->m_inlineCache->m_typedArrayType;
+                    TypedArrayHelper::numberToRawBytes(*state, type, registerFile[code->m_loadRegisterIndex], arr->rawBuffer() + idx * TypedArrayHelper::elementSize(type));
+                    ADD_PROGRAM_COUNTER(SetObjectOperation);
+                    NEXT_INSTRUCTION();
+                }
             }
             JUMP_INSTRUCTION(SetObjectOpcodeSlowCase);
         }
@@ -539,6 +577,9 @@ Value ByteCodeInterpreter::interpret(ExecutionState* state, ByteCodeBlock* byteC
             Jump* code = (Jump*)programCounter;
             ASSERT(code->m_jumpPosition != SIZE_MAX);
             programCounter = code->m_jumpPosition;
+            if (programCounter < (size_t)code) {
+                TIER_UP_IF_NEEDED();
+            }
             NEXT_INSTRUCTION();
         }
 
@@ -584,6 +625,9 @@ Value ByteCodeInterpreter::interpret(ExecutionState* state, ByteCodeBlock* byteC
             ASSERT(code->m_jumpPosition != SIZE_MAX);
             if (registerFile[code->m_registerIndex].toBoolean(*state)) {
                 programCounter = code->m_jumpPosition;
+                if (programCounter < (size_t)code) {
+                    TIER_UP_IF_NEEDED();
+                }
             } else {
                 ADD_PROGRAM_COUNTER(JumpIfTrue);
             }
@@ -952,7 +996,7 @@ Value ByteCodeInterpreter::interpret(ExecutionState* state, ByteCodeBlock* byteC
             :
         {
             GetObject* code = (GetObject*)programCounter;
-            getObjectOpcodeSlowCase(*state, code, registerFile);
+            getObjectOpcodeSlowCase(*state, code, registerFile, byteCodeBlock);
             ADD_PROGRAM_COUNTER(GetObject);
             NEXT_INSTRUCTION();
         }
@@ -961,7 +1005,7 @@ Value ByteCodeInterpreter::interpret(ExecutionState* state, ByteCodeBlock* byteC
             :
         {
             SetObjectOperation* code = (SetObjectOperation*)programCounter;
-            setObjectOpcodeSlowCase(*state, code, registerFile);
+            setObjectOpcodeSlowCase(*state, code, registerFile, byteCodeBlock);
             ADD_PROGRAM_COUNTER(SetObjectOperation);
             NEXT_INSTRUCTION();
         }
@@ -1411,7 +1455,7 @@ Value ByteCodeInterpreter::interpret(ExecutionState* state, ByteCodeBlock* byteC
 
 #if defined(COMPILER_GCC) || defined(COMPILER_CLANG)
 FillOpcodeTableLbl:
-#if defined(ENABLE_CODE_CACHE)
+#if defined(ENABLE_CODE_CACHE) || defined(ENABLE_JIT)
 #define REGISTER_TABLE(opcode, pushCount, popCount)                     \
     g_opcodeTable.m_addressTable[opcode##Opcode] = &&opcode##OpcodeLbl; \
     g_opcodeTable.m_opcodeMap.insert(std::make_pair(&&opcode##OpcodeLbl, (size_t)opcode##Opcode));
@@ -2091,30 +2135,24 @@ NEVER_INLINE Value ByteCodeInterpreter::getObjectPrecomputedCaseOperationCacheMi
     return obj->get(state, ObjectPropertyName(state, code->m_propertyName)).value(state, receiver);
 #endif
 
-    const int maxCacheMissCount = 16;
-    const int minCacheFillCount = 3;
-    const size_t maxCacheCount = 6;
-
-    // cache miss.
-    if (code->m_cacheMissCount > maxCacheMissCount) {
-        return obj->get(state, ObjectPropertyName(state, code->m_propertyName)).value(state, receiver);
+    if (code->m_inlineCacheState == InlineCacheState::Megamorphic) {
+        return getObjectPrecomputedCaseOperationMegamorphic(state, obj, receiver, code);
     }
 
-    code->m_cacheMissCount++;
-    if (code->m_cacheMissCount <= minCacheFillCount) {
-        return obj->get(state, ObjectPropertyName(state, code->m_propertyName)).value(state, receiver);
-    }
+    const int minCacheFillCount = 3;
 
-    if (UNLIKELY(!obj->isInlineCacheable())) {
-        code->m_cacheMissCount = maxCacheMissCount + 1;
+    // cache miss.
+    if (code->m_cacheMissCount < minCacheFillCount) {
+        code->m_cacheMissCount++;
         return obj->get(state, ObjectPropertyName(state, code->m_propertyName)).value(state, receiver);
     }
 
-    if (UNLIKELY(code->m_cacheMissCount == maxCacheMissCount)) {
+    if (UNLIKELY(!obj->isInlineCacheable() || (code->m_inlineCache && code->m_inlineCache->m_cache.size() >= POLYMORPHIC_INLINE_CACHE_SIZE_MAX))) {
         if (code->m_inlineCache) {
             code->m_inlineCache->m_cache.clear();
         }
-        return obj->get(state, ObjectPropertyName(state, code->m_propertyName)).value(state, receiver);
+        code->m_inlineCacheState = InlineCacheState::Megamorphic;
+        return getObjectPrecomputedCaseOperationMegamorphic(state, obj, receiver, code);
     }
 
     auto& currentCodeSizeTotal = state.context()->vmInstance()->compiledByteCodeSize();
@@ -2128,16 +2166,8 @@ NEVER_INLINE Value ByteCodeInterpreter::getObjectPrecomputedCaseOperationCacheMi
 
     auto inlineCache = code->m_inlineCache;
 
-    if (inlineCache->m_cache.size() > maxCacheCount) {
-        return obj->get(state, ObjectPropertyName(state, code->m_propertyName)).value(state, receiver);
-    }
-
     Object* orgObj = obj;
-    inlineCache->m_cache.insert(0, GetObjectInlineCacheData());
-    block->m_inlineCacheDataSize += sizeof(GetObjectInlineCacheData);
-    currentCodeSizeTotal += sizeof(GetObjectInlineCacheData);
-
-    auto& newItem = inlineCache->m_cache[0];
+    GetObjectInlineCacheData newItem;
     VectorWithInlineStorage<24, ObjectStructure*, std::allocator<ObjectStructure*>> cachedhiddenClassChain;
 
     while (true) {
@@ -2159,8 +2189,8 @@ NEVER_INLINE Value ByteCodeInterpreter::getObjectPrecomputedCaseOperationCacheMi
 
         if (UNLIKELY(!obj->isInlineCacheable())) {
             inlineCache->m_cache.clear();
-            code->m_cacheMissCount = maxCacheMissCount + 1;
-            return obj->get(state, ObjectPropertyName(state, code->m_propertyName)).value(state, receiver);
+            code->m_inlineCacheState = InlineCacheState::Megamorphic;
+            return getObjectPrecomputedCaseOperationMegamorphic(state, orgObj, receiver, code);
         }
     }
 
@@ -2174,6 +2204,11 @@ NEVER_INLINE Value ByteCodeInterpreter::getObjectPrecomputedCaseOperationCacheMi
         memcpy(newItem.m_cachedhiddenClassChain, cachedhiddenClassChain.data(), sizeof(ObjectStructure*) * cachedhiddenClassChain.size());
     }
 
+    inlineCache->m_cache.insert(0, newItem);
+    block->m_inlineCacheDataSize += sizeof(GetObjectInlineCacheData);
+    currentCodeSizeTotal += sizeof(GetObjectInlineCacheData);
+    code->m_inlineCacheState = inlineCache->m_cache.size() == 1 ? InlineCacheState::Monomorphic : InlineCacheState::Polymorphic;
+
     if (newItem.m_cachedIndex != SIZE_MAX) {
         return obj->getOwnPropertyUtilForObject(state, newItem.m_cachedIndex, receiver);
     } else {
@@ -2181,6 +2216,46 @@ NEVER_INLINE Value ByteCodeInterpreter::getObjectPrecomputedCaseOperationCacheMi
     }
 }
 
+NEVER_INLINE Value ByteCodeInterpreter::getObjectPrecomputedCaseOperationMegamorphic(ExecutionState& state, Object* obj, const Value& receiver, GetObjectPreComputedCase* code)
+{
+    if (UNLIKELY(!obj->isInlineCacheable())) {
+        return obj->get(state, ObjectPropertyName(state, code->m_propertyName)).value(state, receiver);
+    }
+
+    // megamorphic cache only holds properties of an object or its direct prototype object
+    // because ObjectStructure doesn't tell the prototype of object
+    MegamorphicInlineCache* megamorphicCache = state.context()->vmInstance()->megamorphicInlineCache();
+    ObjectStructure* structure = obj->structure();
+    MegamorphicInlineCacheEntry* entry = megamorphicCache->find(structure, code->m_propertyName);
+    if (LIKELY(entry != nullptr)) {
+        if (!entry->m_holderStructure) {
+            return obj->getOwnPropertyUtilForObject(state, entry->m_index, receiver);
+        }
+        Object* proto = obj->Object::getPrototypeObject(state);
+        if (LIKELY(proto && proto->structure() == entry->m_holderStructure)) {
+            return proto->getOwnPropertyUtilForObject(state, entry->m_index, receiver);
+        }
+    }
+
+    auto result = structure->findProperty(code->m_propertyName);
+    if (result.first != SIZE_MAX) {
+        const auto& desc = structure->readProperty(result.first).m_descriptor;
+        megamorphicCache->add(structure, code->m_propertyName, nullptr, result.first, desc.isPlainDataProperty() && desc.isWritable());
+        return obj->getOwnPropertyUtilForObject(state, result.first, receiver);
+    }
+
+    Object* proto = obj->Object::getPrototypeObject(state);
+    if (proto && proto->isInlineCacheable()) {
+        result = proto->structure()->findProperty(code->m_propertyName);
+        if (result.first != SIZE_MAX) {
+            megamorphicCache->add(structure, code->m_propertyName, proto->structure(), result.first, false);
+            return proto->getOwnPropertyUtilForObject(state, result.first, receiver);
+        }
+    }
+
+    return obj->get(state, ObjectPropertyName(state, code->m_propertyName)).value(state, receiver);
+}
+
 ALWAYS_INLINE void ByteCodeInterpreter::setObjectPreComputedCaseOperation(ExecutionState& state, const Value& willBeObject, const Value& value, SetObjectPreComputedCase* code, ByteCodeBlock* block)
 {
     Object* obj;
@@ -2200,33 +2275,39 @@ ALWAYS_INLINE void ByteCodeInterpreter::setObjectPreComputedCaseOperation(Execut
     auto inlineCache = code->m_inlineCache;
 
     if (inlineCache) {
-        if (inlineCache->m_cachedhiddenClassChainLength == 1 && inlineCache->m_cachedHiddenClass == testItem) {
-            // cache hit!
-            obj->m_values[inlineCache->m_cachedIndex] = value;
-            return;
-        } else if (inlineCache->m_hiddenClassWillBe) {
-            const auto& cSiz = inlineCache->m_cachedhiddenClassChainLength;
-            bool miss = false;
-            for (size_t i = 0; i < cSiz - 1; i++) {
-                if (UNLIKELY(inlineCache->m_cachedHiddenClassChainData[i] != obj->structure())) {
-                    miss = true;
-                    break;
-                } else {
-                    Object* o = obj->Object::getPrototypeObject(state);
-                    if (UNLIKELY(!o)) {
+        const size_t cacheFillCount = inlineCache->m_cache.size();
+        SetObjectInlineCacheData* cacheData = inlineCache->m_cache.data();
+        for (size_t currentCacheIndex = 0; currentCacheIndex < cacheFillCount; currentCacheIndex++) {
+            const SetObjectInlineCacheData& data = cacheData[currentCacheIndex];
+            if (data.m_cachedhiddenClassChainLength == 1 && data.m_cachedHiddenClass == testItem) {
+                // cache hit!
+                obj->m_values[data.m_cachedIndex] = value;
+                return;
+            } else if (data.m_hiddenClassWillBe) {
+                const auto& cSiz = data.m_cachedhiddenClassChainLength;
+                bool miss = false;
+                obj = originalObject;
+                for (size_t i = 0; i < cSiz - 1; i++) {
+                    if (UNLIKELY(data.m_cachedHiddenClassChainData[i] != obj->structure())) {
                         miss = true;
                         break;
+                    } else {
+                        Object* o = obj->Object::getPrototypeObject(state);
+                        if (UNLIKELY(!o)) {
+                            miss = true;
+                            break;
+                        }
+                        obj = o;
                     }
-                    obj = o;
                 }
-            }
-            if (LIKELY(!miss) && inlineCache->m_cachedHiddenClassChainData[cSiz - 1] == obj->structure()) {
-                // cache hit!
-                obj = originalObject;
-                ASSERT(obj->structure()->inTransitionMode());
-                obj->m_values.push_back(value, inlineCache->m_hiddenClassWillBe->propertyCount());
-                obj->m_structure = inlineCache->m_hiddenClassWillBe;
-                return;
+                if (LIKELY(!miss) && data.m_cachedHiddenClassChainData[cSiz - 1] == obj->structure()) {
+                    // cache hit!
+                    obj = originalObject;
+                    ASSERT(obj->structure()->inTransitionMode());
+                    obj->m_values.push_back(value, data.m_hiddenClassWillBe->propertyCount());
+                    obj->m_structure = data.m_hiddenClassWillBe;
+                    return;
+                }
             }
         }
     }
@@ -2249,24 +2330,29 @@ NEVER_INLINE void ByteCodeInterpreter::setObjectPreComputedCaseOperationCacheMis
     return;
 #endif
 
+    if (code->m_inlineCacheState == InlineCacheState::Megamorphic) {
+        setObjectPreComputedCaseOperationMegamorphic(state, originalObject, willBeObject, value, code);
+        return;
+    }
+
     const int maxCacheMissCount = 16;
     const int minCacheFillCount = 3;
 
     // cache miss
-    if (code->m_missCount > maxCacheMissCount) {
-        originalObject->setThrowsExceptionWhenStrictMode(state, ObjectPropertyName(state, code->m_propertyName), value, willBeObject);
-        return;
-    }
-
     if (code->m_missCount < minCacheFillCount) {
         code->m_missCount++;
         originalObject->setThrowsExceptionWhenStrictMode(state, ObjectPropertyName(state, code->m_propertyName), value, willBeObject);
         return;
     }
 
-    if (UNLIKELY(!originalObject->isInlineCacheable())) {
-        code->m_missCount++;
-        originalObject->setThrowsExceptionWhenStrictMode(state, ObjectPropertyName(state, code->m_propertyName), value, willBeObject);
+    // give up the cache of this site if there are too many structures or the cache cannot be filled repeatedly
+    if (UNLIKELY(!originalObject->isInlineCacheable() || code->m_missCount > maxCacheMissCount
+                 || (code->m_inlineCache && code->m_inlineCache->m_cache.size() >= POLYMORPHIC_INLINE_CACHE_SIZE_MAX))) {
+        if (code->m_inlineCache) {
+            code->m_inlineCache->m_cache.clear();
+        }
+        code->m_inlineCacheState = InlineCacheState::Megamorphic;
+        setObjectPreComputedCaseOperationMegamorphic(state, originalObject, willBeObject, value, code);
         return;
     }
 
@@ -2280,8 +2366,7 @@ NEVER_INLINE void ByteCodeInterpreter::setObjectPreComputedCaseOperationCacheMis
     }
 
     auto inlineCache = code->m_inlineCache;
-
-    inlineCache->invalidateCache();
+    SetObjectInlineCacheData newItem;
     code->m_missCount++;
 
     Object* obj = originalObject;
@@ -2302,14 +2387,15 @@ NEVER_INLINE void ByteCodeInterpreter::setObjectPreComputedCaseOperationCacheMis
         const auto& propertyData = obj->structure()->readProperty(findResult.first);
         const auto& desc = propertyData.m_descriptor;
         if (propertyData.m_propertyName == code->m_propertyName && desc.isPlainDataProperty() && desc.isWritable()) {
-            inlineCache->m_cachedIndex = findResult.first;
-            inlineCache->m_cachedhiddenClassChainLength = 1;
-            inlineCache->m_cachedHiddenClass = obj->structure();
+            newItem.m_cachedIndex = findResult.first;
+            newItem.m_cachedhiddenClassChainLength = 1;
+            newItem.m_cachedHiddenClass = obj->structure();
+        } else {
+            return;
         }
     } else {
         Object* orgObject = obj;
         if (UNLIKELY(!obj->structure()->inTransitionMode())) {
-            inlineCache->invalidateCache();
             orgObject->setThrowsExceptionWhenStrictMode(state, ObjectPropertyName(state, code->m_propertyName), value, willBeObject);
             return;
         }
@@ -2321,7 +2407,6 @@ NEVER_INLINE void ByteCodeInterpreter::setObjectPreComputedCaseOperationCacheMis
             obj = proto.asObject();
 
             if (!UNLIKELY(obj->isInlineCacheable())) {
-                code->m_missCount++;
                 originalObject->setThrowsExceptionWhenStrictMode(state, ObjectPropertyName(state, code->m_propertyName), value, willBeObject);
                 return;
             }
@@ -2330,35 +2415,61 @@ NEVER_INLINE void ByteCodeInterpreter::setObjectPreComputedCaseOperationCacheMis
             proto = obj->getPrototype(state);
         }
 
-        inlineCache->m_hiddenClassWillBe = nullptr;
-        inlineCache->m_cachedhiddenClassChainLength = cachedhiddenClassChain.size();
-        inlineCache->m_cachedHiddenClassChainData = (ObjectStructure**)GC_MALLOC(sizeof(ObjectStructure*) * inlineCache->m_cachedhiddenClassChainLength);
-        memcpy(inlineCache->m_cachedHiddenClassChainData, cachedhiddenClassChain.data(), sizeof(ObjectStructure*) * inlineCache->m_cachedhiddenClassChainLength);
-
-        block->m_inlineCacheDataSize += sizeof(size_t) * inlineCache->m_cachedhiddenClassChainLength;
-        currentCodeSizeTotal += sizeof(size_t) * inlineCache->m_cachedhiddenClassChainLength;
         bool s = orgObject->set(state, ObjectPropertyName(state, code->m_propertyName), value, willBeObject);
         if (UNLIKELY(!s)) {
             if (state.inStrictMode()) {
                 orgObject->throwCannotWriteError(state, code->m_propertyName);
             }
-
-            inlineCache->invalidateCache();
             return;
         }
         if (!orgObject->structure()->inTransitionMode()) {
-            inlineCache->invalidateCache();
             return;
         }
 
         auto result = orgObject->get(state, ObjectPropertyName(state, code->m_propertyName));
         if (!result.hasValue() || !result.isDataProperty()) {
-            inlineCache->invalidateCache();
             return;
         }
 
-        inlineCache->m_hiddenClassWillBe = orgObject->structure();
+        newItem.m_cachedhiddenClassChainLength = cachedhiddenClassChain.size();
+        newItem.m_cachedHiddenClassChainData = (ObjectStructure**)GC_MALLOC(sizeof(ObjectStructure*) * newItem.m_cachedhiddenClassChainLength);
+        memcpy(newItem.m_cachedHiddenClassChainData, cachedhiddenClassChain.data(), sizeof(ObjectStructure*) * newItem.m_cachedhiddenClassChainLength);
+        newItem.m_hiddenClassWillBe = orgObject->structure();
+
+        block->m_inlineCacheDataSize += sizeof(size_t) * newItem.m_cachedhiddenClassChainLength;
+        currentCodeSizeTotal += sizeof(size_t) * newItem.m_cachedhiddenClassChainLength;
+    }
+
+    inlineCache->m_cache.insert(0, newItem);
+    block->m_inlineCacheDataSize += sizeof(SetObjectInlineCacheData);
+    currentCodeSizeTotal += sizeof(SetObjectInlineCacheData);
+    code->m_inlineCacheState = inlineCache->m_cache.size() == 1 ? InlineCacheState::Monomorphic : InlineCacheState::Polymorphic;
+}
+
+NEVER_INLINE void ByteCodeInterpreter::setObjectPreComputedCaseOperationMegamorphic(ExecutionState& state, Object* obj, const Value& willBeObject, const Value& value, SetObjectPreComputedCase* code)
+{
+    // megamorphic cache is used only for replacing writable data property
+    if (LIKELY(obj->isInlineCacheable())) {
+        MegamorphicInlineCache* megamorphicCache = state.context()->vmInstance()->megamorphicInlineCache();
+        ObjectStructure* structure = obj->structure();
+        MegamorphicInlineCacheEntry* entry = megamorphicCache->find(structure, code->m_propertyName);
+        if (LIKELY(entry != nullptr && !entry->m_holderStructure && entry->m_isWritableDataProperty)) {
+            obj->m_values[entry->m_index] = value;
+            return;
+        }
+
+        auto findResult = structure->findProperty(code->m_propertyName);
+        if (findResult.first != SIZE_MAX) {
+            const auto& desc = structure->readProperty(findResult.first).m_descriptor;
+            if (desc.isPlainDataProperty() && desc.isWritable()) {
+                megamorphicCache->add(structure, code->m_propertyName, nullptr, findResult.first, true);
+                obj->m_values[findResult.first] = value;
+                return;
+            }
+        }
     }
+
+    obj->setThrowsExceptionWhenStrictMode(state, ObjectPropertyName(state, code->m_propertyName), value, willBeObject);
 }
 
 ALWAYS_INLINE Object* ByteCodeInterpreter::fastToObject(ExecutionState& state, const Value& obj)
@@ -3389,7 +3500,7 @@ NEVER_INLINE void ByteCodeInterpreter::spreadFunctionArguments(ExecutionState& s
             ArrayObject* spreadArray = arg.asObject()->asArrayObject();
             ASSERT(spreadArray->isFastModeArray());
             for (size_t i = 0; i < spreadArray->arrayLength(state); i++) {
-                argVector.push_back(spreadArray->m_fastModeData[i]);
+                argVector.push_back(spreadArray->getFastModeValue(i));
             }
         } else {
             argVector.push_back(arg);
@@ -3606,7 +3717,7 @@ NEVER_INLINE void ByteCodeInterpreter::arrayDefineOwnPropertyOperation(Execution
     if (LIKELY(arr->isFastModeArray())) {
         for (size_t i = 0; i < code->m_count; i++) {
             if (LIKELY(code->m_loadRegisterIndexs[i] != REGISTER_LIMIT)) {
-                arr->m_fastModeData[i + code->m_baseIndex] = registerFile[code->m_loadRegisterIndexs[i]];
+                arr->setFastModeValue(i + code->m_baseIndex, registerFile[code->m_loadRegisterIndexs[i]]);
             }
         }
     } else {
@@ -3647,11 +3758,11 @@ NEVER_INLINE void ByteCodeInterpreter::arrayDefineOwnPropertyBySpreadElementOper
                     ArrayObject* spreadArray = element.asObject()->asArrayObject();
                     ASSERT(spreadArray->isFastModeArray());
                     for (size_t spreadIndex = 0; spreadIndex < spreadArray->arrayLength(state); spreadIndex++) {
-                        arr->m_fastModeData[baseIndex + elementIndex] = spreadArray->m_fastModeData[spreadIndex];
+                        arr->setFastModeValue(baseIndex + elementIndex, spreadArray->getFastModeValue(spreadIndex));
                         elementIndex++;
                     }
                 } else {
-                    arr->m_fastModeData[baseIndex + elementIndex] = element;
+                    arr->setFastModeValue(baseIndex + elementIndex, element);
                     elementIndex++;
                 }
             } else {
@@ -3679,7 +3790,7 @@ NEVER_INLINE void ByteCodeInterpreter::arrayDefineOwnPropertyBySpreadElementOper
                     ASSERT(spreadArray->isFastModeArray());
                     Value spreadElement;
                     for (size_t spreadIndex = 0; spreadIndex < spreadArray->arrayLength(state); spreadIndex++) {
-                        spreadElement = spreadArray->m_fastModeData[spreadIndex];
+                        spreadElement = spreadArray->getFastModeValue(spreadIndex);
                         arr->defineOwnProperty(state, ObjectPropertyName(state, baseIndex + elementIndex), ObjectPropertyDescriptor(spreadElement, ObjectPropertyDescriptor::AllPresent));
                         elementIndex++;
                     }
@@ -4019,23 +4130,100 @@ NEVER_INLINE void ByteCodeInterpreter::taggedTemplateOperation(ExecutionState& s
     }
 }
 
-NEVER_INLINE void ByteCodeInterpreter::getObjectOpcodeSlowCase(ExecutionState& state, GetObject* code, Value* registerFile)
+KeyedObjectInlineCache* ByteCodeInterpreter::ensureKeyedObjectInlineCache(ExecutionState& state, KeyedObjectInlineCache*& inlineCache, ByteCodeBlock* block)
+{
+    if (!inlineCache) {
+        inlineCache = new KeyedObjectInlineCache();
+        block->m_inlineCacheDataSize += sizeof(KeyedObjectInlineCache);
+        state.context()->vmInstance()->compiledByteCodeSize() += sizeof(KeyedObjectInlineCache);
+        block->m_otherLiteralData.push_back(inlineCache);
+    }
+    return inlineCache;
+}
+
+NEVER_INLINE void ByteCodeInterpreter::getObjectOpcodeSlowCase(ExecutionState& state, GetObject* code, Value* registerFile, ByteCodeBlock* block)
 {
     const Value& willBeObject = registerFile[code->m_objectRegisterIndex];
     const Value& property = registerFile[code->m_propertyRegisterIndex];
     Object* obj;
     if (LIKELY(willBeObject.isObject())) {
         obj = willBeObject.asObject();
+#if !defined(ESCARGOT_SMALL_CONFIG)
+        if (property.isString() || property.isSymbol()) {
+            // keyed access with string or symbol key like `obj[name]`
+            PointerValue* key = property.asPointerValue();
+            if (code->m_inlineCache) {
+                auto data = code->m_inlineCache->find(key, obj->structure());
+                if (data && obj->isInlineCacheable()) {
+                    registerFile[code->m_storeRegisterIndex] = obj->getOwnPropertyUtilForObject(state, data->m_cachedIndex, willBeObject);
+                    return;
+                }
+            }
+
+            const int minCacheFillCount = 3;
+            if (code->m_cacheMissCount < minCacheFillCount) {
+                code->m_cacheMissCount++;
+            } else if (obj->isInlineCacheable()) {
+                ObjectStructure* structure = obj->structure();
+                auto result = structure->findProperty(ObjectStructurePropertyName(state, property));
+                if (result.first != SIZE_MAX) {
+                    ensureKeyedObjectInlineCache(state, code->m_inlineCache, block)->add(key, structure, result.first);
+                }
+            }
+        } else if (property.isUInt32() && obj->isTypedArrayObject()) {
+            // remember class of typed array so that later accesses can use GetObject fast path
+            KeyedObjectInlineCache* inlineCache = ensureKeyedObjectInlineCache(state, code->m_inlineCache, block);
+            inlineCache->m_typedArrayTag = obj->getTag();
+            inlineCache->m_typedArrayType = obj->asTypedArrayObject()->typedArrayType();
+        }
+#endif
     } else {
         obj = fastToObject(state, willBeObject);
     }
     registerFile[code->m_storeRegisterIndex] = obj->getIndexedProperty(state, property).value(state, willBeObject);
 }
 
-NEVER_INLINE void ByteCodeInterpreter::setObjectOpcodeSlowCase(ExecutionState& state, SetObjectOperation* code, Value* registerFile)
+NEVER_INLINE void ByteCodeInterpreter::setObjectOpcodeSlowCase(ExecutionState& state, SetObjectOperation* code, Value* registerFile, ByteCodeBlock* block)
 {
     const Value& willBeObject = registerFile[code->m_objectRegisterIndex];
     const Value& property = registerFile[code->m_propertyRegisterIndex];
+#if !defined(ESCARGOT_SMALL_CONFIG)
+    if (LIKELY(willBeObject.isObject())) {
+        Object* obj = willBeObject.asObject();
+        if (property.isString() || property.isSymbol()) {
+            PointerValue* key = property.asPointerValue();
+            if (code->m_inlineCache) {
+                auto data = code->m_inlineCache->find(key, obj->structure());
+                if (data && obj->isInlineCacheable()) {
+                    obj->m_values[data->m_cachedIndex] = registerFile[code->m_loadRegisterIndex];
+                    return;
+                }
+            }
+
+            const int minCacheFillCount = 3;
+            if (code->m_cacheMissCount < minCacheFillCount) {
+                code->m_cacheMissCount++;
+            } else if (obj->isInlineCacheable()) {
+                ObjectStructure* structure = obj->structure();
+                auto result = structure->findProperty(ObjectStructurePropertyName(state, property));
+                if (result.first != SIZE_MAX) {
+                    const auto& desc = result.second.value()->m_descriptor;
+                    if (desc.isPlainDataProperty() && desc.isWritable()) {
+                        ensureKeyedObjectInlineCache(state, code->m_inlineCache, block)->add(key, structure, result.first);
+                    }
+                }
+            }
+        } else if (property.isUInt32() && obj->isTypedArrayObject()) {
+            TypedArrayType type = obj->asTypedArrayObject()->typedArrayType();
+            // BigInt typed arrays cannot store Number values
+            if (type != TypedArrayType::BigInt64 && type != TypedArrayType::BigUint64) {
+                KeyedObjectInlineCache* inlineCache = ensureKeyedObjectInlineCache(state, code->m_inlineCache, block);
+                inlineCache->m_typedArrayTag = obj->getTag();
+                inlineCache->m_typedArrayType = type;
+            }
+        }
+    }
+#endif
     Object* obj = willBeObject.toObject(state);
     if (willBeObject.isPrimitive()) {
         obj->preventExtensions(state);
@@ -4054,4 +4242,32 @@ NEVER_INLINE void ByteCodeInterpreter::ensureArgumentsObjectOperation(ExecutionS
     bool isMapped = functionObject->interpretedCodeBlock()->shouldHaveMappedArguments();
     functionObject->generateArgumentsObject(state, state.argc(), state.argv(), functionRecord, registerFile + byteCodeBlock->m_requiredRegisterFileSizeInValueSize, isMapped);
 }
+
+#if defined(ENABLE_JIT)
+NEVER_INLINE Value ByteCodeInterpreter::getObjectPrecomputedCaseOperationForJIT(ExecutionState& state, const Value& willBeObject, GetObjectPreComputedCase* code, ByteCodeBlock* block)
+{
+    Object* obj;
+    if (LIKELY(willBeObject.isObject())) {
+        obj = willBeObject.asObject();
+    } else {
+        obj = fastToObject(state, willBeObject);
+    }
+    return getObjectPrecomputedCaseOperation(state, obj, willBeObject, code, block);
+}
+
+NEVER_INLINE void ByteCodeInterpreter::setObjectPreComputedCaseOperationForJIT(ExecutionState& state, const Value& willBeObject, const Value& value, SetObjectPreComputedCase* code, ByteCodeBlock* block)
+{
+    setObjectPreComputedCaseOperation(state, willBeObject, value, code, block);
+}
+
+NEVER_INLINE Value ByteCodeInterpreter::getGlobalVariableForJIT(ExecutionState& state, GlobalVariableAccessCacheItem* slot, ByteCodeBlock* block)
+{
+    return getGlobalVariableOperation(state, slot, block);
+}
+
+NEVER_INLINE void ByteCodeInterpreter::setGlobalVariableForJIT(ExecutionState& state, GlobalVariableAccessCacheItem* slot, const Value& value, ByteCodeBlock* block)
+{
+    setGlobalVariableOperation(state, slot, value, block);
+}
+#endif
 } // namespace Escargot
@@ -34,6 +34,7 @@ class GetObjectPreComputedCase;
 class SetObjectPreComputedCase;
 struct GetObjectInlineCache;
 struct SetObjectInlineCache;
+struct KeyedObjectInlineCache;
 struct GlobalVariableAccessCacheItem;
 class InitializeGlobalVariable;
 class CallFunctionComplexCase;
@@ -73,6 +74,16 @@ public:
     static Value interpret(ExecutionState* state, ByteCodeBlock* byteCodeBlock, size_t programCounter, Value* registerFile);
 
 private:
+#if defined(ENABLE_JIT)
+    friend class JITOperations;
+
+    // out-of-line entries of the inlined interpreter operations for JITOperations
+    static Value getObjectPrecomputedCaseOperationForJIT(ExecutionState& state, const Value& willBeObject, GetObjectPreComputedCase* code, ByteCodeBlock* block);
+    static void setObjectPreComputedCaseOperationForJIT(ExecutionState& state, const Value& willBeObject, const Value& value, SetObjectPreComputedCase* code, ByteCodeBlock* block);
+    static Value getGlobalVariableForJIT(ExecutionState& state, GlobalVariableAccessCacheItem* slot, ByteCodeBlock* block);
+    static void setGlobalVariableForJIT(ExecutionState& state, GlobalVariableAccessCacheItem* slot, const Value& value, ByteCodeBlock* block);
+#endif
+
     static Value loadByName(ExecutionState& state, LexicalEnvironment* env, const AtomicString& name, bool throwException = true);
     static EnvironmentRecord* getBindedEnvironmentRecordByName(ExecutionState& state, LexicalEnvironment* env, const AtomicString& name, Value& bindedValue, bool throwException = true);
     static void storeByName(ExecutionState& state, LexicalEnvironment* env, const AtomicString& name, const Value& value);
@@ -112,11 +123,15 @@ private:
 
     static Value getObjectPrecomputedCaseOperation(ExecutionState& state, Object* obj, const Value& receiver, GetObjectPreComputedCase* code, ByteCodeBlock* block);
     static Value getObjectPrecomputedCaseOperationCacheMiss(ExecutionState& state, Object* obj, const Value& receiver, GetObjectPreComputedCase* code, ByteCodeBlock* block);
+    static Value getObjectPrecomputedCaseOperationMegamorphic(ExecutionState& state, Object* obj, const Value& receiver, GetObjectPreComputedCase* code);
     static void setObjectPreComputedCaseOperation(ExecutionState& state, const Value& willBeObject, const Value& value, SetObjectPreComputedCase* code, ByteCodeBlock* block);
     static void setObjectPreComputedCaseOperationCacheMiss(ExecutionState& state, Object* obj, const Value& willBeObject, const Value& value, SetObjectPreComputedCase* code, ByteCodeBlock* block);
+    static void setObjectPreComputedCaseOperationMegamorphic(ExecutionState& state, Object* obj, const Value& willBeObject, const Value& value, SetObjectPreComputedCase* code);
 
     static Object* fastToObject(ExecutionState& state, const Value& obj);
 
+    static Value getGlobalVariableOperation(ExecutionState& state, GlobalVariableAccessCacheItem* slot, ByteCodeBlock* block);
+    static void setGlobalVariableOperation(ExecutionState& state, GlobalVariableAccessCacheItem* slot, const Value& value, ByteCodeBlock* block);
     static Value getGlobalVariableSlowCase(ExecutionState& state, Object* go, GlobalVariableAccessCacheItem* slot, ByteCodeBlock* block);
     static void setGlobalVariableSlowCase(ExecutionState& state, Object* go, GlobalVariableAccessCacheItem* slot, const Value& value, ByteCodeBlock* block);
     static void initializeGlobalVariable(ExecutionState& state, InitializeGlobalVariable* code, const Value& value);
@@ -159,8 +174,9 @@ private:
     static Value decrementOperation(ExecutionState& state, const Value& value);
     static Value decrementOperationSlowCase(ExecutionState& state, const Value& value);
 
-    static void getObjectOpcodeSlowCase(ExecutionState& state, GetObject* code, Value* registerFile);
-    static void setObjectOpcodeSlowCase(ExecutionState& state, SetObjectOperation* code, Value* registerFile);
+    static void getObjectOpcodeSlowCase(ExecutionState& state, GetObject* code, Value* registerFile, ByteCodeBlock* block);
+    static void setObjectOpcodeSlowCase(ExecutionState& state, SetObjectOperation* code, Value* registerFile, ByteCodeBlock* block);
+    static KeyedObjectInlineCache* ensureKeyedObjectInlineCache(ExecutionState& state, KeyedObjectInlineCache*& inlineCache, ByteCodeBlock* block);
 
     static void unaryTypeof(ExecutionState& state, UnaryTypeof* code, Value* registerFile);
 
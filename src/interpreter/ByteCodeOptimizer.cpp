@@ -0,0 +1,932 @@
+/*
+ * Copyright (c) 2021-present Samsung Electronics Co., Ltd
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+ */
+
+#include "Escargot.h"
+#include "interpreter/ByteCode.h"
+#include "interpreter/ByteCodeGenerator.h"
+#include "interpreter/ByteCodeOptimizer.h"
+
+namespace Escargot {
+
+static const char* byteCodeOptimizationPassNames[] = {
+#define DECLARE_BYTECODE_OPTIMIZATION_PASS_NAME(name, humanName) humanName,
+    FOR_EACH_BYTECODE_OPTIMIZATION_PASS(DECLARE_BYTECODE_OPTIMIZATION_PASS_NAME)
+#undef DECLARE_BYTECODE_OPTIMIZATION_PASS_NAME
+};
+
+void ByteCodeOptimizerStatistics::dump()
+{
+    printf("bytecode optimizer: %zu blocks, %zu bytes -> %zu bytes\n", m_optimizedBlockCount, m_originalCodeSize, m_optimizedCodeSize);
+    for (size_t i = 0; i < ByteCodeOptimizationPassKindEnd; i++) {
+        printf("    %s: %zu rewrites, %zu bytes reduced\n", byteCodeOptimizationPassNames[i], m_rewriteCount[i], m_reducedCodeSize[i]);
+    }
+}
+
+static bool isJumpOpcode(Opcode opcode)
+{
+    switch (opcode) {
+    case JumpOpcode:
+    case JumpIfTrueOpcode:
+    case JumpIfFalseOpcode:
+    case JumpIfUndefinedOrNullOpcode:
+    case JumpIfNotFulfilledOpcode:
+    case JumpIfEqualOpcode:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// bytecodes which keep code position in their own way (or their execution depends on the code position)
+// the code layout of ByteCodeBlock which has one of these bytecodes is never changed
+static bool isCodeLayoutDependentOpcode(Opcode opcode)
+{
+    switch (opcode) {
+    case JumpComplexCaseOpcode:
+    case TryOperationOpcode:
+    case CheckLastEnumerateKeyOpcode:
+    case IteratorOperationOpcode:
+    case BlockOperationOpcode:
+    case TaggedTemplateOperationOpcode:
+    case ExecutionPauseOpcode:
+    case ExecutionResumeOpcode:
+    case BreakpointDisabledOpcode:
+    case BreakpointEnabledOpcode:
+        return true;
+    default:
+        return false;
+    }
+}
+
+Opcode ByteCodeOptimizer::opcodeOf(ByteCode* code)
+{
+    // bytecode is not relocated yet
+#if defined(COMPILER_GCC) || defined(COMPILER_CLANG)
+    return (Opcode)(size_t)code->m_opcodeInAddress;
+#else
+    return code->m_opcode;
+#endif
+}
+
+ByteCodeLOC ByteCodeOptimizer::locOf(ByteCode* code)
+{
+#ifndef NDEBUG
+    return code->m_loc;
+#else
+    return ByteCodeLOC(SIZE_MAX);
+#endif
+}
+
+ByteCodeOptimizer::ByteCodeOptimizer(ByteCodeBlock* block, const Value* numeralLiteralData, size_t numeralLiteralCount)
+    : m_block(block)
+    , m_numeralLiteralData(numeralLiteralData)
+    , m_numeralLiteralCount(numeralLiteralCount)
+    , m_canChangeCodeLayout(true)
+    , m_hasLayoutChange(false)
+    , m_currentPass(JumpThreadingPassKind)
+{
+    for (size_t i = 0; i < ByteCodeOptimizationPassKindEnd; i++) {
+        m_rewriteCount[i] = 0;
+        m_reducedCodeSize[i] = 0;
+    }
+}
+
+void ByteCodeOptimizer::decode()
+{
+    char* start = m_block->m_code.data();
+    char* cursor = start;
+    char* end = start + m_block->m_code.size();
+
+    while (cursor < end) {
+        ByteCode* currentCode = (ByteCode*)cursor;
+        Opcode opcode = opcodeOf(currentCode);
+        ASSERT(opcode < EndOpcode + 1);
+
+        size_t length = byteCodeLengths[opcode];
+        if (opcode == ExecutionPauseOpcode) {
+            ExecutionPause* cd = (ExecutionPause*)currentCode;
+            if (cd->m_reason == ExecutionPause::Reason::Yield) {
+                length += cd->m_yieldData.m_tailDataLength;
+            } else if (cd->m_reason == ExecutionPause::Reason::Await) {
+                length += cd->m_awaitData.m_tailDataLength;
+            } else if (cd->m_reason == ExecutionPause::Reason::GeneratorsInitialize) {
+                length += cd->m_asyncGeneratorInitializeData.m_tailDataLength;
+            }
+        }
+
+        if (isCodeLayoutDependentOpcode(opcode)) {
+            m_canChangeCodeLayout = false;
+        }
+
+        Instruction inst;
+        inst.m_position = cursor - start;
+        inst.m_length = length;
+        inst.m_opcode = opcode;
+        inst.m_isJumpTarget = false;
+        inst.m_isRemoved = false;
+        inst.m_replacedCodeIndex = SIZE_MAX;
+        m_instructions.push_back(inst);
+
+        cursor += length;
+    }
+
+    for (size_t i = 0; i < m_instructions.size(); i++) {
+        if (isJumpOpcode(m_instructions[i].m_opcode)) {
+            size_t target = instructionIndexAt(code<Jump>(i)->m_jumpPosition);
+            if (target != SIZE_MAX) {
+                m_instructions[target].m_isJumpTarget = true;
+            }
+        }
+    }
+}
+
+size_t ByteCodeOptimizer::instructionIndexAt(size_t position)
+{
+    size_t low = 0;
+    size_t high = m_instructions.size();
+    while (low < high) {
+        size_t mid = (low + high) / 2;
+        if (m_instructions[mid].m_position < position) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    if (low < m_instructions.size() && m_instructions[low].m_position == position) {
+        return low;
+    }
+    return SIZE_MAX;
+}
+
+size_t ByteCodeOptimizer::nextInstruction(size_t index)
+{
+    for (size_t i = index + 1; i < m_instructions.size(); i++) {
+        if (!m_instructions[i].m_isRemoved) {
+            return i;
+        }
+    }
+    return SIZE_MAX;
+}
+
+size_t ByteCodeOptimizer::previousInstruction(size_t index)
+{
+    while (index > 0) {
+        index--;
+        if (!m_instructions[index].m_isRemoved) {
+            return index;
+        }
+    }
+    return SIZE_MAX;
+}
+
+void ByteCodeOptimizer::remove(size_t index)
+{
+    Instruction& inst = m_instructions[index];
+    ASSERT(!inst.m_isRemoved);
+    ASSERT(m_canChangeCodeLayout);
+    inst.m_isRemoved = true;
+    m_hasLayoutChange = true;
+    m_rewriteCount[m_currentPass]++;
+    m_reducedCodeSize[m_currentPass] += inst.m_length;
+}
+
+// collect registers which are read or written by the bytecode
+// returns false if the bytecode is not understood by the optimizer
+static bool collectRegisterUsage(ByteCodeOptimizer& optimizer, size_t index, ByteCodeRegisterIndex* reads, size_t& readCount, ByteCodeRegisterIndex* writes, size_t& writeCount)
+{
+    readCount = writeCount = 0;
+    switch (optimizer.instruction(index).m_opcode) {
+    case LoadLiteralOpcode:
+        writes[writeCount++] = optimizer.code<LoadLiteral>(index)->m_registerIndex;
+        return true;
+    case MoveOpcode: {
+        Move* cd = optimizer.code<Move>(index);
+        reads[readCount++] = cd->m_registerIndex0;
+        writes[writeCount++] = cd->m_registerIndex1;
+        return true;
+    }
+    case BinaryPlusOpcode:
+    case BinaryMinusOpcode:
+    case BinaryMultiplyOpcode:
+    case BinaryDivisionOpcode:
+    case BinaryExponentiationOpcode:
+    case BinaryModOpcode:
+    case BinaryEqualOpcode:
+    case BinaryNotEqualOpcode:
+    case BinaryLessThanOpcode:
+    case BinaryLessThanOrEqualOpcode:
+    case BinaryGreaterThanOpcode:
+    case BinaryGreaterThanOrEqualOpcode:
+    case BinaryStrictEqualOpcode:
+    case BinaryNotStrictEqualOpcode:
+    case BinaryBitwiseAndOpcode:
+    case BinaryBitwiseOrOpcode:
+    case BinaryBitwiseXorOpcode:
+    case BinaryLeftShiftOpcode:
+    case BinarySignedRightShiftOpcode:
+    case BinaryUnsignedRightShiftOpcode:
+    case BinaryInOperationOpcode:
+    case BinaryInstanceOfOperationOpcode: {
+        BinaryPlus* cd = optimizer.code<BinaryPlus>(index);
+        reads[readCount++] = cd->m_srcIndex0;
+        reads[readCount++] = cd->m_srcIndex1;
+        writes[writeCount++] = cd->m_dstIndex;
+        return true;
+    }
+    case ToNumberOpcode:
+    case IncrementOpcode:
+    case DecrementOpcode:
+    case UnaryMinusOpcode:
+    case UnaryNotOpcode:
+    case UnaryBitwiseNotOpcode:
+    case UnaryTypeofOpcode: {
+        ToNumber* cd = optimizer.code<ToNumber>(index);
+        reads[readCount++] = cd->m_srcIndex;
+        writes[writeCount++] = cd->m_dstIndex;
+        return true;
+    }
+    case ToNumericIncrementOpcode:
+    case ToNumericDecrementOpcode: {
+        ToNumericIncrement* cd = optimizer.code<ToNumericIncrement>(index);
+        reads[readCount++] = cd->m_srcIndex;
+        writes[writeCount++] = cd->m_storeIndex;
+        writes[writeCount++] = cd->m_dstIndex;
+        return true;
+    }
+    case GetObjectOpcode: {
+        GetObject* cd = optimizer.code<GetObject>(index);
+        reads[readCount++] = cd->m_objectRegisterIndex;
+        reads[readCount++] = cd->m_propertyRegisterIndex;
+        writes[writeCount++] = cd->m_storeRegisterIndex;
+        return true;
+    }
+    case SetObjectOperationOpcode: {
+        SetObjectOperation* cd = optimizer.code<SetObjectOperation>(index);
+        reads[readCount++] = cd->m_objectRegisterIndex;
+        reads[readCount++] = cd->m_propertyRegisterIndex;
+        reads[readCount++] = cd->m_loadRegisterIndex;
+        return true;
+    }
+    case GetObjectPreComputedCaseOpcode: {
+        GetObjectPreComputedCase* cd = optimizer.code<GetObjectPreComputedCase>(index);
+        reads[readCount++] = cd->m_objectRegisterIndex;
+        writes[writeCount++] = cd->m_storeRegisterIndex;
+        return true;
+    }
+    case SetObjectPreComputedCaseOpcode: {
+        SetObjectPreComputedCase* cd = optimizer.code<SetObjectPreComputedCase>(index);
+        reads[readCount++] = cd->m_objectRegisterIndex;
+        reads[readCount++] = cd->m_loadRegisterIndex;
+        return true;
+    }
+    case GetGlobalVariableOpcode:
+        writes[writeCount++] = optimizer.code<GetGlobalVariable>(index)->m_registerIndex;
+        return true;
+    case SetGlobalVariableOpcode:
+        reads[readCount++] = optimizer.code<SetGlobalVariable>(index)->m_registerIndex;
+        return true;
+    case LoadByHeapIndexOpcode:
+        writes[writeCount++] = optimizer.code<LoadByHeapIndex>(index)->m_registerIndex;
+        return true;
+    case StoreByHeapIndexOpcode:
+        reads[readCount++] = optimizer.code<StoreByHeapIndex>(index)->m_registerIndex;
+        return true;
+    case JumpIfTrueOpcode:
+        reads[readCount++] = optimizer.code<JumpIfTrue>(index)->m_registerIndex;
+        return true;
+    case JumpIfFalseOpcode:
+        reads[readCount++] = optimizer.code<JumpIfFalse>(index)->m_registerIndex;
+        return true;
+    case JumpIfUndefinedOrNullOpcode:
+        reads[readCount++] = optimizer.code<JumpIfUndefinedOrNull>(index)->m_registerIndex;
+        return true;
+    case JumpIfNotFulfilledOpcode: {
+        JumpIfNotFulfilled* cd = optimizer.code<JumpIfNotFulfilled>(index);
+        reads[readCount++] = cd->m_leftIndex;
+        reads[readCount++] = cd->m_rightIndex;
+        return true;
+    }
+    case JumpIfEqualOpcode: {
+        JumpIfEqual* cd = optimizer.code<JumpIfEqual>(index);
+        reads[readCount++] = cd->m_registerIndex0;
+        reads[readCount++] = cd->m_registerIndex1;
+        return true;
+    }
+    case JumpOpcode:
+        return true;
+    case EndOpcode:
+        reads[readCount++] = optimizer.code<End>(index)->m_registerIndex;
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool ByteCodeOptimizer::isTemporaryRegisterDeadFrom(size_t index, ByteCodeRegisterIndex reg)
+{
+    ASSERT(isTemporaryRegister(reg));
+    return isTemporaryRegisterDeadFrom(index, reg, 0);
+}
+
+bool ByteCodeOptimizer::isTemporaryRegisterDeadFrom(size_t index, ByteCodeRegisterIndex reg, size_t depth)
+{
+    // give up on long paths or many branches
+    const size_t maxScanLength = 64;
+    const size_t maxBranchDepth = 4;
+    if (depth > maxBranchDepth) {
+        return false;
+    }
+
+    ByteCodeRegisterIndex reads[4];
+    ByteCodeRegisterIndex writes[2];
+    size_t readCount, writeCount;
+    for (size_t scanned = 0; index != SIZE_MAX && index < m_instructions.size() && scanned < maxScanLength; scanned++) {
+        if (m_instructions[index].m_isRemoved) {
+            index = nextInstruction(index);
+            continue;
+        }
+        if (!collectRegisterUsage(*this, index, reads, readCount, writes, writeCount)) {
+            return false;
+        }
+        for (size_t i = 0; i < readCount; i++) {
+            if (reads[i] == reg) {
+                return false;
+            }
+        }
+        for (size_t i = 0; i < writeCount; i++) {
+            if (writes[i] == reg) {
+                return true;
+            }
+        }
+
+        Opcode opcode = m_instructions[index].m_opcode;
+        if (opcode == EndOpcode) {
+            return true;
+        } else if (isJumpOpcode(opcode)) {
+            size_t target = instructionIndexAt(code<Jump>(index)->m_jumpPosition);
+            if (target == SIZE_MAX || !isTemporaryRegisterDeadFrom(target, reg, depth + 1)) {
+                return false;
+            }
+            if (opcode == JumpOpcode) {
+                return true;
+            }
+        }
+        index = nextInstruction(index);
+    }
+    return false;
+}
+
+void ByteCodeOptimizer::compact(ByteCodeLOCData* locData)
+{
+    ByteCodeBlockData newCode;
+    std::vector<size_t> newPositions;
+    newPositions.reserve(m_instructions.size() + 1);
+
+    for (size_t i = 0; i < m_instructions.size(); i++) {
+        const Instruction& inst = m_instructions[i];
+        newPositions.push_back(newCode.size());
+        if (inst.m_isRemoved) {
+            continue;
+        }
+        char* src = code<char>(i);
+        size_t start = newCode.size();
+        newCode.resizeWithUninitializedValues(start + inst.m_length);
+        memcpy(newCode.data() + start, src, inst.m_length);
+    }
+    newPositions.push_back(newCode.size());
+
+    // update jump positions
+    for (size_t i = 0; i < m_instructions.size(); i++) {
+        const Instruction& inst = m_instructions[i];
+        if (!inst.m_isRemoved && isJumpOpcode(inst.m_opcode)) {
+            Jump* jump = (Jump*)(newCode.data() + newPositions[i]);
+            size_t target = jump->m_jumpPosition == m_block->m_code.size() ? m_instructions.size() : instructionIndexAt(jump->m_jumpPosition);
+            ASSERT(target != SIZE_MAX);
+            jump->m_jumpPosition = newPositions[target];
+        }
+    }
+
+    if (locData) {
+        size_t j = 0;
+        for (size_t i = 0; i < locData->size(); i++) {
+            size_t index = instructionIndexAt((*locData)[i].first);
+            if (index != SIZE_MAX && m_instructions[index].m_isRemoved) {
+                continue;
+            }
+            if (index != SIZE_MAX) {
+                (*locData)[j] = std::make_pair(newPositions[index], (*locData)[i].second);
+            } else {
+                (*locData)[j] = (*locData)[i];
+            }
+            j++;
+        }
+        locData->resize(j);
+    }
+
+    m_block->m_code = std::move(newCode);
+}
+
+// redirect jumps whose target is an unconditional jump
+class JumpThreadingPass : public ByteCodeOptimizationPass {
+public:
+    virtual ByteCodeOptimizationPassKind kind() override { return ByteCodeOptimizationPassKind::JumpThreadingPassKind; }
+    virtual bool changesCodeLayout() override { return false; }
+    virtual void run(ByteCodeOptimizer& optimizer) override
+    {
+        const size_t maxThreadingCount = 8;
+        for (size_t i = 0; i < optimizer.instructionCount(); i++) {
+            if (!isJumpOpcode(optimizer.instruction(i).m_opcode)) {
+                continue;
+            }
+            Jump* jump = optimizer.code<Jump>(i);
+            size_t finalPosition = jump->m_jumpPosition;
+            for (size_t count = 0; count < maxThreadingCount; count++) {
+                size_t target = optimizer.instructionIndexAt(finalPosition);
+                if (target == SIZE_MAX || target == i || optimizer.instruction(target).m_opcode != JumpOpcode) {
+                    break;
+                }
+                finalPosition = optimizer.code<Jump>(target)->m_jumpPosition;
+            }
+            if (finalPosition != jump->m_jumpPosition) {
+                jump->m_jumpPosition = finalPosition;
+                optimizer.countRewrite();
+            }
+        }
+    }
+};
+
+// LoadLiteral r0, number; LoadLiteral r1, number; Binary r0, r1 -> r2  ==>  LoadLiteral r2, result
+class ConstantFoldingPass : public ByteCodeOptimizationPass {
+public:
+    virtual ByteCodeOptimizationPassKind kind() override { return ByteCodeOptimizationPassKind::ConstantFoldingPassKind; }
+    virtual bool changesCodeLayout() override { return true; }
+    virtual void run(ByteCodeOptimizer& optimizer) override
+    {
+        for (size_t i = 0; i < optimizer.instructionCount(); i++) {
+            ByteCodeOptimizer::Instruction& inst = optimizer.instruction(i);
+            if (inst.m_isRemoved || !isFoldableOpcode(inst.m_opcode)) {
+                continue;
+            }
+
+            BinaryPlus* binary = optimizer.code<BinaryPlus>(i);
+            Value left, right;
+            size_t leftLoad = SIZE_MAX, rightLoad = SIZE_MAX;
+            if (!findConstantOperand(optimizer, i, binary->m_srcIndex0, left, leftLoad) || !findConstantOperand(optimizer, i, binary->m_srcIndex1, right, rightLoad)) {
+                continue;
+            }
+
+            Value result;
+            if (!fold(inst.m_opcode, left, right, result)) {
+                continue;
+            }
+
+            ByteCodeRegisterIndex dst = binary->m_dstIndex;
+            size_t next = optimizer.nextInstruction(i);
+            optimizer.replace(i, LoadLiteral(ByteCodeOptimizer::locOf(binary), dst, result));
+
+            // remove loads which are not used anymore
+            size_t loads[2] = { leftLoad, rightLoad };
+            for (size_t j = 0; j < 2; j++) {
+                if (loads[j] == SIZE_MAX || optimizer.instruction(loads[j]).m_isRemoved) {
+                    continue;
+                }
+                ByteCodeRegisterIndex reg = optimizer.code<LoadLiteral>(loads[j])->m_registerIndex;
+                if (reg == dst || (next != SIZE_MAX && optimizer.isTemporaryRegisterDeadFrom(next, reg))) {
+                    optimizer.remove(loads[j]);
+                }
+            }
+        }
+    }
+
+private:
+    static bool isFoldableOpcode(Opcode opcode)
+    {
+        switch (opcode) {
+        case BinaryPlusOpcode:
+        case BinaryMinusOpcode:
+        case BinaryMultiplyOpcode:
+        case BinaryDivisionOpcode:
+        case BinaryModOpcode:
+        case BinaryEqualOpcode:
+        case BinaryNotEqualOpcode:
+        case BinaryLessThanOpcode:
+        case BinaryLessThanOrEqualOpcode:
+        case BinaryGreaterThanOpcode:
+        case BinaryGreaterThanOrEqualOpcode:
+        case BinaryStrictEqualOpcode:
+        case BinaryNotStrictEqualOpcode:
+        case BinaryBitwiseAndOpcode:
+        case BinaryBitwiseOrOpcode:
+        case BinaryBitwiseXorOpcode:
+        case BinaryLeftShiftOpcode:
+        case BinarySignedRightShiftOpcode:
+        case BinaryUnsignedRightShiftOpcode:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    // operand should be a numeral literal register or a temporary register loaded by one of two previous bytecodes
+    static bool findConstantOperand(ByteCodeOptimizer& optimizer, size_t index, ByteCodeRegisterIndex reg, Value& value, size_t& loadIndex)
+    {
+        if (optimizer.isNumeralLiteralRegister(reg)) {
+            value = optimizer.numeralLiteral(reg);
+            return value.isNumber();
+        }
+        if (!ByteCodeOptimizer::isTemporaryRegister(reg)) {
+            return false;
+        }
+
+        size_t current = index;
+        for (size_t distance = 0; distance < 2; distance++) {
+            if (optimizer.instruction(current).m_isJumpTarget) {
+                return false;
+            }
+            size_t prev = optimizer.previousInstruction(current);
+            if (prev == SIZE_MAX || optimizer.instruction(prev).m_opcode != LoadLiteralOpcode) {
+                return false;
+            }
+            LoadLiteral* load = optimizer.code<LoadLiteral>(prev);
+            if (load->m_registerIndex == reg) {
+                if (!load->m_value.isNumber()) {
+                    return false;
+                }
+                value = load->m_value;
+                loadIndex = prev;
+                return true;
+            }
+            current = prev;
+        }
+        return false;
+    }
+
+    static bool fold(Opcode opcode, const Value& left, const Value& right, Value& result)
+    {
+        ASSERT(left.isNumber() && right.isNumber());
+        double a = left.asNumber();
+        double b = right.asNumber();
+        switch (opcode) {
+        case BinaryPlusOpcode:
+            result = Value(a + b);
+            return true;
+        case BinaryMinusOpcode:
+            result = Value(a - b);
+            return true;
+        case BinaryMultiplyOpcode:
+            result = Value(a * b);
+            return true;
+        case BinaryDivisionOpcode:
+            result = Value(a / b);
+            return true;
+        case BinaryModOpcode:
+            result = Value(std::fmod(a, b));
+            return true;
+        case BinaryEqualOpcode:
+        case BinaryStrictEqualOpcode:
+            result = Value(a == b);
+            return true;
+        case BinaryNotEqualOpcode:
+        case BinaryNotStrictEqualOpcode:
+            result = Value(a != b);
+            return true;
+        case BinaryLessThanOpcode:
+            result = Value(a < b);
+            return true;
+        case BinaryLessThanOrEqualOpcode:
+            result = Value(a <= b);
+            return true;
+        case BinaryGreaterThanOpcode:
+            result = Value(a > b);
+            return true;
+        case BinaryGreaterThanOrEqualOpcode:
+            result = Value(a >= b);
+            return true;
+        default:
+            break;
+        }
+
+        // bitwise operations are folded only for int32 operands
+        if (!left.isInt32() || !right.isInt32()) {
+            return false;
+        }
+        int32_t l = left.asInt32();
+        int32_t r = right.asInt32();
+        switch (opcode) {
+        case BinaryBitwiseAndOpcode:
+            result = Value(l & r);
+            return true;
+        case BinaryBitwiseOrOpcode:
+            result = Value(l | r);
+            return true;
+        case BinaryBitwiseXorOpcode:
+            result = Value(l ^ r);
+            return true;
+        case BinaryLeftShiftOpcode:
+            result = Value((int32_t)((uint32_t)l << ((unsigned)r & 0x1F)));
+            return true;
+        case BinarySignedRightShiftOpcode:
+            result = Value(l >> ((unsigned)r & 0x1F));
+            return true;
+        case BinaryUnsignedRightShiftOpcode:
+            result = Value((double)((uint32_t)l >> ((unsigned)r & 0x1F)));
+            return true;
+        default:
+            ASSERT_NOT_REACHED();
+            return false;
+        }
+    }
+};
+
+// BinaryLessThan r0, r1 -> r2; JumpIfFalse r2  ==>  JumpIfNotFulfilled r0, r1
+class CompareBranchFusionPass : public ByteCodeOptimizationPass {
+public:
+    virtual ByteCodeOptimizationPassKind kind() override { return ByteCodeOptimizationPassKind::CompareBranchFusionPassKind; }
+    virtual bool changesCodeLayout() override { return true; }
+    virtual void run(ByteCodeOptimizer& optimizer) override
+    {
+        for (size_t i = 0; i < optimizer.instructionCount(); i++) {
+            ByteCodeOptimizer::Instruction& inst = optimizer.instruction(i);
+            if (inst.m_isRemoved) {
+                continue;
+            }
+            size_t next = optimizer.nextInstruction(i);
+            if (next == SIZE_MAX || optimizer.instruction(next).m_isJumpTarget) {
+                continue;
+            }
+            Opcode branch = optimizer.instruction(next).m_opcode;
+            if (branch != JumpIfFalseOpcode && branch != JumpIfTrueOpcode) {
+                continue;
+            }
+
+            BinaryPlus* compare = optimizer.code<BinaryPlus>(i);
+            Jump* jump = optimizer.code<Jump>(next);
+            ByteCodeRegisterIndex condition = branch == JumpIfFalseOpcode ? ((JumpIfFalse*)jump)->m_registerIndex : ((JumpIfTrue*)jump)->m_registerIndex;
+            if (!isCompareOpcode(inst.m_opcode) || compare->m_dstIndex != condition || !ByteCodeOptimizer::isTemporaryRegister(condition)) {
+                continue;
+            }
+
+            // the result of comparison should not be used after the branch
+            size_t jumpTarget = optimizer.instructionIndexAt(jump->m_jumpPosition);
+            size_t fallThrough = optimizer.nextInstruction(next);
+            if (jumpTarget == SIZE_MAX || fallThrough == SIZE_MAX
+                || !optimizer.isTemporaryRegisterDeadFrom(jumpTarget, condition) || !optimizer.isTemporaryRegisterDeadFrom(fallThrough, condition)) {
+                continue;
+            }
+
+            ByteCodeLOC loc = ByteCodeOptimizer::locOf(compare);
+            ByteCodeRegisterIndex src0 = compare->m_srcIndex0;
+            ByteCodeRegisterIndex src1 = compare->m_srcIndex1;
+            size_t jumpPosition = jump->m_jumpPosition;
+            bool jumpIfFalse = branch == JumpIfFalseOpcode;
+
+            // JumpIfNotFulfilled jumps when the relation is false, so it can replace only JumpIfFalse
+            // operands are kept in the same order with ByteCodeGenerator output
+            switch (inst.m_opcode) {
+            case BinaryLessThanOpcode:
+            case BinaryLessThanOrEqualOpcode:
+            case BinaryGreaterThanOpcode:
+            case BinaryGreaterThanOrEqualOpcode: {
+                if (!jumpIfFalse) {
+                    continue;
+                }
+                bool containEqual = inst.m_opcode == BinaryLessThanOrEqualOpcode || inst.m_opcode == BinaryGreaterThanOrEqualOpcode;
+                bool switched = inst.m_opcode == BinaryGreaterThanOpcode || inst.m_opcode == BinaryGreaterThanOrEqualOpcode;
+                JumpIfNotFulfilled fused(loc, switched ? src1 : src0, switched ? src0 : src1, containEqual, switched);
+                fused.m_jumpPosition = jumpPosition;
+                optimizer.replace(i, fused);
+                break;
+            }
+            default: {
+                bool isStrict = inst.m_opcode == BinaryStrictEqualOpcode || inst.m_opcode == BinaryNotStrictEqualOpcode;
+                bool isEqual = inst.m_opcode == BinaryStrictEqualOpcode || inst.m_opcode == BinaryEqualOpcode;
+                // JumpIfEqual jumps when (equality ^ shouldNegate) is true
+                JumpIfEqual fused(loc, src0, src1, isStrict, isEqual == jumpIfFalse);
+                fused.m_jumpPosition = jumpPosition;
+                optimizer.replace(i, fused);
+                break;
+            }
+            }
+            optimizer.remove(next);
+        }
+    }
+
+private:
+    static bool isCompareOpcode(Opcode opcode)
+    {
+        switch (opcode) {
+        case BinaryLessThanOpcode:
+        case BinaryLessThanOrEqualOpcode:
+        case BinaryGreaterThanOpcode:
+        case BinaryGreaterThanOrEqualOpcode:
+        case BinaryEqualOpcode:
+        case BinaryNotEqualOpcode:
+        case BinaryStrictEqualOpcode:
+        case BinaryNotStrictEqualOpcode:
+            return true;
+        default:
+            return false;
+        }
+    }
+};
+
+// Move r0 -> r0 ==> (removed)
+// Move r0 -> r1; Move r1 -> r0 ==> Move r0 -> r1
+// (operation) -> r0; Move r0 -> r1 ==> (operation) -> r1 (if r0 is temporary register which is not used later)
+class RedundantMoveEliminationPass : public ByteCodeOptimizationPass {
+public:
+    virtual ByteCodeOptimizationPassKind kind() override { return ByteCodeOptimizationPassKind::RedundantMoveEliminationPassKind; }
+    virtual bool changesCodeLayout() override { return true; }
+    virtual void run(ByteCodeOptimizer& optimizer) override
+    {
+        for (size_t i = 0; i < optimizer.instructionCount(); i++) {
+            ByteCodeOptimizer::Instruction& inst = optimizer.instruction(i);
+            if (inst.m_isRemoved || inst.m_opcode != MoveOpcode) {
+                continue;
+            }
+
+            Move* move = optimizer.code<Move>(i);
+            if (move->m_registerIndex0 == move->m_registerIndex1) {
+                optimizer.remove(i);
+                continue;
+            }
+
+            if (inst.m_isJumpTarget) {
+                continue;
+            }
+            size_t prev = optimizer.previousInstruction(i);
+            if (prev == SIZE_MAX) {
+                continue;
+            }
+
+            if (optimizer.instruction(prev).m_opcode == MoveOpcode) {
+                Move* prevMove = optimizer.code<Move>(prev);
+                if (prevMove->m_registerIndex0 == move->m_registerIndex1 && prevMove->m_registerIndex1 == move->m_registerIndex0) {
+                    optimizer.remove(i);
+                    continue;
+                }
+            }
+
+            ByteCodeRegisterIndex* producerDst = producerDestination(optimizer, prev);
+            ByteCodeRegisterIndex src = move->m_registerIndex0;
+            ByteCodeRegisterIndex dst = move->m_registerIndex1;
+            if (producerDst && *producerDst == src && ByteCodeOptimizer::isTemporaryRegister(src) && !readsRegister(optimizer, prev, dst)) {
+                size_t next = optimizer.nextInstruction(i);
+                if (next != SIZE_MAX && optimizer.isTemporaryRegisterDeadFrom(next, src)) {
+                    *producerDst = dst;
+                    optimizer.remove(i);
+                }
+            }
+        }
+    }
+
+private:
+    // destination register of bytecode which writes only one register
+    static ByteCodeRegisterIndex* producerDestination(ByteCodeOptimizer& optimizer, size_t index)
+    {
+        switch (optimizer.instruction(index).m_opcode) {
+        case LoadLiteralOpcode:
+            return &optimizer.code<LoadLiteral>(index)->m_registerIndex;
+        case BinaryPlusOpcode:
+        case BinaryMinusOpcode:
+        case BinaryMultiplyOpcode:
+        case BinaryDivisionOpcode:
+        case BinaryModOpcode:
+        case BinaryEqualOpcode:
+        case BinaryNotEqualOpcode:
+        case BinaryLessThanOpcode:
+        case BinaryLessThanOrEqualOpcode:
+        case BinaryGreaterThanOpcode:
+        case BinaryGreaterThanOrEqualOpcode:
+        case BinaryStrictEqualOpcode:
+        case BinaryNotStrictEqualOpcode:
+        case BinaryBitwiseAndOpcode:
+        case BinaryBitwiseOrOpcode:
+        case BinaryBitwiseXorOpcode:
+        case BinaryLeftShiftOpcode:
+        case BinarySignedRightShiftOpcode:
+        case BinaryUnsignedRightShiftOpcode:
+            return &optimizer.code<BinaryPlus>(index)->m_dstIndex;
+        case ToNumberOpcode:
+        case IncrementOpcode:
+        case DecrementOpcode:
+        case UnaryMinusOpcode:
+        case UnaryNotOpcode:
+        case UnaryBitwiseNotOpcode:
+            return &optimizer.code<ToNumber>(index)->m_dstIndex;
+        case GetObjectOpcode:
+            return &optimizer.code<GetObject>(index)->m_storeRegisterIndex;
+        case GetObjectPreComputedCaseOpcode:
+            return &optimizer.code<GetObjectPreComputedCase>(index)->m_storeRegisterIndex;
+        case GetGlobalVariableOpcode:
+            return &optimizer.code<GetGlobalVariable>(index)->m_registerIndex;
+        case LoadByHeapIndexOpcode:
+            return &optimizer.code<LoadByHeapIndex>(index)->m_registerIndex;
+        default:
+            return nullptr;
+        }
+    }
+
+    static bool readsRegister(ByteCodeOptimizer& optimizer, size_t index, ByteCodeRegisterIndex reg)
+    {
+        ByteCodeRegisterIndex reads[4];
+        ByteCodeRegisterIndex writes[2];
+        size_t readCount, writeCount;
+        if (!collectRegisterUsage(optimizer, index, reads, readCount, writes, writeCount)) {
+            return true;
+        }
+        for (size_t i = 0; i < readCount; i++) {
+            if (reads[i] == reg) {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+// remove LoadLiteral and Move which write temporary register never read
+class DeadRegisterEliminationPass : public ByteCodeOptimizationPass {
+public:
+    virtual ByteCodeOptimizationPassKind kind() override { return ByteCodeOptimizationPassKind::DeadRegisterEliminationPassKind; }
+    virtual bool changesCodeLayout() override { return true; }
+    virtual void run(ByteCodeOptimizer& optimizer) override
+    {
+        for (size_t i = 0; i < optimizer.instructionCount(); i++) {
+            ByteCodeOptimizer::Instruction& inst = optimizer.instruction(i);
+            if (inst.m_isRemoved) {
+                continue;
+            }
+            ByteCodeRegisterIndex dst;
+            if (inst.m_opcode == LoadLiteralOpcode) {
+                dst = optimizer.code<LoadLiteral>(i)->m_registerIndex;
+            } else if (inst.m_opcode == MoveOpcode) {
+                dst = optimizer.code<Move>(i)->m_registerIndex1;
+            } else {
+                continue;
+            }
+            if (!ByteCodeOptimizer::isTemporaryRegister(dst)) {
+                continue;
+            }
+            size_t next = optimizer.nextInstruction(i);
+            if (next != SIZE_MAX && optimizer.isTemporaryRegisterDeadFrom(next, dst)) {
+                optimizer.remove(i);
+            }
+        }
+    }
+};
+
+void ByteCodeOptimizer::optimize(ByteCodeLOCData* locData, ByteCodeOptimizerStatistics& statistics, uint32_t enabledPasses)
+{
+    size_t originalCodeSize = m_block->m_code.size();
+    decode();
+
+    JumpThreadingPass jumpThreading;
+    ConstantFoldingPass constantFolding;
+    CompareBranchFusionPass compareBranchFusion;
+    RedundantMoveEliminationPass redundantMoveElimination;
+    DeadRegisterEliminationPass deadRegisterElimination;
+    ByteCodeOptimizationPass* passes[] = {
+        &jumpThreading,
+        &constantFolding,
+        &compareBranchFusion,
+        &redundantMoveElimination,
+        &deadRegisterElimination
+    };
+
+    for (size_t i = 0; i < sizeof(passes) / sizeof(ByteCodeOptimizationPass*); i++) {
+        if (!(enabledPasses & (1u << passes[i]->kind())) || (passes[i]->changesCodeLayout() && !m_canChangeCodeLayout)) {
+            continue;
+        }
+        m_currentPass = passes[i]->kind();
+        passes[i]->run(*this);
+    }
+
+    if (m_hasLayoutChange || m_replacedCode.size()) {
+        compact(locData);
+    }
+
+    statistics.m_optimizedBlockCount++;
+    statistics.m_originalCodeSize += originalCodeSize;
+    statistics.m_optimizedCodeSize += m_block->m_code.size();
+    for (size_t i = 0; i < ByteCodeOptimizationPassKindEnd; i++) {
+        statistics.m_rewriteCount[i] += m_rewriteCount[i];
+        statistics.m_reducedCodeSize[i] += m_reducedCodeSize[i];
+    }
+}
+} // namespace Escargot
@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2021-present Samsung Electronics Co., Ltd
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+ */
+
+#ifndef __EscargotByteCodeOptimizer__
+#define __EscargotByteCodeOptimizer__
+
+namespace Escargot {
+
+class ByteCode;
+class ByteCodeBlock;
+class ByteCodeOptimizer;
+
+// <PassName, HumanName>
+#define FOR_EACH_BYTECODE_OPTIMIZATION_PASS(F)                   \
+    F(JumpThreading, "jump threading")                           \
+    F(ConstantFolding, "constant folding")                       \
+    F(CompareBranchFusion, "compare and branch fusion")          \
+    F(RedundantMoveElimination, "redundant move elimination")    \
+    F(DeadRegisterElimination, "dead register elimination")
+
+enum ByteCodeOptimizationPassKind {
+#define DECLARE_BYTECODE_OPTIMIZATION_PASS_KIND(name, humanName) name##PassKind,
+    FOR_EACH_BYTECODE_OPTIMIZATION_PASS(DECLARE_BYTECODE_OPTIMIZATION_PASS_KIND)
+#undef DECLARE_BYTECODE_OPTIMIZATION_PASS_KIND
+        ByteCodeOptimizationPassKindEnd
+};
+
+// bit (1 << ByteCodeOptimizationPassKind) of each enabled pass
+#define BYTECODE_OPTIMIZATION_ALL_PASSES ((1u << ByteCodeOptimizationPassKindEnd) - 1)
+
+struct ByteCodeOptimizerStatistics {
+    ByteCodeOptimizerStatistics()
+        : m_optimizedBlockCount(0)
+        , m_originalCodeSize(0)
+        , m_optimizedCodeSize(0)
+    {
+        for (size_t i = 0; i < ByteCodeOptimizationPassKindEnd; i++) {
+            m_rewriteCount[i] = 0;
+            m_reducedCodeSize[i] = 0;
+        }
+    }
+
+    void dump();
+
+    size_t m_optimizedBlockCount;
+    size_t m_originalCodeSize;
+    size_t m_optimizedCodeSize;
+    // number of rewritten or removed bytecodes of each pass
+    size_t m_rewriteCount[ByteCodeOptimizationPassKindEnd];
+    size_t m_reducedCodeSize[ByteCodeOptimizationPassKindEnd];
+};
+
+class ByteCodeOptimizationPass {
+public:
+    virtual ~ByteCodeOptimizationPass() {}
+
+    virtual ByteCodeOptimizationPassKind kind() = 0;
+    // passes which never change the size of bytecode can run on every ByteCodeBlock
+    virtual bool changesCodeLayout() = 0;
+    virtual void run(ByteCodeOptimizer& optimizer) = 0;
+};
+
+// Optimizes the bytecode stream of ByteCodeBlock before relocation
+// Every position (jump target, location info) is an offset into ByteCodeBlock::m_code while passes run
+// Passes remove or replace bytecodes through ByteCodeOptimizer, and the stream is compacted once at the end
+class ByteCodeOptimizer {
+public:
+    struct Instruction {
+        size_t m_position;
+        size_t m_length;
+        Opcode m_opcode;
+        bool m_isJumpTarget : 1;
+        bool m_isRemoved : 1;
+        // index into m_replacedCode or SIZE_MAX
+        size_t m_replacedCodeIndex;
+    };
+
+    ByteCodeOptimizer(ByteCodeBlock* block, const Value* numeralLiteralData, size_t numeralLiteralCount);
+
+    // optimize the bytecode stream of block and update location data (if exists) and statistics
+    // only passes whose bit is set in enabledPasses run
+    void optimize(ByteCodeLOCData* locData, ByteCodeOptimizerStatistics& statistics, uint32_t enabledPasses);
+
+    size_t instructionCount() const
+    {
+        return m_instructions.size();
+    }
+
+    Instruction& instruction(size_t index)
+    {
+        return m_instructions[index];
+    }
+
+    template <typename CodeType>
+    CodeType* code(size_t index)
+    {
+        const Instruction& inst = m_instructions[index];
+        if (inst.m_replacedCodeIndex != SIZE_MAX) {
+            return (CodeType*)m_replacedCode[inst.m_replacedCodeIndex].data();
+        }
+        return (CodeType*)(m_block->m_code.data() + inst.m_position);
+    }
+
+    template <typename CodeType>
+    void replace(size_t index, const CodeType& code)
+    {
+        Instruction& inst = m_instructions[index];
+        ASSERT(!inst.m_isRemoved);
+        ASSERT(m_canChangeCodeLayout);
+        std::vector<char> data((char*)&code, (char*)&code + sizeof(CodeType));
+        if (inst.m_replacedCodeIndex == SIZE_MAX) {
+            inst.m_replacedCodeIndex = m_replacedCode.size();
+            m_replacedCode.push_back(std::move(data));
+        } else {
+            m_replacedCode[inst.m_replacedCodeIndex] = std::move(data);
+        }
+        m_reducedCodeSize[m_currentPass] += inst.m_length;
+        m_reducedCodeSize[m_currentPass] -= sizeof(CodeType);
+        inst.m_length = sizeof(CodeType);
+        inst.m_opcode = opcodeOf((ByteCode*)m_replacedCode[inst.m_replacedCodeIndex].data());
+        m_rewriteCount[m_currentPass]++;
+    }
+
+    void remove(size_t index);
+    void countRewrite()
+    {
+        m_rewriteCount[m_currentPass]++;
+    }
+
+    // returns index of instruction which starts at the position
+    size_t instructionIndexAt(size_t position);
+    // returns the next instruction which is not removed or SIZE_MAX
+    size_t nextInstruction(size_t index);
+    // returns the previous instruction which is not removed or SIZE_MAX
+    size_t previousInstruction(size_t index);
+
+    bool isNumeralLiteralRegister(ByteCodeRegisterIndex index)
+    {
+        return index != REGISTER_LIMIT && index >= (REGULAR_REGISTER_LIMIT + VARIABLE_LIMIT) && index - (REGULAR_REGISTER_LIMIT + VARIABLE_LIMIT) < m_numeralLiteralCount;
+    }
+
+    const Value& numeralLiteral(ByteCodeRegisterIndex index)
+    {
+        ASSERT(isNumeralLiteralRegister(index));
+        return m_numeralLiteralData[index - (REGULAR_REGISTER_LIMIT + VARIABLE_LIMIT)];
+    }
+
+    static bool isTemporaryRegister(ByteCodeRegisterIndex index)
+    {
+        return index < REGULAR_REGISTER_LIMIT;
+    }
+
+    // check whether the value of temporary register is never read before overwritten
+    // when execution continues from the instruction of index
+    bool isTemporaryRegisterDeadFrom(size_t index, ByteCodeRegisterIndex reg);
+
+    static Opcode opcodeOf(ByteCode* code);
+    static ByteCodeLOC locOf(ByteCode* code);
+
+private:
+    void decode();
+    void compact(ByteCodeLOCData* locData);
+    bool isTemporaryRegisterDeadFrom(size_t index, ByteCodeRegisterIndex reg, size_t depth);
+
+    ByteCodeBlock* m_block;
+    const Value* m_numeralLiteralData;
+    size_t m_numeralLiteralCount;
+    // false if the block has bytecodes which remember code position except jumps
+    bool m_canChangeCodeLayout;
+    bool m_hasLayoutChange;
+    ByteCodeOptimizationPassKind m_currentPass;
+    std::vector<Instruction> m_instructions;
+    std::vector<std::vector<char>> m_replacedCode;
+    size_t m_rewriteCount[ByteCodeOptimizationPassKindEnd];
+    size_t m_reducedCodeSize[ByteCodeOptimizationPassKindEnd];
+};
+} // namespace Escargot
+
+#endif
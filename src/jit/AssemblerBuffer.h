@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2021-present Samsung Electronics Co., Ltd
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+ */
+
+#ifndef __EscargotAssemblerBuffer__
+#define __EscargotAssemblerBuffer__
+
+#if defined(ENABLE_JIT)
+
+#include "runtime/Value.h"
+
+namespace Escargot {
+
+enum class AssemblerCondition : uint8_t {
+    Equal,
+    NotEqual,
+    Below, // unsigned
+    AboveOrEqual, // unsigned
+    Above, // unsigned
+    BelowOrEqual, // unsigned
+    LessThan, // signed
+    GreaterThanOrEqual, // signed
+    GreaterThan, // signed
+    LessThanOrEqual, // signed
+    Overflow,
+};
+
+// position in the assembler buffer
+// every branch that refers to a label before it is bound is recorded and patched on bind
+class AssemblerLabel {
+public:
+    AssemblerLabel()
+        : m_offset(SIZE_MAX)
+    {
+    }
+
+    bool isBound() const
+    {
+        return m_offset != SIZE_MAX;
+    }
+
+    size_t offset() const
+    {
+        ASSERT(isBound());
+        return m_offset;
+    }
+
+private:
+    friend class AssemblerBuffer;
+    friend class MacroAssemblerX86_64;
+    friend class MacroAssemblerARM64;
+
+    size_t m_offset;
+    std::vector<size_t> m_unresolvedBranches;
+};
+
+class AssemblerBuffer {
+public:
+    AssemblerBuffer()
+    {
+        m_buffer.reserve(1024);
+    }
+
+    size_t size() const
+    {
+        return m_buffer.size();
+    }
+
+    const uint8_t* data() const
+    {
+        return m_buffer.data();
+    }
+
+protected:
+    void emit8(uint8_t value)
+    {
+        m_buffer.push_back(value);
+    }
+
+    void emit32(uint32_t value)
+    {
+        for (size_t i = 0; i < 4; i++) {
+            m_buffer.push_back((uint8_t)(value >> (i * 8)));
+        }
+    }
+
+    void emit64(uint64_t value)
+    {
+        emit32((uint32_t)value);
+        emit32((uint32_t)(value >> 32));
+    }
+
+    uint32_t read32(size_t offset) const
+    {
+        uint32_t value;
+        memcpy(&value, &m_buffer[offset], sizeof(uint32_t));
+        return value;
+    }
+
+    void write32(size_t offset, uint32_t value)
+    {
+        memcpy(&m_buffer[offset], &value, sizeof(uint32_t));
+    }
+
+    std::vector<uint8_t> m_buffer;
+};
+} // namespace Escargot
+
+#endif // ENABLE_JIT
+
+#endif
@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2021-present Samsung Electronics Co., Ltd
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+ */
+
+#if defined(ENABLE_JIT)
+
+#include "Escargot.h"
+#include "jit/JITCode.h"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace Escargot {
+
+JITCode* JITCode::create(const uint8_t* code, size_t codeSize, EntryPointVector&& entryPoints)
+{
+    size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+    size_t allocSize = (codeSize + pageSize - 1) & ~(pageSize - 1);
+
+    void* memory = mmap(nullptr, allocSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (UNLIKELY(memory == MAP_FAILED)) {
+        return nullptr;
+    }
+
+    memcpy(memory, code, codeSize);
+
+    // W^X: the memory is never writable and executable at the same time
+    if (UNLIKELY(mprotect(memory, allocSize, PROT_READ | PROT_EXEC) != 0)) {
+        munmap(memory, allocSize);
+        return nullptr;
+    }
+    __builtin___clear_cache((char*)memory, (char*)memory + codeSize);
+
+    return new JITCode(memory, allocSize, std::move(entryPoints));
+}
+
+JITCode::~JITCode()
+{
+    munmap(m_code, m_codeSize);
+}
+
+void* JITCode::entryAddress(size_t byteCodePosition) const
+{
+    auto iter = std::lower_bound(m_entryPoints.begin(), m_entryPoints.end(), std::make_pair(byteCodePosition, (size_t)0));
+    if (UNLIKELY(iter == m_entryPoints.end() || iter->first != byteCodePosition)) {
+        return nullptr;
+    }
+    return (char*)m_code + iter->second;
+}
+
+} // namespace Escargot
+
+#endif // ENABLE_JIT
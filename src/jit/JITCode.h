@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2021-present Samsung Electronics Co., Ltd
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+ */
+
+#ifndef __EscargotJITCode__
+#define __EscargotJITCode__
+
+#if defined(ENABLE_JIT)
+
+#include "runtime/Value.h"
+
+namespace Escargot {
+
+class ExecutionState;
+class ByteCodeBlock;
+
+// native frame shared between the generated code and JITOperations
+struct JITFrame {
+    JITFrame(ExecutionState* state, ByteCodeBlock* byteCodeBlock, Value* registerFile, size_t* programCounter)
+        : m_registerFile(registerFile)
+        , m_state(state)
+        , m_byteCodeBlock(byteCodeBlock)
+        , m_programCounter(programCounter)
+    {
+    }
+
+    Value* m_registerFile;
+    ExecutionState* m_state;
+    ByteCodeBlock* m_byteCodeBlock;
+    // points the programCounter of the interpreter to keep stack trace and generator state correct
+    size_t* m_programCounter;
+    // exception thrown inside of JITOperations is kept here and rethrown after leaving the generated code
+    std::exception_ptr m_exception;
+};
+
+// executable memory of a compiled ByteCodeBlock
+class JITCode {
+public:
+    // (bytecode position, native code offset) sorted by bytecode position
+    typedef std::vector<std::pair<size_t, size_t>> EntryPointVector;
+
+    // returns nullptr when executable memory is not available
+    static JITCode* create(const uint8_t* code, size_t codeSize, EntryPointVector&& entryPoints);
+    ~JITCode();
+
+    void* entryAddress(size_t byteCodePosition) const;
+
+    // returns the absolute program counter where the interpreter should resume
+    size_t execute(JITFrame* frame, void* entryAddress) const
+    {
+        typedef size_t (*JITFunction)(JITFrame*, void*);
+        return ((JITFunction)m_code)(frame, entryAddress);
+    }
+
+    size_t codeSize() const
+    {
+        return m_codeSize;
+    }
+
+private:
+    JITCode(void* code, size_t codeSize, EntryPointVector&& entryPoints)
+        : m_code(code)
+        , m_codeSize(codeSize)
+        , m_entryPoints(std::move(entryPoints))
+    {
+    }
+
+    void* m_code;
+    size_t m_codeSize;
+    EntryPointVector m_entryPoints;
+};
+} // namespace Escargot
+
+#endif // ENABLE_JIT
+
+#endif
@@ -0,0 +1,367 @@
+/*
+ * Copyright (c) 2021-present Samsung Electronics Co., Ltd
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+ */
+
+#if defined(ENABLE_JIT)
+
+#include "Escargot.h"
+#include "jit/JITCompiler.h"
+#include "jit/JITCode.h"
+#include "jit/JITOperations.h"
+#include "interpreter/ByteCode.h"
+#include "interpreter/ByteCodeGenerator.h"
+
+namespace Escargot {
+
+static JITOperation operationOf(Opcode opcode)
+{
+    switch (opcode) {
+#define RETURN_JIT_OPERATION(name) \
+    case name##Opcode:             \
+        return JITOperations::name##Operation;
+        FOR_EACH_JIT_OPERATION(RETURN_JIT_OPERATION)
+        FOR_EACH_JIT_CONDITION_OPERATION(RETURN_JIT_OPERATION)
+#undef RETURN_JIT_OPERATION
+    default:
+        return nullptr;
+    }
+}
+
+static Opcode opcodeOf(ByteCode* code)
+{
+    ASSERT(g_opcodeTable.m_opcodeMap.find(code->m_opcodeInAddress) != g_opcodeTable.m_opcodeMap.end());
+    return (Opcode)g_opcodeTable.m_opcodeMap.find(code->m_opcodeInAddress)->second;
+}
+
+void JITCompiler::tierUp(ExecutionState* state, ByteCodeBlock* byteCodeBlock, size_t& programCounter, Value* registerFile)
+{
+    if (UNLIKELY(byteCodeBlock->m_jitDisabled)) {
+        return;
+    }
+
+    if (!byteCodeBlock->m_jitCode) {
+        JITCompiler compiler(byteCodeBlock);
+        byteCodeBlock->m_jitCode = compiler.compile();
+        if (UNLIKELY(!byteCodeBlock->m_jitCode)) {
+            // interpreter stops counting hotness of this block
+            byteCodeBlock->m_jitDisabled = true;
+            return;
+        }
+    }
+
+    JITCode* jitCode = byteCodeBlock->m_jitCode;
+    void* entryAddress = jitCode->entryAddress(programCounter - (size_t)byteCodeBlock->m_code.data());
+    if (UNLIKELY(!entryAddress)) {
+        return;
+    }
+
+    JITFrame frame(state, byteCodeBlock, registerFile, &programCounter);
+    programCounter = jitCode->execute(&frame, entryAddress);
+    if (UNLIKELY(!!frame.m_exception)) {
+        std::rethrow_exception(frame.m_exception);
+    }
+}
+
+JITCompiler::JITCompiler(ByteCodeBlock* byteCodeBlock)
+    : m_byteCodeBlock(byteCodeBlock)
+    , m_codeBuffer(byteCodeBlock->m_code.data())
+{
+}
+
+JITCode* JITCompiler::compile()
+{
+    char* code = m_codeBuffer;
+    char* end = m_codeBuffer + m_byteCodeBlock->m_code.size();
+    while (code < end) {
+        ByteCode* currentCode = (ByteCode*)code;
+        Opcode opcode = opcodeOf(currentCode);
+        m_positions.push_back(code - m_codeBuffer);
+
+        if (opcode == ExecutionPauseOpcode) {
+            ExecutionPause* cd = (ExecutionPause*)currentCode;
+            if (cd->m_reason == ExecutionPause::Reason::Yield) {
+                code += cd->m_yieldData.m_tailDataLength;
+            } else if (cd->m_reason == ExecutionPause::Reason::Await) {
+                code += cd->m_awaitData.m_tailDataLength;
+            } else if (cd->m_reason == ExecutionPause::Reason::GeneratorsInitialize) {
+                code += cd->m_asyncGeneratorInitializeData.m_tailDataLength;
+            }
+        }
+
+        ASSERT(opcode <= EndOpcode);
+        code += byteCodeLengths[opcode];
+    }
+    m_labels.resize(m_positions.size());
+
+    JITCode::EntryPointVector entryPoints;
+    entryPoints.reserve(m_positions.size());
+
+    m_assembler.emitPrologue(offsetof(JITFrame, m_registerFile));
+    for (size_t i = 0; i < m_positions.size(); i++) {
+        m_assembler.bind(m_labels[i]);
+        entryPoints.push_back(std::make_pair(m_positions[i], m_assembler.size()));
+
+        ByteCode* currentCode = (ByteCode*)(m_codeBuffer + m_positions[i]);
+        if (!compileByteCode(currentCode, opcodeOf(currentCode), m_positions[i])) {
+            return nullptr;
+        }
+    }
+    m_assembler.bind(m_exitLabel);
+    m_assembler.emitEpilogue();
+
+    if (!MacroAssembler::canEncodeBranchesIn(m_assembler.size())) {
+        return nullptr;
+    }
+
+    return JITCode::create(m_assembler.data(), m_assembler.size(), std::move(entryPoints));
+}
+
+AssemblerLabel* JITCompiler::labelOf(size_t jumpPosition)
+{
+    size_t position = jumpPosition - (size_t)m_codeBuffer;
+    auto iter = std::lower_bound(m_positions.begin(), m_positions.end(), position);
+    if (iter == m_positions.end() || *iter != position) {
+        return nullptr;
+    }
+    return &m_labels[iter - m_positions.begin()];
+}
+
+void JITCompiler::emitExit(size_t byteCodePosition)
+{
+    m_assembler.move((uint64_t)(m_codeBuffer + byteCodePosition), MacroAssembler::returnValueRegister);
+    m_assembler.jump(m_exitLabel);
+}
+
+void JITCompiler::emitOperation(JITOperation operation, ByteCode* code)
+{
+    m_assembler.callOperation((void*)operation, code);
+    m_assembler.branch64(AssemblerCondition::NotEqual, MacroAssembler::returnValueRegister, 0, m_exitLabel);
+}
+
+void JITCompiler::emitConditionOperation(JITOperation operation, ByteCode* code, AssemblerLabel& target)
+{
+    m_assembler.callOperation((void*)operation, code);
+    m_assembler.branch64(AssemblerCondition::Above, MacroAssembler::returnValueRegister, 1, m_exitLabel);
+    m_assembler.branch64(AssemblerCondition::Equal, MacroAssembler::returnValueRegister, 1, target);
+}
+
+bool JITCompiler::compileByteCode(ByteCode* code, Opcode opcode, size_t position)
+{
+    MacroAssembler& masm = m_assembler;
+    const MacroAssembler::RegisterID regT0 = MacroAssembler::regT0;
+    const MacroAssembler::RegisterID regT1 = MacroAssembler::regT1;
+    const MacroAssembler::RegisterID regT2 = MacroAssembler::regT2;
+    AssemblerLabel slowCase;
+    AssemblerLabel done;
+
+    switch (opcode) {
+    case LoadLiteralOpcode: {
+        LoadLiteral* cd = (LoadLiteral*)code;
+        masm.move((uint64_t)cd->m_value.payload(), regT0);
+        masm.storeValue(regT0, cd->m_registerIndex);
+        return true;
+    }
+    case MoveOpcode: {
+        Move* cd = (Move*)code;
+        masm.loadValue(cd->m_registerIndex0, regT0);
+        masm.storeValue(regT0, cd->m_registerIndex1);
+        return true;
+    }
+    case JumpOpcode: {
+        AssemblerLabel* target = labelOf(((Jump*)code)->m_jumpPosition);
+        if (!target) {
+            return false;
+        }
+        masm.jump(*target);
+        return true;
+    }
+    case JumpIfTrueOpcode:
+    case JumpIfFalseOpcode: {
+        AssemblerLabel* target = labelOf(((Jump*)code)->m_jumpPosition);
+        if (!target) {
+            return false;
+        }
+        bool jumpIfTrue = opcode == JumpIfTrueOpcode;
+        masm.loadValue(jumpIfTrue ? ((JumpIfTrue*)code)->m_registerIndex : ((JumpIfFalse*)code)->m_registerIndex, regT0);
+        masm.branch64(AssemblerCondition::Equal, regT0, (int32_t)Value(true).payload(), jumpIfTrue ? *target : done);
+        masm.branch64(AssemblerCondition::Equal, regT0, (int32_t)Value(false).payload(), jumpIfTrue ? done : *target);
+        masm.branchIfNotInt32(regT0, slowCase);
+        masm.branchTest32(jumpIfTrue ? AssemblerCondition::NotEqual : AssemblerCondition::Equal, regT0, *target);
+        masm.jump(done);
+        masm.bind(slowCase);
+        emitConditionOperation(operationOf(opcode), code, *target);
+        masm.bind(done);
+        return true;
+    }
+    case JumpIfUndefinedOrNullOpcode: {
+        JumpIfUndefinedOrNull* cd = (JumpIfUndefinedOrNull*)code;
+        AssemblerLabel* target = labelOf(cd->m_jumpPosition);
+        if (!target) {
+            return false;
+        }
+        AssemblerLabel& undefinedOrNull = cd->m_shouldNegate ? done : *target;
+        masm.loadValue(cd->m_registerIndex, regT0);
+        masm.branch64(AssemblerCondition::Equal, regT0, (int32_t)Value(Value::Undefined).payload(), undefinedOrNull);
+        masm.branch64(AssemblerCondition::Equal, regT0, (int32_t)Value(Value::Null).payload(), undefinedOrNull);
+        if (cd->m_shouldNegate) {
+            masm.jump(*target);
+        }
+        masm.bind(done);
+        return true;
+    }
+    case JumpIfNotFulfilledOpcode: {
+        JumpIfNotFulfilled* cd = (JumpIfNotFulfilled*)code;
+        AssemblerLabel* target = labelOf(cd->m_jumpPosition);
+        if (!target) {
+            return false;
+        }
+        masm.loadValue(cd->m_leftIndex, regT0);
+        masm.loadValue(cd->m_rightIndex, regT1);
+        masm.branchIfNotInt32(regT0, slowCase);
+        masm.branchIfNotInt32(regT1, slowCase);
+        masm.branch32(cd->m_containEqual ? AssemblerCondition::GreaterThan : AssemblerCondition::GreaterThanOrEqual, regT0, regT1, *target);
+        masm.jump(done);
+        masm.bind(slowCase);
+        emitConditionOperation(operationOf(opcode), code, *target);
+        masm.bind(done);
+        return true;
+    }
+    case JumpIfEqualOpcode: {
+        JumpIfEqual* cd = (JumpIfEqual*)code;
+        AssemblerLabel* target = labelOf(cd->m_jumpPosition);
+        if (!target) {
+            return false;
+        }
+        masm.loadValue(cd->m_registerIndex0, regT0);
+        masm.loadValue(cd->m_registerIndex1, regT1);
+        masm.branchIfNotInt32(regT0, slowCase);
+        masm.branchIfNotInt32(regT1, slowCase);
+        masm.branch64(cd->m_shouldNegate ? AssemblerCondition::NotEqual : AssemblerCondition::Equal, regT0, regT1, *target);
+        masm.jump(done);
+        masm.bind(slowCase);
+        emitConditionOperation(operationOf(opcode), code, *target);
+        masm.bind(done);
+        return true;
+    }
+    case BinaryPlusOpcode:
+    case BinaryMinusOpcode:
+    case BinaryBitwiseAndOpcode:
+    case BinaryBitwiseOrOpcode:
+    case BinaryBitwiseXorOpcode:
+    case BinaryLessThanOpcode:
+    case BinaryLessThanOrEqualOpcode:
+    case BinaryGreaterThanOpcode:
+    case BinaryGreaterThanOrEqualOpcode:
+    case BinaryStrictEqualOpcode:
+    case BinaryNotStrictEqualOpcode: {
+        // every binary operation has the same layout
+        BinaryPlus* cd = (BinaryPlus*)code;
+        masm.loadValue(cd->m_srcIndex0, regT0);
+        masm.loadValue(cd->m_srcIndex1, regT1);
+        masm.branchIfNotInt32(regT0, slowCase);
+        masm.branchIfNotInt32(regT1, slowCase);
+
+        switch (opcode) {
+        case BinaryPlusOpcode:
+            masm.branchAdd32(regT1, regT0, slowCase);
+            masm.boxInt32(regT0);
+            masm.storeValue(regT0, cd->m_dstIndex);
+            break;
+        case BinaryMinusOpcode:
+            masm.branchSub32(regT1, regT0, slowCase);
+            masm.boxInt32(regT0);
+            masm.storeValue(regT0, cd->m_dstIndex);
+            break;
+        case BinaryBitwiseAndOpcode:
+            // number tag is kept by and, or
+            masm.and64(regT1, regT0);
+            masm.storeValue(regT0, cd->m_dstIndex);
+            break;
+        case BinaryBitwiseOrOpcode:
+            masm.or64(regT1, regT0);
+            masm.storeValue(regT0, cd->m_dstIndex);
+            break;
+        case BinaryBitwiseXorOpcode:
+            masm.xor32(regT1, regT0);
+            masm.boxInt32(regT0);
+            masm.storeValue(regT0, cd->m_dstIndex);
+            break;
+        default: {
+            AssemblerCondition condition;
+            if (opcode == BinaryLessThanOpcode) {
+                condition = AssemblerCondition::LessThan;
+            } else if (opcode == BinaryLessThanOrEqualOpcode) {
+                condition = AssemblerCondition::LessThanOrEqual;
+            } else if (opcode == BinaryGreaterThanOpcode) {
+                condition = AssemblerCondition::GreaterThan;
+            } else if (opcode == BinaryGreaterThanOrEqualOpcode) {
+                condition = AssemblerCondition::GreaterThanOrEqual;
+            } else if (opcode == BinaryStrictEqualOpcode) {
+                condition = AssemblerCondition::Equal;
+            } else {
+                ASSERT(opcode == BinaryNotStrictEqualOpcode);
+                condition = AssemblerCondition::NotEqual;
+            }
+            AssemblerLabel isTrue, store;
+            masm.branch32(condition, regT0, regT1, isTrue);
+            masm.move((uint64_t)Value(false).payload(), regT2);
+            masm.jump(store);
+            masm.bind(isTrue);
+            masm.move((uint64_t)Value(true).payload(), regT2);
+            masm.bind(store);
+            masm.storeValue(regT2, cd->m_dstIndex);
+            break;
+        }
+        }
+        masm.jump(done);
+        masm.bind(slowCase);
+        emitOperation(operationOf(opcode), code);
+        masm.bind(done);
+        return true;
+    }
+    case IncrementOpcode:
+    case DecrementOpcode: {
+        bool isIncrement = opcode == IncrementOpcode;
+        masm.loadValue(isIncrement ? ((Increment*)code)->m_srcIndex : ((Decrement*)code)->m_srcIndex, regT0);
+        masm.branchIfNotInt32(regT0, slowCase);
+        masm.branchAdd32(isIncrement ? 1 : -1, regT0, slowCase);
+        masm.boxInt32(regT0);
+        masm.storeValue(regT0, isIncrement ? ((Increment*)code)->m_dstIndex : ((Decrement*)code)->m_dstIndex);
+        masm.jump(done);
+        masm.bind(slowCase);
+        emitOperation(operationOf(opcode), code);
+        masm.bind(done);
+        return true;
+    }
+    default:
+        break;
+    }
+
+    JITOperation operation = operationOf(opcode);
+    if (operation) {
+        emitOperation(operation, code);
+    } else {
+        // leave the generated code and execute this bytecode in the interpreter
+        emitExit(position);
+    }
+    return true;
+}
+
+} // namespace Escargot
+
+#endif // ENABLE_JIT
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2021-present Samsung Electronics Co., Ltd
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+ */
+
+#ifndef __EscargotJITCompiler__
+#define __EscargotJITCompiler__
+
+#if defined(ENABLE_JIT)
+
+#ifndef OS_POSIX
+#error "JIT does not support OS other than POSIX"
+#endif
+
+#if !defined(CPU_X86_64) && !defined(CPU_ARM64)
+#error "JIT supports only x86-64 and AArch64"
+#endif
+
+#include "interpreter/ByteCode.h"
+#include "jit/MacroAssembler.h"
+#include "jit/JITOperations.h"
+
+namespace Escargot {
+
+class ExecutionState;
+class ByteCodeBlock;
+class ByteCode;
+class JITCode;
+struct JITFrame;
+
+// baseline template compiler
+// every bytecode is translated into a fixed machine code template. simple int32 cases are inlined,
+// other cases call JITOperations, and bytecodes which change the execution state of the interpreter
+// (try, lexical environment, generator, return...) leave the generated code and resume the interpreter.
+class JITCompiler {
+public:
+    // called by the interpreter when byteCodeBlock becomes hot
+    // it compiles byteCodeBlock for the first time and runs the generated code from programCounter
+    // programCounter is updated to the position where the interpreter should resume
+    static void tierUp(ExecutionState* state, ByteCodeBlock* byteCodeBlock, size_t& programCounter, Value* registerFile);
+
+private:
+    explicit JITCompiler(ByteCodeBlock* byteCodeBlock);
+
+    JITCode* compile();
+    bool compileByteCode(ByteCode* code, Opcode opcode, size_t position);
+
+    AssemblerLabel* labelOf(size_t jumpPosition);
+
+    void emitExit(size_t byteCodePosition);
+    void emitOperation(JITOperation operation, ByteCode* code);
+    void emitConditionOperation(JITOperation operation, ByteCode* code, AssemblerLabel& target);
+
+    ByteCodeBlock* m_byteCodeBlock;
+    char* m_codeBuffer;
+    MacroAssembler m_assembler;
+    // start position of every bytecode and its label
+    std::vector<size_t> m_positions;
+    std::vector<AssemblerLabel> m_labels;
+    AssemblerLabel m_exitLabel;
+};
+} // namespace Escargot
+
+#endif // ENABLE_JIT
+
+#endif
@@ -0,0 +1,523 @@
+/*
+ * Copyright (c) 2021-present Samsung Electronics Co., Ltd
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+ */
+
+#if defined(ENABLE_JIT)
+
+#include "Escargot.h"
+#include "jit/JITOperations.h"
+#include "jit/JITCode.h"
+#include "interpreter/ByteCode.h"
+#include "interpreter/ByteCodeInterpreter.h"
+#include "runtime/Context.h"
+#include "runtime/Environment.h"
+#include "runtime/EnvironmentRecord.h"
+#include "runtime/ErrorObject.h"
+#include "runtime/ArrayObject.h"
+#include "runtime/TypedArrayObject.h"
+#include "runtime/TypedArrayInlines.h"
+#include "CheckedArithmetic.h"
+
+namespace Escargot {
+
+// every JITOperation stores its program counter before the execution,
+// so stack traces and nested execution states see the same state as the interpreter.
+// C++ exceptions cannot unwind the generated code, so they are kept in the JITFrame
+// and the interpreter rethrows them after the generated code returns.
+#define JIT_OPERATION_BEGIN(CodeType)                                              \
+    size_t JITOperations::CodeType##Operation(JITFrame* frame, ByteCode* byteCode) \
+    {                                                                              \
+        CodeType* code = (CodeType*)byteCode;                                      \
+        ExecutionState& state = *frame->m_state;                                   \
+        Value* registerFile = frame->m_registerFile;                               \
+        UNUSED_VARIABLE(state);                                                    \
+        UNUSED_VARIABLE(registerFile);                                             \
+        *frame->m_programCounter = (size_t)code;                                   \
+        try {
+#define JIT_OPERATION_END()                            \
+    }                                                  \
+    catch (...)                                        \
+    {                                                  \
+        frame->m_exception = std::current_exception(); \
+        return *frame->m_programCounter;               \
+    }                                                  \
+    return 0;                                          \
+    }
+
+JIT_OPERATION_BEGIN(BinaryPlus)
+{
+    const Value& v0 = registerFile[code->m_srcIndex0];
+    const Value& v1 = registerFile[code->m_srcIndex1];
+    if (v0.isNumber() && v1.isNumber()) {
+        // int32 overflow falls into here too
+        registerFile[code->m_dstIndex] = Value(v0.asNumber() + v1.asNumber());
+    } else {
+        registerFile[code->m_dstIndex] = ByteCodeInterpreter::plusSlowCase(state, v0, v1);
+    }
+}
+JIT_OPERATION_END()
+
+JIT_OPERATION_BEGIN(BinaryMinus)
+{
+    const Value& left = registerFile[code->m_srcIndex0];
+    const Value& right = registerFile[code->m_srcIndex1];
+    if (LIKELY(left.isNumber() && right.isNumber())) {
+        registerFile[code->m_dstIndex] = Value(left.asNumber() - right.asNumber());
+    } else {
+        registerFile[code->m_dstIndex] = ByteCodeInterpreter::minusSlowCase(state, left, right);
+    }
+}
+JIT_OPERATION_END()
+
+JIT_OPERATION_BEGIN(BinaryMultiply)
+{
+    const Value& left = registerFile[code->m_srcIndex0];
+    const Value& right = registerFile[code->m_srcIndex1];
+    Value ret(Value::ForceUninitialized);
+    if (left.isInt32() && right.isInt32()) {
+        int32_t a = left.asInt32();
+        int32_t b = right.asInt32();
+        if (UNLIKELY((!a || !b) && (a >> 31 || b >> 31))) { // -1 * 0 should be treated as -0, not +0
+            ret = Value(left.asNumber() * right.asNumber());
+        } else {
+            int32_t c;
+            bool result = ArithmeticOperations<int32_t, int32_t, int32_t>::multiply(a, b, c);
+            if (LIKELY(result)) {
+                ret = Value(c);
+            } else {
+                ret = Value(Value::EncodeAsDouble, a * (double)b);
+            }
+        }
+    } else if (LIKELY(left.isNumber() && right.isNumber())) {
+        ret = Value(Value::EncodeAsDouble, left.asNumber() * right.asNumber());
+    } else {
+        ret = ByteCodeInterpreter::multiplySlowCase(state, left, right);
+    }
+    registerFile[code->m_dstIndex] = ret;
+}
+JIT_OPERATION_END()
+
+JIT_OPERATION_BEGIN(BinaryDivision)
+{
+    const Value& left = registerFile[code->m_srcIndex0];
+    const Value& right = registerFile[code->m_srcIndex1];
+    if (LIKELY(left.isNumber() && right.isNumber())) {
+        registerFile[code->m_dstIndex] = Value(left.asNumber() / right.asNumber());
+    } else {
+        registerFile[code->m_dstIndex] = ByteCodeInterpreter::divisionSlowCase(state, left, right);
+    }
+}
+JIT_OPERATION_END()
+
+JIT_OPERATION_BEGIN(BinaryMod)
+{
+    registerFile[code->m_dstIndex] = ByteCodeInterpreter::modOperation(state, registerFile[code->m_srcIndex0], registerFile[code->m_srcIndex1]);
+}
+JIT_OPERATION_END()
+
+JIT_OPERATION_BEGIN(BinaryExponentiation)
+{
+    registerFile[code->m_dstIndex] = ByteCodeInterpreter::exponentialOperation(state, registerFile[code->m_srcIndex0], registerFile[code->m_srcIndex1]);
+}
+JIT_OPERATION_END()
+
+JIT_OPERATION_BEGIN(BinaryEqual)
+{
+    registerFile[code->m_dstIndex] = Value(registerFile[code->m_srcIndex0].abstractEqualsTo(state, registerFile[code->m_srcIndex1]));
+}
+JIT_OPERATION_END()
+
+JIT_OPERATION_BEGIN(BinaryNotEqual)
+{
+    registerFile[code->m_dstIndex] = Value(!registerFile[code->m_srcIndex0].abstractEqualsTo(state, registerFile[code->m_srcIndex1]));
+}
+JIT_OPERATION_END()
+
+JIT_OPERATION_BEGIN(BinaryStrictEqual)
+{
+    registerFile[code->m_dstIndex] = Value(registerFile[code->m_srcIndex0].equalsTo(state, registerFile[code->m_srcIndex1]));
+}
+JIT_OPERATION_END()
+
+JIT_OPERATION_BEGIN(BinaryNotStrictEqual)
+{
+    registerFile[code->m_dstIndex] = Value(!registerFile[code->m_srcIndex0].equalsTo(state, registerFile[code->m_srcIndex1]));
+}
+JIT_OPERATION_END()
+
+// the int32 case is handled in the generated code, so the slow cases which cover every other type are called directly
+JIT_OPERATION_BEGIN(BinaryLessThan)
+{
+    registerFile[code->m_dstIndex] = Value(ByteCodeInterpreter::abstractLeftIsLessThanRightSlowCase(state, registerFile[code->m_srcIndex0], registerFile[code->m_srcIndex1], false));
+}
+JIT_OPERATION_END()
+
+JIT_OPERATION_BEGIN(BinaryLessThanOrEqual)
+{
+    registerFile[code->m_dstIndex] = Value(ByteCodeInterpreter::abstractLeftIsLessThanEqualRightSlowCase(state, registerFile[code->m_srcIndex0], registerFile[code->m_srcIndex1], false));
+}
+JIT_OPERATION_END()
+
+JIT_OPERATION_BEGIN(BinaryGreaterThan)
+{
+    registerFile[code->m_dstIndex] = Value(ByteCodeInterpreter::abstractLeftIsLessThanRightSlowCase(state, registerFile[code->m_srcIndex1], registerFile[code->m_srcIndex0], true));
+}
+JIT_OPERATION_END()
+
+JIT_OPERATION_BEGIN(BinaryGreaterThanOrEqual)
+{
+    registerFile[code->m_dstIndex] = Value(ByteCodeInterpreter::abstractLeftIsLessThanEqualRightSlowCase(state, registerFile[code->m_srcIndex1], registerFile[code->m_srcIndex0], true));
+}
+JIT_OPERATION_END()
+
+JIT_OPERATION_BEGIN(BinaryBitwiseAnd)
+{
+    registerFile[code->m_dstIndex] = ByteCodeInterpreter::bitwiseOperationSlowCase(state, registerFile[code->m_srcIndex0], registerFile[code->m_srcIndex1], ByteCodeInterpreter::BitwiseOperationKind::And);
+}
+JIT_OPERATION_END()
+
+JIT_OPERATION_BEGIN(BinaryBitwiseOr)
+{
+    registerFile[code->m_dstIndex] = ByteCodeInterpreter::bitwiseOperationSlowCase(state, registerFile[code->m_srcIndex0], registerFile[code->m_srcIndex1], ByteCodeInterpreter::BitwiseOperationKind::Or);
+}
+JIT_OPERATION_END()
+
+JIT_OPERATION_BEGIN(BinaryBitwiseXor)
+{
+    registerFile[code->m_dstIndex] = ByteCodeInterpreter::bitwiseOperationSlowCase(state, registerFile[code->m_srcIndex0], registerFile[code->m_srcIndex1], ByteCodeInterpreter::BitwiseOperationKind::Xor);
+}
+JIT_OPERATION_END()
+
+JIT_OPERATION_BEGIN(BinaryLeftShift)
+{
+    const Value& left = registerFile[code->m_srcIndex0];
+    const Value& right = registerFile[code->m_srcIndex1];
+    if (left.isInt32() && right.isInt32()) {
+        int32_t lnum = left.asInt32();
+        lnum <<= ((unsigned int)right.asInt32()) & 0x1F;
+        registerFile[code->m_dstIndex] = Value(lnum);
+    } else {
+        registerFile[code->m_dstIndex] = ByteCodeInterpreter::shiftOperationSlowCase(state, left, right, ByteCodeInterpreter::ShiftOperationKind::Left);
+    }
+}
+JIT_OPERATION_END()
+
+JIT_OPERATION_BEGIN(BinarySignedRightShift)
+{
+    const Value& left = registerFile[code->m_srcIndex0];
+    const Value& right = registerFile[code->m_srcIndex1];
+    if (left.isInt32() && right.isInt32()) {
+        int32_t lnum = left.asInt32();
+        lnum >>= ((unsigned int)right.asInt32()) & 0x1F;
+        registerFile[code->m_dstIndex] = Value(lnum);
+    } else {
+        registerFile[code->m_dstIndex] = ByteCodeInterpreter::shiftOperationSlowCase(state, left, right, ByteCodeInterpreter::ShiftOperationKind::SignedRight);
+    }
+}
+JIT_OPERATION_END()
+
+JIT_OPERATION_BEGIN(BinaryUnsignedRightShift)
+{
+    const Value& left = registerFile[code->m_srcIndex0];
+    const Value& right = registerFile[code->m_srcIndex1];
+    if (left.isUInt32() && right.isUInt32()) {
+        uint32_t lnum = left.asUInt32();
+        lnum = lnum >> (right.asUInt32() & 0x1F);
+        registerFile[code->m_dstIndex] = Value(lnum);
+    } else {
+        registerFile[code->m_dstIndex] = ByteCodeInterpreter::shiftOperationSlowCase(state, left, right, ByteCodeInterpreter::ShiftOperationKind::UnsignedRight);
+    }
+}
+JIT_OPERATION_END()
+
+JIT_OPERATION_BEGIN(Increment)
+{
+    registerFile[code->m_dstIndex] = ByteCodeInterpreter::incrementOperationSlowCase(state, registerFile[code->m_srcIndex]);
+}
+JIT_OPERATION_END()
+
+JIT_OPERATION_BEGIN(Decrement)
+{
+    registerFile[code->m_dstIndex] = ByteCodeInterpreter::decrementOperationSlowCase(state, registerFile[code->m_srcIndex]);
+}
+JIT_OPERATION_END()
+
+JIT_OPERATION_BEGIN(ToNumber)
+{
+    registerFile[code->m_dstIndex] = Value(registerFile[code->m_srcIndex].toNumber(state));
+}
+JIT_OPERATION_END()
+
+JIT_OPERATION_BEGIN(UnaryMinus)
+{
+    const Value& val = registerFile[code->m_srcIndex];
+    if (UNLIKELY(val.isPointerValue())) {
+        registerFile[code->m_dstIndex] = ByteCodeInterpreter::unaryMinusSlowCase(state, val);
+    } else {
+        registerFile[code->m_dstIndex] = Value(-val.toNumber(state));
+    }
+}
+JIT_OPERATION_END()
+
+JIT_OPERATION_BEGIN(UnaryNot)
+{
+    registerFile[code->m_dstIndex] = Value(!registerFile[code->m_srcIndex].toBoolean(state));
+}
+JIT_OPERATION_END()
+
+JIT_OPERATION_BEGIN(UnaryBitwiseNot)
+{
+    const Value& val = registerFile[code->m_srcIndex];
+    if (val.isInt32()) {
+        registerFile[code->m_dstIndex] = Value(~val.asInt32());
+    } else {
+        registerFile[code->m_dstIndex] = ByteCodeInterpreter::bitwiseNotOperationSlowCase(state, val);
+    }
+}
+JIT_OPERATION_END()
+
+JIT_OPERATION_BEGIN(UnaryTypeof)
+{
+    ByteCodeInterpreter::unaryTypeof(state, code, registerFile);
+}
+JIT_OPERATION_END()
+
+JIT_OPERATION_BEGIN(GetParameter)
+{
+    if (code->m_paramIndex < state.argc()) {
+        registerFile[code->m_registerIndex] = state.argv()[code->m_paramIndex];
+    } else {
+        registerFile[code->m_registerIndex] = Value();
+    }
+}
+JIT_OPERATION_END()
+
+JIT_OPERATION_BEGIN(GetObject)
+{
+    const Value& willBeObject = registerFile[code->m_objectRegisterIndex];
+    const Value& property = registerFile[code->m_propertyRegisterIndex];
+    PointerValue* v;
+    if (LIKELY(willBeObject.isObject() && (v = willBeObject.asPointerValue())->isArrayObject())) {
+        ArrayObject* arr = (ArrayObject*)v;
+        if (LIKELY(arr->isFastModeArray())) {
+            uint32_t idx = property.tryToUseAsArrayIndex(state);
+            if (LIKELY(idx != Value::InvalidArrayIndexValue) && LIKELY(idx < arr->arrayLength(state))) {
+                Value v = arr->getFastModeValue(idx);
+                if (LIKELY(!v.isEmpty())) {
+                    registerFile[code->m_storeRegisterIndex] = v;
+                    return 0;
+                }
+            }
+        }
+    } else if (code->m_inlineCache && willBeObject.isObject() && v->getTag() == code->m_inlineCache->m_typedArrayTag && property.isUInt32()) {
+        TypedArrayObject* arr = (TypedArrayObject*)v;
+        uint32_t idx = property.asUInt32();
+        if (LIKELY(idx < arr->arrayLength() && !arr->buffer()->isDetachedBuffer())) {
+            TypedArrayType type = code->m_inlineCache->m_typedArrayType;
+            registerFile[code->m_storeRegisterIndex] = TypedArrayHelper::rawBytesToNumber(state, type, arr->rawBuffer() + idx * TypedArrayHelper::elementSize(type));
+            return 0;
+        }
+    }
+    ByteCodeInterpreter::getObjectOpcodeSlowCase(state, code, registerFile, frame->m_byteCodeBlock);
+}
+JIT_OPERATION_END()
+
+JIT_OPERATION_BEGIN(SetObjectOperation)
+{
+    const Value& willBeObject = registerFile[code->m_objectRegisterIndex];
+    const Value& property = registerFile[code->m_propertyRegisterIndex];
+    if (LIKELY(willBeObject.isObject() && (willBeObject.asPointerValue())->isArrayObject())) {
+        ArrayObject* arr = willBeObject.asObject()->asArrayObject();
+        uint32_t idx = property.tryToUseAsArrayIndex(state);
+        if (LIKELY(arr->isFastModeArray()) && LIKELY(idx != Value::InvalidArrayIndexValue)) {
+            uint32_t len = arr->arrayLength(state);
+            if (LIKELY(idx < len) || (arr->isExtensible(state) && arr->setArrayLength(state, idx + 1) && arr->isFastModeArray())) {
+                arr->setFastModeValue(idx, registerFile[code->m_loadRegisterIndex]);
+                return 0;
+            }
+        }
+    } else if (code->m_inlineCache && willBeObject.isObject() && willBeObject.asPointerValue()->getTag() == code->m_inlineCache->m_typedArrayTag
+               && property.isUInt32() && registerFile[code->m_loadRegisterIndex].isNumber()) {
+        TypedArrayObject* arr = willBeObject.asPointerValue()->asTypedArrayObject();
+        uint32_t idx = property.asUInt32();
+        if (LIKELY(idx < arr->arrayLength() && !arr->buffer()->isDetachedBuffer())) {
+            TypedArrayType type = code->m_inlineCache->m_typedArrayType;
+            TypedArrayHelper::numberToRawBytes(state, type, registerFile[code->m_loadRegisterIndex], arr->rawBuffer() + idx * TypedArrayHelper::elementSize(type));
+            return 0;
+        }
+    }
+    ByteCodeInterpreter::setObjectOpcodeSlowCase(state, code, registerFile, frame->m_byteCodeBlock);
+}
+JIT_OPERATION_END()
+
+JIT_OPERATION_BEGIN(GetObjectPreComputedCase)
+{
+    registerFile[code->m_storeRegisterIndex] = ByteCodeInterpreter::getObjectPrecomputedCaseOperationForJIT(state, registerFile[code->m_objectRegisterIndex], code, frame->m_byteCodeBlock);
+}
+JIT_OPERATION_END()
+
+JIT_OPERATION_BEGIN(SetObjectPreComputedCase)
+{
+    ByteCodeInterpreter::setObjectPreComputedCaseOperationForJIT(state, registerFile[code->m_objectRegisterIndex], registerFile[code->m_loadRegisterIndex], code, frame->m_byteCodeBlock);
+}
+JIT_OPERATION_END()
+
+JIT_OPERATION_BEGIN(GetGlobalVariable)
+{
+    registerFile[code->m_registerIndex] = ByteCodeInterpreter::getGlobalVariableForJIT(state, code->m_slot, frame->m_byteCodeBlock);
+}
+JIT_OPERATION_END()
+
+JIT_OPERATION_BEGIN(SetGlobalVariable)
+{
+    ByteCodeInterpreter::setGlobalVariableForJIT(state, code->m_slot, registerFile[code->m_registerIndex], frame->m_byteCodeBlock);
+}
+JIT_OPERATION_END()
+
+JIT_OPERATION_BEGIN(LoadByName)
+{
+    registerFile[code->m_registerIndex] = ByteCodeInterpreter::loadByName(state, state.lexicalEnvironment(), code->m_name);
+}
+JIT_OPERATION_END()
+
+JIT_OPERATION_BEGIN(StoreByName)
+{
+    ByteCodeInterpreter::storeByName(state, state.lexicalEnvironment(), code->m_name, registerFile[code->m_registerIndex]);
+}
+JIT_OPERATION_END()
+
+JIT_OPERATION_BEGIN(LoadByHeapIndex)
+{
+    LexicalEnvironment* upperEnv = state.lexicalEnvironment();
+    for (size_t i = 0; i < code->m_upperIndex; i++) {
+        upperEnv = upperEnv->outerEnvironment();
+    }
+    registerFile[code->m_registerIndex] = upperEnv->record()->asDeclarativeEnvironmentRecord()->getHeapValueByIndex(state, code->m_index);
+}
+JIT_OPERATION_END()
+
+JIT_OPERATION_BEGIN(StoreByHeapIndex)
+{
+    LexicalEnvironment* upperEnv = state.lexicalEnvironment();
+    for (size_t i = 0; i < code->m_upperIndex; i++) {
+        upperEnv = upperEnv->outerEnvironment();
+    }
+    upperEnv->record()->setMutableBindingByIndex(state, code->m_index, registerFile[code->m_registerIndex]);
+}
+JIT_OPERATION_END()
+
+JIT_OPERATION_BEGIN(LoadThisBinding)
+{
+    EnvironmentRecord* envRec = state.getThisEnvironment();
+    ASSERT(envRec->isDeclarativeEnvironmentRecord() && envRec->asDeclarativeEnvironmentRecord()->isFunctionEnvironmentRecord());
+    registerFile[code->m_dstIndex] = envRec->asDeclarativeEnvironmentRecord()->asFunctionEnvironmentRecord()->getThisBinding(state);
+}
+JIT_OPERATION_END()
+
+JIT_OPERATION_BEGIN(CreateObject)
+{
+    registerFile[code->m_registerIndex] = new Object(state);
+#if defined(ESCARGOT_SMALL_CONFIG)
+    registerFile[code->m_registerIndex].asObject()->markThisObjectDontNeedStructureTransitionTable();
+#endif
+}
+JIT_OPERATION_END()
+
+JIT_OPERATION_BEGIN(CreateArray)
+{
+    registerFile[code->m_registerIndex] = new ArrayObject(state, (uint64_t)code->m_length);
+}
+JIT_OPERATION_END()
+
+JIT_OPERATION_BEGIN(CreateFunction)
+{
+    ByteCodeInterpreter::createFunctionOperation(state, code, frame->m_byteCodeBlock, registerFile);
+}
+JIT_OPERATION_END()
+
+JIT_OPERATION_BEGIN(ObjectDefineOwnPropertyOperation)
+{
+    ByteCodeInterpreter::objectDefineOwnPropertyOperation(state, code, registerFile);
+}
+JIT_OPERATION_END()
+
+JIT_OPERATION_BEGIN(ArrayDefineOwnPropertyOperation)
+{
+    ByteCodeInterpreter::arrayDefineOwnPropertyOperation(state, code, registerFile);
+}
+JIT_OPERATION_END()
+
+JIT_OPERATION_BEGIN(CallFunction)
+{
+    const Value& callee = registerFile[code->m_calleeIndex];
+    if (UNLIKELY(!callee.isPointerValue())) {
+        ErrorObject::throwBuiltinError(state, ErrorObject::TypeError, ErrorObject::Messages::NOT_Callable);
+    }
+    registerFile[code->m_resultIndex] = callee.asPointerValue()->call(state, Value(), code->m_argumentCount, &registerFile[code->m_argumentsStartIndex]);
+}
+JIT_OPERATION_END()
+
+JIT_OPERATION_BEGIN(CallFunctionWithReceiver)
+{
+    const Value& callee = registerFile[code->m_calleeIndex];
+    if (UNLIKELY(!callee.isPointerValue())) {
+        ErrorObject::throwBuiltinError(state, ErrorObject::TypeError, ErrorObject::Messages::NOT_Callable);
+    }
+    registerFile[code->m_resultIndex] = callee.asPointerValue()->call(state, registerFile[code->m_receiverIndex], code->m_argumentCount, &registerFile[code->m_argumentsStartIndex]);
+}
+JIT_OPERATION_END()
+
+JIT_OPERATION_BEGIN(NewOperation)
+{
+    registerFile[code->m_resultIndex] = ByteCodeInterpreter::constructOperation(state, registerFile[code->m_calleeIndex], code->m_argumentCount, &registerFile[code->m_argumentsStartIndex]);
+}
+JIT_OPERATION_END()
+
+JIT_OPERATION_BEGIN(JumpIfTrue)
+{
+    return registerFile[code->m_registerIndex].toBoolean(state) ? 1 : 0;
+}
+JIT_OPERATION_END()
+
+JIT_OPERATION_BEGIN(JumpIfFalse)
+{
+    return registerFile[code->m_registerIndex].toBoolean(state) ? 0 : 1;
+}
+JIT_OPERATION_END()
+
+JIT_OPERATION_BEGIN(JumpIfNotFulfilled)
+{
+    const Value& left = registerFile[code->m_leftIndex];
+    const Value& right = registerFile[code->m_rightIndex];
+    bool result = code->m_containEqual ? ByteCodeInterpreter::abstractLeftIsLessThanEqualRightSlowCase(state, left, right, code->m_switched) : ByteCodeInterpreter::abstractLeftIsLessThanRightSlowCase(state, left, right, code->m_switched);
+    return result ? 0 : 1;
+}
+JIT_OPERATION_END()
+
+JIT_OPERATION_BEGIN(JumpIfEqual)
+{
+    const Value& left = registerFile[code->m_registerIndex0];
+    const Value& right = registerFile[code->m_registerIndex1];
+    bool result = code->m_isStrict ? left.equalsTo(state, right) : left.abstractEqualsTo(state, right);
+    return (result ^ code->m_shouldNegate) ? 1 : 0;
+}
+JIT_OPERATION_END()
+
+} // namespace Escargot
+
+#endif // ENABLE_JIT
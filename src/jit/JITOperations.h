@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2021-present Samsung Electronics Co., Ltd
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+ */
+
+#ifndef __EscargotJITOperations__
+#define __EscargotJITOperations__
+
+#if defined(ENABLE_JIT)
+
+namespace Escargot {
+
+struct JITFrame;
+class ByteCode;
+
+typedef size_t (*JITOperation)(JITFrame* frame, ByteCode* byteCode);
+
+// bytecodes which are executed by calling a JITOperation from the generated code
+// every operation returns 0 when the execution can continue in the generated code
+// otherwise it returns the absolute program counter where the interpreter should resume
+#define FOR_EACH_JIT_OPERATION(F)       \
+    F(BinaryPlus)                       \
+    F(BinaryMinus)                      \
+    F(BinaryMultiply)                   \
+    F(BinaryDivision)                   \
+    F(BinaryMod)                        \
+    F(BinaryExponentiation)             \
+    F(BinaryEqual)                      \
+    F(BinaryNotEqual)                   \
+    F(BinaryStrictEqual)                \
+    F(BinaryNotStrictEqual)             \
+    F(BinaryLessThan)                   \
+    F(BinaryLessThanOrEqual)            \
+    F(BinaryGreaterThan)                \
+    F(BinaryGreaterThanOrEqual)         \
+    F(BinaryBitwiseAnd)                 \
+    F(BinaryBitwiseOr)                  \
+    F(BinaryBitwiseXor)                 \
+    F(BinaryLeftShift)                  \
+    F(BinarySignedRightShift)           \
+    F(BinaryUnsignedRightShift)         \
+    F(Increment)                        \
+    F(Decrement)                        \
+    F(ToNumber)                         \
+    F(UnaryMinus)                       \
+    F(UnaryNot)                         \
+    F(UnaryBitwiseNot)                  \
+    F(UnaryTypeof)                      \
+    F(GetParameter)                     \
+    F(GetObject)                        \
+    F(SetObjectOperation)               \
+    F(GetObjectPreComputedCase)         \
+    F(SetObjectPreComputedCase)         \
+    F(GetGlobalVariable)                \
+    F(SetGlobalVariable)                \
+    F(LoadByName)                       \
+    F(StoreByName)                      \
+    F(LoadByHeapIndex)                  \
+    F(StoreByHeapIndex)                 \
+    F(LoadThisBinding)                  \
+    F(CreateObject)                     \
+    F(CreateArray)                      \
+    F(CreateFunction)                   \
+    F(ObjectDefineOwnPropertyOperation) \
+    F(ArrayDefineOwnPropertyOperation)  \
+    F(CallFunction)                     \
+    F(CallFunctionWithReceiver)         \
+    F(NewOperation)
+
+// conditional jumps whose operation returns 1 when the jump is taken, 0 when it is not
+#define FOR_EACH_JIT_CONDITION_OPERATION(F) \
+    F(JumpIfTrue)                           \
+    F(JumpIfFalse)                          \
+    F(JumpIfNotFulfilled)                   \
+    F(JumpIfEqual)
+
+class JITOperations {
+public:
+#define DECLARE_JIT_OPERATION(name) \
+    static size_t name##Operation(JITFrame* frame, ByteCode* byteCode);
+    FOR_EACH_JIT_OPERATION(DECLARE_JIT_OPERATION)
+    FOR_EACH_JIT_CONDITION_OPERATION(DECLARE_JIT_OPERATION)
+#undef DECLARE_JIT_OPERATION
+};
+} // namespace Escargot
+
+#endif // ENABLE_JIT
+
+#endif
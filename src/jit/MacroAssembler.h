@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2021-present Samsung Electronics Co., Ltd
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+ */
+
+#ifndef __EscargotMacroAssembler__
+#define __EscargotMacroAssembler__
+
+#if defined(ENABLE_JIT)
+
+#if defined(CPU_X86_64)
+#include "jit/MacroAssemblerX86_64.h"
+#elif defined(CPU_ARM64)
+#include "jit/MacroAssemblerARM64.h"
+#endif
+
+namespace Escargot {
+
+#if defined(CPU_X86_64)
+typedef MacroAssemblerX86_64 MacroAssembler;
+#elif defined(CPU_ARM64)
+typedef MacroAssemblerARM64 MacroAssembler;
+#endif
+
+} // namespace Escargot
+
+#endif // ENABLE_JIT
+
+#endif
@@ -0,0 +1,318 @@
+/*
+ * Copyright (c) 2021-present Samsung Electronics Co., Ltd
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+ */
+
+#ifndef __EscargotMacroAssemblerARM64__
+#define __EscargotMacroAssemblerARM64__
+
+#if defined(ENABLE_JIT) && defined(CPU_ARM64)
+
+#include "jit/AssemblerBuffer.h"
+
+namespace Escargot {
+
+// AAPCS64
+// x19, x20 and x21 are callee-saved, so they keep the JITFrame, the register file and the number tag across operation calls
+class MacroAssemblerARM64 : public AssemblerBuffer {
+public:
+    enum RegisterID : uint8_t {
+        x0 = 0,
+        x1,
+        x2,
+        x16 = 16,
+        x19 = 19,
+        x20,
+        x21,
+        x22,
+        x29 = 29,
+        x30,
+        sp = 31,
+        xzr = 31,
+    };
+
+    static constexpr RegisterID regT0 = x0;
+    static constexpr RegisterID regT1 = x1;
+    static constexpr RegisterID regT2 = x2;
+    static constexpr RegisterID returnValueRegister = x0;
+
+    // size_t function(JITFrame* frame, void* entryAddress)
+    void emitPrologue(size_t registerFileOffsetInFrame)
+    {
+        // stp x29, x30, [sp, #-48]!
+        emitInstruction(0xA9800000 | (((uint32_t)-6 & 0x7F) << 15) | (x30 << 10) | (sp << 5) | x29);
+        // mov x29, sp
+        emitInstruction(0x91000000 | (sp << 5) | x29);
+        // stp x19, x20, [sp, #16]
+        emitInstruction(0xA9000000 | (2 << 15) | (x20 << 10) | (sp << 5) | x19);
+        // stp x21, x22, [sp, #32]
+        emitInstruction(0xA9000000 | (4 << 15) | (x22 << 10) | (sp << 5) | x21);
+        move(x0, frameRegister);
+        ASSERT(registerFileOffsetInFrame % 8 == 0 && registerFileOffsetInFrame / 8 < 4096);
+        // ldr x20, [x0, #offset]
+        emitInstruction(0xF9400000 | ((uint32_t)(registerFileOffsetInFrame / 8) << 10) | (x0 << 5) | registerFileRegister);
+        move((uint64_t)TagTypeNumber, numberTagRegister);
+        // br x1
+        emitInstruction(0xD61F0000 | (x1 << 5));
+    }
+
+    void emitEpilogue()
+    {
+        // ldp x21, x22, [sp, #32]
+        emitInstruction(0xA9400000 | (4 << 15) | (x22 << 10) | (sp << 5) | x21);
+        // ldp x19, x20, [sp, #16]
+        emitInstruction(0xA9400000 | (2 << 15) | (x20 << 10) | (sp << 5) | x19);
+        // ldp x29, x30, [sp], #48
+        emitInstruction(0xA8C00000 | (6 << 15) | (x30 << 10) | (sp << 5) | x29);
+        // ret
+        emitInstruction(0xD65F03C0);
+    }
+
+    void loadValue(size_t registerIndex, RegisterID dst)
+    {
+        if (registerIndex < 4096) {
+            // ldr dst, [x20, #index * 8]
+            emitInstruction(0xF9400000 | ((uint32_t)registerIndex << 10) | (registerFileRegister << 5) | dst);
+        } else {
+            move(registerIndex * sizeof(Value), scratchRegister);
+            // ldr dst, [x20, x16]
+            emitInstruction(0xF8606800 | (scratchRegister << 16) | (registerFileRegister << 5) | dst);
+        }
+    }
+
+    void storeValue(RegisterID src, size_t registerIndex)
+    {
+        if (registerIndex < 4096) {
+            // str src, [x20, #index * 8]
+            emitInstruction(0xF9000000 | ((uint32_t)registerIndex << 10) | (registerFileRegister << 5) | src);
+        } else {
+            move(registerIndex * sizeof(Value), scratchRegister);
+            // str src, [x20, x16]
+            emitInstruction(0xF8206800 | (scratchRegister << 16) | (registerFileRegister << 5) | src);
+        }
+    }
+
+    void move(uint64_t imm, RegisterID dst)
+    {
+        // movz + movk for every non-zero halfword
+        bool first = true;
+        for (uint32_t hw = 0; hw < 4; hw++) {
+            uint32_t part = (uint32_t)(imm >> (hw * 16)) & 0xFFFF;
+            if (part || (hw == 3 && first)) {
+                emitInstruction((first ? 0xD2800000 : 0xF2800000) | (hw << 21) | (part << 5) | dst);
+                first = false;
+            }
+        }
+    }
+
+    void move(RegisterID src, RegisterID dst)
+    {
+        // orr dst, xzr, src
+        emitInstruction(0xAA0003E0 | (src << 16) | dst);
+    }
+
+    void branchIfNotInt32(RegisterID reg, AssemblerLabel& target)
+    {
+        // int32 values have every bit of the number tag set
+        branch64(AssemblerCondition::Below, reg, numberTagRegister, target);
+    }
+
+    void boxInt32(RegisterID reg)
+    {
+        or64(numberTagRegister, reg);
+    }
+
+    void branch64(AssemblerCondition cond, RegisterID left, RegisterID right, AssemblerLabel& target)
+    {
+        // cmp left, right
+        emitInstruction(0xEB00001F | (right << 16) | (left << 5));
+        branch(cond, target);
+    }
+
+    void branch64(AssemblerCondition cond, RegisterID left, int32_t right, AssemblerLabel& target)
+    {
+        ASSERT(right >= 0 && right < 4096);
+        // cmp left, #imm
+        emitInstruction(0xF100001F | ((uint32_t)right << 10) | (left << 5));
+        branch(cond, target);
+    }
+
+    void branch32(AssemblerCondition cond, RegisterID left, RegisterID right, AssemblerLabel& target)
+    {
+        // cmp wLeft, wRight
+        emitInstruction(0x6B00001F | (right << 16) | (left << 5));
+        branch(cond, target);
+    }
+
+    // Equal jumps when the low 32 bits are zero, NotEqual jumps otherwise
+    void branchTest32(AssemblerCondition cond, RegisterID reg, AssemblerLabel& target)
+    {
+        ASSERT(cond == AssemblerCondition::Equal || cond == AssemblerCondition::NotEqual);
+        // tst wReg, wReg
+        emitInstruction(0x6A00001F | (reg << 16) | (reg << 5));
+        branch(cond, target);
+    }
+
+    // dst = dst + src (32bit), jumps to target on overflow
+    void branchAdd32(RegisterID src, RegisterID dst, AssemblerLabel& overflow)
+    {
+        // adds wDst, wDst, wSrc
+        emitInstruction(0x2B000000 | (src << 16) | (dst << 5) | dst);
+        branch(AssemblerCondition::Overflow, overflow);
+    }
+
+    void branchSub32(RegisterID src, RegisterID dst, AssemblerLabel& overflow)
+    {
+        // subs wDst, wDst, wSrc
+        emitInstruction(0x6B000000 | (src << 16) | (dst << 5) | dst);
+        branch(AssemblerCondition::Overflow, overflow);
+    }
+
+    void branchAdd32(int8_t imm, RegisterID dst, AssemblerLabel& overflow)
+    {
+        if (imm >= 0) {
+            // adds wDst, wDst, #imm
+            emitInstruction(0x31000000 | ((uint32_t)imm << 10) | (dst << 5) | dst);
+        } else {
+            // subs wDst, wDst, #-imm
+            emitInstruction(0x71000000 | ((uint32_t)-imm << 10) | (dst << 5) | dst);
+        }
+        branch(AssemblerCondition::Overflow, overflow);
+    }
+
+    void and64(RegisterID src, RegisterID dst)
+    {
+        emitInstruction(0x8A000000 | (src << 16) | (dst << 5) | dst);
+    }
+
+    void or64(RegisterID src, RegisterID dst)
+    {
+        emitInstruction(0xAA000000 | (src << 16) | (dst << 5) | dst);
+    }
+
+    // result is zero-extended
+    void xor32(RegisterID src, RegisterID dst)
+    {
+        emitInstruction(0x4A000000 | (src << 16) | (dst << 5) | dst);
+    }
+
+    // calls size_t function(JITFrame* frame, argument)
+    // the result is placed in returnValueRegister
+    void callOperation(const void* function, const void* argument)
+    {
+        move(frameRegister, x0);
+        move((uint64_t)argument, x1);
+        move((uint64_t)function, scratchRegister);
+        // blr x16
+        emitInstruction(0xD63F0000 | (scratchRegister << 5));
+    }
+
+    void jump(AssemblerLabel& target)
+    {
+        emitBranch(0x14000000, target);
+    }
+
+    void branch(AssemblerCondition cond, AssemblerLabel& target)
+    {
+        emitBranch(0x54000000 | conditionCode(cond), target);
+    }
+
+    void bind(AssemblerLabel& label)
+    {
+        ASSERT(!label.isBound());
+        label.m_offset = size();
+        for (size_t i = 0; i < label.m_unresolvedBranches.size(); i++) {
+            size_t site = label.m_unresolvedBranches[i];
+            write32(site, encodeBranchOffset(read32(site), label.m_offset - site));
+        }
+        label.m_unresolvedBranches.clear();
+    }
+
+    // conditional branches can reach +-1MB
+    static bool canEncodeBranchesIn(size_t codeSize)
+    {
+        return codeSize < 1024 * 1024;
+    }
+
+private:
+    static constexpr RegisterID frameRegister = x19;
+    static constexpr RegisterID registerFileRegister = x20;
+    static constexpr RegisterID numberTagRegister = x21;
+    // intra-procedure-call scratch register
+    static constexpr RegisterID scratchRegister = x16;
+
+    void emitInstruction(uint32_t instruction)
+    {
+        emit32(instruction);
+    }
+
+    void emitBranch(uint32_t instruction, AssemblerLabel& target)
+    {
+        if (target.isBound()) {
+            emitInstruction(encodeBranchOffset(instruction, target.m_offset - size()));
+        } else {
+            target.m_unresolvedBranches.push_back(size());
+            emitInstruction(instruction);
+        }
+    }
+
+    static uint32_t encodeBranchOffset(uint32_t instruction, size_t distance)
+    {
+        int64_t imm = (int64_t)distance >> 2;
+        if ((instruction & 0xFC000000) == 0x14000000) {
+            return (instruction & 0xFC000000) | ((uint32_t)imm & 0x3FFFFFF);
+        }
+        ASSERT((instruction & 0xFF000010) == 0x54000000);
+        return (instruction & 0xFF00001F) | (((uint32_t)imm & 0x7FFFF) << 5);
+    }
+
+    static uint32_t conditionCode(AssemblerCondition cond)
+    {
+        switch (cond) {
+        case AssemblerCondition::Equal:
+            return 0x0;
+        case AssemblerCondition::NotEqual:
+            return 0x1;
+        case AssemblerCondition::Below:
+            return 0x3;
+        case AssemblerCondition::AboveOrEqual:
+            return 0x2;
+        case AssemblerCondition::Above:
+            return 0x8;
+        case AssemblerCondition::BelowOrEqual:
+            return 0x9;
+        case AssemblerCondition::LessThan:
+            return 0xB;
+        case AssemblerCondition::GreaterThanOrEqual:
+            return 0xA;
+        case AssemblerCondition::GreaterThan:
+            return 0xC;
+        case AssemblerCondition::LessThanOrEqual:
+            return 0xD;
+        case AssemblerCondition::Overflow:
+            return 0x6;
+        default:
+            RELEASE_ASSERT_NOT_REACHED();
+            return 0;
+        }
+    }
+};
+} // namespace Escargot
+
+#endif // ENABLE_JIT && CPU_ARM64
+
+#endif
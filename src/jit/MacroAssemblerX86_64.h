@@ -0,0 +1,367 @@
+/*
+ * Copyright (c) 2021-present Samsung Electronics Co., Ltd
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+ */
+
+#ifndef __EscargotMacroAssemblerX86_64__
+#define __EscargotMacroAssemblerX86_64__
+
+#if defined(ENABLE_JIT) && defined(CPU_X86_64)
+
+#include "jit/AssemblerBuffer.h"
+
+namespace Escargot {
+
+// System V AMD64 ABI
+// rbx, r13 and r14 are callee-saved, so they keep the register file, the number tag and the JITFrame across operation calls
+class MacroAssemblerX86_64 : public AssemblerBuffer {
+public:
+    enum RegisterID : uint8_t {
+        rax = 0,
+        rcx,
+        rdx,
+        rbx,
+        rsp,
+        rbp,
+        rsi,
+        rdi,
+        r8,
+        r9,
+        r10,
+        r11,
+        r12,
+        r13,
+        r14,
+        r15,
+    };
+
+    static constexpr RegisterID regT0 = rax;
+    static constexpr RegisterID regT1 = rcx;
+    static constexpr RegisterID regT2 = rdx;
+    static constexpr RegisterID returnValueRegister = rax;
+
+    // size_t function(JITFrame* frame, void* entryAddress)
+    void emitPrologue(size_t registerFileOffsetInFrame)
+    {
+        push(rbx);
+        push(r13);
+        push(r14);
+        move(rdi, frameRegister);
+        loadPointer(rdi, registerFileOffsetInFrame, registerFileRegister);
+        move((uint64_t)TagTypeNumber, numberTagRegister);
+        // jmp rsi
+        emit8(0xFF);
+        emit8(modRM(3, 4, rsi));
+    }
+
+    void emitEpilogue()
+    {
+        pop(r14);
+        pop(r13);
+        pop(rbx);
+        emit8(0xC3);
+    }
+
+    void loadValue(size_t registerIndex, RegisterID dst)
+    {
+        loadPointer(registerFileRegister, registerIndex * sizeof(Value), dst);
+    }
+
+    void storeValue(RegisterID src, size_t registerIndex)
+    {
+        // mov [rbx + disp], src
+        emitRex(true, src, 0, registerFileRegister);
+        emit8(0x89);
+        emitMemoryOperand(src, registerFileRegister, registerIndex * sizeof(Value));
+    }
+
+    void move(uint64_t imm, RegisterID dst)
+    {
+        if (imm <= std::numeric_limits<uint32_t>::max()) {
+            // mov r32, imm32 zero-extends
+            emitRex(false, 0, 0, dst);
+            emit8(0xB8 + (dst & 7));
+            emit32((uint32_t)imm);
+        } else {
+            emitRex(true, 0, 0, dst);
+            emit8(0xB8 + (dst & 7));
+            emit64(imm);
+        }
+    }
+
+    void move(RegisterID src, RegisterID dst)
+    {
+        emitRex(true, src, 0, dst);
+        emit8(0x89);
+        emit8(modRM(3, src, dst));
+    }
+
+    void branchIfNotInt32(RegisterID reg, AssemblerLabel& target)
+    {
+        // int32 values have every bit of the number tag set
+        branch64(AssemblerCondition::Below, reg, numberTagRegister, target);
+    }
+
+    void boxInt32(RegisterID reg)
+    {
+        // or reg, r13
+        emitRex(true, numberTagRegister, 0, reg);
+        emit8(0x09);
+        emit8(modRM(3, numberTagRegister, reg));
+    }
+
+    void branch64(AssemblerCondition cond, RegisterID left, RegisterID right, AssemblerLabel& target)
+    {
+        // cmp left, right
+        emitRex(true, right, 0, left);
+        emit8(0x39);
+        emit8(modRM(3, right, left));
+        branch(cond, target);
+    }
+
+    void branch64(AssemblerCondition cond, RegisterID left, int32_t right, AssemblerLabel& target)
+    {
+        // cmp left, imm
+        emitRex(true, 0, 0, left);
+        if (isInt8(right)) {
+            emit8(0x83);
+            emit8(modRM(3, 7, left));
+            emit8((uint8_t)right);
+        } else {
+            emit8(0x81);
+            emit8(modRM(3, 7, left));
+            emit32((uint32_t)right);
+        }
+        branch(cond, target);
+    }
+
+    void branch32(AssemblerCondition cond, RegisterID left, RegisterID right, AssemblerLabel& target)
+    {
+        emitRex(false, right, 0, left);
+        emit8(0x39);
+        emit8(modRM(3, right, left));
+        branch(cond, target);
+    }
+
+    // Equal jumps when the low 32 bits are zero, NotEqual jumps otherwise
+    void branchTest32(AssemblerCondition cond, RegisterID reg, AssemblerLabel& target)
+    {
+        ASSERT(cond == AssemblerCondition::Equal || cond == AssemblerCondition::NotEqual);
+        // test reg, reg
+        arithmetic32(0x85, reg, reg);
+        branch(cond, target);
+    }
+
+    // dst = dst + src (32bit), jumps to target on overflow
+    void branchAdd32(RegisterID src, RegisterID dst, AssemblerLabel& overflow)
+    {
+        arithmetic32(0x01, src, dst);
+        branch(AssemblerCondition::Overflow, overflow);
+    }
+
+    void branchSub32(RegisterID src, RegisterID dst, AssemblerLabel& overflow)
+    {
+        arithmetic32(0x29, src, dst);
+        branch(AssemblerCondition::Overflow, overflow);
+    }
+
+    void branchAdd32(int8_t imm, RegisterID dst, AssemblerLabel& overflow)
+    {
+        emitRex(false, 0, 0, dst);
+        emit8(0x83);
+        emit8(modRM(3, 0, dst));
+        emit8((uint8_t)imm);
+        branch(AssemblerCondition::Overflow, overflow);
+    }
+
+    void and64(RegisterID src, RegisterID dst)
+    {
+        emitRex(true, src, 0, dst);
+        emit8(0x21);
+        emit8(modRM(3, src, dst));
+    }
+
+    void or64(RegisterID src, RegisterID dst)
+    {
+        emitRex(true, src, 0, dst);
+        emit8(0x09);
+        emit8(modRM(3, src, dst));
+    }
+
+    // result is zero-extended
+    void xor32(RegisterID src, RegisterID dst)
+    {
+        arithmetic32(0x31, src, dst);
+    }
+
+    // calls size_t function(JITFrame* frame, argument)
+    // the result is placed in returnValueRegister
+    void callOperation(const void* function, const void* argument)
+    {
+        move(frameRegister, rdi);
+        move((uint64_t)argument, rsi);
+        move((uint64_t)function, rax);
+        // call rax
+        emit8(0xFF);
+        emit8(modRM(3, 2, rax));
+    }
+
+    void jump(AssemblerLabel& target)
+    {
+        emit8(0xE9);
+        linkRelative32(target);
+    }
+
+    void branch(AssemblerCondition cond, AssemblerLabel& target)
+    {
+        emit8(0x0F);
+        emit8(0x80 + conditionCode(cond));
+        linkRelative32(target);
+    }
+
+    void bind(AssemblerLabel& label)
+    {
+        ASSERT(!label.isBound());
+        label.m_offset = size();
+        for (size_t i = 0; i < label.m_unresolvedBranches.size(); i++) {
+            size_t site = label.m_unresolvedBranches[i];
+            write32(site, (uint32_t)(int32_t)(label.m_offset - (site + 4)));
+        }
+        label.m_unresolvedBranches.clear();
+    }
+
+    // x86-64 has coherent instruction cache and rel32 covers every buffer we generate
+    static bool canEncodeBranchesIn(size_t codeSize)
+    {
+        return codeSize <= (size_t)std::numeric_limits<int32_t>::max();
+    }
+
+private:
+    static constexpr RegisterID registerFileRegister = rbx;
+    static constexpr RegisterID numberTagRegister = r13;
+    static constexpr RegisterID frameRegister = r14;
+
+    static bool isInt8(int64_t value)
+    {
+        return value == (int8_t)value;
+    }
+
+    static uint8_t modRM(int mod, int reg, int rm)
+    {
+        return (uint8_t)((mod << 6) | ((reg & 7) << 3) | (rm & 7));
+    }
+
+    void emitRex(bool is64, int reg, int index, int base)
+    {
+        uint8_t rex = 0x40 | (is64 ? 0x8 : 0) | ((reg >> 3) << 2) | ((index >> 3) << 1) | (base >> 3);
+        if (rex != 0x40) {
+            emit8(rex);
+        }
+    }
+
+    void emitMemoryOperand(int reg, RegisterID base, size_t offset)
+    {
+        RELEASE_ASSERT(offset <= (size_t)std::numeric_limits<int32_t>::max());
+        if (isInt8(offset)) {
+            emit8(modRM(1, reg, base));
+            if ((base & 7) == rsp) {
+                emit8(0x24);
+            }
+            emit8((uint8_t)offset);
+        } else {
+            emit8(modRM(2, reg, base));
+            if ((base & 7) == rsp) {
+                emit8(0x24);
+            }
+            emit32((uint32_t)offset);
+        }
+    }
+
+    void loadPointer(RegisterID base, size_t offset, RegisterID dst)
+    {
+        // mov dst, [base + disp]
+        emitRex(true, dst, 0, base);
+        emit8(0x8B);
+        emitMemoryOperand(dst, base, offset);
+    }
+
+    void arithmetic32(uint8_t opcode, RegisterID src, RegisterID dst)
+    {
+        emitRex(false, src, 0, dst);
+        emit8(opcode);
+        emit8(modRM(3, src, dst));
+    }
+
+    void push(RegisterID reg)
+    {
+        emitRex(false, 0, 0, reg);
+        emit8(0x50 + (reg & 7));
+    }
+
+    void pop(RegisterID reg)
+    {
+        emitRex(false, 0, 0, reg);
+        emit8(0x58 + (reg & 7));
+    }
+
+    void linkRelative32(AssemblerLabel& target)
+    {
+        size_t site = size();
+        if (target.isBound()) {
+            emit32((uint32_t)(int32_t)(target.m_offset - (site + 4)));
+        } else {
+            target.m_unresolvedBranches.push_back(site);
+            emit32(0);
+        }
+    }
+
+    static uint8_t conditionCode(AssemblerCondition cond)
+    {
+        switch (cond) {
+        case AssemblerCondition::Equal:
+            return 0x4;
+        case AssemblerCondition::NotEqual:
+            return 0x5;
+        case AssemblerCondition::Below:
+            return 0x2;
+        case AssemblerCondition::AboveOrEqual:
+            return 0x3;
+        case AssemblerCondition::Above:
+            return 0x7;
+        case AssemblerCondition::BelowOrEqual:
+            return 0x6;
+        case AssemblerCondition::LessThan:
+            return 0xC;
+        case AssemblerCondition::GreaterThanOrEqual:
+            return 0xD;
+        case AssemblerCondition::GreaterThan:
+            return 0xF;
+        case AssemblerCondition::LessThanOrEqual:
+            return 0xE;
+        case AssemblerCondition::Overflow:
+            return 0x0;
+        default:
+            RELEASE_ASSERT_NOT_REACHED();
+            return 0;
+        }
+    }
+};
+} // namespace Escargot
+
+#endif // ENABLE_JIT && CPU_X86_64
+
+#endif
@@ -214,6 +214,10 @@ InterpretedCodeBlock::InterpretedCodeBlock(Context* ctx, Script* script, StringV
     , m_allowSuperCall(false)
     , m_allowSuperProperty(false)
     , m_allowArguments(false)
+    , m_isByteCodeBlockFlushed(false)
+#if defined(ENABLE_CODE_CACHE)
+    , m_codeCacheIndex(SIZE_MAX)
+#endif
 #ifndef NDEBUG
     , m_scopeContext(scopeCtx)
 #endif
@@ -270,6 +274,10 @@ InterpretedCodeBlock::InterpretedCodeBlock(Context* ctx, Script* script, StringV
     , m_allowSuperCall(false)
     , m_allowSuperProperty(false)
     , m_allowArguments(false)
+    , m_isByteCodeBlockFlushed(false)
+#if defined(ENABLE_CODE_CACHE)
+    , m_codeCacheIndex(SIZE_MAX)
+#endif
 #ifndef NDEBUG
     , m_scopeContext(scopeCtx)
 #endif
@@ -326,6 +334,10 @@ InterpretedCodeBlock::InterpretedCodeBlock(Context* ctx, Script* script)
     , m_allowSuperCall(false)
     , m_allowSuperProperty(false)
     , m_allowArguments(false)
+    , m_isByteCodeBlockFlushed(false)
+#if defined(ENABLE_CODE_CACHE)
+    , m_codeCacheIndex(SIZE_MAX)
+#endif
 #ifndef NDEBUG
     , m_scopeContext(nullptr)
 #endif
@@ -192,6 +192,7 @@ class InterpretedCodeBlock : public CodeBlock {
     friend class VMInstance;
     friend int getValidValueInInterpretedCodeBlock(void* ptr, GC_mark_custom_result* arr);
 #if defined(ENABLE_CODE_CACHE)
+    friend class CodeCache;
     friend class CodeCacheWriter;
     friend class CodeCacheReader;
 #endif
@@ -849,6 +850,13 @@ protected:
     bool m_allowSuperCall : 1;
     bool m_allowSuperProperty : 1;
     bool m_allowArguments : 1;
+    // ByteCodeBlock is flushed by VMInstance and should be regenerated on the next call
+    bool m_isByteCodeBlockFlushed : 1;
+
+#if defined(ENABLE_CODE_CACHE)
+    // index in the cached CodeBlock tree (SIZE_MAX if CodeBlock tree is not cached)
+    size_t m_codeCacheIndex;
+#endif
 
 #ifndef NDEBUG
     ASTScopeContext* m_scopeContext;
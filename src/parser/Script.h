@@ -152,6 +152,9 @@ public:
         , m_sourceCode(sourceCode)
         , m_topCodeBlock(nullptr)
         , m_moduleData(moduleData)
+#if defined(ENABLE_CODE_CACHE)
+        , m_codeCacheSourceHash(0)
+#endif
     {
     }
 
@@ -181,6 +184,14 @@ public:
         return m_moduleData;
     }
 
+#if defined(ENABLE_CODE_CACHE)
+    // hash value of source code used as a key of CodeCache (0 if this Script is not cached)
+    size_t codeCacheSourceHash()
+    {
+        return m_codeCacheSourceHash;
+    }
+#endif
+
     ModuleData* moduleData()
     {
         return m_moduleData;
@@ -278,6 +289,9 @@ private:
     String* m_sourceCode;
     InterpretedCodeBlock* m_topCodeBlock;
     ModuleData* m_moduleData;
+#if defined(ENABLE_CODE_CACHE)
+    size_t m_codeCacheSourceHash;
+#endif
 };
 } // namespace Escargot
 
@@ -59,6 +59,7 @@ InterpretedCodeBlock* ScriptParser::generateCodeBlockTreeFromASTWalker(Context*
     if (m_codeBlockCacheInfo) {
         ASSERT(m_codeBlockCacheInfo->m_codeBlockIndex.find(codeBlock) == m_codeBlockCacheInfo->m_codeBlockIndex.end());
         m_codeBlockCacheInfo->m_codeBlockIndex.insert(std::make_pair(codeBlock, m_codeBlockCacheInfo->m_codeBlockCount));
+        codeBlock->m_codeCacheIndex = m_codeBlockCacheInfo->m_codeBlockCount;
         m_codeBlockCacheInfo->m_codeBlockCount++;
     }
 #endif
@@ -265,7 +266,7 @@ ScriptParser::InitializeScriptResult ScriptParser::initializeScript(String* sour
     // Load caching
     if (cacheable) {
         ASSERT(!parentCodeBlock);
-        srcHash = source->hashValue();
+        srcHash = static_cast<size_t>(source->computeHash());
         auto result = codeCache->searchCache(srcHash);
         if (result.first) {
             GC_disable();
@@ -286,6 +287,7 @@ ScriptParser::InitializeScriptResult ScriptParser::initializeScript(String* sour
             if (LIKELY(loadingDone)) {
                 ASSERT(!!topCodeBlock && !!topByteBlock);
                 script->m_topCodeBlock = topCodeBlock;
+                script->m_codeCacheSourceHash = srcHash;
                 topCodeBlock->m_byteCodeBlock = topByteBlock;
 
                 ESCARGOT_LOG_INFO("[CodeCache] Load CodeCache Done (%s)\n", srcName->toUTF8StringData().data());
@@ -373,7 +375,10 @@ ScriptParser::InitializeScriptResult ScriptParser::initializeScript(String* sour
             // After CodeBlockTree, ByteCode and StringTable are stored sequentially
             topCodeBlock->m_byteCodeBlock = ByteCodeGenerator::generateByteCode(m_context, topCodeBlock, programNode, inWith, true);
 
-            codeCache->postCacheWriting(srcHash);
+            if (codeCache->postCacheWriting(srcHash)) {
+                // ByteCode of each function is stored later when it is compiled
+                script->m_codeCacheSourceHash = srcHash;
+            }
             deleteCodeBlockCacheInfo();
 
             ESCARGOT_LOG_INFO("[CodeCache] Store CodeCache Done (%s)\n", srcName->toUTF8StringData().data());
@@ -484,27 +489,51 @@ void ScriptParser::generateFunctionByteCode(ExecutionState& state, InterpretedCo
 
     GC_disable();
 
-    FunctionNode* functionNode;
+    ByteCodeBlock* block = nullptr;
+    bool cacheByteCode = false;
+
+#if defined(ENABLE_CODE_CACHE)
+    CodeCache* codeCache = m_context->vmInstance()->codeCache();
+    if (codeCache->enabled() && codeCache->isCachedCodeBlock(codeBlock)) {
+        // ByteCode of this function could be stored by the previous run
+        block = codeCache->loadFunctionByteCodeBlock(m_context, codeBlock);
+        cacheByteCode = !block;
+        if (block) {
+            m_context->vmInstance()->codeCacheLoadedByteCodeBlockCount()++;
+        }
+    }
+#endif
+
+    if (!block) {
+        FunctionNode* functionNode;
+
+        // Parsing
+        try {
+            functionNode = esprima::parseSingleFunction(m_context, codeBlock, stackSizeRemain);
+        } catch (esprima::Error* orgError) {
+            // reset ASTAllocator
+            m_context->astAllocator().reset();
+            GC_enable();
+
+            auto str = orgError->message->toUTF8StringData();
+            delete orgError;
+            ErrorObject::throwBuiltinError(state, ErrorObject::SyntaxError, str.data());
+            RELEASE_ASSERT_NOT_REACHED();
+        }
+
+        // Generate ByteCode
+        block = ByteCodeGenerator::generateByteCode(state.context(), codeBlock, functionNode, false, cacheByteCode);
 
-    // Parsing
-    try {
-        functionNode = esprima::parseSingleFunction(m_context, codeBlock, stackSizeRemain);
-    } catch (esprima::Error* orgError) {
         // reset ASTAllocator
         m_context->astAllocator().reset();
-        GC_enable();
-
-        auto str = orgError->message->toUTF8StringData();
-        delete orgError;
-        ErrorObject::throwBuiltinError(state, ErrorObject::SyntaxError, str.data());
-        RELEASE_ASSERT_NOT_REACHED();
     }
 
-    // Generate ByteCode
-    codeBlock->m_byteCodeBlock = ByteCodeGenerator::generateByteCode(state.context(), codeBlock, functionNode);
+    codeBlock->m_byteCodeBlock = block;
+    if (UNLIKELY(codeBlock->m_isByteCodeBlockFlushed)) {
+        codeBlock->m_isByteCodeBlockFlushed = false;
+        m_context->vmInstance()->regeneratedByteCodeBlockCount()++;
+    }
 
-    // reset ASTAllocator
-    m_context->astAllocator().reset();
     GC_enable();
 }
 
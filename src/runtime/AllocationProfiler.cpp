@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2021-present Samsung Electronics Co., Ltd
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+ */
+
+#include "Escargot.h"
+#include "AllocationProfiler.h"
+#include "runtime/Object.h"
+#include "runtime/FunctionObject.h"
+#include "runtime/SandBox.h"
+#include "interpreter/ByteCode.h"
+#include "parser/CodeBlock.h"
+
+namespace Escargot {
+
+ESCARGOT_THREAD_LOCAL AllocationProfiler* AllocationProfiler::g_profiler;
+
+AllocationProfiler::AllocationProfiler(size_t samplingInterval)
+    : m_samplingInterval(std::max(samplingInterval, (size_t)1))
+    , m_lastSampledBytes(GC_get_total_bytes())
+    , m_nextSampleBytes(m_lastSampledBytes + m_samplingInterval)
+    , m_isSampling(false)
+{
+}
+
+void AllocationProfiler::start(size_t samplingInterval)
+{
+    delete g_profiler;
+    g_profiler = new AllocationProfiler(samplingInterval);
+}
+
+bool AllocationProfiler::stop(const char* path)
+{
+    AllocationProfiler* profiler = g_profiler;
+    if (!profiler) {
+        return false;
+    }
+    g_profiler = nullptr;
+
+    FILE* fp = fopen(path, "w");
+    bool succeeded = false;
+    if (fp) {
+        for (const auto& item : profiler->m_samples) {
+            fprintf(fp, "%s %zu\n", item.first.data(), item.second);
+        }
+        succeeded = !ferror(fp);
+        succeeded = !fclose(fp) && succeeded;
+    }
+    delete profiler;
+    return succeeded;
+}
+
+static void appendFrameName(std::string& stack, String* name)
+{
+    // ';' separates frames and ' ' separates the count in folded stack format
+    std::string str = name->toNonGCUTF8StringData();
+    std::replace(str.begin(), str.end(), ';', ':');
+    std::replace(str.begin(), str.end(), '\n', ' ');
+    stack += str;
+}
+
+void AllocationProfiler::sample(ExecutionState& state, Object* proto, bool isString)
+{
+    // collecting stack trace can create objects
+    if (m_isSampling) {
+        return;
+    }
+
+    size_t totalBytes = GC_get_total_bytes();
+    if (LIKELY(totalBytes < m_nextSampleBytes)) {
+        return;
+    }
+
+    m_isSampling = true;
+    size_t bytes = totalBytes - m_lastSampledBytes;
+    m_lastSampledBytes = totalBytes;
+    m_nextSampleBytes = totalBytes + m_samplingInterval;
+
+    SandBox::StackTraceDataVector stackTraceData;
+    SandBox::createStackTraceData(stackTraceData, state);
+
+    std::string stack;
+    // stackTraceData starts with the innermost frame
+    for (size_t i = stackTraceData.size(); i > 0; i--) {
+        const SandBox::StackTraceData& data = stackTraceData[i - 1].second;
+        if (data.isFunction) {
+            if (data.functionName->length()) {
+                appendFrameName(stack, data.functionName);
+            } else {
+                stack += "(anonymous)";
+            }
+        } else {
+            stack += "(global)";
+        }
+
+        if (data.isAssociatedWithJavaScriptCode) {
+            // functions are distinguished by where they start, not by the position of each call
+            stack += " (";
+            appendFrameName(stack, data.src);
+            const ExtendedNodeLOC& loc = data.loc;
+            if (loc.index == SIZE_MAX && (size_t)loc.actualCodeBlock != SIZE_MAX) {
+                stack += ':';
+                stack += std::to_string(loc.actualCodeBlock->codeBlock()->functionStart().line);
+            }
+            stack += ')';
+        } else {
+            stack += " [native]";
+        }
+        stack += ';';
+    }
+
+    String* name = proto ? proto->constructorNameWithoutState() : nullptr;
+    stack += '[';
+    if (isString) {
+        stack += "String";
+    } else if (name && name->length()) {
+        appendFrameName(stack, name);
+    } else {
+        stack += "Object";
+    }
+    stack += ']';
+
+    m_samples[stack] += bytes;
+    m_isSampling = false;
+}
+} // namespace Escargot
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2021-present Samsung Electronics Co., Ltd
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+ */
+
+#ifndef __EscargotAllocationProfiler__
+#define __EscargotAllocationProfiler__
+
+namespace Escargot {
+
+class ExecutionState;
+class Object;
+
+// Sampling profiler of gc allocation
+// Allocated bytes are counted by bdwgc, so every kind of allocation (strings, vectors, code blocks...) is included.
+// Whenever `samplingInterval` bytes are allocated, the JS stack of the next object creation or string concatenation is recorded
+// with the bytes allocated since the previous sample, and the class of the created object (or [String]) as the leaf frame.
+// Other allocations have no sampling point, so their bytes are attributed to the next sampled stack
+// (e.g. results of String builtins or flattening of rope strings are counted as a following object creation).
+// With threading, bdwgc counts the allocation of every thread but only the stacks of the profiling thread are recorded.
+class AllocationProfiler {
+public:
+    static void start(size_t samplingInterval);
+    // write samples in folded stack format ("outer;inner;[class] bytes" per line) which flamegraph.pl reads
+    // returns false if the profiler is not running or the file cannot be written
+    static bool stop(const char* path);
+
+    // called by every constructor of Object which has ExecutionState
+    static ALWAYS_INLINE void objectCreated(ExecutionState& state, Object* proto)
+    {
+        if (UNLIKELY(g_profiler != nullptr)) {
+            g_profiler->sample(state, proto, false);
+        }
+    }
+
+    // called by string concatenation which has ExecutionState (`+` operator and String.prototype.concat)
+    static ALWAYS_INLINE void stringCreated(ExecutionState& state)
+    {
+        if (UNLIKELY(g_profiler != nullptr)) {
+            g_profiler->sample(state, nullptr, true);
+        }
+    }
+
+private:
+    explicit AllocationProfiler(size_t samplingInterval);
+    void sample(ExecutionState& state, Object* proto, bool isString);
+
+    static ESCARGOT_THREAD_LOCAL AllocationProfiler* g_profiler;
+
+    size_t m_samplingInterval;
+    size_t m_lastSampledBytes;
+    size_t m_nextSampleBytes;
+    bool m_isSampling;
+    // folded stack -> allocated bytes
+    std::unordered_map<std::string, size_t> m_samples;
+};
+} // namespace Escargot
+
+#endif
@@ -56,6 +56,17 @@ ArrayBufferObject* ArrayBufferObject::cloneArrayBuffer(ExecutionState& state, Ar
     return targetBuffer;
 }
 
+static void freeArrayBufferObjectDataBufferByPlatform(void* data, size_t length, void* deleterData)
+{
+    Platform* platform = (Platform*)deleterData;
+    platform->onFreeArrayBufferObjectDataBuffer(data, length);
+}
+
+bool ArrayBufferObject::isAllocatedByPlatform(BackingStore* backingStore)
+{
+    return backingStore->m_deleter == freeArrayBufferObjectDataBufferByPlatform;
+}
+
 ArrayBufferObject::ArrayBufferObject(ExecutionState& state)
     : ArrayBufferObject(state, state.context()->globalObject()->arrayBufferPrototype())
 {
@@ -69,12 +80,9 @@ ArrayBufferObject::ArrayBufferObject(ExecutionState& state, Object* proto)
 {
 }
 
-void ArrayBufferObject::allocateBuffer(ExecutionState& state, size_t byteLength)
+void ArrayBufferObject::collectGarbageBeforeAllocatingBuffer(size_t byteLength)
 {
-    detachArrayBuffer();
-
-    ASSERT(byteLength < (size_t)ArrayBufferObject::maxArrayBufferSize);
-
+    // buffer data is allocated out of gc heap, so gc does not know how much memory unreachable buffers hold
     const size_t ratio = std::max((size_t)GC_get_free_space_divisor() / 6, (size_t)1);
     if (byteLength > (GC_get_heap_size() / ratio)) {
         size_t n = 0;
@@ -85,14 +93,19 @@ void ArrayBufferObject::allocateBuffer(ExecutionState& state, size_t byteLength)
         } while (n < times);
         GC_invoke_finalizers();
     }
+}
+
+void ArrayBufferObject::allocateBuffer(ExecutionState& state, size_t byteLength)
+{
+    detachArrayBuffer();
+
+    ASSERT(byteLength < (size_t)ArrayBufferObject::maxArrayBufferSize);
+
+    collectGarbageBeforeAllocatingBuffer(byteLength);
 
     auto platform = state.context()->vmInstance()->platform();
     void* buffer = platform->onMallocArrayBufferObjectDataBuffer(byteLength);
-    m_backingStore = new BackingStore(buffer, byteLength, [](void* data, size_t length, void* deleterData) {
-        Platform* platform = (Platform*)deleterData;
-        platform->onFreeArrayBufferObjectDataBuffer(data, length);
-    },
-                                      platform);
+    m_backingStore = new BackingStore(buffer, byteLength, freeArrayBufferObjectDataBufferByPlatform, platform);
     m_backingStore->m_isShared = true;
     m_data = (uint8_t*)m_backingStore->data();
     m_byteLength = byteLength;
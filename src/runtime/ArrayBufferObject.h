@@ -53,6 +53,11 @@ public:
 
     static const uint32_t maxArrayBufferSize = 210000000;
 
+    // true if data of backingStore is freed by Platform of the VMInstance which allocated it
+    static bool isAllocatedByPlatform(BackingStore* backingStore);
+    // collect garbage buffers first if byteLength is large compared to the gc heap
+    static void collectGarbageBeforeAllocatingBuffer(size_t byteLength);
+
     void allocateBuffer(ExecutionState& state, size_t bytelength);
     void attachBuffer(BackingStore* backingStore);
     void detachArrayBuffer();
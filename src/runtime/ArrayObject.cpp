@@ -34,6 +34,7 @@ ArrayObject::ArrayObject(ExecutionState& state)
 ArrayObject::ArrayObject(ExecutionState& state, Object* proto)
     : Object(state, proto, ESCARGOT_OBJECT_BUILTIN_PROPERTY_NUMBER)
     , m_arrayLength(0)
+    , m_elementKind(Int32ElementKind)
 #if !defined(ESCARGOT_64) || !defined(ESCARGOT_USE_32BIT_IN_64BIT)
     , m_fastModeData(nullptr)
 #endif
@@ -64,8 +65,16 @@ ArrayObject::ArrayObject(ExecutionState& state, const Value* src, const uint64_t
 }
 
 ArrayObject::ArrayObject(ExecutionState& state, Object* proto, const Value* src, const uint64_t& size)
-    : ArrayObject(state, proto, size, false)
+    : ArrayObject(state, proto)
 {
+    if (UNLIKELY(size > ((1LL << 32LL) - 1LL))) {
+        ErrorObject::throwBuiltinError(state, ErrorObject::RangeError, ErrorObject::Messages::GlobalObject_InvalidArrayLength);
+    }
+
+    // select element kind before allocating buffer to avoid transition while copying
+    m_elementKind = elementKindFor(src, size);
+    setArrayLength(state, size, true, false);
+
     // Let array be ! ArrayCreate(0).
     // Let n be 0.
     // For each element e of elements, do
@@ -166,7 +175,7 @@ bool ArrayObject::defineOwnProperty(ExecutionState& state, const ObjectPropertyN
     if (LIKELY(isFastModeArray())) {
         if (LIKELY(idx != Value::InvalidArrayIndexValue)) {
             uint32_t len = arrayLength(state);
-            if (len > idx && !m_fastModeData[idx].isEmpty()) {
+            if (len > idx && !getFastModeValue(idx).isEmpty()) {
                 // Non-empty slot of fast-mode array always has {writable:true, enumerable:true, configurable:true}.
                 // So, when new desciptor is not present, keep {w:true, e:true, c:true}
                 if (UNLIKELY(!(desc.isValuePresentAlone() || desc.isDataWritableEnumerableConfigurable()))) {
@@ -193,7 +202,7 @@ bool ArrayObject::defineOwnProperty(ExecutionState& state, const ObjectPropertyN
                     goto NonFastPath;
                 }
             }
-            m_fastModeData[idx] = desc.value();
+            setFastModeValue(idx, desc.value());
             return true;
         }
     }
@@ -228,8 +237,8 @@ bool ArrayObject::deleteOwnProperty(ExecutionState& state, const ObjectPropertyN
         if (LIKELY(idx != Value::InvalidArrayIndexValue)) {
             uint64_t len = arrayLength(state);
             if (idx < len) {
-                if (!m_fastModeData[idx].isEmpty()) {
-                    m_fastModeData[idx] = Value(Value::EmptyValue);
+                if (!getFastModeValue(idx).isEmpty()) {
+                    setFastModeValue(idx, Value(Value::EmptyValue));
                     ensureRareData()->m_shouldUpdateEnumerateObject = true;
                 }
                 return true;
@@ -246,7 +255,7 @@ void ArrayObject::enumeration(ExecutionState& state, bool (*callback)(ExecutionS
         size_t len = arrayLength(state);
         for (size_t i = 0; i < len; i++) {
             ASSERT(isFastModeArray());
-            if (m_fastModeData[i].isEmpty())
+            if (getFastModeValue(i).isEmpty())
                 continue;
             if (!callback(state, this, ObjectPropertyName(state, Value(i)), ObjectStructurePropertyDescriptor::createDataDescriptor(ObjectStructurePropertyDescriptor::AllPresent), data)) {
                 return;
@@ -272,7 +281,7 @@ void ArrayObject::sort(ExecutionState& state, int64_t length, const std::functio
             Value* tempBuffer = canUseStack ? (Value*)alloca(byteLength) : CustomAllocator<Value>().allocate(orgLength);
 
             for (size_t i = 0; i < orgLength; i++) {
-                tempBuffer[i] = m_fastModeData[i];
+                tempBuffer[i] = getFastModeValue(i);
             }
 
             if (orgLength) {
@@ -294,7 +303,7 @@ void ArrayObject::sort(ExecutionState& state, int64_t length, const std::functio
 
             if (isFastModeArray()) {
                 for (size_t i = 0; i < orgLength; i++) {
-                    m_fastModeData[i] = tempBuffer[i];
+                    setFastModeValue(i, tempBuffer[i]);
                 }
             }
 
@@ -309,7 +318,8 @@ void ArrayObject::sort(ExecutionState& state, int64_t length, const std::functio
 
 void* ArrayObject::operator new(size_t size)
 {
-    return CustomAllocator<ArrayObject>().allocate(1);
+    ASSERT(size == sizeof(ArrayObject));
+    return AllocationCache::allocate<AllocationCache::ArrayObjectKind>(size);
 }
 
 void ArrayObject::iterateArrays(ExecutionState& state, HeapObjectIteratorCallback callback)
@@ -328,17 +338,161 @@ void ArrayObject::convertIntoNonFastMode(ExecutionState& state)
 
     auto length = arrayLength(state);
     for (size_t i = 0; i < length; i++) {
-        if (!m_fastModeData[i].isEmpty()) {
-            defineOwnPropertyThrowsExceptionWhenStrictMode(state, ObjectPropertyName(state, Value(i)), ObjectPropertyDescriptor(m_fastModeData[i], ObjectPropertyDescriptor::AllPresent));
+        Value v = getFastModeValue(i);
+        if (!v.isEmpty()) {
+            defineOwnPropertyThrowsExceptionWhenStrictMode(state, ObjectPropertyName(state, Value(i)), ObjectPropertyDescriptor(v, ObjectPropertyDescriptor::AllPresent));
         }
     }
 
+    reallocateFastModeBuffer(length, 0);
+}
+
+void ArrayObject::setFastModeValueSlowCase(size_t idx, const Value& v)
+{
+    ASSERT(m_elementKind != GenericElementKind);
+    if (v.isEmpty()) {
+        if (m_elementKind == Int32ElementKind) {
+            fastModeInt32Data()[idx] = Int32ElementHole;
+        } else {
+            fastModeDoubleData()[idx] = bitwise_cast<double>(DoubleElementHoleBits);
+        }
+        return;
+    }
+
+    if (m_elementKind == Int32ElementKind && v.isNumber()) {
+        transitionElementKind(DoubleElementKind);
+    } else {
+        transitionElementKind(GenericElementKind);
+    }
+    setFastModeValue(idx, v);
+}
+
+void ArrayObject::transitionElementKind(ElementKind newKind)
+{
+    ASSERT(newKind > m_elementKind);
+    size_t length = m_arrayLength;
+    size_t capacity = hasRareData() ? (size_t)rareData()->m_arrayObjectFastModeBufferCapacity : 0;
+    capacity = std::max(capacity, length);
+
+    void* oldBuffer = fastModeBuffer();
+    void* newBuffer = allocateFastModeBuffer(newKind, capacity);
+    if (newKind == DoubleElementKind) {
+        double* data = reinterpret_cast<double*>(newBuffer);
+        int32_t* oldData = fastModeInt32Data();
+        for (size_t i = 0; i < length; i++) {
+            data[i] = oldData[i] == Int32ElementHole ? bitwise_cast<double>(DoubleElementHoleBits) : oldData[i];
+        }
+    } else {
+        ObjectPropertyValue* data = reinterpret_cast<ObjectPropertyValue*>(newBuffer);
+        for (size_t i = 0; i < length; i++) {
+            new (&data[i]) ObjectPropertyValue(getFastModeValue(i));
+        }
+    }
+
+    if (oldBuffer) {
+        GC_FREE(oldBuffer);
+    }
+    setFastModeBuffer(newBuffer);
+    m_elementKind = newKind;
+}
+
+void* ArrayObject::allocateFastModeBuffer(ElementKind kind, size_t capacity)
+{
+    if (!capacity) {
+        return nullptr;
+    }
+
+    switch (kind) {
+    case Int32ElementKind:
+        return GC_MALLOC_ATOMIC(sizeof(int32_t) * capacity);
+    case DoubleElementKind:
+        return GC_MALLOC_ATOMIC(sizeof(double) * capacity);
+    default:
+        ASSERT(kind == GenericElementKind);
 #if defined(ESCARGOT_64) && defined(ESCARGOT_USE_32BIT_IN_64BIT)
-    m_fastModeData.resizeWithUninitializedValues(length, 0);
+        return CustomAllocator<EncodedSmallValue>().allocate(capacity);
 #else
-    GC_FREE(m_fastModeData);
-    m_fastModeData = nullptr;
+        return GC_MALLOC(sizeof(ObjectPropertyValue) * capacity);
+#endif
+    }
+}
+
+void ArrayObject::reallocateFastModeBuffer(size_t oldLength, size_t newCapacity)
+{
+#if defined(ESCARGOT_64) && defined(ESCARGOT_USE_32BIT_IN_64BIT)
+    if (m_elementKind == GenericElementKind) {
+        m_fastModeData.resizeWithUninitializedValues(oldLength, newCapacity);
+        return;
+    }
 #endif
+    void* buffer = fastModeBuffer();
+    if (!newCapacity) {
+        if (buffer) {
+            GC_FREE(buffer);
+        }
+        setFastModeBuffer(nullptr);
+        return;
+    }
+    if (!buffer) {
+        setFastModeBuffer(allocateFastModeBuffer(m_elementKind, newCapacity));
+        return;
+    }
+
+    size_t elementSize;
+    switch (m_elementKind) {
+    case Int32ElementKind:
+        elementSize = sizeof(int32_t);
+        break;
+    case DoubleElementKind:
+        elementSize = sizeof(double);
+        break;
+    default:
+        elementSize = sizeof(ObjectPropertyValue);
+        break;
+    }
+    // GC_REALLOC keeps the kind(atomic or not) of buffer
+    setFastModeBuffer(GC_REALLOC(buffer, elementSize * newCapacity));
+}
+
+void ArrayObject::fillFastModeHoles(size_t start, size_t end)
+{
+    switch (m_elementKind) {
+    case Int32ElementKind: {
+        int32_t* data = fastModeInt32Data();
+        for (size_t i = start; i < end; i++) {
+            data[i] = Int32ElementHole;
+        }
+        break;
+    }
+    case DoubleElementKind: {
+        double* data = fastModeDoubleData();
+        for (size_t i = start; i < end; i++) {
+            data[i] = bitwise_cast<double>(DoubleElementHoleBits);
+        }
+        break;
+    }
+    default:
+        for (size_t i = start; i < end; i++) {
+            m_fastModeData[i] = ObjectPropertyValue(ObjectPropertyValue::EmptyValue);
+        }
+        break;
+    }
+}
+
+ArrayObject::ElementKind ArrayObject::elementKindFor(const Value* src, size_t size)
+{
+    ElementKind kind = Int32ElementKind;
+    for (size_t i = 0; i < size; i++) {
+        const Value& v = src[i];
+        if (v.isInt32() && v.asInt32() != Int32ElementHole) {
+            continue;
+        } else if (v.isNumber()) {
+            kind = DoubleElementKind;
+        } else if (!v.isEmpty()) {
+            return GenericElementKind;
+        }
+    }
+    return kind;
 }
 
 bool ArrayObject::setArrayLength(ExecutionState& state, const Value& newLength)
@@ -382,34 +536,11 @@ bool ArrayObject::setArrayLength(ExecutionState& state, const uint32_t newLength
         if (LIKELY(oldLength != newLength)) {
             m_arrayLength = newLength;
             if (useFitStorage || oldLength == 0 || newLength <= 128) {
-                bool hasRD = hasRareData();
-#if defined(ESCARGOT_64) && defined(ESCARGOT_USE_32BIT_IN_64BIT)
-                m_fastModeData.resizeWithUninitializedValues(oldLength, newLength);
-                for (size_t i = oldLength; i < newLength; i++) {
-                    m_fastModeData[i] = EncodedSmallValue(EncodedSmallValue::EmptyValue);
+                reallocateFastModeBuffer(oldLength, newLength);
+                if (newLength > oldLength) {
+                    fillFastModeHoles(oldLength, newLength);
                 }
-#else
-                size_t oldCapacity = hasRD ? (size_t)rareData()->m_arrayObjectFastModeBufferCapacity : 0;
-                if (oldCapacity) {
-                    if (newLength > oldCapacity) {
-                        m_fastModeData = (EncodedValue*)GC_REALLOC(m_fastModeData, sizeof(EncodedValue) * newLength);
-
-                        for (size_t i = oldLength; i < newLength; i++) {
-                            m_fastModeData[i] = EncodedValue(EncodedValue::EmptyValue);
-                        }
-
-                    } else {
-                        m_fastModeData = (EncodedValue*)GC_REALLOC(m_fastModeData, sizeof(EncodedValue) * newLength);
-                    }
-                } else {
-                    m_fastModeData = (EncodedValue*)GC_REALLOC(m_fastModeData, sizeof(EncodedValue) * newLength);
-
-                    for (size_t i = oldLength; i < newLength; i++) {
-                        m_fastModeData[i] = EncodedValue(EncodedValue::EmptyValue);
-                    }
-                }
-#endif
-                if (hasRD) {
+                if (hasRareData()) {
                     rareData()->m_arrayObjectFastModeBufferCapacity = 0;
                 }
             } else {
@@ -419,7 +550,6 @@ bool ArrayObject::setArrayLength(ExecutionState& state, const uint32_t newLength
                 bool hasRD = hasRareData();
                 size_t oldCapacity = hasRD ? (size_t)rareData()->m_arrayObjectFastModeBufferCapacity : oldLength;
 
-#if defined(ESCARGOT_64) && defined(ESCARGOT_USE_32BIT_IN_64BIT)
                 auto rd = ensureRareData();
                 if (newLength > oldCapacity) {
                     size_t newCapacity;
@@ -430,53 +560,18 @@ bool ArrayObject::setArrayLength(ExecutionState& state, const uint32_t newLength
                         ComputeReservedCapacityFunctionWithPercent<130> f;
                         newCapacity = f(newLength);
                     }
-                    m_fastModeData.resizeWithUninitializedValues(oldLength, newCapacity);
-
-                    for (size_t i = oldLength; i < newLength; i++) {
-                        m_fastModeData[i] = EncodedSmallValue(EncodedSmallValue::EmptyValue);
-                    }
+                    reallocateFastModeBuffer(oldLength, newCapacity);
 
                     rd->m_arrayObjectFastModeBufferCapacity = newCapacity;
                     if (rd->m_arrayObjectFastModeBufferExpandCount < minExpandCountForUsingLog2Function) {
                         rd->m_arrayObjectFastModeBufferExpandCount++;
                     }
                 } else {
-                    for (size_t i = oldLength; i < newLength; i++) {
-                        m_fastModeData[i] = EncodedSmallValue(EncodedSmallValue::EmptyValue);
-                    }
                     rd->m_arrayObjectFastModeBufferCapacity = oldCapacity;
                 }
-#else
-                auto rd = ensureRareData();
-                if (newLength > oldCapacity) {
-                    size_t newCapacity;
-                    if (rd->m_arrayObjectFastModeBufferExpandCount >= minExpandCountForUsingLog2Function) {
-                        ComputeReservedCapacityFunctionWithLog2<> f;
-                        newCapacity = f(newLength);
-                    } else {
-                        ComputeReservedCapacityFunctionWithPercent<130> f;
-                        newCapacity = f(newLength);
-                    }
-                    auto newFastModeData = (EncodedValue*)GC_MALLOC(sizeof(EncodedValue) * newCapacity);
-                    memcpy(newFastModeData, m_fastModeData, sizeof(EncodedValue) * oldLength);
-                    GC_FREE(m_fastModeData);
-                    m_fastModeData = newFastModeData;
-
-                    for (size_t i = oldLength; i < newLength; i++) {
-                        m_fastModeData[i] = EncodedValue(EncodedValue::EmptyValue);
-                    }
-
-                    rd->m_arrayObjectFastModeBufferCapacity = newCapacity;
-                    if (rd->m_arrayObjectFastModeBufferExpandCount < minExpandCountForUsingLog2Function) {
-                        rd->m_arrayObjectFastModeBufferExpandCount++;
-                    }
-                } else {
-                    for (size_t i = oldLength; i < newLength; i++) {
-                        m_fastModeData[i] = EncodedValue(EncodedValue::EmptyValue);
-                    }
-                    rd->m_arrayObjectFastModeBufferCapacity = oldCapacity;
+                if (newLength > oldLength) {
+                    fillFastModeHoles(oldLength, newLength);
                 }
-#endif
             }
 
             if (UNLIKELY(!isLengthPropertyWritable())) {
@@ -523,7 +618,7 @@ ObjectGetResult ArrayObject::getVirtualValue(ExecutionState& state, const Object
     if (LIKELY(isFastModeArray())) {
         uint64_t idx = P.tryToUseAsArrayIndex();
         if (LIKELY(idx != Value::InvalidArrayIndexValue) && LIKELY(idx < arrayLength(state))) {
-            Value v = m_fastModeData[idx];
+            Value v = getFastModeValue(idx);
             if (LIKELY(!v.isEmpty())) {
                 return ObjectGetResult(v, true, true, true);
             }
@@ -538,7 +633,7 @@ ObjectHasPropertyResult ArrayObject::hasIndexedProperty(ExecutionState& state, c
     if (LIKELY(isFastModeArray())) {
         uint32_t idx = propertyName.tryToUseAsArrayIndex(state);
         if (LIKELY(idx != Value::InvalidArrayIndexValue) && LIKELY(idx < arrayLength(state))) {
-            Value v = m_fastModeData[idx];
+            Value v = getFastModeValue(idx);
             if (LIKELY(!v.isEmpty())) {
                 return ObjectHasPropertyResult(ObjectGetResult(v, true, true, true));
             }
@@ -552,7 +647,7 @@ ObjectGetResult ArrayObject::getIndexedProperty(ExecutionState& state, const Val
     if (LIKELY(isFastModeArray())) {
         uint32_t idx = property.tryToUseAsArrayIndex(state);
         if (LIKELY(idx != Value::InvalidArrayIndexValue) && LIKELY(idx < arrayLength(state))) {
-            Value v = m_fastModeData[idx];
+            Value v = getFastModeValue(idx);
             if (LIKELY(!v.isEmpty())) {
                 return ObjectGetResult(v, true, true, true);
             }
@@ -577,11 +672,11 @@ bool ArrayObject::setIndexedProperty(ExecutionState& state, const Value& propert
                 }
                 // fast, non-fast mode can be changed while changing length
                 if (LIKELY(isFastModeArray())) {
-                    m_fastModeData[idx] = value;
+                    setFastModeValue(idx, value);
                     return true;
                 }
             } else {
-                m_fastModeData[idx] = value;
+                setFastModeValue(idx, value);
                 return true;
             }
         }
@@ -34,8 +34,10 @@ class ArrayIteratorObject;
 class ArrayObject : public Object {
     friend class VMInstance;
     friend class ByteCodeInterpreter;
+    friend class JITOperations;
     friend class EnumerateObjectWithDestruction;
     friend class EnumerateObjectWithIteration;
+    friend class JSONStringifyFastPath;
     friend Value builtinArrayConstructor(ExecutionState& state, Value thisValue, size_t argc, Value* argv, Optional<Object*> newTarget);
     friend void initializeCustomAllocators();
     friend int getValidValueInArrayObject(void* ptr, GC_mark_custom_result* arr);
@@ -92,6 +94,7 @@ protected:
     ArrayObject()
         : Object()
         , m_arrayLength(0)
+        , m_elementKind(Int32ElementKind)
 #if !defined(ESCARGOT_64) || !defined(ESCARGOT_USE_32BIT_IN_64BIT)
         , m_fastModeData(nullptr)
 #endif
@@ -101,6 +104,20 @@ protected:
     }
 
 private:
+    // Representation of fast-mode elements.
+    // Kind only moves toward GenericElementKind (Int32 -> Double -> Generic) while the array stays in fast mode.
+    // Every kind stores holes in-place, so packed and holey arrays share the same representation.
+    enum ElementKind : uint8_t {
+        Int32ElementKind, // int32_t buffer allocated by GC_MALLOC_ATOMIC. hole is Int32ElementHole
+        DoubleElementKind, // double buffer allocated by GC_MALLOC_ATOMIC. hole is DoubleElementHoleBits
+        GenericElementKind, // ObjectPropertyValue buffer. hole is empty value
+    };
+
+    static constexpr int32_t Int32ElementHole = std::numeric_limits<int32_t>::min();
+    // quiet NaN with non-zero payload. every NaN element is canonicalized before store, so this never collides with a value
+    // (signaling NaN is not used because x87 loads quiet it)
+    static constexpr uint64_t DoubleElementHoleBits = 0x7ff8000000000001ULL;
+
     ALWAYS_INLINE bool isFastModeArray()
     {
         if (UNLIKELY(hasRareData())) {
@@ -118,9 +135,95 @@ private:
     {
         ASSERT(isFastModeArray());
         ASSERT(idx < arrayLength(state));
-        m_fastModeData[idx] = v;
+        setFastModeValue(idx, v);
+    }
+
+    void* fastModeBuffer()
+    {
+#if defined(ESCARGOT_64) && defined(ESCARGOT_USE_32BIT_IN_64BIT)
+        return m_fastModeData.data();
+#else
+        return m_fastModeData;
+#endif
+    }
+
+    void setFastModeBuffer(void* buffer)
+    {
+#if defined(ESCARGOT_64) && defined(ESCARGOT_USE_32BIT_IN_64BIT)
+        m_fastModeData.setData(reinterpret_cast<EncodedSmallValue*>(buffer));
+#else
+        m_fastModeData = reinterpret_cast<ObjectPropertyValue*>(buffer);
+#endif
+    }
+
+    int32_t* fastModeInt32Data()
+    {
+        ASSERT(m_elementKind == Int32ElementKind);
+        return reinterpret_cast<int32_t*>(fastModeBuffer());
+    }
+
+    double* fastModeDoubleData()
+    {
+        ASSERT(m_elementKind == DoubleElementKind);
+        return reinterpret_cast<double*>(fastModeBuffer());
+    }
+
+    // returns empty value for hole
+    ALWAYS_INLINE Value getFastModeValue(size_t idx)
+    {
+        switch (m_elementKind) {
+        case Int32ElementKind: {
+            int32_t v = fastModeInt32Data()[idx];
+            if (UNLIKELY(v == Int32ElementHole)) {
+                return Value(Value::EmptyValue);
+            }
+            return Value(v);
+        }
+        case DoubleElementKind: {
+            double v = fastModeDoubleData()[idx];
+            if (UNLIKELY(bitwise_cast<uint64_t>(v) == DoubleElementHoleBits)) {
+                return Value(Value::EmptyValue);
+            }
+            return Value(v);
+        }
+        default:
+            ASSERT(m_elementKind == GenericElementKind);
+            return m_fastModeData[idx];
+        }
+    }
+
+    // empty value makes a hole
+    ALWAYS_INLINE void setFastModeValue(size_t idx, const Value& v)
+    {
+        switch (m_elementKind) {
+        case Int32ElementKind:
+            if (LIKELY(v.isInt32() && v.asInt32() != Int32ElementHole)) {
+                fastModeInt32Data()[idx] = v.asInt32();
+                return;
+            }
+            break;
+        case DoubleElementKind:
+            if (LIKELY(v.isNumber())) {
+                double d = v.asNumber();
+                fastModeDoubleData()[idx] = UNLIKELY(std::isnan(d)) ? std::numeric_limits<double>::quiet_NaN() : d;
+                return;
+            }
+            break;
+        default:
+            ASSERT(m_elementKind == GenericElementKind);
+            m_fastModeData[idx] = v;
+            return;
+        }
+        setFastModeValueSlowCase(idx, v);
     }
 
+    void setFastModeValueSlowCase(size_t idx, const Value& v);
+    void transitionElementKind(ElementKind newKind);
+    void* allocateFastModeBuffer(ElementKind kind, size_t capacity);
+    void reallocateFastModeBuffer(size_t oldLength, size_t newCapacity);
+    void fillFastModeHoles(size_t start, size_t end);
+    static ElementKind elementKindFor(const Value* src, size_t size);
+
     ALWAYS_INLINE uint32_t arrayLength(ExecutionState&)
     {
         return m_arrayLength;
@@ -133,6 +236,7 @@ private:
     ObjectGetResult getVirtualValue(ExecutionState& state, const ObjectPropertyName& P);
 
     uint32_t m_arrayLength;
+    ElementKind m_elementKind;
 #if defined(ESCARGOT_64) && defined(ESCARGOT_USE_32BIT_IN_64BIT)
     TightVectorWithNoSize<EncodedSmallValue, CustomAllocator<EncodedSmallValue>> m_fastModeData;
 #else
@@ -23,6 +23,90 @@
 
 namespace Escargot {
 
+AtomicStringMap::AtomicStringMap()
+    : m_capacity(InitialCapacity)
+    , m_size(0)
+    , m_strings(nullptr)
+    , m_hashes(nullptr)
+{
+    m_strings = (String**)GC_MALLOC(sizeof(String*) * m_capacity);
+    m_hashes = (uint32_t*)GC_MALLOC_ATOMIC(sizeof(uint32_t) * m_capacity);
+    memset(m_hashes, 0, sizeof(uint32_t) * m_capacity);
+}
+
+AtomicStringMap::~AtomicStringMap()
+{
+    GC_FREE(m_strings);
+    GC_FREE(m_hashes);
+}
+
+String* AtomicStringMap::find(String* str, size_t hash) const
+{
+    const uint32_t storedHash = static_cast<uint32_t>(hash);
+    ASSERT(storedHash);
+    const size_t mask = m_capacity - 1;
+    for (size_t i = storedHash & mask;; i = (i + 1) & mask) {
+        uint32_t h = m_hashes[i];
+        if (!h) {
+            return nullptr;
+        }
+        if (h == storedHash && m_strings[i]->equals(str)) {
+            return m_strings[i];
+        }
+    }
+}
+
+void AtomicStringMap::insert(String* str, size_t hash)
+{
+    ASSERT(!find(str, hash));
+    // keep load factor under 3/4
+    if (UNLIKELY((m_size + 1) * 4 > m_capacity * 3)) {
+        grow();
+    }
+
+    const uint32_t storedHash = static_cast<uint32_t>(hash);
+    const size_t mask = m_capacity - 1;
+    size_t i = storedHash & mask;
+    while (m_hashes[i]) {
+        i = (i + 1) & mask;
+    }
+    m_strings[i] = str;
+    m_hashes[i] = storedHash;
+    m_size++;
+}
+
+void AtomicStringMap::grow()
+{
+    size_t oldCapacity = m_capacity;
+    String** oldStrings = m_strings;
+    uint32_t* oldHashes = m_hashes;
+
+    size_t capacity = oldCapacity * 2;
+    const size_t mask = capacity - 1;
+    String** strings = (String**)GC_MALLOC(sizeof(String*) * capacity);
+    uint32_t* hashes = (uint32_t*)GC_MALLOC_ATOMIC(sizeof(uint32_t) * capacity);
+    memset(hashes, 0, sizeof(uint32_t) * capacity);
+
+    // cached hash values are reused, so strings are not read while rehashing
+    for (size_t i = 0; i < oldCapacity; i++) {
+        uint32_t h = oldHashes[i];
+        if (h) {
+            size_t j = h & mask;
+            while (hashes[j]) {
+                j = (j + 1) & mask;
+            }
+            strings[j] = oldStrings[i];
+            hashes[j] = h;
+        }
+    }
+
+    m_capacity = capacity;
+    m_strings = strings;
+    m_hashes = hashes;
+    GC_FREE(oldStrings);
+    GC_FREE(oldHashes);
+}
+
 AtomicString::AtomicString(ExecutionState& ec, const char16_t* src, size_t len)
 {
     init(ec.context()->m_atomicStringMap, src, len);
@@ -125,19 +209,20 @@ void AtomicString::init(AtomicStringMap* map, const char* src, size_t len, bool
 {
     ASCIIStringOnStack stringForSearch(src, len);
 
-    auto iter = map->find(&stringForSearch);
-    if (map->end() == iter) {
+    size_t hash = stringForSearch.hashValue();
+    String* found = map->find(&stringForSearch, hash);
+    if (!found) {
         ASCIIString* newStr;
         if (fromExternalMemory) {
             newStr = new ASCIIStringFromExternalMemory(src, len);
         } else {
             newStr = new ASCIIString(src, len);
         }
-        map->insert(newStr);
+        map->insert(newStr, hash);
         m_string = newStr;
         newStr->m_tag = (size_t)POINTER_VALUE_STRING_TAG_IN_DATA | (size_t)m_string;
     } else {
-        m_string = iter.operator*();
+        m_string = found;
     }
 }
 
@@ -188,14 +273,15 @@ void AtomicString::init(AtomicStringMap* map, const LChar* src, size_t len)
 {
     Latin1StringOnStack stringForSearch(src, len);
 
-    auto iter = map->find(&stringForSearch);
-    if (map->end() == iter) {
+    size_t hash = stringForSearch.hashValue();
+    String* found = map->find(&stringForSearch, hash);
+    if (!found) {
         Latin1String* newStr = new Latin1String(src, len);
-        map->insert(newStr);
+        map->insert(newStr, hash);
         m_string = newStr;
         newStr->m_tag = (size_t)POINTER_VALUE_STRING_TAG_IN_DATA | (size_t)m_string;
     } else {
-        m_string = iter.operator*();
+        m_string = found;
     }
 }
 
@@ -246,19 +332,20 @@ void AtomicString::init(AtomicStringMap* map, const char16_t* src, size_t len)
 {
     UTF16StringOnStack stringForSearch(src, len);
 
-    auto iter = map->find(&stringForSearch);
-    if (map->end() == iter) {
+    size_t hash = stringForSearch.hashValue();
+    String* found = map->find(&stringForSearch, hash);
+    if (!found) {
         String* newStr;
         if (isAllASCII(src, len)) {
             newStr = new ASCIIString(src, len);
         } else {
             newStr = new UTF16String(src, len);
         }
-        map->insert(newStr);
+        map->insert(newStr, hash);
         m_string = newStr;
         newStr->m_tag = (size_t)POINTER_VALUE_STRING_TAG_IN_DATA | (size_t)m_string;
     } else {
-        m_string = iter.operator*();
+        m_string = found;
     }
 }
 
@@ -271,8 +358,9 @@ AtomicString::AtomicString(Context* c, const StringView& sv)
     }
 
     AtomicStringMap* ec = c->atomicStringMap();
-    auto iter = ec->find(&const_cast<StringView&>(sv));
-    if (ec->end() == iter) {
+    size_t hash = sv.hashValue();
+    String* found = ec->find(&const_cast<StringView&>(sv), hash);
+    if (!found) {
         String* newString;
         auto buffer = sv.bufferAccessData();
         if (buffer.has8BitContent) {
@@ -280,12 +368,11 @@ AtomicString::AtomicString(Context* c, const StringView& sv)
         } else {
             newString = new UTF16String((const char16_t*)buffer.buffer, buffer.length);
         }
-        ec->insert(newString);
-        ASSERT(ec->find(newString) != ec->end());
+        ec->insert(newString, hash);
         m_string = newString;
         const_cast<StringView&>(sv).m_tag = (size_t)POINTER_VALUE_STRING_TAG_IN_DATA | (size_t)m_string;
     } else {
-        m_string = iter.operator*();
+        m_string = found;
         const_cast<StringView&>(sv).m_tag = (size_t)POINTER_VALUE_STRING_TAG_IN_DATA | (size_t)m_string;
     }
 }
@@ -297,7 +384,7 @@ AtomicString::AtomicString(Context* c, String* name)
 
 void AtomicString::initStaticString(AtomicStringMap* ec, String* name)
 {
-    ASSERT(ec->find(name) == ec->end());
+    ASSERT(!ec->find(name));
     ec->insert(name);
     m_string = name;
     name->m_tag = (size_t)POINTER_VALUE_STRING_TAG_IN_DATA | (size_t)m_string;
@@ -311,8 +398,9 @@ void AtomicString::init(AtomicStringMap* ec, String* name)
         return;
     }
 
-    auto iter = ec->find(name);
-    if (ec->end() == iter) {
+    size_t hash = name->hashValue();
+    String* found = ec->find(name, hash);
+    if (!found) {
         if (name->isStringView()) {
             auto buffer = name->bufferAccessData();
             if (buffer.has8BitContent) {
@@ -322,12 +410,11 @@ void AtomicString::init(AtomicStringMap* ec, String* name)
             }
         }
         ASSERT(!name->isStringView());
-        ec->insert(name);
-        ASSERT(ec->find(name) != ec->end());
+        ec->insert(name, hash);
         m_string = name;
         name->m_tag = (size_t)POINTER_VALUE_STRING_TAG_IN_DATA | (size_t)m_string;
     } else {
-        m_string = iter.operator*();
+        m_string = found;
         name->m_tag = (size_t)POINTER_VALUE_STRING_TAG_IN_DATA | (size_t)m_string;
     }
 }
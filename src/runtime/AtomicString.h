@@ -27,7 +27,46 @@
 
 namespace Escargot {
 
-typedef std::unordered_set<String*, std::hash<String*>, std::equal_to<String*>, GCUtil::gc_malloc_allocator<String*> > AtomicStringMap;
+// open addressing hash set of atomic strings with linear probing
+// hash values are kept in a separated array, so probing does not touch the strings until hash values are same
+// strings are never removed from this map
+class AtomicStringMap {
+public:
+    AtomicStringMap();
+    ~AtomicStringMap();
+
+    AtomicStringMap(const AtomicStringMap&) = delete;
+    AtomicStringMap& operator=(const AtomicStringMap&) = delete;
+
+    size_t size() const
+    {
+        return m_size;
+    }
+
+    // returns the string in this map which has same content with str or nullptr
+    String* find(String* str) const
+    {
+        return find(str, str->hashValue());
+    }
+    String* find(String* str, size_t hash) const;
+
+    // str should not be in this map
+    void insert(String* str)
+    {
+        insert(str, str->hashValue());
+    }
+    void insert(String* str, size_t hash);
+
+private:
+    static constexpr size_t InitialCapacity = 4096;
+    void grow();
+
+    size_t m_capacity; // power of 2
+    size_t m_size;
+    String** m_strings;
+    // hash value of each string, 0 for empty slot (String::hashValue is never 0)
+    uint32_t* m_hashes;
+};
 
 class AtomicString : public gc {
     friend class StaticStrings;
@@ -147,7 +147,13 @@ void BigInt::initFinalizer()
 {
     GC_REGISTER_FINALIZER_NO_ORDER(this, [](void* obj, void*) {
         BigInt* self = (BigInt*)obj;
-        bf_delete(&self->m_bf);
+        // finalizer can run on another thread after the thread which created this BigInt has finished
+        // so m_bf.ctx (bf_context_t of the creating thread) could be already ended here.
+        // every bf_context_t reallocates limbs with libc realloc (see VMInstance::initializeThread),
+        // so the limbs are released without touching the context.
+        free(self->m_bf.tab);
+        self->m_bf.tab = nullptr;
+        self->m_bf.len = 0;
     },
                                    nullptr, nullptr, nullptr);
 }
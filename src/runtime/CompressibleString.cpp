@@ -49,8 +49,11 @@ CompressibleString::CompressibleString(VMInstance* instance)
 {
     m_bufferData.hasSpecialImpl = true;
 
-    auto& v = instance->compressibleStrings();
-    v.push_back(this);
+    {
+        VMInstance::RegistryLocker locker(instance);
+        auto& v = instance->compressibleStrings();
+        v.push_back(this);
+    }
     GC_REGISTER_FINALIZER_NO_ORDER(this, [](void* obj, void*) {
         CompressibleString* self = (CompressibleString*)obj;
         if (self->isCompressed()) {
@@ -60,10 +63,14 @@ CompressibleString::CompressibleString(VMInstance* instance)
         }
 
         if (!self->m_isOwnerMayFreed) {
-            self->m_vmInstance->compressibleStringsUncomressedBufferSize() -= self->decomressedBufferSize();
-
-            auto& v = self->m_vmInstance->compressibleStrings();
-            v.erase(std::find(v.begin(), v.end(), self));
+            VMInstance::RegistryLocker locker(self->m_vmInstance);
+            // ~VMInstance can be running on another thread
+            if (!self->m_isOwnerMayFreed) {
+                self->m_vmInstance->compressibleStringsUncomressedBufferSize() -= self->decomressedBufferSize();
+
+                auto& v = self->m_vmInstance->compressibleStrings();
+                v.erase(std::find(v.begin(), v.end(), self));
+            }
         }
     },
                                    nullptr, nullptr, nullptr);
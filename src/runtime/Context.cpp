@@ -31,6 +31,7 @@
 #include "SandBox.h"
 #include "ArrayObject.h"
 #include "debugger/Debugger.h"
+#include "ContextSnapshot.h"
 #if defined(ENABLE_WASM)
 #include "wasm/WASMObject.h"
 #endif
@@ -89,7 +90,12 @@ Context::Context(VMInstance* instance)
 {
     ExecutionState stateForInit(this);
     m_globalObjectProxy = m_globalObject = new GlobalObject(stateForInit);
-    m_globalObject->installBuiltins(stateForInit);
+    if (ContextSnapshot* snapshot = instance->contextSnapshot()) {
+        snapshot->restore(stateForInit, m_globalObject);
+    } else {
+        m_globalObject->installBuiltins(stateForInit);
+        instance->ensureContextSnapshot(stateForInit, m_globalObject);
+    }
 }
 
 void Context::throwException(ExecutionState& state, const Value& exception)
@@ -0,0 +1,436 @@
+/*
+ * Copyright (c) 2021-present Samsung Electronics Co., Ltd
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+ */
+
+#include "Escargot.h"
+#include "ContextSnapshot.h"
+#include "runtime/Context.h"
+#include "runtime/GlobalObject.h"
+#include "runtime/ObjectStructure.h"
+#include "runtime/NativeFunctionObject.h"
+#include "runtime/ArrayObject.h"
+#include "runtime/StringObject.h"
+#include "runtime/NumberObject.h"
+#include "runtime/BooleanObject.h"
+#include "runtime/SymbolObject.h"
+#include "runtime/BigIntObject.h"
+#include "runtime/MapObject.h"
+
+namespace Escargot {
+
+struct ContextSnapshotRecordingData {
+    explicit ContextSnapshotRecordingData(GlobalObject* globalObject)
+        : m_globalObject(globalObject)
+    {
+    }
+
+    GlobalObject* m_globalObject;
+    // every object is alive while recording because it is reachable from m_globalObject
+    std::unordered_map<Object*, size_t> m_objectIndexes;
+    std::unordered_map<JSGetterSetter*, size_t> m_getterSetterIndexes;
+    std::vector<Object*> m_sources;
+    std::vector<std::pair<size_t, uint8_t>> m_kindTags;
+};
+
+static ObjectStructure* createTransitionStructure(ObjectStructure* from)
+{
+    size_t propertyCount = from->propertyCount();
+    const ObjectStructureItem* properties = from->properties();
+
+    ObjectStructureItemTightVector structureItemVector;
+    structureItemVector.resizeWithUninitializedValues(propertyCount);
+
+    bool hasNonAtomicPropertyName = false;
+    for (size_t i = 0; i < propertyCount; i++) {
+        structureItemVector[i] = properties[i];
+        hasNonAtomicPropertyName |= !properties[i].m_propertyName.hasAtomicString();
+    }
+
+    return new ObjectStructureWithTransition(std::move(structureItemVector), from->hasIndexPropertyName(), hasNonAtomicPropertyName);
+}
+
+// builtin objects had non-transition structure when they are installed (see Object::setGlobalIntrinsicObject)
+// non-transition structure is modified in place on adding property, so each copy needs its own one
+static ObjectStructure* createNonTransitionStructure(ObjectStructure* from)
+{
+    size_t propertyCount = from->propertyCount();
+    if (propertyCount > ESCARGOT_OBJECT_STRUCTURE_ACCESS_CACHE_BUILD_MIN_SIZE) {
+        const ObjectStructureItem* properties = from->properties();
+        ObjectStructureItemTightVector structureItemVector;
+        structureItemVector.resizeWithUninitializedValues(propertyCount);
+        for (size_t i = 0; i < propertyCount; i++) {
+            structureItemVector[i] = properties[i];
+        }
+        return new ObjectStructureWithMap(from->hasIndexPropertyName(), std::move(structureItemVector));
+    }
+
+    return from->convertToNonTransitionStructure();
+}
+
+ContextSnapshot* ContextSnapshot::create(ExecutionState& state, GlobalObject* globalObject)
+{
+    ContextSnapshotRecordingData data(globalObject);
+
+    // every builtin object is one of these classes
+    // an exact type is found by comparing the virtual table address (see PointerValue::g_arrayObjectTag)
+    ASSERT(globalObject->m_objectCreate->isNativeFunctionObject());
+    ASSERT(globalObject->m_stringPrototype->isStringObject());
+    ASSERT(globalObject->m_numberPrototype->isNumberObject());
+    ASSERT(globalObject->m_booleanPrototype->isBooleanObject());
+    ASSERT(globalObject->m_symbolProxyObject->isSymbolObject());
+    ASSERT(globalObject->m_bigIntProxyObject->isBigIntObject());
+    ASSERT(globalObject->m_mapPrototype->isMapObject());
+    data.m_kindTags.push_back(std::make_pair(globalObject->m_objectPrototype->getTag(), OrdinaryObjectKind));
+    data.m_kindTags.push_back(std::make_pair(globalObject->m_objectCreate->getTag(), NativeFunctionObjectKind));
+    data.m_kindTags.push_back(std::make_pair(globalObject->m_arrayPrototype->getTag(), ArrayPrototypeObjectKind));
+    data.m_kindTags.push_back(std::make_pair(globalObject->m_stringPrototype->getTag(), StringObjectKind));
+    data.m_kindTags.push_back(std::make_pair(globalObject->m_numberPrototype->getTag(), NumberObjectKind));
+    data.m_kindTags.push_back(std::make_pair(globalObject->m_booleanPrototype->getTag(), BooleanObjectKind));
+    data.m_kindTags.push_back(std::make_pair(globalObject->m_symbolProxyObject->getTag(), SymbolObjectKind));
+    data.m_kindTags.push_back(std::make_pair(globalObject->m_bigIntProxyObject->getTag(), BigIntObjectKind));
+    data.m_kindTags.push_back(std::make_pair(globalObject->m_mapPrototype->getTag(), MapObjectKind));
+
+    ContextSnapshot* snapshot = new ContextSnapshot();
+    if (snapshot->recordObject(data, globalObject) == SIZE_MAX) {
+        return nullptr;
+    }
+
+#define RECORD_BUILTIN_VALUE(builtin, TYPE, NAME)                               \
+    {                                                                           \
+        SnapshotValue value;                                                    \
+        if (!snapshot->recordPointer(data, globalObject->m_##builtin, value)) { \
+            return nullptr;                                                     \
+        }                                                                       \
+        snapshot->m_builtins.pushBack(value);                                   \
+    }
+
+    GLOBALOBJECT_BUILTIN_LIST(RECORD_BUILTIN_VALUE)
+#undef RECORD_BUILTIN_VALUE
+
+    // recordObject appends newly found objects to m_objects
+    // so this loop visits every reachable object
+    for (size_t i = 0; i < snapshot->m_objects.size(); i++) {
+        if (!snapshot->recordProperties(data, i)) {
+            return nullptr;
+        }
+    }
+
+    return snapshot;
+}
+
+size_t ContextSnapshot::recordObject(ContextSnapshotRecordingData& data, Object* obj)
+{
+    auto iter = data.m_objectIndexes.find(obj);
+    if (iter != data.m_objectIndexes.end()) {
+        return iter->second;
+    }
+
+    SnapshotObject info;
+    if (obj == data.m_globalObject) {
+        info.m_kind = GlobalObjectKind;
+    } else if (obj == data.m_globalObject->m_objectPrototype) {
+        info.m_kind = ObjectPrototypeKind;
+    } else {
+        size_t tag = obj->getTag();
+        size_t i = 0;
+        for (; i < data.m_kindTags.size(); i++) {
+            if (data.m_kindTags[i].first == tag) {
+                break;
+            }
+        }
+        if (i == data.m_kindTags.size()) {
+            return SIZE_MAX;
+        }
+        info.m_kind = (ObjectKind)data.m_kindTags[i].second;
+    }
+
+    bool isExtensible = true;
+    bool isEverSetAsPrototypeObject = false;
+    Object* proto = obj->m_prototype;
+    if (obj->hasRareData()) {
+        ObjectRareData* rareData = obj->rareData();
+        // extra data and internal slot are not part of the snapshot
+        if (rareData->m_extraData || rareData->m_isSpreadArrayObject || rareData->m_hasNonWritableLastIndexRegExpObject) {
+            return SIZE_MAX;
+        }
+        if (info.m_kind != ArrayPrototypeObjectKind && rareData->m_internalSlot) {
+            return SIZE_MAX;
+        }
+#if defined(ESCARGOT_ENABLE_TEST)
+        if (rareData->m_isHTMLDDA) {
+            return SIZE_MAX;
+        }
+#endif
+        isExtensible = rareData->m_isExtensible;
+        isEverSetAsPrototypeObject = rareData->m_isEverSetAsPrototypeObject;
+        proto = rareData->m_prototype;
+    }
+
+    // prototype object should be created ahead of the object on restore
+    info.m_prototypeIndex = SIZE_MAX;
+    if (proto) {
+        info.m_prototypeIndex = recordObject(data, proto);
+        if (info.m_prototypeIndex == SIZE_MAX) {
+            return SIZE_MAX;
+        }
+    }
+
+    info.m_isExtensible = isExtensible;
+    info.m_isEverSetAsPrototypeObject = isEverSetAsPrototypeObject;
+    if (obj->structure()->inTransitionMode()) {
+        // structures in transition mode are never modified, so they can be shared by every Context
+        info.m_hasOwnStructure = false;
+        info.m_structure = obj->structure();
+    } else {
+        info.m_hasOwnStructure = true;
+        info.m_structure = createTransitionStructure(obj->structure());
+    }
+    info.m_valueStart = SIZE_MAX;
+    info.m_primitiveValue = Value();
+    info.m_nativeFunction = nullptr;
+    info.m_functionLength = 0;
+    info.m_functionFlags = 0;
+
+    switch (info.m_kind) {
+    case NativeFunctionObjectKind: {
+        NativeCodeBlock* codeBlock = obj->asFunctionObject()->codeBlock()->asNativeCodeBlock();
+        info.m_functionName = codeBlock->functionName();
+        info.m_nativeFunction = codeBlock->nativeFunction();
+        info.m_functionLength = codeBlock->functionLength();
+        info.m_functionFlags = (codeBlock->isStrict() ? NativeFunctionInfo::Strict : 0) | (codeBlock->isNativeConstructor() ? NativeFunctionInfo::Constructor : 0);
+        break;
+    }
+    case StringObjectKind:
+        info.m_primitiveValue = Value(obj->asStringObject()->primitiveValue());
+        break;
+    case NumberObjectKind:
+        info.m_primitiveValue = Value(obj->asNumberObject()->primitiveValue());
+        break;
+    case BooleanObjectKind:
+        info.m_primitiveValue = Value(obj->asBooleanObject()->primitiveValue());
+        break;
+    case SymbolObjectKind:
+        info.m_primitiveValue = Value(obj->asSymbolObject()->primitiveValue());
+        break;
+    case BigIntObjectKind:
+        info.m_primitiveValue = Value(obj->asBigIntObject()->primitiveValue());
+        break;
+    default:
+        break;
+    }
+
+    size_t index = m_objects.size();
+    m_objects.pushBack(info);
+    data.m_sources.push_back(obj);
+    data.m_objectIndexes.insert(std::make_pair(obj, index));
+    return index;
+}
+
+bool ContextSnapshot::recordProperties(ContextSnapshotRecordingData& data, size_t index)
+{
+    Object* obj = data.m_sources[index];
+    ObjectStructure* structure = obj->structure();
+    size_t propertyCount = structure->propertyCount();
+
+    // m_objects can be reallocated by recordValue
+    m_objects[index].m_valueStart = m_values.size();
+    for (size_t i = 0; i < propertyCount; i++) {
+        const ObjectStructurePropertyDescriptor& desc = structure->readProperty(i).m_descriptor;
+        SnapshotValue value;
+        if (desc.isNativeAccessorProperty()) {
+            // private data of native accessor is not a js value
+            value.m_value = Value(Value::FromPayload, obj->m_values[i].payload());
+        } else if (desc.isDataProperty()) {
+            if (!recordValue(data, Value(obj->m_values[i]), value)) {
+                return false;
+            }
+        } else if (!recordPointer(data, Value(obj->m_values[i]).asPointerValue(), value)) {
+            return false;
+        }
+        m_values.pushBack(value);
+    }
+
+    return true;
+}
+
+bool ContextSnapshot::recordValue(ContextSnapshotRecordingData& data, const Value& value, SnapshotValue& result)
+{
+    if (value.isObject()) {
+        return recordPointer(data, value.asObject(), result);
+    }
+
+    if (value.isPointerValue() && !value.isString() && !value.isSymbol() && !value.isBigInt()) {
+        return false;
+    }
+
+    // primitive values are immutable, so they are shared by every Context
+    result.m_type = SnapshotValue::PlainValue;
+    result.m_value = value;
+    return true;
+}
+
+bool ContextSnapshot::recordPointer(ContextSnapshotRecordingData& data, PointerValue* pointer, SnapshotValue& result)
+{
+    if (!pointer) {
+        result.m_type = SnapshotValue::PlainValue;
+        result.m_value = Value(Value::EmptyValue);
+        return true;
+    }
+
+    if (pointer->isObject()) {
+        size_t index = recordObject(data, pointer->asObject());
+        if (index == SIZE_MAX) {
+            return false;
+        }
+        result.m_type = SnapshotValue::ObjectIndex;
+        result.m_index = index;
+        return true;
+    }
+
+    if (!pointer->isJSGetterSetter()) {
+        return false;
+    }
+
+    // JSGetterSetter can be shared by several properties (e.g. GlobalObject::throwerGetterSetterData)
+    JSGetterSetter* gs = pointer->asJSGetterSetter();
+    auto iter = data.m_getterSetterIndexes.find(gs);
+    if (iter == data.m_getterSetterIndexes.end()) {
+        SnapshotGetterSetter item;
+        if (gs->hasGetter() && !recordValue(data, gs->getter(), item.m_getter)) {
+            return false;
+        }
+        if (gs->hasSetter() && !recordValue(data, gs->setter(), item.m_setter)) {
+            return false;
+        }
+        iter = data.m_getterSetterIndexes.insert(std::make_pair(gs, m_getterSetters.size())).first;
+        m_getterSetters.pushBack(item);
+    }
+
+    result.m_type = SnapshotValue::GetterSetterIndex;
+    result.m_index = iter->second;
+    return true;
+}
+
+Object* ContextSnapshot::restoreObject(ExecutionState& state, GlobalObject* globalObject, const SnapshotObject& info, Object* proto)
+{
+    switch (info.m_kind) {
+    case GlobalObjectKind:
+        return globalObject;
+    case ObjectPrototypeKind:
+        return globalObject->m_objectPrototype;
+    case OrdinaryObjectKind:
+        if (proto) {
+            return new Object(state, proto);
+        }
+        return new Object(state, Object::PrototypeIsNull);
+    case NativeFunctionObjectKind:
+        return new NativeFunctionObject(state.context(), state.context()->defaultStructureForObject(), ObjectPropertyValueVector(), proto,
+                                        NativeFunctionInfo(info.m_functionName, info.m_nativeFunction, info.m_functionLength, info.m_functionFlags));
+    case ArrayPrototypeObjectKind:
+        return new ArrayPrototypeObject(state);
+    case StringObjectKind:
+        return new StringObject(state, proto, info.m_primitiveValue.asString());
+    case NumberObjectKind:
+        return new NumberObject(state, proto, info.m_primitiveValue.asNumber());
+    case BooleanObjectKind:
+        return new BooleanObject(state, proto, info.m_primitiveValue.asBoolean());
+    case SymbolObjectKind:
+        return new SymbolObject(state, proto, info.m_primitiveValue.asSymbol());
+    case BigIntObjectKind:
+        return new BigIntObject(state, proto, info.m_primitiveValue.asBigInt());
+    case MapObjectKind:
+        return new MapObject(state, proto);
+    default:
+        RELEASE_ASSERT_NOT_REACHED();
+        return nullptr;
+    }
+}
+
+Value ContextSnapshot::restoreValue(const SnapshotValue& value, Object** objects, JSGetterSetter** getterSetters)
+{
+    switch (value.m_type) {
+    case SnapshotValue::ObjectIndex:
+        return Value(objects[value.m_index]);
+    case SnapshotValue::GetterSetterIndex:
+        return Value(static_cast<PointerValue*>(getterSetters[value.m_index]));
+    default:
+        return value.m_value;
+    }
+}
+
+void ContextSnapshot::restore(ExecutionState& state, GlobalObject* globalObject)
+{
+    Vector<Object*, GCUtil::gc_malloc_allocator<Object*>> objects;
+    objects.resizeWithUninitializedValues(m_objects.size());
+
+    // create every object first, because properties can refer any object
+    for (size_t i = 0; i < m_objects.size(); i++) {
+        const SnapshotObject& info = m_objects[i];
+        Object* proto = nullptr;
+        if (info.m_prototypeIndex != SIZE_MAX) {
+            ASSERT(info.m_prototypeIndex < i);
+            proto = objects[info.m_prototypeIndex];
+        }
+
+        Object* obj = restoreObject(state, globalObject, info, proto);
+        if (info.m_isEverSetAsPrototypeObject) {
+            obj->ensureRareData()->m_isEverSetAsPrototypeObject = true;
+        }
+        if (!info.m_isExtensible) {
+            obj->ensureRareData()->m_isExtensible = false;
+        }
+        if (obj->hasRareData()) {
+            obj->rareData()->m_prototype = proto;
+        } else {
+            obj->m_prototype = proto;
+        }
+
+        size_t oldPropertyCount = obj->m_structure->propertyCount();
+        obj->m_structure = info.m_hasOwnStructure ? createNonTransitionStructure(info.m_structure) : info.m_structure;
+        obj->m_values.resizeWithUninitializedValues(oldPropertyCount, obj->m_structure->propertyCount());
+        objects[i] = obj;
+    }
+
+    Vector<JSGetterSetter*, GCUtil::gc_malloc_allocator<JSGetterSetter*>> getterSetters;
+    getterSetters.resizeWithUninitializedValues(m_getterSetters.size());
+    for (size_t i = 0; i < m_getterSetters.size(); i++) {
+        getterSetters[i] = new JSGetterSetter(restoreValue(m_getterSetters[i].m_getter, objects.data(), nullptr),
+                                              restoreValue(m_getterSetters[i].m_setter, objects.data(), nullptr));
+    }
+
+    for (size_t i = 0; i < m_objects.size(); i++) {
+        Object* obj = objects[i];
+        const SnapshotValue* values = m_values.data() + m_objects[i].m_valueStart;
+        size_t propertyCount = obj->m_structure->propertyCount();
+        for (size_t j = 0; j < propertyCount; j++) {
+            obj->m_values[j] = restoreValue(values[j], objects.data(), getterSetters.data());
+        }
+    }
+
+    size_t builtinIndex = 0;
+#define RESTORE_BUILTIN_VALUE(builtin, TYPE, NAME)                                                          \
+    {                                                                                                       \
+        Value value = restoreValue(m_builtins[builtinIndex++], objects.data(), getterSetters.data());       \
+        globalObject->m_##builtin = value.isEmpty() ? nullptr : static_cast<TYPE*>(value.asPointerValue()); \
+    }
+
+    GLOBALOBJECT_BUILTIN_LIST(RESTORE_BUILTIN_VALUE)
+#undef RESTORE_BUILTIN_VALUE
+    ASSERT(builtinIndex == m_builtins.size());
+}
+} // namespace Escargot
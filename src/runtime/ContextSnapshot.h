@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2021-present Samsung Electronics Co., Ltd
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+ */
+
+#ifndef __EscargotContextSnapshot__
+#define __EscargotContextSnapshot__
+
+#include "runtime/AtomicString.h"
+#include "runtime/Value.h"
+#include "parser/CodeBlock.h"
+
+namespace Escargot {
+
+class GlobalObject;
+class Object;
+class ObjectStructure;
+class JSGetterSetter;
+struct ContextSnapshotRecordingData;
+
+// Heap graph of the builtin objects of a freshly initialized GlobalObject.
+// It is taken once per VMInstance right after the first GlobalObject::installBuiltins,
+// and every later Context copies its builtins from here instead of running the installXXX functions.
+// Object structures, strings, symbols and native function pointers are shared by every Context of a VMInstance,
+// so only the objects themselves are allocated again on restore.
+// The snapshot keeps no reference to the Context it is taken from.
+class ContextSnapshot : public gc {
+public:
+    // returns nullptr if builtins have an object which ContextSnapshot cannot copy
+    static ContextSnapshot* create(ExecutionState& state, GlobalObject* globalObject);
+
+    // fill builtins of newly created GlobalObject
+    void restore(ExecutionState& state, GlobalObject* globalObject);
+
+    size_t objectCount() const
+    {
+        return m_objects.size();
+    }
+
+private:
+    ContextSnapshot() {}
+
+    enum ObjectKind : uint8_t {
+        GlobalObjectKind,
+        ObjectPrototypeKind,
+        OrdinaryObjectKind,
+        NativeFunctionObjectKind,
+        ArrayPrototypeObjectKind,
+        StringObjectKind,
+        NumberObjectKind,
+        BooleanObjectKind,
+        SymbolObjectKind,
+        BigIntObjectKind,
+        MapObjectKind,
+    };
+
+    struct SnapshotValue {
+        enum Type : uint8_t {
+            PlainValue,
+            ObjectIndex,
+            GetterSetterIndex,
+        };
+
+        SnapshotValue()
+            : m_type(PlainValue)
+            , m_index(SIZE_MAX)
+            , m_value(Value::EmptyValue)
+        {
+        }
+
+        Type m_type;
+        size_t m_index;
+        Value m_value;
+    };
+
+    struct SnapshotObject {
+        ObjectKind m_kind;
+        bool m_hasOwnStructure : 1;
+        bool m_isExtensible : 1;
+        bool m_isEverSetAsPrototypeObject : 1;
+        size_t m_prototypeIndex;
+        // transition structure shared by every copy
+        // objects which had non-transition structure get their own copy of this on restore
+        ObjectStructure* m_structure;
+        size_t m_valueStart;
+        // primitive value of String, Number, Boolean, Symbol and BigInt objects
+        Value m_primitiveValue;
+        // info of NativeCodeBlock
+        AtomicString m_functionName;
+        NativeFunctionPointer m_nativeFunction;
+        uint16_t m_functionLength;
+        int m_functionFlags;
+    };
+
+    struct SnapshotGetterSetter {
+        SnapshotValue m_getter;
+        SnapshotValue m_setter;
+    };
+
+    // returns SIZE_MAX on failure
+    size_t recordObject(ContextSnapshotRecordingData& data, Object* obj);
+    bool recordProperties(ContextSnapshotRecordingData& data, size_t index);
+    bool recordValue(ContextSnapshotRecordingData& data, const Value& value, SnapshotValue& result);
+    bool recordPointer(ContextSnapshotRecordingData& data, PointerValue* pointer, SnapshotValue& result);
+
+    Value restoreValue(const SnapshotValue& value, Object** objects, JSGetterSetter** getterSetters);
+    Object* restoreObject(ExecutionState& state, GlobalObject* globalObject, const SnapshotObject& info, Object* proto);
+
+    Vector<SnapshotObject, GCUtil::gc_malloc_allocator<SnapshotObject>> m_objects;
+    Vector<SnapshotValue, GCUtil::gc_malloc_allocator<SnapshotValue>> m_values;
+    Vector<SnapshotGetterSetter, GCUtil::gc_malloc_allocator<SnapshotGetterSetter>> m_getterSetters;
+    // one item for each GLOBALOBJECT_BUILTIN_LIST member of GlobalObject
+    Vector<SnapshotValue, GCUtil::gc_malloc_allocator<SnapshotValue>> m_builtins;
+};
+} // namespace Escargot
+
+#endif
@@ -38,6 +38,15 @@ COMPILE_ASSERT(sizeof(EncodedValueData) == 4, "");
 COMPILE_ASSERT(sizeof(EncodedValueData) == 8, "");
 #endif
 
+// On 64-bit, EncodedValue has the same NaN-boxed representation as Value.
+// Encoded numbers start with 0x0001..0xFFFF in the high 16 bits, so they are never seen as heap addresses by the
+// conservative GC (user space addresses of supported 64-bit platforms fit in 48 bits), and doubles need no heap cell.
+// EncodedSmallValue (ESCARGOT_USE_32BIT_IN_64BIT) cannot hold a double in 32 bits, so it still boxes doubles
+// and converts from/to EncodedValue through Value.
+#if defined(ESCARGOT_64)
+#define ESCARGOT_NAN_BOXED_ENCODED_VALUE
+#endif
+
 class DoubleInEncodedValue : public PointerValue {
     friend class EncodedValue;
     friend class EncodedSmallValue;
@@ -50,7 +59,7 @@ public:
 
     void* operator new(size_t size)
     {
-        return GC_MALLOC_ATOMIC(size);
+        return AllocationCache::allocate<AllocationCache::PointerFreeKind>(size);
     }
     void* operator new[](size_t size) = delete;
 
@@ -144,6 +153,7 @@ const int kSmiValueSize = PlatformSmiTagging::kSmiValueSize;
 
 // EncodedValue turns int, double values into pointer or odd value
 // so there is no conservative gc leak(there is no even value looks like pointer without pointers)
+// (with ESCARGOT_NAN_BOXED_ENCODED_VALUE, it is just a Value. see above)
 // developers should use this class if want to save some Value on Heap
 // developers should not copy this value because this class changes DoubleInEncodedValue without copy it
 // just convert into Value and use it.
@@ -168,11 +178,15 @@ public:
 
     explicit EncodedValue(const uint32_t from)
     {
+#if defined(ESCARGOT_NAN_BOXED_ENCODED_VALUE)
+        fromValueForCtor(Value(from));
+#else
         if (LIKELY(EncodedValueImpl::PlatformSmiTagging::IsValidSmi(from))) {
             m_data.payload = EncodedValueImpl::PlatformSmiTagging::IntToSmi(from);
         } else {
             fromValueForCtor(Value(from));
         }
+#endif
     }
 
     EncodedValue(const Value& from)
@@ -187,12 +201,16 @@ public:
 
     bool isStoredInHeap()
     {
+#if defined(ESCARGOT_NAN_BOXED_ENCODED_VALUE)
+        return !(m_data.payload & TagMask) && m_data.payload != ValueEmpty;
+#else
         if (HAS_SMI_TAG(m_data.payload)) {
             return false;
         }
 
         PointerValue* v = (PointerValue*)m_data.payload;
         return ((size_t)v) > ValueLast;
+#endif
     }
 
     intptr_t payload() const
@@ -212,6 +230,9 @@ public:
 
     ALWAYS_INLINE operator Value() const
     {
+#if defined(ESCARGOT_NAN_BOXED_ENCODED_VALUE)
+        return Value(Value::FromPayload, m_data.payload);
+#else
         if (HAS_SMI_TAG(m_data.payload)) {
             int32_t value = EncodedValueImpl::PlatformSmiTagging::SmiToInt(m_data.payload);
             return Value(value);
@@ -228,11 +249,16 @@ public:
             return Value(v->asDoubleInEncodedValue()->value());
         }
         return Value(v);
+#endif
     }
 
     bool isInt32()
     {
+#if defined(ESCARGOT_NAN_BOXED_ENCODED_VALUE)
+        return (m_data.payload & TagTypeNumber) == TagTypeNumber;
+#else
         return HAS_SMI_TAG(m_data.payload);
+#endif
     }
 
     bool isUInt32()
@@ -244,22 +270,23 @@ public:
 
     int32_t asInt32()
     {
-        ASSERT(HAS_SMI_TAG(m_data.payload));
+        ASSERT(isInt32());
+#if defined(ESCARGOT_NAN_BOXED_ENCODED_VALUE)
+        return static_cast<int32_t>(m_data.payload);
+#else
         return EncodedValueImpl::PlatformSmiTagging::SmiToInt(m_data.payload);
+#endif
     }
 
     uint32_t asUInt32()
     {
-        ASSERT(HAS_SMI_TAG(m_data.payload));
-        int32_t value = EncodedValueImpl::PlatformSmiTagging::SmiToInt(m_data.payload);
-        return (uint32_t)value;
+        return (uint32_t)asInt32();
     }
 
     uint32_t toUInt32(ExecutionState& state)
     {
-        if (LIKELY(HAS_SMI_TAG(m_data.payload))) {
-            int32_t value = EncodedValueImpl::PlatformSmiTagging::SmiToInt(m_data.payload);
-            return (uint32_t)value;
+        if (LIKELY(isInt32())) {
+            return (uint32_t)asInt32();
         }
 
         return operator Escargot::Value().toUint32(state);
@@ -278,6 +305,9 @@ public:
 
     ALWAYS_INLINE void operator=(const Value& from)
     {
+#if defined(ESCARGOT_NAN_BOXED_ENCODED_VALUE)
+        m_data.payload = from.payload();
+#else
         if (from.isPointerValue()) {
 #ifdef ESCARGOT_32
             ASSERT(!from.isEmpty());
@@ -310,12 +340,16 @@ public:
         m_data.payload = ~from.tag();
 #else
         m_data.payload = from.payload();
+#endif
 #endif
     }
 
 protected:
     void fromValueForCtor(const Value& from)
     {
+#if defined(ESCARGOT_NAN_BOXED_ENCODED_VALUE)
+        m_data.payload = from.payload();
+#else
         if (from.isPointerValue()) {
 #ifdef ESCARGOT_32
             ASSERT(!from.isEmpty());
@@ -335,6 +369,7 @@ protected:
 #endif
             }
         }
+#endif
     }
 
     explicit EncodedValue(EncodedValueData v)
@@ -378,14 +413,13 @@ public:
     }
 
     EncodedSmallValue(const EncodedValue& from)
+        : EncodedSmallValue(Value(from))
     {
-        ASSERT(from.payload() <= std::numeric_limits<uint32_t>::max());
-        m_data.payload = from.payload();
     }
 
     ALWAYS_INLINE operator EncodedValue() const
     {
-        return EncodedValue::fromPayload(reinterpret_cast<void*>(m_data.payload));
+        return EncodedValue(operator Value());
     }
 
     static EncodedSmallValue fromPayload(void* p)
@@ -451,8 +485,7 @@ public:
 
     ALWAYS_INLINE void operator=(const EncodedValue& from)
     {
-        ASSERT(from.payload() <= std::numeric_limits<uint32_t>::max());
-        m_data.payload = from.payload();
+        operator=(Value(from));
     }
 
     ALWAYS_INLINE void operator=(const Value& from)
@@ -112,6 +112,9 @@ public:
         static constexpr const char* GlobalObject_ConstructorRequiresNew = "Constructor requires 'new'";
         static constexpr const char* GlobalObject_CalledOnIncompatibleReceiver = "%s: called on incompatible receiver";
         static constexpr const char* GlobalObject_IllegalFirstArgument = "%s: illegal first argument";
+        static constexpr const char* GlobalObject_InvalidAtomicsTypedArray = "%s: typed array cannot be used for atomic operations";
+        static constexpr const char* GlobalObject_NotSharedArrayBuffer = "%s: buffer is not a SharedArrayBuffer";
+        static constexpr const char* GlobalObject_AgentCannotSuspend = "%s: agent cannot be suspended";
         static constexpr const char* String_InvalidStringLength = "Invalid string length";
 #if defined(ENABLE_CODE_CACHE)
         static constexpr const char* CodeCache_Loaded_StaticError = "[CodeCache] Default Error Message of ThrowStaticError: %s";
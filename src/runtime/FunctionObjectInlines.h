@@ -110,6 +110,7 @@ public:
         }
 
         ByteCodeBlock* blk = codeBlock->byteCodeBlock();
+        blk->m_isExecutedSinceLastGC = true;
         Context* ctx = codeBlock->context();
         bool isStrict = codeBlock->isStrict();
         size_t registerSize = blk->m_requiredRegisterFileSizeInValueSize;
@@ -46,6 +46,7 @@ namespace Escargot {
 GlobalObject::GlobalObject(ExecutionState& state)
     : Object(state, ESCARGOT_OBJECT_BUILTIN_PROPERTY_NUMBER, Object::__ForGlobalBuiltin__)
     , m_context(state.context())
+    , m_installedLazyBuiltins(0)
 #define INIT_BUILTIN_VALUE(builtin, TYPE, NAME) \
     , m_##builtin(nullptr)
 
@@ -75,33 +76,159 @@ void GlobalObject::installBuiltins(ExecutionState& state)
     installBoolean(state);
     installArray(state);
     installMath(state);
-    installDate(state);
     installRegExp(state);
     installJSON(state);
-#if defined(ENABLE_ICU) && defined(ENABLE_INTL)
-    installIntl(state);
-#endif
     installPromise(state);
-    installProxy(state);
-    installReflect(state);
-    installArrayBuffer(state);
-    installDataView(state);
-    installTypedArray(state);
     installMap(state);
     installSet(state);
     installWeakMap(state);
-    installWeakRef(state);
     installWeakSet(state);
-    installFinalizationRegistry(state);
     installGenerator(state);
     installAsyncFunction(state);
     installAsyncIterator(state);
     installAsyncFromSyncIterator(state);
     installAsyncGeneratorFunction(state);
+    installOthers(state);
+    installLazyBuiltinProperties(state);
+}
+
+struct LazyBuiltinGlobalProperty {
+    GlobalObject::LazyBuiltin m_builtin;
+    AtomicString StaticStrings::*m_name;
+};
+
+static const LazyBuiltinGlobalProperty g_lazyBuiltinGlobalProperties[] = {
+    { GlobalObject::LazyBuiltinArrayBuffer, &StaticStrings::ArrayBuffer },
+    { GlobalObject::LazyBuiltinAtomics, &StaticStrings::Atomics },
+    { GlobalObject::LazyBuiltinDataView, &StaticStrings::DataView },
+    { GlobalObject::LazyBuiltinDate, &StaticStrings::Date },
+#if defined(ENABLE_ICU) && defined(ENABLE_INTL)
+    { GlobalObject::LazyBuiltinIntl, &StaticStrings::Intl },
+#endif
+    { GlobalObject::LazyBuiltinProxy, &StaticStrings::Proxy },
+    { GlobalObject::LazyBuiltinReflect, &StaticStrings::Reflect },
+    { GlobalObject::LazyBuiltinSharedArrayBuffer, &StaticStrings::SharedArrayBuffer },
+    { GlobalObject::LazyBuiltinTypedArray, &StaticStrings::Int8Array },
+    { GlobalObject::LazyBuiltinTypedArray, &StaticStrings::Uint8Array },
+    { GlobalObject::LazyBuiltinTypedArray, &StaticStrings::Uint8ClampedArray },
+    { GlobalObject::LazyBuiltinTypedArray, &StaticStrings::Int16Array },
+    { GlobalObject::LazyBuiltinTypedArray, &StaticStrings::Uint16Array },
+    { GlobalObject::LazyBuiltinTypedArray, &StaticStrings::Int32Array },
+    { GlobalObject::LazyBuiltinTypedArray, &StaticStrings::Uint32Array },
+    { GlobalObject::LazyBuiltinTypedArray, &StaticStrings::Float32Array },
+    { GlobalObject::LazyBuiltinTypedArray, &StaticStrings::Float64Array },
+    { GlobalObject::LazyBuiltinTypedArray, &StaticStrings::BigInt64Array },
+    { GlobalObject::LazyBuiltinTypedArray, &StaticStrings::BigUint64Array },
+    { GlobalObject::LazyBuiltinWeakRef, &StaticStrings::WeakRef },
+    { GlobalObject::LazyBuiltinFinalizationRegistry, &StaticStrings::FinalizationRegistry },
 #if defined(ENABLE_WASM)
-    installWASM(state);
+    { GlobalObject::LazyBuiltinWASM, &StaticStrings::WebAssembly },
 #endif
-    installOthers(state);
+};
+
+// lazy global properties look like plain data properties (writable, non-enumerable and configurable)
+// which every install function defines for its builtin
+static ObjectPropertyNativeGetterSetterData lazyBuiltinPropertyNativeGetterSetterData(
+    true, false, true, &GlobalObject::lazyBuiltinPropertyNativeGetter, &GlobalObject::lazyBuiltinPropertyNativeSetter);
+
+void GlobalObject::installLazyBuiltinProperties(ExecutionState& state)
+{
+    const StaticStrings& strings = state.context()->staticStrings();
+    for (size_t i = 0; i < sizeof(g_lazyBuiltinGlobalProperties) / sizeof(LazyBuiltinGlobalProperty); i++) {
+        // private data of each property is the index of g_lazyBuiltinGlobalProperties
+        defineNativeDataAccessorProperty(state, ObjectPropertyName(strings.*(g_lazyBuiltinGlobalProperties[i].m_name)),
+                                         &lazyBuiltinPropertyNativeGetterSetterData, Value(i));
+    }
+}
+
+void GlobalObject::installLazyBuiltin(LazyBuiltin builtin)
+{
+    ExecutionState state(m_context);
+    installLazyBuiltin(state, builtin);
+}
+
+void GlobalObject::installLazyBuiltin(ExecutionState& state, LazyBuiltin builtin)
+{
+    static_assert(LazyBuiltinCount <= sizeof(m_installedLazyBuiltins) * 8, "");
+    uint32_t bit = 1 << builtin;
+    if (m_installedLazyBuiltins & bit) {
+        return;
+    }
+    // mark first because some builtins are accessed again while installing
+    m_installedLazyBuiltins |= bit;
+
+    // turn lazy global properties of this group into plain data properties
+    // so install function just fills its value by defineOwnProperty
+    // install functions define every global property of their group, so the properties which were already
+    // deleted or redefined (e.g. `delete globalThis.Date` before accessing an internal slot) are restored after installing
+    const StaticStrings& strings = state.context()->staticStrings();
+    const size_t propertyCount = sizeof(g_lazyBuiltinGlobalProperties) / sizeof(LazyBuiltinGlobalProperty);
+    bool shouldRestore[propertyCount] = {};
+    // kept on the stack so that GC can see values of the properties
+    ObjectGetResult restoredProperties[propertyCount];
+    for (size_t i = 0; i < propertyCount; i++) {
+        if (g_lazyBuiltinGlobalProperties[i].m_builtin != builtin) {
+            continue;
+        }
+        auto findResult = structure()->findProperty(strings.*(g_lazyBuiltinGlobalProperties[i].m_name));
+        if (findResult.first == SIZE_MAX) {
+            shouldRestore[i] = true;
+            continue;
+        }
+        const ObjectStructurePropertyDescriptor& desc = findResult.second.value()->m_descriptor;
+        if (desc.isNativeAccessorProperty() && desc.nativeGetterSetterData()->m_getter == lazyBuiltinPropertyNativeGetter) {
+            auto attribute = (ObjectStructurePropertyDescriptor::PresentAttribute)((desc.isWritable() ? ObjectStructurePropertyDescriptor::WritablePresent : 0)
+                                                                                   | (desc.isEnumerable() ? ObjectStructurePropertyDescriptor::EnumerablePresent : 0)
+                                                                                   | (desc.isConfigurable() ? ObjectStructurePropertyDescriptor::ConfigurablePresent : 0));
+            m_structure = m_structure->replacePropertyDescriptor(findResult.first, ObjectStructurePropertyDescriptor::createDataDescriptor(attribute));
+            m_values[findResult.first] = Value();
+        } else {
+            shouldRestore[i] = true;
+            restoredProperties[i] = getOwnProperty(state, ObjectPropertyName(strings.*(g_lazyBuiltinGlobalProperties[i].m_name)));
+        }
+    }
+
+    switch (builtin) {
+#define INSTALL_LAZY_BUILTIN(NAME) \
+    case LazyBuiltin##NAME:        \
+        install##NAME(state);      \
+        break;
+        GLOBALOBJECT_LAZY_BUILTIN_GROUP_LIST(INSTALL_LAZY_BUILTIN)
+#undef INSTALL_LAZY_BUILTIN
+    default:
+        RELEASE_ASSERT_NOT_REACHED();
+    }
+
+    for (size_t i = 0; i < propertyCount; i++) {
+        if (!shouldRestore[i]) {
+            continue;
+        }
+        ObjectPropertyName name(strings.*(g_lazyBuiltinGlobalProperties[i].m_name));
+        if (restoredProperties[i].hasValue()) {
+            defineOwnProperty(state, name, restoredProperties[i].convertToPropertyDescriptor(state, this));
+        } else {
+            deleteOwnProperty(state, name);
+        }
+    }
+}
+
+Value GlobalObject::lazyBuiltinPropertyNativeGetter(ExecutionState& state, Object* self, const Value& receiver, const EncodedValue& privateDataFromObjectPrivateArea)
+{
+    ASSERT(self->isGlobalObject());
+    const LazyBuiltinGlobalProperty& property = g_lazyBuiltinGlobalProperties[Value(privateDataFromObjectPrivateArea).asUInt32()];
+    self->asGlobalObject()->installLazyBuiltin(state, property.m_builtin);
+    return self->getOwnProperty(state, ObjectPropertyName(state.context()->staticStrings().*(property.m_name))).value(state, receiver);
+}
+
+bool GlobalObject::lazyBuiltinPropertyNativeSetter(ExecutionState& state, Object* self, const Value& receiver, EncodedValue& privateDataFromObjectPrivateArea, const Value& setterInputData)
+{
+    ASSERT(self->isGlobalObject());
+    const LazyBuiltinGlobalProperty& property = g_lazyBuiltinGlobalProperties[Value(privateDataFromObjectPrivateArea).asUInt32()];
+    // install functions only redefine the value of their own global properties
+    // so the global object keeps its property storage and privateDataFromObjectPrivateArea is still valid here
+    self->asGlobalObject()->installLazyBuiltin(state, property.m_builtin);
+    privateDataFromObjectPrivateArea = setterInputData;
+    return true;
 }
 
 Value builtinSpeciesGetter(ExecutionState& state, Value thisValue, size_t argc, Value* argv, Optional<Object*> newTarget)
@@ -59,6 +59,8 @@ class FunctionObject;
     F(asyncGeneratorFunction, FunctionObject, NAME)
 #define GLOBALOBJECT_BUILTIN_ASYNCITERATOR(F, NAME) \
     F(asyncIteratorPrototype, Object, NAME)
+#define GLOBALOBJECT_BUILTIN_ATOMICS(F, NAME) \
+    F(atomics, Object, NAME)
 #define GLOBALOBJECT_BUILTIN_BOOLEAN(F, NAME) \
     F(boolean, FunctionObject, NAME)          \
     F(booleanPrototype, Object, NAME)
@@ -160,6 +162,9 @@ class FunctionObject;
     F(set, FunctionObject, NAME)          \
     F(setPrototype, Object, NAME)         \
     F(setIteratorPrototype, Object, NAME)
+#define GLOBALOBJECT_BUILTIN_SHAREDARRAYBUFFER(F, NAME) \
+    F(sharedArrayBuffer, FunctionObject, NAME)          \
+    F(sharedArrayBufferPrototype, Object, NAME)
 #define GLOBALOBJECT_BUILTIN_STRING(F, NAME) \
     F(string, FunctionObject, NAME)          \
     F(stringPrototype, Object, NAME)         \
@@ -210,11 +215,11 @@ class FunctionObject;
 //WebAssembly
 #if defined(ENABLE_WASM)
 #define GLOBALOBJECT_BUILTIN_WASM(F, NAME)     \
-    F(wasmModulePrototype, Object, Name)       \
-    F(wasmInstancePrototype, Object, Name)     \
-    F(wasmMemoryPrototype, Object, Name)       \
-    F(wasmTablePrototype, Object, Name)        \
-    F(wasmGlobalPrototype, Object, Name)       \
+    F(wasmModulePrototype, Object, NAME)       \
+    F(wasmInstancePrototype, Object, NAME)     \
+    F(wasmMemoryPrototype, Object, NAME)       \
+    F(wasmTablePrototype, Object, NAME)        \
+    F(wasmGlobalPrototype, Object, NAME)       \
     F(wasmCompileErrorPrototype, Object, NAME) \
     F(wasmLinkErrorPrototype, Object, NAME)    \
     F(wasmRuntimeErrorPrototype, Object, NAME)
@@ -223,21 +228,17 @@ class FunctionObject;
 #endif
 
 
-#define GLOBALOBJECT_BUILTIN_LIST(F)                                     \
-    GLOBALOBJECT_BUILTIN_ARRAYBUFFER(F, ArrayBuffer)                     \
+#define GLOBALOBJECT_EAGER_BUILTIN_LIST(F)                               \
     GLOBALOBJECT_BUILTIN_ARRAY(F, Array)                                 \
     GLOBALOBJECT_BUILTIN_ASYNCFROMSYNCITERATOR(F, AsyncFromSyncIterator) \
     GLOBALOBJECT_BUILTIN_ASYNCFUNCTION(F, AsyncFunction)                 \
     GLOBALOBJECT_BUILTIN_ASYNCGENERATOR(F, AsyncGenerator)               \
     GLOBALOBJECT_BUILTIN_ASYNCITERATOR(F, AsyncIterator)                 \
     GLOBALOBJECT_BUILTIN_BOOLEAN(F, Boolean)                             \
-    GLOBALOBJECT_BUILTIN_DATAVIEW(F, DataView)                           \
-    GLOBALOBJECT_BUILTIN_DATE(F, Date)                                   \
     GLOBALOBJECT_BUILTIN_ERROR(F, Error)                                 \
     GLOBALOBJECT_BUILTIN_EVAL(F, Eval)                                   \
     GLOBALOBJECT_BUILTIN_FUNCTION(F, Function)                           \
     GLOBALOBJECT_BUILTIN_GENERATOR(F, Generator)                         \
-    GLOBALOBJECT_BUILTIN_INTL(F, Intl)                                   \
     GLOBALOBJECT_BUILTIN_ITERATOR(F, Iterator)                           \
     GLOBALOBJECT_BUILTIN_JSON(F, JSON)                                   \
     GLOBALOBJECT_BUILTIN_MAP(F, Map)                                     \
@@ -246,19 +247,59 @@ class FunctionObject;
     GLOBALOBJECT_BUILTIN_OBJECT(F, Object)                               \
     GLOBALOBJECT_BUILTIN_OTHERS(F, Others)                               \
     GLOBALOBJECT_BUILTIN_PROMISE(F, Promise)                             \
-    GLOBALOBJECT_BUILTIN_PROXY(F, Proxy)                                 \
-    GLOBALOBJECT_BUILTIN_REFLECT(F, Reflect)                             \
     GLOBALOBJECT_BUILTIN_REGEXP(F, RegExp)                               \
     GLOBALOBJECT_BUILTIN_SET(F, Set)                                     \
     GLOBALOBJECT_BUILTIN_STRING(F, String)                               \
     GLOBALOBJECT_BUILTIN_SYMBOL(F, Symbol)                               \
     GLOBALOBJECT_BUILTIN_BIGINT(F, BigInt)                               \
-    GLOBALOBJECT_BUILTIN_TYPEDARRAY(F, TypedArray)                       \
     GLOBALOBJECT_BUILTIN_WEAKMAP(F, WeakMap)                             \
-    GLOBALOBJECT_BUILTIN_WEAKSET(F, WeakSet)                             \
-    GLOBALOBJECT_BUILTIN_WEAKREF(F, WeakRef)                             \
-    GLOBALOBJECT_BUILTIN_FINALIZATIONREGISTRY(F, FinalizationRegistry)   \
-    GLOBALOBJECT_BUILTIN_WASM(F, WebAssembly)
+    GLOBALOBJECT_BUILTIN_WEAKSET(F, WeakSet)
+
+// builtins installed on the first access of their global property or of their member (see GlobalObject::installLazyBuiltin)
+// NAME of each group should be listed in GLOBALOBJECT_LAZY_BUILTIN_GROUP_LIST
+#define GLOBALOBJECT_LAZY_BUILTIN_LIST(F)                              \
+    GLOBALOBJECT_BUILTIN_ARRAYBUFFER(F, ArrayBuffer)                   \
+    GLOBALOBJECT_BUILTIN_ATOMICS(F, Atomics)                           \
+    GLOBALOBJECT_BUILTIN_DATAVIEW(F, DataView)                         \
+    GLOBALOBJECT_BUILTIN_DATE(F, Date)                                 \
+    GLOBALOBJECT_BUILTIN_INTL(F, Intl)                                 \
+    GLOBALOBJECT_BUILTIN_PROXY(F, Proxy)                               \
+    GLOBALOBJECT_BUILTIN_REFLECT(F, Reflect)                           \
+    GLOBALOBJECT_BUILTIN_SHAREDARRAYBUFFER(F, SharedArrayBuffer)       \
+    GLOBALOBJECT_BUILTIN_TYPEDARRAY(F, TypedArray)                     \
+    GLOBALOBJECT_BUILTIN_WEAKREF(F, WeakRef)                           \
+    GLOBALOBJECT_BUILTIN_FINALIZATIONREGISTRY(F, FinalizationRegistry) \
+    GLOBALOBJECT_BUILTIN_WASM(F, WASM)
+
+#if defined(ENABLE_ICU) && defined(ENABLE_INTL)
+#define GLOBALOBJECT_LAZY_BUILTIN_GROUP_INTL(F) F(Intl)
+#else
+#define GLOBALOBJECT_LAZY_BUILTIN_GROUP_INTL(F)
+#endif
+#if defined(ENABLE_WASM)
+#define GLOBALOBJECT_LAZY_BUILTIN_GROUP_WASM(F) F(WASM)
+#else
+#define GLOBALOBJECT_LAZY_BUILTIN_GROUP_WASM(F)
+#endif
+
+// each group is installed by GlobalObject::install##NAME
+#define GLOBALOBJECT_LAZY_BUILTIN_GROUP_LIST(F) \
+    F(ArrayBuffer)                              \
+    F(Atomics)                                  \
+    F(DataView)                                 \
+    F(Date)                                     \
+    GLOBALOBJECT_LAZY_BUILTIN_GROUP_INTL(F)     \
+    F(Proxy)                                    \
+    F(Reflect)                                  \
+    F(SharedArrayBuffer)                        \
+    F(TypedArray)                               \
+    F(WeakRef)                                  \
+    F(FinalizationRegistry)                     \
+    GLOBALOBJECT_LAZY_BUILTIN_GROUP_WASM(F)
+
+#define GLOBALOBJECT_BUILTIN_LIST(F)  \
+    GLOBALOBJECT_EAGER_BUILTIN_LIST(F) \
+    GLOBALOBJECT_LAZY_BUILTIN_LIST(F)
 
 
 Value builtinSpeciesGetter(ExecutionState& state, Value thisValue, size_t argc, Value* argv, Optional<Object*> newTarget);
@@ -268,6 +309,7 @@ public:
     friend class ByteCodeInterpreter;
     friend class GlobalEnvironmentRecord;
     friend class IdentifierNode;
+    friend class ContextSnapshot;
 
     explicit GlobalObject(ExecutionState& state);
 
@@ -289,9 +331,35 @@ public:
         return m_##builtin;                       \
     }
 
-    GLOBALOBJECT_BUILTIN_LIST(DECLARE_BUILTIN_FUNC)
+    GLOBALOBJECT_EAGER_BUILTIN_LIST(DECLARE_BUILTIN_FUNC)
 #undef DECLARE_BUILTIN_FUNC
 
+    enum LazyBuiltin : uint8_t {
+#define DECLARE_LAZY_BUILTIN_ENUM(NAME) LazyBuiltin##NAME,
+        GLOBALOBJECT_LAZY_BUILTIN_GROUP_LIST(DECLARE_LAZY_BUILTIN_ENUM)
+#undef DECLARE_LAZY_BUILTIN_ENUM
+            LazyBuiltinCount
+    };
+
+    // install lazy builtin group if it is not installed yet
+    void installLazyBuiltin(ExecutionState& state, LazyBuiltin builtin);
+    // global properties of lazy builtins
+    static Value lazyBuiltinPropertyNativeGetter(ExecutionState& state, Object* self, const Value& receiver, const EncodedValue& privateDataFromObjectPrivateArea);
+    static bool lazyBuiltinPropertyNativeSetter(ExecutionState& state, Object* self, const Value& receiver, EncodedValue& privateDataFromObjectPrivateArea, const Value& setterInputData);
+
+#define DECLARE_LAZY_BUILTIN_FUNC(builtin, TYPE, NAME) \
+    TYPE* builtin()                                    \
+    {                                                  \
+        if (UNLIKELY(!m_##builtin)) {                  \
+            installLazyBuiltin(LazyBuiltin##NAME);     \
+        }                                              \
+        ASSERT(!!m_##builtin);                         \
+        return m_##builtin;                            \
+    }
+
+    GLOBALOBJECT_LAZY_BUILTIN_LIST(DECLARE_LAZY_BUILTIN_FUNC)
+#undef DECLARE_LAZY_BUILTIN_FUNC
+
     virtual bool isInlineCacheable() override
     {
         return false;
@@ -308,6 +376,8 @@ public:
 
 private:
     Context* m_context;
+    // bit set of installed LazyBuiltin
+    uint32_t m_installedLazyBuiltins;
 
 #define DECLARE_BUILTIN_VALUE(builtin, TYPE, NAME) \
     TYPE* m_##builtin;
@@ -335,6 +405,8 @@ private:
     void installProxy(ExecutionState& state);
     void installReflect(ExecutionState& state);
     void installArrayBuffer(ExecutionState& state);
+    void installSharedArrayBuffer(ExecutionState& state);
+    void installAtomics(ExecutionState& state);
     void installDataView(ExecutionState& state);
     void installTypedArray(ExecutionState& state);
     template <typename TA, int elementSize>
@@ -355,6 +427,10 @@ private:
     void installWASM(ExecutionState& state);
 #endif
     void installOthers(ExecutionState& state);
+
+    NEVER_INLINE void installLazyBuiltin(LazyBuiltin builtin);
+    // define global properties which install their lazy builtin group on access
+    void installLazyBuiltinProperties(ExecutionState& state);
 };
 } // namespace Escargot
 
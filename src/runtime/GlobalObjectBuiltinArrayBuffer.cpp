@@ -27,7 +27,7 @@
 namespace Escargot {
 
 #define RESOLVE_THIS_BINDING_TO_ARRAYBUFFER(NAME, OBJ, BUILT_IN_METHOD)                                                                                                                                                                                  \
-    if (!thisValue.isObject() || !thisValue.asObject()->isArrayBufferObject()) {                                                                                                                                                                         \
+    if (!thisValue.isObject() || !thisValue.asObject()->isArrayBufferObject() || thisValue.asObject()->isSharedArrayBufferObject()) {                                                                                                                    \
         ErrorObject::throwBuiltinError(state, ErrorObject::TypeError, state.context()->staticStrings().OBJ.string(), true, state.context()->staticStrings().BUILT_IN_METHOD.string(), ErrorObject::Messages::GlobalObject_CalledOnIncompatibleReceiver); \
     }                                                                                                                                                                                                                                                    \
     ArrayBufferObject* NAME = thisValue.asObject()->asArrayBufferObject();                                                                                                                                                                               \
@@ -66,7 +66,7 @@ static Value builtinArrayBufferIsView(ExecutionState& state, Value thisValue, si
 // https://www.ecma-international.org/ecma-262/10.0/#sec-get-arraybuffer.prototype.bytelength
 static Value builtinArrayBufferByteLengthGetter(ExecutionState& state, Value thisValue, size_t argc, Value* argv, Optional<Object*> newTarget)
 {
-    if (!thisValue.isObject() || !thisValue.asObject()->isArrayBufferObject()) {
+    if (!thisValue.isObject() || !thisValue.asObject()->isArrayBufferObject() || thisValue.asObject()->isSharedArrayBufferObject()) {
         ErrorObject::throwBuiltinError(state, ErrorObject::TypeError, state.context()->staticStrings().ArrayBuffer.string(), true, state.context()->staticStrings().getbyteLength.string(), ErrorObject::Messages::GlobalObject_CalledOnIncompatibleReceiver);
     }
     ArrayBufferObject* obj = thisValue.asObject()->asArrayBufferObject();
@@ -91,7 +91,7 @@ static Value builtinArrayBufferSlice(ExecutionState& state, Value thisValue, siz
     Value constructor = obj->speciesConstructor(state, state.context()->globalObject()->arrayBuffer());
     Value arguments[] = { Value(newLen) };
     Object* newValue = Object::construct(state, constructor, 1, arguments).toObject(state);
-    if (!newValue->isArrayBufferObject()) {
+    if (!newValue->isArrayBufferObject() || newValue->isSharedArrayBufferObject()) {
         ErrorObject::throwBuiltinError(state, ErrorObject::TypeError, state.context()->staticStrings().ArrayBuffer.string(), true, state.context()->staticStrings().slice.string(), "%s: return value of constructor ArrayBuffer is not valid ArrayBuffer");
     }
 
@@ -0,0 +1,452 @@
+/*
+ * Copyright (c) 2021-present Samsung Electronics Co., Ltd
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+ */
+
+#include "Escargot.h"
+#include "GlobalObject.h"
+#include "Context.h"
+#include "VMInstance.h"
+#include "NativeFunctionObject.h"
+#include "SharedArrayBufferObject.h"
+#include "TypedArrayObject.h"
+#include "TypedArrayInlines.h"
+#include <atomic>
+#if defined(ENABLE_THREADING)
+#include <condition_variable>
+#include <list>
+#endif
+
+namespace Escargot {
+
+#define FOR_EACH_ATOMICS_INTEGER_TYPE(F) \
+    F(Int8, int8_t)                      \
+    F(Uint8, uint8_t)                    \
+    F(Int16, int16_t)                    \
+    F(Uint16, uint16_t)                  \
+    F(Int32, int32_t)                    \
+    F(Uint32, uint32_t)                  \
+    F(BigInt64, int64_t)                 \
+    F(BigUint64, uint64_t)
+
+enum class AtomicsOperation {
+    Load,
+    Store,
+    Add,
+    Sub,
+    And,
+    Or,
+    Xor,
+    Exchange,
+    CompareExchange,
+};
+
+// elements of a typed array are accessed through std::atomic of the same size
+// so data of backing store is never copied or locked by js side
+template <typename T>
+static T applyAtomicsOperation(AtomicsOperation operation, uint8_t* address, T operand, T replacement)
+{
+    static_assert(sizeof(std::atomic<T>) == sizeof(T), "std::atomic should have the same layout as its value");
+    std::atomic<T>* p = reinterpret_cast<std::atomic<T>*>(address);
+    switch (operation) {
+    case AtomicsOperation::Load:
+        return p->load();
+    case AtomicsOperation::Store:
+        p->store(operand);
+        return operand;
+    case AtomicsOperation::Add:
+        return p->fetch_add(operand);
+    case AtomicsOperation::Sub:
+        return p->fetch_sub(operand);
+    case AtomicsOperation::And:
+        return p->fetch_and(operand);
+    case AtomicsOperation::Or:
+        return p->fetch_or(operand);
+    case AtomicsOperation::Xor:
+        return p->fetch_xor(operand);
+    case AtomicsOperation::Exchange:
+        return p->exchange(operand);
+    case AtomicsOperation::CompareExchange:
+        // operand is the expected value, and it is replaced with the current value on failure
+        p->compare_exchange_strong(operand, replacement);
+        return operand;
+    default:
+        RELEASE_ASSERT_NOT_REACHED();
+        return 0;
+    }
+}
+
+static bool isBigIntTypedArrayType(TypedArrayType type)
+{
+    return type == TypedArrayType::BigInt64 || type == TypedArrayType::BigUint64;
+}
+
+// https://tc39.es/ecma262/#sec-validateintegertypedarray
+static TypedArrayObject* validateIntegerTypedArray(ExecutionState& state, const Value& value, AtomicString methodName, bool waitable = false)
+{
+    if (!value.isObject() || !value.asObject()->isTypedArrayObject()) {
+        ErrorObject::throwBuiltinError(state, ErrorObject::TypeError, state.context()->staticStrings().Atomics.string(), false, methodName.string(), ErrorObject::Messages::GlobalObject_InvalidAtomicsTypedArray);
+    }
+
+    TypedArrayObject* typedArray = value.asObject()->asTypedArrayObject();
+    typedArray->buffer()->throwTypeErrorIfDetached(state);
+
+    TypedArrayType type = typedArray->typedArrayType();
+    bool isValidType;
+    if (waitable) {
+        isValidType = type == TypedArrayType::Int32 || type == TypedArrayType::BigInt64;
+    } else {
+        isValidType = type != TypedArrayType::Uint8Clamped && type != TypedArrayType::Float32 && type != TypedArrayType::Float64;
+    }
+    if (!isValidType) {
+        ErrorObject::throwBuiltinError(state, ErrorObject::TypeError, state.context()->staticStrings().Atomics.string(), false, methodName.string(), ErrorObject::Messages::GlobalObject_InvalidAtomicsTypedArray);
+    }
+
+    return typedArray;
+}
+
+// https://tc39.es/ecma262/#sec-validateatomicaccess
+// returns byte index of the element in buffer
+static size_t validateAtomicAccess(ExecutionState& state, TypedArrayObject* typedArray, const Value& requestIndex, AtomicString methodName)
+{
+    uint64_t accessIndex = requestIndex.toIndex(state);
+    if (accessIndex == Value::InvalidIndexValue || accessIndex >= typedArray->arrayLength()) {
+        ErrorObject::throwBuiltinError(state, ErrorObject::RangeError, state.context()->staticStrings().Atomics.string(), false, methodName.string(), ErrorObject::Messages::GlobalObject_RangeError);
+    }
+    return accessIndex * typedArray->elementSize() + typedArray->byteOffset();
+}
+
+static Value toAtomicsOperand(ExecutionState& state, TypedArrayType type, const Value& value)
+{
+    if (isBigIntTypedArrayType(type)) {
+        return Value(value.toBigInt(state));
+    }
+    double v = value.toInteger(state);
+    // ToIntegerOrInfinity never returns -0
+    return Value(v == 0 ? 0 : v);
+}
+
+// https://tc39.es/ecma262/#sec-atomicreadmodifywrite
+static Value atomicsOperation(ExecutionState& state, AtomicsOperation operation, AtomicString methodName, size_t argc, Value* argv)
+{
+    TypedArrayObject* typedArray = validateIntegerTypedArray(state, argv[0], methodName);
+    size_t indexedPosition = validateAtomicAccess(state, typedArray, argv[1], methodName);
+    TypedArrayType type = typedArray->typedArrayType();
+
+    Value operand(Value::EmptyValue);
+    Value replacement(Value::EmptyValue);
+    if (operation != AtomicsOperation::Load) {
+        operand = toAtomicsOperand(state, type, argv[2]);
+    }
+    if (operation == AtomicsOperation::CompareExchange) {
+        replacement = toAtomicsOperand(state, type, argv[3]);
+    }
+    // conversion of arguments can detach the buffer
+    typedArray->buffer()->throwTypeErrorIfDetached(state);
+
+    // 8 bytes are enough for every integer type
+    uint64_t operandBytes = 0;
+    uint64_t replacementBytes = 0;
+    uint64_t resultBytes = 0;
+    if (!operand.isEmpty()) {
+        TypedArrayHelper::numberToRawBytes(state, type, operand, reinterpret_cast<uint8_t*>(&operandBytes));
+    }
+    if (!replacement.isEmpty()) {
+        TypedArrayHelper::numberToRawBytes(state, type, replacement, reinterpret_cast<uint8_t*>(&replacementBytes));
+    }
+
+    uint8_t* address = const_cast<uint8_t*>(typedArray->buffer()->data()) + indexedPosition;
+    switch (type) {
+#define DEFINE_ATOMICS_OPERATION_CASE(TYPE, nativeType)                                                                \
+    case TypedArrayType::TYPE: {                                                                                       \
+        nativeType operandValue, replacementValue;                                                                     \
+        memcpy(&operandValue, &operandBytes, sizeof(nativeType));                                                      \
+        memcpy(&replacementValue, &replacementBytes, sizeof(nativeType));                                              \
+        nativeType result = applyAtomicsOperation<nativeType>(operation, address, operandValue, replacementValue);     \
+        memcpy(&resultBytes, &result, sizeof(nativeType));                                                             \
+        break;                                                                                                         \
+    }
+        FOR_EACH_ATOMICS_INTEGER_TYPE(DEFINE_ATOMICS_OPERATION_CASE)
+#undef DEFINE_ATOMICS_OPERATION_CASE
+    default:
+        RELEASE_ASSERT_NOT_REACHED();
+    }
+
+    if (operation == AtomicsOperation::Store) {
+        // Atomics.store returns the converted value, not the stored raw bytes
+        return operand;
+    }
+    return TypedArrayHelper::rawBytesToNumber(state, type, reinterpret_cast<uint8_t*>(&resultBytes));
+}
+
+#if defined(ENABLE_THREADING)
+// futex-like parking of Atomics.wait
+// every VMInstance in this process can share the backing store of a SharedArrayBuffer
+// so waiters are kept by address of the element, not by SharedArrayBufferObject
+class AtomicsWaiterList {
+public:
+    struct Waiter {
+        explicit Waiter(void* address)
+            : m_address(address)
+            , m_notified(false)
+        {
+        }
+
+        void* m_address;
+        bool m_notified;
+        std::condition_variable m_condition;
+    };
+
+    static AtomicsWaiterList& instance()
+    {
+        static AtomicsWaiterList list;
+        return list;
+    }
+
+    std::mutex& mutex()
+    {
+        return m_mutex;
+    }
+
+    // returns true if the waiter is notified before timeout
+    bool wait(std::unique_lock<std::mutex>& locker, void* address, double timeout)
+    {
+        ASSERT(locker.owns_lock());
+        Waiter waiter(address);
+        m_waiters.push_back(&waiter);
+
+        // too long timeout cannot be represented by std::chrono::steady_clock, so it is regarded as infinity
+        if (timeout > maxFiniteTimeout) {
+            waiter.m_condition.wait(locker, [&waiter]() -> bool { return waiter.m_notified; });
+        } else {
+            auto duration = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double, std::milli>(timeout));
+            waiter.m_condition.wait_for(locker, duration, [&waiter]() -> bool { return waiter.m_notified; });
+        }
+
+        // notify removes the waiter from the list
+        if (!waiter.m_notified) {
+            m_waiters.remove(&waiter);
+        }
+        return waiter.m_notified;
+    }
+
+    // wake up waiters on address in FIFO order
+    size_t notify(void* address, size_t count)
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        size_t notified = 0;
+        for (auto iter = m_waiters.begin(); iter != m_waiters.end() && notified < count;) {
+            Waiter* waiter = *iter;
+            if (waiter->m_address != address) {
+                iter++;
+                continue;
+            }
+            waiter->m_notified = true;
+            waiter->m_condition.notify_one();
+            iter = m_waiters.erase(iter);
+            notified++;
+        }
+        return notified;
+    }
+
+private:
+    AtomicsWaiterList() {}
+
+    // about 30 years in milliseconds
+    static constexpr double maxFiniteTimeout = 1e12;
+
+    std::mutex m_mutex;
+    std::list<Waiter*> m_waiters;
+};
+#endif
+
+static Value builtinAtomicsLoad(ExecutionState& state, Value thisValue, size_t argc, Value* argv, Optional<Object*> newTarget)
+{
+    return atomicsOperation(state, AtomicsOperation::Load, state.context()->staticStrings().load, argc, argv);
+}
+
+static Value builtinAtomicsStore(ExecutionState& state, Value thisValue, size_t argc, Value* argv, Optional<Object*> newTarget)
+{
+    return atomicsOperation(state, AtomicsOperation::Store, state.context()->staticStrings().store, argc, argv);
+}
+
+static Value builtinAtomicsAdd(ExecutionState& state, Value thisValue, size_t argc, Value* argv, Optional<Object*> newTarget)
+{
+    return atomicsOperation(state, AtomicsOperation::Add, state.context()->staticStrings().add, argc, argv);
+}
+
+static Value builtinAtomicsSub(ExecutionState& state, Value thisValue, size_t argc, Value* argv, Optional<Object*> newTarget)
+{
+    return atomicsOperation(state, AtomicsOperation::Sub, state.context()->staticStrings().sub, argc, argv);
+}
+
+static Value builtinAtomicsAnd(ExecutionState& state, Value thisValue, size_t argc, Value* argv, Optional<Object*> newTarget)
+{
+    return atomicsOperation(state, AtomicsOperation::And, state.context()->staticStrings().stringAnd, argc, argv);
+}
+
+static Value builtinAtomicsOr(ExecutionState& state, Value thisValue, size_t argc, Value* argv, Optional<Object*> newTarget)
+{
+    return atomicsOperation(state, AtomicsOperation::Or, state.context()->staticStrings().stringOr, argc, argv);
+}
+
+static Value builtinAtomicsXor(ExecutionState& state, Value thisValue, size_t argc, Value* argv, Optional<Object*> newTarget)
+{
+    return atomicsOperation(state, AtomicsOperation::Xor, state.context()->staticStrings().stringXor, argc, argv);
+}
+
+static Value builtinAtomicsExchange(ExecutionState& state, Value thisValue, size_t argc, Value* argv, Optional<Object*> newTarget)
+{
+    return atomicsOperation(state, AtomicsOperation::Exchange, state.context()->staticStrings().exchange, argc, argv);
+}
+
+static Value builtinAtomicsCompareExchange(ExecutionState& state, Value thisValue, size_t argc, Value* argv, Optional<Object*> newTarget)
+{
+    return atomicsOperation(state, AtomicsOperation::CompareExchange, state.context()->staticStrings().compareExchange, argc, argv);
+}
+
+// https://tc39.es/ecma262/#sec-atomics.islockfree
+static Value builtinAtomicsIsLockFree(ExecutionState& state, Value thisValue, size_t argc, Value* argv, Optional<Object*> newTarget)
+{
+    double size = argv[0].toInteger(state);
+    if (size == 1) {
+        return Value(ATOMIC_CHAR_LOCK_FREE == 2);
+    } else if (size == 2) {
+        return Value(ATOMIC_SHORT_LOCK_FREE == 2);
+    } else if (size == 4) {
+        // AR_IsLockFree4 is always true
+        return Value(true);
+    } else if (size == 8) {
+        return Value(ATOMIC_LLONG_LOCK_FREE == 2);
+    }
+    return Value(false);
+}
+
+// https://tc39.es/ecma262/#sec-atomics.wait
+static Value builtinAtomicsWait(ExecutionState& state, Value thisValue, size_t argc, Value* argv, Optional<Object*> newTarget)
+{
+    const StaticStrings& strings = state.context()->staticStrings();
+    TypedArrayObject* typedArray = validateIntegerTypedArray(state, argv[0], strings.wait, true);
+    if (!typedArray->buffer()->isSharedArrayBufferObject()) {
+        ErrorObject::throwBuiltinError(state, ErrorObject::TypeError, strings.Atomics.string(), false, strings.wait.string(), ErrorObject::Messages::GlobalObject_NotSharedArrayBuffer);
+    }
+    size_t indexedPosition = validateAtomicAccess(state, typedArray, argv[1], strings.wait);
+
+    TypedArrayType type = typedArray->typedArrayType();
+    int64_t value;
+    if (type == TypedArrayType::BigInt64) {
+        value = argv[2].toBigInt(state)->toInt64();
+    } else {
+        value = argv[2].toInt32(state);
+    }
+
+    double timeout = argv[3].toNumber(state);
+    timeout = std::isnan(timeout) ? std::numeric_limits<double>::infinity() : std::max(timeout, 0.0);
+
+#if defined(ENABLE_THREADING)
+    uint8_t* address = const_cast<uint8_t*>(typedArray->buffer()->data()) + indexedPosition;
+    AtomicsWaiterList& waiterList = AtomicsWaiterList::instance();
+    // value should be compared in the critical section of waiter list
+    // otherwise notify called right after the comparison can be lost
+    std::unique_lock<std::mutex> locker(waiterList.mutex());
+    int64_t current;
+    if (type == TypedArrayType::BigInt64) {
+        current = applyAtomicsOperation<int64_t>(AtomicsOperation::Load, address, 0, 0);
+    } else {
+        current = applyAtomicsOperation<int32_t>(AtomicsOperation::Load, address, 0, 0);
+    }
+    if (current != value) {
+        return Value(strings.notEqual.string());
+    }
+
+    if (waiterList.wait(locker, address, timeout)) {
+        return Value(strings.ok.string());
+    }
+    return Value(strings.timedOut.string());
+#else
+    UNUSED_VARIABLE(indexedPosition);
+    UNUSED_VARIABLE(value);
+    // nobody can wake up the only agent of this process
+    ErrorObject::throwBuiltinError(state, ErrorObject::TypeError, strings.Atomics.string(), false, strings.wait.string(), ErrorObject::Messages::GlobalObject_AgentCannotSuspend);
+    return Value();
+#endif
+}
+
+// https://tc39.es/ecma262/#sec-atomics.notify
+static Value builtinAtomicsNotify(ExecutionState& state, Value thisValue, size_t argc, Value* argv, Optional<Object*> newTarget)
+{
+    const StaticStrings& strings = state.context()->staticStrings();
+    TypedArrayObject* typedArray = validateIntegerTypedArray(state, argv[0], strings.notify, true);
+    size_t indexedPosition = validateAtomicAccess(state, typedArray, argv[1], strings.notify);
+
+    size_t count = SIZE_MAX;
+    if (!argv[2].isUndefined()) {
+        double c = std::max(argv[2].toInteger(state), 0.0);
+        count = c < (double)SIZE_MAX ? (size_t)c : SIZE_MAX;
+    }
+
+    // non-shared buffer cannot have any waiter
+    if (!typedArray->buffer()->isSharedArrayBufferObject()) {
+        return Value(0);
+    }
+
+#if defined(ENABLE_THREADING)
+    uint8_t* address = const_cast<uint8_t*>(typedArray->buffer()->data()) + indexedPosition;
+    return Value(AtomicsWaiterList::instance().notify(address, count));
+#else
+    UNUSED_VARIABLE(indexedPosition);
+    return Value(0);
+#endif
+}
+
+void GlobalObject::installAtomics(ExecutionState& state)
+{
+    const StaticStrings* strings = &state.context()->staticStrings();
+    m_atomics = new Object(state);
+    m_atomics->setGlobalIntrinsicObject(state);
+
+    struct {
+        AtomicString name;
+        NativeFunctionPointer function;
+        size_t length;
+    } functions[] = {
+        { strings->add, builtinAtomicsAdd, 3 },
+        { strings->stringAnd, builtinAtomicsAnd, 3 },
+        { strings->compareExchange, builtinAtomicsCompareExchange, 4 },
+        { strings->exchange, builtinAtomicsExchange, 3 },
+        { strings->isLockFree, builtinAtomicsIsLockFree, 1 },
+        { strings->load, builtinAtomicsLoad, 2 },
+        { strings->stringOr, builtinAtomicsOr, 3 },
+        { strings->store, builtinAtomicsStore, 3 },
+        { strings->sub, builtinAtomicsSub, 3 },
+        { strings->wait, builtinAtomicsWait, 4 },
+        { strings->notify, builtinAtomicsNotify, 3 },
+        { strings->stringXor, builtinAtomicsXor, 3 },
+    };
+
+    for (size_t i = 0; i < sizeof(functions) / sizeof(functions[0]); i++) {
+        m_atomics->defineOwnPropertyThrowsException(state, ObjectPropertyName(functions[i].name),
+                                                    ObjectPropertyDescriptor(new NativeFunctionObject(state, NativeFunctionInfo(functions[i].name, functions[i].function, functions[i].length, NativeFunctionInfo::Strict)), (ObjectPropertyDescriptor::PresentAttribute)(ObjectPropertyDescriptor::WritablePresent | ObjectPropertyDescriptor::ConfigurablePresent)));
+    }
+
+    m_atomics->defineOwnPropertyThrowsException(state, ObjectPropertyName(state, Value(state.context()->vmInstance()->globalSymbols().toStringTag)),
+                                                ObjectPropertyDescriptor(strings->Atomics.string(), (ObjectPropertyDescriptor::PresentAttribute)(ObjectPropertyDescriptor::ConfigurablePresent)));
+
+    defineOwnProperty(state, ObjectPropertyName(strings->Atomics),
+                      ObjectPropertyDescriptor(m_atomics, (ObjectPropertyDescriptor::PresentAttribute)(ObjectPropertyDescriptor::WritablePresent | ObjectPropertyDescriptor::ConfigurablePresent)));
+}
+} // namespace Escargot
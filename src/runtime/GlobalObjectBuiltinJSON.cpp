@@ -27,6 +27,7 @@
 #include "BooleanObject.h"
 #include "BigIntObject.h"
 #include "NativeFunctionObject.h"
+#include "JSONStream.h"
 
 #define RAPIDJSON_PARSE_DEFAULT_FLAGS kParseFullPrecisionFlag
 #define RAPIDJSON_ERROR_CHARTYPE char
@@ -40,11 +41,11 @@
 
 namespace Escargot {
 
-template <typename Encoding>
+template <typename Encoding, typename SourceCharType>
 struct JSONStringStream {
     typedef typename Encoding::Ch Ch;
 
-    JSONStringStream(const Ch* src, size_t length)
+    JSONStringStream(const SourceCharType* src, size_t length)
         : src_(src)
         , head_(src)
         , tail_(src + length)
@@ -79,117 +80,322 @@ struct JSONStringStream {
         return 0;
     }
 
-    const Ch* src_; //!< Current read position.
-    const Ch* head_; //!< Original head of the string.
-    const Ch* tail_;
+    const SourceCharType* src_; //!< Current read position.
+    const SourceCharType* head_; //!< Original head of the string.
+    const SourceCharType* tail_;
 };
 
-template <typename CharType, typename JSONCharType>
-static Value parseJSONWorker(ExecutionState& state, rapidjson::GenericValue<JSONCharType>& value)
+// UTF-8 input stream of rapidjson which reads the text part by part from JSONStream::InputCallback
+class JSONChunkedInputStream {
+    MAKE_STACK_ALLOCATED();
+
+public:
+    typedef char Ch;
+
+    JSONChunkedInputStream(JSONStream::InputCallback input, void* data)
+        : m_input(input)
+        , m_data(data)
+        , m_current(m_buffer)
+        , m_end(m_buffer)
+        , m_consumed(0)
+        , m_isEnded(false)
+    {
+    }
+
+    Ch Peek()
+    {
+        if (UNLIKELY(m_current == m_end) && !fill()) {
+            return 0;
+        }
+        return *m_current;
+    }
+    Ch Take()
+    {
+        if (UNLIKELY(m_current == m_end) && !fill()) {
+            return 0;
+        }
+        m_consumed++;
+        return *m_current++;
+    }
+    size_t Tell() const { return m_consumed; }
+    Ch* PutBegin()
+    {
+        RAPIDJSON_ASSERT(false);
+        return 0;
+    }
+    void Put(Ch) { RAPIDJSON_ASSERT(false); }
+    void Flush() { RAPIDJSON_ASSERT(false); }
+    size_t PutEnd(Ch*)
+    {
+        RAPIDJSON_ASSERT(false);
+        return 0;
+    }
+
+private:
+    bool fill()
+    {
+        if (m_isEnded) {
+            return false;
+        }
+        size_t length = m_input(m_buffer, sizeof(m_buffer), m_data);
+        ASSERT(length <= sizeof(m_buffer));
+        if (!length) {
+            m_isEnded = true;
+            return false;
+        }
+        m_current = m_buffer;
+        m_end = m_buffer + length;
+        return true;
+    }
+
+    JSONStream::InputCallback m_input;
+    void* m_data;
+    const char* m_current;
+    const char* m_end;
+    size_t m_consumed;
+    bool m_isEnded;
+    char m_buffer[16 * 1024];
+};
+
+static Value createJSONString(const char16_t* chars, size_t length)
 {
-    volatile int sp;
-    size_t currentStackBase = (size_t)&sp;
-#ifdef STACK_GROWS_DOWN
-    if (UNLIKELY(state.stackLimit() > currentStackBase)) {
-#else
-    if (UNLIKELY(state.stackLimit() < currentStackBase)) {
-#endif
-        ErrorObject::throwBuiltinError(state, ErrorObject::RangeError, "Maximum call stack size exceeded");
-    }
-
-    if (value.IsBool()) {
-        return Value(value.GetBool());
-    } else if (value.IsInt()) {
-        return Value(value.GetInt());
-    } else if (value.IsUint()) {
-        return Value(value.GetUint());
-    } else if (value.IsInt64()) {
-        return Value(value.GetInt64());
-    } else if (value.IsUint64()) {
-        return Value(value.GetUint64());
-    } else if (value.IsDouble()) {
-        return Value(value.GetDouble());
-    } else if (value.IsNull()) {
-        return Value(Value::Null);
-    } else if (value.IsString()) {
-        if (std::is_same<CharType, char16_t>::value) {
-            const char16_t* chars = (const char16_t*)value.GetString();
-            unsigned len = value.GetStringLength();
-            if (isAllLatin1(chars, len)) {
-                return new Latin1String(chars, len);
-            } else {
-                return new UTF16String(chars, len);
+    if (!length) {
+        return String::emptyString;
+    }
+    if (isAllLatin1(chars, length)) {
+        return new Latin1String(chars, length);
+    }
+    return new UTF16String(chars, length);
+}
+
+static bool equalsJSONString(const String* str, const char16_t* chars, size_t length)
+{
+    if (str->length() != length) {
+        return false;
+    }
+    auto data = str->bufferAccessData();
+    if (data.has8BitContent) {
+        const LChar* buffer = (const LChar*)data.bufferAs8Bit;
+        for (size_t i = 0; i < length; i++) {
+            if (buffer[i] != chars[i]) {
+                return false;
             }
+        }
+        return true;
+    }
+    return memcmp(data.bufferAs16Bit, chars, sizeof(char16_t) * length) == 0;
+}
+
+// SAX handler of rapidjson::GenericReader which creates the result of JSON.parse in one pass.
+// Values of unfinished arrays and objects are kept in m_values (property names in m_keys)
+// until the matching EndArray or EndObject creates the container from them.
+// With elementCallback, elements of the top-level array are given to it one by one instead (see JSONStream::parse).
+// JSON texts usually have many objects with the same property names in the same order (like records of an array),
+// so the transition structure of the last object of each depth is kept. The next object of the same depth
+// reuses its property names without looking up the AtomicString table, and is created with the structure directly.
+class JSONParseHandler {
+    MAKE_STACK_ALLOCATED();
+
+public:
+    typedef char16_t Ch;
+
+    explicit JSONParseHandler(ExecutionState& state, JSONStream::ElementCallback elementCallback = nullptr, void* callbackData = nullptr)
+        : m_state(state)
+        , m_elementCallback(elementCallback)
+        , m_callbackData(callbackData)
+        , m_isStreamingArray(false)
+    {
+    }
+
+    Value result()
+    {
+        ASSERT(m_frames.empty() && m_values.size() == 1);
+        return m_values[0];
+    }
+
+    // true if the top-level array is given to elementCallback
+    bool isStreamingArray() const
+    {
+        return m_isStreamingArray;
+    }
+
+    bool Null() { return pushValue(Value(Value::Null)); }
+    bool Bool(bool b) { return pushValue(Value(b)); }
+    bool Int(int i) { return pushValue(Value(i)); }
+    bool Uint(unsigned u) { return pushValue(Value(u)); }
+    bool Int64(int64_t i) { return pushValue(Value(i)); }
+    bool Uint64(uint64_t u) { return pushValue(Value(u)); }
+    bool Double(double d) { return pushValue(Value(d)); }
+    bool String(const char16_t* chars, rapidjson::SizeType length, bool)
+    {
+        return pushValue(createJSONString(chars, length));
+    }
+
+    bool StartObject() { return pushFrame(); }
+    bool Key(const char16_t* chars, rapidjson::SizeType length, bool)
+    {
+        size_t depth = m_frames.size() - 1;
+        size_t index = m_keys.size() - m_frames.back().m_keyStart;
+        ObjectStructure* structure = depth < m_structures.size() ? m_structures[depth] : nullptr;
+        if (structure && index < structure->propertyCount()) {
+            const ObjectStructurePropertyName& expected = structure->readProperty(index).m_propertyName;
+            if (expected.hasAtomicString() && equalsJSONString(expected.plainString(), chars, length)) {
+                m_keys.pushBack(expected.asAtomicString());
+                return true;
+            }
+        }
+        m_keys.pushBack(AtomicString(m_state, chars, length));
+        return true;
+    }
+    bool EndObject(rapidjson::SizeType memberCount)
+    {
+        Frame frame = m_frames.back();
+        m_frames.pop_back();
+        ASSERT(m_keys.size() - frame.m_keyStart == memberCount);
+        ASSERT(m_values.size() - frame.m_valueStart == memberCount);
+
+        size_t depth = m_frames.size();
+        const AtomicString* keys = m_keys.data() + frame.m_keyStart;
+        const Value* values = m_values.data() + frame.m_valueStart;
+        ObjectStructure* structure = depth < m_structures.size() ? m_structures[depth] : nullptr;
+
+        Object* obj;
+        if (structure && hasSameProperties(structure, keys, memberCount)) {
+            ObjectPropertyValueVector propertyValues;
+            propertyValues.resizeWithUninitializedValues(0, memberCount);
+            for (size_t i = 0; i < memberCount; i++) {
+                propertyValues[i] = values[i];
+            }
+            obj = new Object(structure, std::move(propertyValues), m_state.context()->globalObject()->objectPrototype());
         } else {
-            const char* valueAsString = (const char*)value.GetString();
-            if (isAllASCII(valueAsString, strlen(valueAsString))) {
-                return new ASCIIString(valueAsString);
-            } else {
-                return new UTF16String(utf8StringToUTF16String(valueAsString, strlen(valueAsString)));
+            obj = new Object(m_state);
+            if (memberCount > ESCARGOT_OBJECT_STRUCTURE_TRANSITION_MODE_MAX_SIZE) {
+                obj->markThisObjectDontNeedStructureTransitionTable();
+            }
+            // the later value wins if there are duplicated names
+            for (size_t i = 0; i < memberCount; i++) {
+                obj->defineOwnProperty(m_state, ObjectPropertyName(keys[i]), ObjectPropertyDescriptor(values[i], ObjectPropertyDescriptor::AllPresent));
+            }
+
+            // only transition structures can be shared between objects
+            structure = obj->structure();
+            if (structure->inTransitionMode() && structure->propertyCount() == memberCount) {
+                if (depth >= m_structures.size()) {
+                    m_structures.resize(depth + 1, nullptr);
+                }
+                m_structures[depth] = structure;
             }
         }
-    } else if (value.IsArray()) {
-        ArrayObject* arr = new ArrayObject(state, value.Size(), false);
-        size_t i = 0;
-        for (size_t i = 0; i < value.Size(); i++) {
-            arr->defineOwnIndexedPropertyWithExpandedLength(state, i, parseJSONWorker<CharType, JSONCharType>(state, value[i]));
-        }
-        return arr;
-    } else if (value.IsObject()) {
-        Object* obj = new Object(state);
-        if (value.MemberCount() > ESCARGOT_OBJECT_STRUCTURE_TRANSITION_MODE_MAX_SIZE) {
-            obj->markThisObjectDontNeedStructureTransitionTable();
-        }
-        auto iter = value.MemberBegin();
-        while (iter != value.MemberEnd()) {
-            Value propertyName = parseJSONWorker<CharType, JSONCharType>(state, iter->name);
-            ASSERT(propertyName.isString());
-            obj->defineOwnProperty(state, ObjectPropertyName(AtomicString(state, propertyName.toString(state))),
-                                   ObjectPropertyDescriptor(parseJSONWorker<CharType, JSONCharType>(state, iter->value), ObjectPropertyDescriptor::AllPresent));
-            iter++;
-        }
-        return obj;
-    } else {
-        RELEASE_ASSERT_NOT_REACHED();
+
+        m_keys.resize(frame.m_keyStart);
+        m_values.resize(frame.m_valueStart);
+        return pushValue(obj);
+    }
+
+    bool StartArray()
+    {
+        if (m_elementCallback && m_frames.empty()) {
+            m_isStreamingArray = true;
+        }
+        return pushFrame();
+    }
+    bool EndArray(rapidjson::SizeType elementCount)
+    {
+        if (m_isStreamingArray && m_frames.size() == 1) {
+            m_frames.pop_back();
+            return true;
+        }
+
+        size_t start = m_frames.back().m_valueStart;
+        m_frames.pop_back();
+        ASSERT(m_values.size() - start == elementCount);
+
+        ArrayObject* arr = new ArrayObject(m_state, m_values.data() + start, elementCount);
+        m_values.resize(start);
+        return pushValue(arr);
+    }
+
+private:
+    struct Frame {
+        size_t m_valueStart;
+        size_t m_keyStart;
+    };
+
+    bool pushValue(const Value& value)
+    {
+        if (UNLIKELY(m_isStreamingArray && m_frames.size() == 1)) {
+            return m_elementCallback(m_state, value, m_callbackData);
+        }
+        m_values.pushBack(value);
+        return true;
+    }
+
+    bool pushFrame()
+    {
+        m_frames.push_back(Frame{ m_values.size(), m_keys.size() });
+        return true;
+    }
+
+    static bool hasSameProperties(ObjectStructure* structure, const AtomicString* keys, size_t count)
+    {
+        if (structure->propertyCount() != count) {
+            return false;
+        }
+        for (size_t i = 0; i < count; i++) {
+            if (structure->readProperty(i).m_propertyName != keys[i]) {
+                return false;
+            }
+        }
+        return true;
     }
-}
 
-template <typename CharType, typename JSONCharType>
-Value parseJSON(ExecutionState& state, const CharType* data, size_t length)
+    ExecutionState& m_state;
+    ValueVector m_values;
+    Vector<AtomicString, GCUtil::gc_malloc_allocator<AtomicString>> m_keys;
+    // structure of the last object created at each depth
+    Vector<ObjectStructure*, GCUtil::gc_malloc_allocator<ObjectStructure*>> m_structures;
+    std::vector<Frame> m_frames;
+    JSONStream::ElementCallback m_elementCallback;
+    void* m_callbackData;
+    bool m_isStreamingArray;
+};
+
+template <typename CharType>
+static Value parseJSON(ExecutionState& state, const CharType* data, size_t length)
 {
     auto strings = &state.context()->staticStrings();
-    rapidjson::GenericDocument<JSONCharType> jsonDocument;
+    // iterative parsing keeps nesting of arrays and objects in heap instead of native stack
+    rapidjson::GenericReader<rapidjson::UTF16<char16_t>, rapidjson::UTF16<char16_t>> reader;
+    JSONStringStream<rapidjson::UTF16<char16_t>, CharType> stringStream(data, length);
+    JSONParseHandler handler(state);
 
-    JSONStringStream<JSONCharType> stringStream(data, length);
-    jsonDocument.ParseStream(stringStream);
-    if (jsonDocument.HasParseError()) {
-        ErrorObject::throwBuiltinError(state, ErrorObject::SyntaxError, strings->JSON.string(), true, strings->parse.string(), rapidjson::GetParseError_En(jsonDocument.GetParseError()));
+    rapidjson::ParseResult result = reader.Parse<rapidjson::kParseIterativeFlag | rapidjson::kParseFullPrecisionFlag>(stringStream, handler);
+    if (result.IsError()) {
+        ErrorObject::throwBuiltinError(state, ErrorObject::SyntaxError, strings->JSON.string(), true, strings->parse.string(), rapidjson::GetParseError_En(result.Code()));
     }
 
-    return parseJSONWorker<CharType, JSONCharType>(state, jsonDocument);
+    return handler.result();
 }
 
-String* codePointTo4digitString(int codepoint)
+void JSONStream::parse(ExecutionState& state, InputCallback input, ElementCallback callback, void* data)
 {
-    StringBuilder ret;
-    int d = 16 * 16 * 16;
-    for (int i = 0; i < 4; ++i) {
-        if (codepoint >= d) {
-            char16_t c;
-            if (codepoint / d < 10) {
-                c = (codepoint / d) + '0';
-            } else {
-                c = (codepoint / d) - 10 + 'a';
-            }
-            codepoint %= d;
-            ret.appendChar(c);
-        } else {
-            ret.appendChar('0');
-        }
-        d >>= 4;
+    auto strings = &state.context()->staticStrings();
+    rapidjson::GenericReader<rapidjson::UTF8<char>, rapidjson::UTF16<char16_t>> reader;
+    JSONChunkedInputStream stream(input, data);
+    JSONParseHandler handler(state, callback, data);
+
+    rapidjson::ParseResult result = reader.Parse<rapidjson::kParseIterativeFlag | rapidjson::kParseFullPrecisionFlag | rapidjson::kParseValidateEncodingFlag>(stream, handler);
+    if (result.Code() == rapidjson::kParseErrorTermination) {
+        // stopped by callback
+        return;
+    }
+    if (result.IsError()) {
+        ErrorObject::throwBuiltinError(state, ErrorObject::SyntaxError, strings->JSON.string(), true, strings->parse.string(), rapidjson::GetParseError_En(result.Code()));
     }
 
-    return ret.finalize();
+    if (!handler.isStreamingArray()) {
+        callback(state, handler.result(), data);
+    }
 }
 
 static Value builtinJSONParse(ExecutionState& state, Value thisValue, size_t argc, Value* argv, Optional<Object*> newTarget)
@@ -201,16 +407,9 @@ static Value builtinJSONParse(ExecutionState& state, Value thisValue, size_t arg
     Value unfiltered;
 
     if (JText->has8BitContent()) {
-        size_t len = JText->length();
-        char16_t* char16Buf = new char16_t[len];
-        std::unique_ptr<char16_t[]> buf(char16Buf);
-        const LChar* srcBuf = JText->characters8();
-        for (size_t i = 0; i < len; i++) {
-            char16Buf[i] = srcBuf[i];
-        }
-        unfiltered = parseJSON<char16_t, rapidjson::UTF16<char16_t>>(state, buf.get(), JText->length());
+        unfiltered = parseJSON(state, JText->characters8(), JText->length());
     } else {
-        unfiltered = parseJSON<char16_t, rapidjson::UTF16<char16_t>>(state, JText->characters16(), JText->length());
+        unfiltered = parseJSON(state, JText->characters16(), JText->length());
     }
 
     // 4
@@ -221,6 +420,17 @@ static Value builtinJSONParse(ExecutionState& state, Value thisValue, size_t arg
         root->defineOwnProperty(state, ObjectPropertyName(state, String::emptyString), ObjectPropertyDescriptor(unfiltered, ObjectPropertyDescriptor::AllPresent));
         std::function<Value(Value, const ObjectPropertyName&)> Walk;
         Walk = [&](Value holder, const ObjectPropertyName& name) -> Value {
+            // parsing accepts any depth, but Walk recurses for each level
+            volatile int sp;
+            size_t currentStackBase = (size_t)&sp;
+#ifdef STACK_GROWS_DOWN
+            if (UNLIKELY(state.stackLimit() > currentStackBase)) {
+#else
+            if (UNLIKELY(state.stackLimit() < currentStackBase)) {
+#endif
+                ErrorObject::throwBuiltinError(state, ErrorObject::RangeError, "Maximum call stack size exceeded");
+            }
+
             Value val = holder.asPointerValue()->asObject()->get(state, name).value(state, holder);
             if (val.isObject()) {
                 if (val.asObject()->isArray(state)) {
@@ -542,74 +752,71 @@ static void builtinJSONStringifyJO(ExecutionState& state, Object* value,
     indent = stepback;
 }
 
+static ALWAYS_INLINE bool needsJSONEscape(char16_t c)
+{
+    return c < 0x20 || c == u'\"' || c == u'\\';
+}
+
+// returns the index of the first character in [start, length) which needs escaping, or length
+// characters are checked a 64-bit word at a time (8 Latin1 or 4 UTF-16 characters) before the exact position is searched
+template <typename CharType>
+static size_t findJSONEscapeCharacter(const CharType* chars, size_t start, size_t length)
+{
+    const size_t charsPerWord = sizeof(uint64_t) / sizeof(CharType);
+    const uint64_t ones = ~0ULL / ((1ULL << (8 * sizeof(CharType))) - 1);
+    const uint64_t highBits = ones << (8 * sizeof(CharType) - 1);
+
+    size_t i = start;
+    for (; i + charsPerWord <= length; i += charsPerWord) {
+        uint64_t word;
+        memcpy(&word, chars + i, sizeof(uint64_t));
+        uint64_t quote = word ^ (ones * '"');
+        uint64_t backslash = word ^ (ones * '\\');
+        // high bit of a lane is set if the lane is less than 0x20 or zero after xor
+        uint64_t found = ((word - ones * 0x20) & ~word) | ((quote - ones) & ~quote) | ((backslash - ones) & ~backslash);
+        if (found & highBits) {
+            break;
+        }
+    }
+
+    while (i < length && !needsJSONEscape(chars[i])) {
+        i++;
+    }
+    return i;
+}
+
 // https://www.ecma-international.org/ecma-262/6.0/#sec-quotejsonstring
 static void builtinJSONStringifyQuote(ExecutionState& state, String* value, LargeStringBuilder& product)
 {
+    static const char* const controlCharacterEscapes[0x20] = {
+        "\\u0000", "\\u0001", "\\u0002", "\\u0003", "\\u0004", "\\u0005", "\\u0006", "\\u0007",
+        "\\b", "\\t", "\\n", "\\u000b", "\\f", "\\r", "\\u000e", "\\u000f",
+        "\\u0010", "\\u0011", "\\u0012", "\\u0013", "\\u0014", "\\u0015", "\\u0016", "\\u0017",
+        "\\u0018", "\\u0019", "\\u001a", "\\u001b", "\\u001c", "\\u001d", "\\u001e", "\\u001f"
+    };
+
     auto bad = value->bufferAccessData();
     product.appendChar('"');
-    for (size_t i = 0; i < bad.length; ++i) {
-        char16_t c = bad.charAt(i);
-
-        switch (c) {
-        case u'\"':
-        case u'\\':
-            product.appendChar('\\');
-            product.appendChar(c);
-            break;
-        case u'\b':
-            product.appendChar('\\');
-            product.appendChar('b');
-            break;
-        case u'\f':
-            product.appendChar('\\');
-            product.appendChar('f');
-            break;
-        case u'\n':
-            product.appendChar('\\');
-            product.appendChar('n');
+    size_t start = 0;
+    while (start < bad.length) {
+        // runs of characters without escaping are appended as a substring of value
+        size_t end = bad.has8BitContent ? findJSONEscapeCharacter((const LChar*)bad.bufferAs8Bit, start, bad.length)
+                                        : findJSONEscapeCharacter(bad.bufferAs16Bit, start, bad.length);
+        product.appendSubString(value, start, end);
+        if (end == bad.length) {
             break;
-        case u'\r':
-            product.appendChar('\\');
-            product.appendChar('r');
-            break;
-        case u'\t':
-            product.appendChar('\\');
-            product.appendChar('t');
-            break;
-        case 0:
-        case 1:
-        case 2:
-        case 3:
-        case 4:
-        case 5:
-        case 6:
-        case 7:
-        case 11:
-        case 14:
-        case 15:
-        case 16:
-        case 17:
-        case 18:
-        case 19:
-        case 20:
-        case 21:
-        case 22:
-        case 23:
-        case 24:
-        case 25:
-        case 26:
-        case 27:
-        case 28:
-        case 29:
-        case 30:
-        case 31:
-            product.appendChar('\\');
-            product.appendChar('u');
-            product.appendString(codePointTo4digitString(c));
-            break;
-        default:
-            product.appendChar(c);
         }
+
+        char16_t c = bad.charAt(end);
+        if (c == u'\"') {
+            product.appendString("\\\"");
+        } else if (c == u'\\') {
+            product.appendString("\\\\");
+        } else {
+            ASSERT(c < 0x20);
+            product.appendString(controlCharacterEscapes[c]);
+        }
+        start = end + 1;
     }
     product.appendChar('"');
 }
@@ -620,6 +827,316 @@ static void builtinJSONStringifyQuote(ExecutionState& state, Value value, LargeS
     builtinJSONStringifyQuote(state, str, product);
 }
 
+// Serializer for the common JSON.stringify call without replacer and gap.
+// Plain objects and fast mode arrays are written directly from their structure and fast mode buffer
+// when nothing user-observable (toJSON, accessor, proxy) can be reached through them.
+// Every other value goes to builtinJSONStringifyStr, so the result is same with the generic steps.
+class JSONStringifyFastPath {
+    MAKE_STACK_ALLOCATED();
+
+public:
+    JSONStringifyFastPath(ExecutionState& state, StaticStrings* strings, ValueVectorWithInlineStorage& stack)
+        : m_state(state)
+        , m_strings(strings)
+        , m_stack(stack)
+        , m_output(nullptr)
+        , m_outputData(nullptr)
+        , m_outputProduct(nullptr)
+    {
+        m_checkedPrototypes[0] = m_checkedPrototypes[1] = nullptr;
+        for (size_t i = 0; i < StructureCacheSize; i++) {
+            m_structureCache[i] = nullptr;
+        }
+    }
+
+    // same with builtinJSONStringifyStr(key, holder) where value is the value of key in holder
+    bool serialize(const Value& key, Object* holder, const Value& value, LargeStringBuilder& product)
+    {
+        if (canSerializeDirectly(value)) {
+            serializeDirectly(value, product);
+            return true;
+        }
+        if (value.isUndefined() || value.isSymbol()) {
+            return false;
+        }
+        return serializeGeneric(key, holder, product);
+    }
+
+    // product is written to output in UTF-8 whenever it grows over OutputChunkSize (see JSONStream::stringify)
+    // it is checked only between elements and properties, so a surrogate pair is never split
+    void setOutput(LargeStringBuilder* product, JSONStream::OutputCallback output, void* data)
+    {
+        m_outputProduct = product;
+        m_output = output;
+        m_outputData = data;
+    }
+
+    void flush()
+    {
+        ASSERT(!!m_outputProduct);
+        if (m_outputProduct->contentLength()) {
+            String* chunk = m_outputProduct->finalize(&m_state);
+            m_outputProduct->clear();
+            auto utf8 = chunk->toNonGCUTF8StringData();
+            m_output(utf8.data(), utf8.length(), m_outputData);
+        }
+    }
+
+private:
+    static const size_t OutputChunkSize = 64 * 1024;
+
+    void flushIfNeeded(LargeStringBuilder& product)
+    {
+        if (UNLIKELY(&product == m_outputProduct) && product.contentLength() >= OutputChunkSize) {
+            flush();
+        }
+    }
+
+    struct PropertyPrefix {
+        size_t m_index;
+        String* m_name;
+        // ,"name":
+        String* m_prefix;
+    };
+
+    struct StructureInfo : public gc {
+        explicit StructureInfo(ObjectStructure* structure)
+            : m_structure(structure)
+            , m_canUseFastPath(true)
+        {
+        }
+
+        ObjectStructure* m_structure;
+        // false if the structure has accessor, index name or toJSON
+        bool m_canUseFastPath;
+        // enumerable string properties in structure order
+        Vector<PropertyPrefix, GCUtil::gc_malloc_allocator<PropertyPrefix>> m_properties;
+    };
+
+    static const size_t StructureCacheSize = 16;
+
+    // true if value is written without running any user code (this always writes something)
+    bool canSerializeDirectly(const Value& value)
+    {
+        if (!value.isPointerValue()) {
+            return !value.isUndefined();
+        }
+        if (value.isString()) {
+            return true;
+        }
+        if (!value.isObject()) {
+            return false;
+        }
+
+        Object* obj = value.asObject();
+        if (obj->isArrayObject()) {
+            ArrayObject* arr = obj->asArrayObject();
+            return arr->isFastModeArray() && arr->structure()->findProperty(ObjectStructurePropertyName(m_strings->toJSON)).first == SIZE_MAX
+                && prototypeChainHasNoToJSON(arr->getPrototypeObject(m_state));
+        }
+        if (obj->isPlainObject()) {
+            return structureInfo(obj->structure())->m_canUseFastPath && prototypeChainHasNoToJSON(obj->getPrototypeObject(m_state));
+        }
+        return false;
+    }
+
+    void serializeDirectly(const Value& value, LargeStringBuilder& product)
+    {
+        if (value.isNull()) {
+            product.appendString(m_strings->null.string());
+        } else if (value.isBoolean()) {
+            product.appendString(value.asBoolean() ? m_strings->stringTrue.string() : m_strings->stringFalse.string());
+        } else if (value.isNumber()) {
+            if (std::isfinite(value.asNumber())) {
+                product.appendString(value.toString(m_state));
+            } else {
+                product.appendString(m_strings->null.string());
+            }
+        } else if (value.isString()) {
+            builtinJSONStringifyQuote(m_state, value.asString(), product);
+        } else if (value.asObject()->isArrayObject()) {
+            serializeArray(value.asObject()->asArrayObject(), product);
+        } else {
+            serializeObject(value.asObject(), product);
+        }
+    }
+
+    bool serializeGeneric(const Value& key, Object* holder, LargeStringBuilder& product)
+    {
+        // user code can add toJSON to any prototype
+        m_checkedPrototypes[0] = m_checkedPrototypes[1] = nullptr;
+        return builtinJSONStringifyStr(m_state, key, holder, m_strings, Value(), m_stack, String::emptyString, String::emptyString, false, m_propertyList, product);
+    }
+
+    void pushStack(Object* obj, const char* message)
+    {
+        for (size_t i = 0; i < m_stack.size(); i++) {
+            if (m_stack[i] == Value(obj)) {
+                ErrorObject::throwBuiltinError(m_state, ErrorObject::TypeError, m_strings->JSON.string(), false, m_strings->stringify.string(), message);
+            }
+        }
+        m_stack.push_back(Value(obj));
+    }
+
+    void serializeArray(ArrayObject* arr, LargeStringBuilder& product)
+    {
+        pushStack(arr, ErrorObject::Messages::GlobalObject_JAError);
+
+        uint32_t len = arr->arrayLength(m_state);
+        if (len / 2 > STRING_MAXIMUM_LENGTH) {
+            ErrorObject::throwBuiltinError(m_state, ErrorObject::RangeError, m_strings->JSON.string(), false, m_strings->stringify.string(), ErrorObject::Messages::GlobalObject_JAError);
+        }
+
+        product.appendChar('[');
+        for (uint32_t i = 0; i < len; i++) {
+            flushIfNeeded(product);
+            if (i) {
+                product.appendChar(',');
+            }
+            // array can be changed by user code of previous elements
+            Value value(Value::EmptyValue);
+            if (LIKELY(arr->isFastModeArray() && i < arr->arrayLength(m_state))) {
+                value = arr->getFastModeValue(i);
+            }
+
+            if (!value.isEmpty() && canSerializeDirectly(value)) {
+                serializeDirectly(value, product);
+            } else if (!value.isEmpty() && (value.isUndefined() || value.isSymbol())) {
+                product.appendString(m_strings->null.string());
+            } else if (!serializeGeneric(Value(i), arr, product)) {
+                // holes are read from prototype chain
+                product.appendString(m_strings->null.string());
+            }
+        }
+        product.appendChar(']');
+
+        m_stack.pop_back();
+    }
+
+    void serializeObject(Object* obj, LargeStringBuilder& product)
+    {
+        pushStack(obj, ErrorObject::Messages::GlobalObject_JOError);
+
+        // info is kept by this stack frame even if it is evicted from cache by nested objects
+        ObjectStructure* structure = obj->structure();
+        StructureInfo* info = structureInfo(structure);
+        ASSERT(info->m_canUseFastPath);
+        const auto& properties = info->m_properties;
+
+        bool first = true;
+        product.appendChar('{');
+        for (size_t i = 0; i < properties.size(); i++) {
+            flushIfNeeded(product);
+            const PropertyPrefix& property = properties[i];
+            // properties can be deleted or changed to accessor by user code of previous properties
+            if (LIKELY(obj->structure() == structure)) {
+                Value value = obj->uncheckedGetOwnDataProperty(property.m_index);
+                if (value.isUndefined() || value.isSymbol()) {
+                    continue;
+                }
+                if (canSerializeDirectly(value)) {
+                    product.appendSubString(property.m_prefix, first ? 1 : 0, property.m_prefix->length());
+                    serializeDirectly(value, product);
+                    first = false;
+                    continue;
+                }
+            }
+
+            LargeStringBuilder subProduct;
+            if (serializeGeneric(property.m_name, obj, subProduct)) {
+                product.appendSubString(property.m_prefix, first ? 1 : 0, property.m_prefix->length());
+                product.appendStringBuilder(subProduct);
+                first = false;
+            }
+        }
+        product.appendChar('}');
+
+        m_stack.pop_back();
+    }
+
+    bool prototypeChainHasNoToJSON(Object* proto)
+    {
+        if (proto == m_checkedPrototypes[0] || proto == m_checkedPrototypes[1]) {
+            return true;
+        }
+        // getOwnProperty of ordinary objects except Proxy and objects with named property handler does not run user code
+        for (Object* iter = proto; iter; iter = iter->getPrototypeObject(m_state)) {
+            if (!iter->isOrdinary() || !(iter->isInlineCacheable() || iter->isArrayObject())) {
+                return false;
+            }
+            if (iter->getOwnProperty(m_state, ObjectPropertyName(m_strings->toJSON)).hasValue()) {
+                return false;
+            }
+        }
+        m_checkedPrototypes[1] = m_checkedPrototypes[0];
+        m_checkedPrototypes[0] = proto;
+        return true;
+    }
+
+    StructureInfo* structureInfo(ObjectStructure* structure)
+    {
+        // info holds the structure, so the address is not reused by another structure while serialization
+        StructureInfo*& cached = m_structureCache[(reinterpret_cast<size_t>(structure) >> 4) & (StructureCacheSize - 1)];
+        if (cached && cached->m_structure == structure) {
+            return cached;
+        }
+
+        StructureInfo* info = new StructureInfo(structure);
+        for (size_t i = 0; i < structure->propertyCount(); i++) {
+            const ObjectStructureItem& item = structure->readProperty(i);
+            if (item.m_propertyName.isSymbol()) {
+                continue;
+            }
+            // index names come first in [[OwnPropertyKeys]], so structure order cannot be used
+            if (!item.m_descriptor.isPlainDataProperty() || item.m_propertyName.isIndexString() || item.m_propertyName == m_strings->toJSON) {
+                info->m_canUseFastPath = false;
+                info->m_properties.clear();
+                break;
+            }
+            if (!item.m_descriptor.isEnumerable()) {
+                continue;
+            }
+
+            String* name = item.m_propertyName.plainString();
+            LargeStringBuilder prefix;
+            prefix.appendChar(',');
+            builtinJSONStringifyQuote(m_state, name, prefix);
+            prefix.appendChar(':');
+            info->m_properties.pushBack(PropertyPrefix({ i, name, prefix.finalize(&m_state) }));
+        }
+        cached = info;
+        return info;
+    }
+
+    ExecutionState& m_state;
+    StaticStrings* m_strings;
+    ValueVectorWithInlineStorage& m_stack;
+    // empty property list for builtinJSONStringifyStr
+    ValueVectorWithInlineStorage m_propertyList;
+    // prototypes which are known to have no toJSON in their chain (cleared after running user code)
+    Object* m_checkedPrototypes[2];
+    StructureInfo* m_structureCache[StructureCacheSize];
+    JSONStream::OutputCallback m_output;
+    void* m_outputData;
+    LargeStringBuilder* m_outputProduct;
+};
+
+bool JSONStream::stringify(ExecutionState& state, const Value& value, OutputCallback output, void* data)
+{
+    Object* wrapper = new Object(state);
+    wrapper->defineOwnProperty(state, ObjectPropertyName(state, String::emptyString), ObjectPropertyDescriptor(value, ObjectPropertyDescriptor::AllPresent));
+
+    ValueVectorWithInlineStorage stack;
+    LargeStringBuilder product;
+    JSONStringifyFastPath fastPath(state, &state.context()->staticStrings(), stack);
+    fastPath.setOutput(&product, output, data);
+    if (!fastPath.serialize(String::emptyString, wrapper, value, product)) {
+        return false;
+    }
+    fastPath.flush();
+    return true;
+}
+
 static Value builtinJSONStringify(ExecutionState& state, Value thisValue, size_t argc, Value* argv, Optional<Object*> newTarget)
 {
     auto strings = &state.context()->staticStrings();
@@ -705,7 +1222,13 @@ static Value builtinJSONStringify(ExecutionState& state, Value thisValue, size_t
     // 10
     wrapper->defineOwnProperty(state, ObjectPropertyName(state, String::emptyString), ObjectPropertyDescriptor(value, ObjectPropertyDescriptor::AllPresent));
     LargeStringBuilder product;
-    auto ret = builtinJSONStringifyStr(state, String::emptyString, wrapper, strings, replacerFunc, stack, indent, gap, propertyListTouched, propertyList, product);
+    bool ret;
+    if (replacerFunc.isUndefined() && !propertyListTouched && !gap->length()) {
+        JSONStringifyFastPath fastPath(state, strings, stack);
+        ret = fastPath.serialize(String::emptyString, wrapper, value, product);
+    } else {
+        ret = builtinJSONStringifyStr(state, String::emptyString, wrapper, strings, replacerFunc, stack, indent, gap, propertyListTouched, propertyList, product);
+    }
     if (ret) {
         return product.finalize(&state);
     }
@@ -702,27 +702,14 @@ static Value builtinStringSplit(ExecutionState& state, Value thisValue, size_t a
         return A;
     }
 
-    std::function<Value(String*, int, String*)> splitMatchUsingStr;
-    splitMatchUsingStr = [](String* S, int q, String* R) -> Value {
-        int s = S->length();
-        int r = R->length();
-        if (q + r > s)
-            return Value(false);
-        for (int i = 0; i < r; i++)
-            if (S->charAt(q + i) != R->charAt(i))
-                return Value(false);
-        return Value(q + r);
-    };
     if (s == 0) {
-        bool ret = true;
+        bool ret;
         if (P->isRegExpObject()) {
             RegexMatchResult result;
             ret = P->asRegExpObject()->matchNonGlobally(state, S, result, false, 0);
         } else {
-            Value z = splitMatchUsingStr(S, 0, P->asString());
-            if (z.isBoolean()) {
-                ret = z.asBoolean();
-            }
+            // only an empty separator matches empty S
+            ret = P->asString()->length() == 0;
         }
         if (ret)
             return A;
@@ -761,25 +748,20 @@ static Value builtinStringSplit(ExecutionState& state, Value thisValue, size_t a
         }
     } else {
         String* R = P->asString();
+        size_t r = R->length();
         while (q != s) {
-            Value e = splitMatchUsingStr(S, q, R);
-            if (e == Value(false))
-                q++;
-            else {
-                if ((size_t)e.asInt32() == p)
-                    q++;
-                else {
-                    if (q >= S->length())
-                        break;
-
-                    String* T = S->substring(p, q);
-                    A->defineOwnProperty(state, ObjectPropertyName(state, Value(lengthA++)), ObjectPropertyDescriptor(T, ObjectPropertyDescriptor::AllPresent));
-                    if (lengthA == lim)
-                        return A;
-                    p = e.asInt32();
-                    q = p;
-                }
-            }
+            // find the next match of R instead of trying SplitMatch at every q
+            // an empty R matching at p does not split, so it is searched from q + 1
+            size_t e = S->find(R, r ? q : q + 1);
+            if (e == SIZE_MAX || e >= s)
+                break;
+
+            String* T = S->substring(p, e);
+            A->defineOwnProperty(state, ObjectPropertyName(state, Value(lengthA++)), ObjectPropertyDescriptor(T, ObjectPropertyDescriptor::AllPresent));
+            if (lengthA == lim)
+                return A;
+            p = e + r;
+            q = p;
         }
     }
 
@@ -1810,10 +1810,10 @@ Value Intl::getOption(ExecutionState& state, Object* options, Value property, In
 
 std::vector<std::string> Intl::numberingSystemsForLocale(String* locale)
 {
-    static std::vector<std::string> availableNumberingSystems;
-
-    UErrorCode status = U_ZERO_ERROR;
-    if (availableNumberingSystems.size() == 0) {
+    // function-local static is initialized only once even if several threads reach here together
+    static const std::vector<std::string> availableNumberingSystems = []() {
+        std::vector<std::string> names;
+        UErrorCode status = U_ZERO_ERROR;
         UEnumeration* numberingSystemNames = unumsys_openAvailableNames(&status);
         ASSERT(U_SUCCESS(status));
 
@@ -1824,14 +1824,15 @@ std::vector<std::string> Intl::numberingSystemsForLocale(String* locale)
             auto numsys = unumsys_openByName(result, &status);
             ASSERT(U_SUCCESS(status));
             if (!unumsys_isAlgorithmic(numsys)) {
-                availableNumberingSystems.push_back(std::string(result, resultLength));
+                names.push_back(std::string(result, resultLength));
             }
             unumsys_close(numsys);
         }
         uenum_close(numberingSystemNames);
-    }
+        return names;
+    }();
 
-    status = U_ZERO_ERROR;
+    UErrorCode status = U_ZERO_ERROR;
     UNumberingSystem* defaultSystem = unumsys_open(locale->toUTF8StringData().data(), &status);
     ASSERT(U_SUCCESS(status));
     std::string defaultSystemName(unumsys_getName(defaultSystem));
@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2021-present Samsung Electronics Co., Ltd
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+ */
+
+#ifndef __EscargotJSONStream__
+#define __EscargotJSONStream__
+
+#include "runtime/Value.h"
+
+namespace Escargot {
+
+// JSON.parse and JSON.stringify on UTF-8 text which is not held in memory at once
+// (implemented in GlobalObjectBuiltinJSON.cpp with the builtins)
+class JSONStream {
+public:
+    // fills buffer with the next part of the text and returns the number of bytes, 0 at the end of the text
+    typedef size_t (*InputCallback)(char* buffer, size_t bufferSize, void* data);
+    // returns false to stop parsing
+    typedef bool (*ElementCallback)(ExecutionState& state, const Value& element, void* data);
+    typedef void (*OutputCallback)(const char* chunk, size_t length, void* data);
+
+    // If the text is an array, each element is given to callback as soon as it is parsed and the array itself is not created.
+    // Otherwise the parsed value is given once.
+    // throws SyntaxError like JSON.parse
+    static void parse(ExecutionState& state, InputCallback input, ElementCallback callback, void* data);
+
+    // same with JSON.stringify(value) without replacer and space, but the result is written in chunks
+    // Values which can run user code (toJSON, getters, Proxy...) are buffered until they are done.
+    // returns false if nothing is written (value is undefined, function or symbol)
+    static bool stringify(ExecutionState& state, const Value& value, OutputCallback output, void* data);
+};
+} // namespace Escargot
+
+#endif
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2021-present Samsung Electronics Co., Ltd
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+ */
+
+#ifndef __EscargotMegamorphicInlineCache__
+#define __EscargotMegamorphicInlineCache__
+
+#include "runtime/ObjectStructurePropertyName.h"
+
+namespace Escargot {
+
+class ObjectStructure;
+
+struct MegamorphicInlineCacheEntry {
+    ObjectStructure* m_structure;
+    // structure of the prototype object which owns the property
+    // nullptr means the property is an own property of m_structure
+    ObjectStructure* m_holderStructure;
+    size_t m_propertyName;
+    size_t m_index;
+    bool m_isWritableDataProperty;
+};
+
+// VM-wide (ObjectStructure, property name) -> property index table used by megamorphic sites.
+// Every modification of an ObjectStructure creates a new ObjectStructure,
+// so an entry is valid while its structure is alive.
+// The table is scanned by GC, so its entries keep their structures alive until it is cleared.
+// VMInstance clears it on the first GC_EVENT_MARK_START of each collection, on the thread which owns the VMInstance
+class MegamorphicInlineCache : public gc {
+public:
+    MegamorphicInlineCache()
+    {
+        clear();
+    }
+
+    MegamorphicInlineCacheEntry* find(ObjectStructure* structure, const ObjectStructurePropertyName& propertyName)
+    {
+        MegamorphicInlineCacheEntry& entry = m_entries[hash(structure, propertyName)];
+        if (LIKELY(entry.m_structure == structure && entry.m_propertyName == propertyName.rawValue())) {
+            return &entry;
+        }
+        return nullptr;
+    }
+
+    void add(ObjectStructure* structure, const ObjectStructurePropertyName& propertyName, ObjectStructure* holderStructure, size_t index, bool isWritableDataProperty)
+    {
+        MegamorphicInlineCacheEntry& entry = m_entries[hash(structure, propertyName)];
+        entry.m_structure = structure;
+        entry.m_holderStructure = holderStructure;
+        entry.m_propertyName = propertyName.rawValue();
+        entry.m_index = index;
+        entry.m_isWritableDataProperty = isWritableDataProperty;
+    }
+
+    void clear()
+    {
+        memset(m_entries, 0, sizeof(m_entries));
+    }
+
+private:
+    static size_t hash(ObjectStructure* structure, const ObjectStructurePropertyName& propertyName)
+    {
+        size_t h = ((size_t)structure >> 4) ^ (propertyName.rawValue() >> 3);
+        return (h ^ (h >> 10)) & (MEGAMORPHIC_INLINE_CACHE_SIZE - 1);
+    }
+
+    MegamorphicInlineCacheEntry m_entries[MEGAMORPHIC_INLINE_CACHE_SIZE];
+};
+
+COMPILE_ASSERT((MEGAMORPHIC_INLINE_CACHE_SIZE & (MEGAMORPHIC_INLINE_CACHE_SIZE - 1)) == 0, "");
+} // namespace Escargot
+
+#endif
@@ -62,7 +62,12 @@ NativeFunctionObject::NativeFunctionObject(ExecutionState& state, const NativeFu
 }
 
 NativeFunctionObject::NativeFunctionObject(Context* context, ObjectStructure* structure, ObjectPropertyValueVector&& values, const NativeFunctionInfo& info)
-    : FunctionObject(structure, std::move(values), context->globalObject()->functionPrototype())
+    : NativeFunctionObject(context, structure, std::move(values), context->globalObject()->functionPrototype(), info)
+{
+}
+
+NativeFunctionObject::NativeFunctionObject(Context* context, ObjectStructure* structure, ObjectPropertyValueVector&& values, Object* proto, const NativeFunctionInfo& info)
+    : FunctionObject(structure, std::move(values), proto)
 {
     m_codeBlock = new NativeCodeBlock(context, info);
 }
@@ -25,6 +25,8 @@
 namespace Escargot {
 
 class NativeFunctionObject : public FunctionObject {
+    friend class ContextSnapshot;
+
 public:
     NativeFunctionObject(ExecutionState& state, const NativeFunctionInfo& info);
 
@@ -55,6 +57,7 @@ public:
 
 protected:
     NativeFunctionObject(Context* context, ObjectStructure* structure, ObjectPropertyValueVector&& values, const NativeFunctionInfo& info);
+    NativeFunctionObject(Context* context, ObjectStructure* structure, ObjectPropertyValueVector&& values, Object* proto, const NativeFunctionInfo& info);
 
     template <bool isConstruct, bool shouldReturnsObjectOnConstructCall = true>
     ALWAYS_INLINE Value processNativeFunctionCall(ExecutionState& state, const Value& receiver, const size_t argc, Value* argv, Optional<Object*> newTarget);
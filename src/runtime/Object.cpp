@@ -31,6 +31,7 @@
 #include "SymbolObject.h"
 #include "BigIntObject.h"
 #include "ProxyObject.h"
+#include "AllocationProfiler.h"
 
 namespace Escargot {
 
@@ -459,6 +460,7 @@ Object::Object(ExecutionState& state, Object* proto)
     ASSERT(proto->hasRareData() && proto->rareData()->m_isEverSetAsPrototypeObject);
     // create a new ordinary object
     m_values.resizeWithUninitializedValues(0, ESCARGOT_OBJECT_BUILTIN_PROPERTY_NUMBER);
+    AllocationProfiler::objectCreated(state, proto);
 }
 
 Object::Object(ExecutionState& state, Object::PrototypeIsNullTag)
@@ -467,6 +469,7 @@ Object::Object(ExecutionState& state, Object::PrototypeIsNullTag)
 {
     // create a new ordinary object
     m_values.resizeWithUninitializedValues(0, ESCARGOT_OBJECT_BUILTIN_PROPERTY_NUMBER);
+    AllocationProfiler::objectCreated(state, nullptr);
 }
 
 Object::Object(ExecutionState& state, Object* proto, size_t defaultSpace)
@@ -477,6 +480,7 @@ Object::Object(ExecutionState& state, Object* proto, size_t defaultSpace)
     ASSERT(!!proto);
     ASSERT(proto->hasRareData() && proto->rareData()->m_isEverSetAsPrototypeObject);
     m_values.resizeWithUninitializedValues(0, defaultSpace);
+    AllocationProfiler::objectCreated(state, proto);
 }
 
 // this constructor is used only for initialization of GlobalObject
@@ -533,6 +537,20 @@ Object* Object::createFunctionPrototypeObject(ExecutionState& state, FunctionObj
     return obj;
 }
 
+String* Object::constructorNameWithoutState()
+{
+    // depth is limited because Proxy can make a cycle of prototype chain
+    Optional<Object*> o = this;
+    for (size_t depth = 0; o && depth < 64; depth++) {
+        auto ctor = o->readConstructorSlotWithoutState();
+        if (ctor && ctor.value().isFunction()) {
+            return ctor.value().asFunction()->codeBlock()->functionName().string();
+        }
+        o = o->rawInternalPrototypeObject();
+    }
+    return nullptr;
+}
+
 void Object::setGlobalIntrinsicObject(ExecutionState& state, bool isPrototype)
 {
     // For initialization of GlobalObject's intrinsic objects
@@ -787,12 +787,16 @@ enum class ElementTypes : uint8_t {
 
 class Object : public PointerValue {
     friend class ObjectRef;
+    friend class VMInstance;
     friend class GlobalObject;
     friend class ByteCodeInterpreter;
     friend class EnumerateObjectWithDestruction;
     friend class EnumerateObjectWithIteration;
     friend struct ObjectRareData;
     friend class ObjectTemplate;
+    friend class ContextSnapshot;
+    friend class JSONParseHandler;
+    friend class JSONStringifyFastPath;
 
 public:
     explicit Object(ExecutionState& state);
@@ -800,6 +804,13 @@ public:
     enum PrototypeIsNullTag { PrototypeIsNull };
     explicit Object(ExecutionState& state, PrototypeIsNullTag); // I added new function for reducing checking null for prototype
 
+    // subclasses without their own allocator are allocated here too
+    void* operator new(size_t size)
+    {
+        return AllocationCache::allocate<AllocationCache::NormalKind>(size);
+    }
+    void* operator new[](size_t size) = delete;
+
     static Object* createBuiltinObjectPrototype(ExecutionState& state);
     static Object* createFunctionPrototypeObject(ExecutionState& state, FunctionObject* function);
 
@@ -872,6 +883,10 @@ public:
         return Optional<Value>();
     }
 
+    // name of the first constructor found in the prototype chain from this object (nullptr if there is none)
+    // it runs no user code, so it can be used while collecting heap information
+    String* constructorNameWithoutState();
+
     // internal [[prototype]]
     virtual bool setPrototype(ExecutionState& state, const Value& proto);
 
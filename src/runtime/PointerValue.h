@@ -52,6 +52,7 @@ class BoundFunctionObject;
 class PromiseObject;
 class ProxyObject;
 class ArrayBufferObject;
+class SharedArrayBufferObject;
 class ArrayBufferView;
 class DoubleInEncodedValue;
 class JSGetterSetter;
@@ -104,9 +105,12 @@ class PointerValue : public gc {
     friend class Context;
     friend class VMInstance;
     friend class ByteCodeInterpreter;
+    friend class JITOperations;
+    friend class ContextSnapshot;
 
     // tag values for fast type check
     // these values actually have unique virtual table address of each object class
+    static size_t g_objectTag;
     static size_t g_arrayObjectTag;
     static size_t g_arrayPrototypeObjectTag;
     static size_t g_objectRareDataTag;
@@ -135,6 +139,12 @@ public:
         return getTagInFirstDataArea() & POINTER_VALUE_BIGINT_TAG_IN_DATA;
     }
 
+    // instance of Object class itself (not of any subclass)
+    inline bool isPlainObject() const
+    {
+        return hasTag(g_objectTag);
+    }
+
     inline bool isArrayObject() const
     {
         return hasTag(g_arrayObjectTag) || hasTag(g_arrayPrototypeObjectTag);
@@ -291,6 +301,11 @@ public:
         return false;
     }
 
+    virtual bool isSharedArrayBufferObject() const
+    {
+        return false;
+    }
+
     virtual bool isTypedArrayPrototypeObject() const
     {
         return false;
@@ -635,6 +650,12 @@ public:
         return (ArrayBufferObject*)this;
     }
 
+    SharedArrayBufferObject* asSharedArrayBufferObject()
+    {
+        ASSERT(isSharedArrayBufferObject());
+        return (SharedArrayBufferObject*)this;
+    }
+
     ArrayBufferView* asArrayBufferView()
     {
         ASSERT(isArrayBufferView());
@@ -21,6 +21,7 @@
 #include "RopeString.h"
 #include "StringBuilder.h"
 #include "ErrorObject.h"
+#include "AllocationProfiler.h"
 
 namespace Escargot {
 
@@ -50,6 +51,10 @@ String* RopeString::createRopeString(String* lstr, String* rstr, ExecutionState*
         return lstr;
     }
 
+    if (state) {
+        AllocationProfiler::stringCreated(*state);
+    }
+
     if (llen + rlen < ROPE_STRING_MIN_LENGTH) {
         const auto& lData = lstr->bufferAccessData();
         const auto& rData = rstr->bufferAccessData();
@@ -0,0 +1,457 @@
+/*
+ * Copyright (c) 2021-present Samsung Electronics Co., Ltd
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+ */
+
+#include "Escargot.h"
+#include "SerializedValue.h"
+#include "runtime/Context.h"
+#include "runtime/GlobalObject.h"
+#include "runtime/ArrayObject.h"
+#include "runtime/ArrayBufferObject.h"
+#include "runtime/SharedArrayBufferObject.h"
+#include "runtime/BigInt.h"
+#include "runtime/DateObject.h"
+#include "runtime/MapObject.h"
+#include "runtime/SetObject.h"
+#include "runtime/RegExpObject.h"
+
+namespace Escargot {
+
+struct SerializerWriteData {
+    std::vector<uint8_t> m_buffer;
+    // every object is alive while writing because it is reachable from the value being serialized
+    std::unordered_map<Object*, size_t> m_objectIndexes;
+    std::vector<ArrayBufferObject*> m_transferList;
+    std::vector<BackingStore*> m_sharedBackingStores;
+
+    template <typename T>
+    void write(const T& value)
+    {
+        const uint8_t* p = reinterpret_cast<const uint8_t*>(&value);
+        m_buffer.insert(m_buffer.end(), p, p + sizeof(T));
+    }
+
+    void write(const void* src, size_t length)
+    {
+        const uint8_t* p = reinterpret_cast<const uint8_t*>(src);
+        m_buffer.insert(m_buffer.end(), p, p + length);
+    }
+};
+
+struct SerializerReadData {
+    const uint8_t* m_cursor;
+    const uint8_t* m_end;
+    Vector<Object*, GCUtil::gc_malloc_allocator<Object*>> m_objects;
+    Vector<ArrayBufferObject*, GCUtil::gc_malloc_allocator<ArrayBufferObject*>> m_transferred;
+    // SerializedValue::m_sharedBackingStores
+    const Vector<BackingStore*, GCUtil::gc_malloc_allocator<BackingStore*>>* m_sharedBackingStores;
+
+    template <typename T>
+    T read()
+    {
+        ASSERT(m_cursor + sizeof(T) <= m_end);
+        T value;
+        memcpy(&value, m_cursor, sizeof(T));
+        m_cursor += sizeof(T);
+        return value;
+    }
+
+    const uint8_t* read(size_t length)
+    {
+        ASSERT(m_cursor + length <= m_end);
+        const uint8_t* p = m_cursor;
+        m_cursor += length;
+        return p;
+    }
+};
+
+static void throwDataCloneError(ExecutionState& state, const char* message)
+{
+    ErrorObject::throwBuiltinError(state, ErrorObject::TypeError, "DataCloneError: %s", String::fromASCII(message, strlen(message)));
+}
+
+static void checkStackOverflow(ExecutionState& state)
+{
+    volatile int sp;
+    size_t currentStackBase = (size_t)&sp;
+#ifdef STACK_GROWS_DOWN
+    if (UNLIKELY(state.stackLimit() > currentStackBase)) {
+#else
+    if (UNLIKELY(state.stackLimit() < currentStackBase)) {
+#endif
+        ErrorObject::throwBuiltinError(state, ErrorObject::RangeError, "Maximum call stack size exceeded");
+    }
+}
+
+SerializedValue* SerializedValue::serialize(ExecutionState& state, const Value& value, const ValueVector& transferList)
+{
+    SerializerWriteData data;
+    for (size_t i = 0; i < transferList.size(); i++) {
+        const Value& item = transferList[i];
+        if (!item.isObject() || !item.asObject()->isArrayBufferObject() || item.asObject()->isSharedArrayBufferObject()) {
+            throwDataCloneError(state, "only ArrayBuffer can be transferred");
+        }
+        ArrayBufferObject* buffer = item.asObject()->asArrayBufferObject();
+        if (buffer->isDetachedBuffer()) {
+            throwDataCloneError(state, "detached ArrayBuffer cannot be transferred");
+        }
+        if (std::find(data.m_transferList.begin(), data.m_transferList.end(), buffer) != data.m_transferList.end()) {
+            throwDataCloneError(state, "ArrayBuffer is transferred more than once");
+        }
+        data.m_transferList.push_back(buffer);
+    }
+
+    writeValue(state, data, value);
+
+    SerializedValue* result = new SerializedValue();
+    result->m_data.resizeWithUninitializedValues(data.m_buffer.size());
+    memcpy(result->m_data.data(), data.m_buffer.data(), data.m_buffer.size());
+    for (size_t i = 0; i < data.m_sharedBackingStores.size(); i++) {
+        result->m_sharedBackingStores.pushBack(data.m_sharedBackingStores[i]);
+    }
+
+    // detach transferred buffers after every fallible step is done
+    for (size_t i = 0; i < data.m_transferList.size(); i++) {
+        ArrayBufferObject* buffer = data.m_transferList[i];
+        // backingStore() marks buffer as sharing its backing store, so detachArrayBuffer does not free it
+        BackingStore* backingStore = buffer->backingStore().value();
+        if (ArrayBufferObject::isAllocatedByPlatform(backingStore)) {
+            // Platform of this VMInstance can be deleted before the receiver frees the data (e.g. exit of worker thread)
+            // so the data is moved into a backing store which frees it by itself
+            BackingStore* ownedBackingStore = new BackingStore(backingStore->byteLength());
+            memcpy(ownedBackingStore->data(), backingStore->data(), backingStore->byteLength());
+            backingStore = ownedBackingStore;
+        }
+        buffer->detachArrayBuffer();
+        result->m_transferredBackingStores.pushBack(backingStore);
+    }
+
+    return result;
+}
+
+void SerializedValue::writeString(SerializerWriteData& data, String* str)
+{
+    auto bufferAccessData = str->bufferAccessData();
+    data.write(bufferAccessData.has8BitContent ? Latin1StringTag : UTF16StringTag);
+    data.write(bufferAccessData.length);
+    data.write(bufferAccessData.buffer, bufferAccessData.length * (bufferAccessData.has8BitContent ? sizeof(LChar) : sizeof(char16_t)));
+}
+
+void SerializedValue::writeValue(ExecutionState& state, SerializerWriteData& data, const Value& value)
+{
+    if (value.isUndefined()) {
+        data.write(UndefinedTag);
+    } else if (value.isNull()) {
+        data.write(NullTag);
+    } else if (value.isTrue()) {
+        data.write(TrueTag);
+    } else if (value.isFalse()) {
+        data.write(FalseTag);
+    } else if (value.isInt32()) {
+        data.write(Int32Tag);
+        data.write(value.asInt32());
+    } else if (value.isNumber()) {
+        data.write(DoubleTag);
+        data.write(value.asNumber());
+    } else if (value.isString()) {
+        writeString(data, value.asString());
+    } else if (value.isBigInt()) {
+        data.write(BigIntTag);
+        writeString(data, value.asBigInt()->toString());
+    } else if (value.isObject()) {
+        writeObject(state, data, value.asObject());
+    } else {
+        ASSERT(value.isSymbol());
+        throwDataCloneError(state, "Symbol cannot be cloned");
+    }
+}
+
+void SerializedValue::writeObject(ExecutionState& state, SerializerWriteData& data, Object* obj)
+{
+    checkStackOverflow(state);
+
+    auto iter = data.m_objectIndexes.find(obj);
+    if (iter != data.m_objectIndexes.end()) {
+        data.write(ObjectReferenceTag);
+        data.write(iter->second);
+        return;
+    }
+
+    // every other kind of object (functions, wrappers of primitives, errors, iterators, proxies...) cannot be cloned
+    if (!obj->isPlainObject() && !obj->isArrayObject() && !obj->isMapObject() && !obj->isSetObject() && !obj->isDateObject()
+        && !obj->isRegExpObject() && !obj->isArrayBufferObject()) {
+        throwDataCloneError(state, "object cannot be cloned");
+    }
+
+    // register the object ahead of its properties, so cyclic references are read as ObjectReferenceTag
+    data.m_objectIndexes.insert(std::make_pair(obj, data.m_objectIndexes.size()));
+
+    if (obj->isArrayObject()) {
+        data.write(ArrayTag);
+        data.write(obj->asArrayObject()->arrayLength(state));
+        writeProperties(state, data, obj);
+    } else if (obj->isMapObject()) {
+        data.write(MapTag);
+        MapObject* map = obj->asMapObject();
+        // storage can be modified by getters while writing entries
+        for (size_t i = 0; i < map->storage().size(); i++) {
+            Value key = map->storage()[i].first;
+            if (key.isEmpty()) {
+                continue;
+            }
+            Value value = map->storage()[i].second;
+            writeValue(state, data, key);
+            writeValue(state, data, value);
+        }
+        data.write(EndTag);
+    } else if (obj->isSetObject()) {
+        data.write(SetTag);
+        SetObject* set = obj->asSetObject();
+        for (size_t i = 0; i < set->storage().size(); i++) {
+            Value key = set->storage()[i];
+            if (key.isEmpty()) {
+                continue;
+            }
+            writeValue(state, data, key);
+        }
+        data.write(EndTag);
+    } else if (obj->isDateObject()) {
+        data.write(DateTag);
+        data.write(obj->asDateObject()->primitiveValue());
+    } else if (obj->isRegExpObject()) {
+        RegExpObject* regexp = obj->asRegExpObject();
+        data.write(RegExpTag);
+        data.write((unsigned)regexp->option());
+        writeString(data, regexp->source());
+    } else if (obj->isSharedArrayBufferObject()) {
+        // backing store is shared, not copied
+        BackingStore* backingStore = obj->asSharedArrayBufferObject()->backingStore().value();
+        size_t index = std::find(data.m_sharedBackingStores.begin(), data.m_sharedBackingStores.end(), backingStore) - data.m_sharedBackingStores.begin();
+        if (index == data.m_sharedBackingStores.size()) {
+            data.m_sharedBackingStores.push_back(backingStore);
+        }
+        data.write(SharedArrayBufferTag);
+        data.write(index);
+    } else if (obj->isArrayBufferObject()) {
+        ArrayBufferObject* buffer = obj->asArrayBufferObject();
+        auto transferIter = std::find(data.m_transferList.begin(), data.m_transferList.end(), buffer);
+        if (transferIter != data.m_transferList.end()) {
+            data.write(TransferredArrayBufferTag);
+            data.write((size_t)(transferIter - data.m_transferList.begin()));
+        } else {
+            if (buffer->isDetachedBuffer()) {
+                throwDataCloneError(state, "detached ArrayBuffer cannot be cloned");
+            }
+            data.write(ArrayBufferTag);
+            data.write(buffer->byteLength());
+            data.write(buffer->data(), buffer->byteLength());
+        }
+    } else {
+        ASSERT(obj->isPlainObject());
+        data.write(ObjectTag);
+        writeProperties(state, data, obj);
+    }
+}
+
+void SerializedValue::writeProperties(ExecutionState& state, SerializerWriteData& data, Object* obj)
+{
+    // own enumerable string-keyed properties only
+    Object::OwnPropertyKeyVector keys = obj->ownPropertyKeys(state);
+    for (size_t i = 0; i < keys.size(); i++) {
+        if (keys[i].isSymbol()) {
+            continue;
+        }
+        ObjectPropertyName name(state, keys[i]);
+        ObjectGetResult desc = obj->getOwnProperty(state, name);
+        // property can be deleted by getters
+        if (!desc.hasValue() || !desc.isEnumerable()) {
+            continue;
+        }
+        Value value = desc.value(state, Value(obj));
+        writeString(data, keys[i].toString(state));
+        writeValue(state, data, value);
+    }
+    data.write(EndTag);
+}
+
+Value SerializedValue::deserialize(ExecutionState& state)
+{
+    SerializerReadData data;
+    data.m_cursor = m_data.data();
+    data.m_end = m_data.data() + m_data.size();
+    data.m_sharedBackingStores = &m_sharedBackingStores;
+
+    for (size_t i = 0; i < m_transferredBackingStores.size(); i++) {
+        if (!m_transferredBackingStores[i]) {
+            throwDataCloneError(state, "transferred ArrayBuffer is already deserialized");
+        }
+    }
+    for (size_t i = 0; i < m_transferredBackingStores.size(); i++) {
+        ArrayBufferObject* buffer = new ArrayBufferObject(state);
+        buffer->attachBuffer(m_transferredBackingStores[i]);
+        m_transferredBackingStores[i] = nullptr;
+        data.m_transferred.pushBack(buffer);
+    }
+
+    Value result = readValue(state, data);
+    ASSERT(data.m_cursor == data.m_end);
+    return result;
+}
+
+Value SerializedValue::readValue(ExecutionState& state, SerializerReadData& data)
+{
+    return readValue(state, data, data.read<Tag>());
+}
+
+Value SerializedValue::readValue(ExecutionState& state, SerializerReadData& data, Tag tag)
+{
+    switch (tag) {
+    case UndefinedTag:
+        return Value();
+    case NullTag:
+        return Value(Value::Null);
+    case TrueTag:
+        return Value(true);
+    case FalseTag:
+        return Value(false);
+    case Int32Tag:
+        return Value(data.read<int32_t>());
+    case DoubleTag:
+        return Value(data.read<double>());
+    case Latin1StringTag: {
+        size_t length = data.read<size_t>();
+        if (!length) {
+            return Value(String::emptyString);
+        }
+        return Value(new Latin1String(data.read(length * sizeof(LChar)), length));
+    }
+    case UTF16StringTag: {
+        size_t length = data.read<size_t>();
+        // char16_t buffer in m_data can be unaligned
+        UTF16StringData buffer;
+        buffer.resizeWithUninitializedValues(length);
+        memcpy(buffer.data(), data.read(length * sizeof(char16_t)), length * sizeof(char16_t));
+        return Value(new UTF16String(std::move(buffer)));
+    }
+    case BigIntTag: {
+        Value str = readValue(state, data);
+        return Value(BigInt::parseString(str.asString()).value());
+    }
+    case ObjectReferenceTag: {
+        size_t index = data.read<size_t>();
+        ASSERT(index < data.m_objects.size());
+        return Value(data.m_objects[index]);
+    }
+    default:
+        break;
+    }
+
+    checkStackOverflow(state);
+
+    Object* result;
+    switch (tag) {
+    case ObjectTag:
+        result = new Object(state);
+        data.m_objects.pushBack(result);
+        readProperties(state, data, result);
+        break;
+    case ArrayTag: {
+        uint32_t length = data.read<uint32_t>();
+        ArrayObject* array = new ArrayObject(state);
+        data.m_objects.pushBack(array);
+        array->setArrayLength(state, length);
+        readProperties(state, data, array);
+        result = array;
+        break;
+    }
+    case MapTag: {
+        MapObject* map = new MapObject(state);
+        data.m_objects.pushBack(map);
+        Tag itemTag;
+        while ((itemTag = data.read<Tag>()) != EndTag) {
+            Value key = readValue(state, data, itemTag);
+            Value value = readValue(state, data);
+            map->set(state, key, value);
+        }
+        result = map;
+        break;
+    }
+    case SetTag: {
+        SetObject* set = new SetObject(state);
+        data.m_objects.pushBack(set);
+        Tag itemTag;
+        while ((itemTag = data.read<Tag>()) != EndTag) {
+            set->add(state, readValue(state, data, itemTag));
+        }
+        result = set;
+        break;
+    }
+    case DateTag: {
+        DateObject* date = new DateObject(state);
+        date->setTimeValue(DateObject::timeClip(state, data.read<double>()));
+        data.m_objects.pushBack(date);
+        result = date;
+        break;
+    }
+    case RegExpTag: {
+        unsigned option = data.read<unsigned>();
+        Value source = readValue(state, data);
+        result = new RegExpObject(state, source.asString(), option);
+        data.m_objects.pushBack(result);
+        break;
+    }
+    case ArrayBufferTag: {
+        size_t byteLength = data.read<size_t>();
+        ArrayBufferObject* buffer = ArrayBufferObject::allocateArrayBuffer(state, state.context()->globalObject()->arrayBuffer(), byteLength);
+        buffer->fillData(data.read(byteLength), byteLength);
+        data.m_objects.pushBack(buffer);
+        result = buffer;
+        break;
+    }
+    case SharedArrayBufferTag: {
+        size_t index = data.read<size_t>();
+        ASSERT(index < data.m_sharedBackingStores->size());
+        result = new SharedArrayBufferObject(state, state.context()->globalObject()->sharedArrayBufferPrototype(), (*data.m_sharedBackingStores)[index]);
+        data.m_objects.pushBack(result);
+        break;
+    }
+    case TransferredArrayBufferTag: {
+        size_t index = data.read<size_t>();
+        ASSERT(index < data.m_transferred.size());
+        result = data.m_transferred[index];
+        data.m_objects.pushBack(result);
+        break;
+    }
+    default:
+        RELEASE_ASSERT_NOT_REACHED();
+        return Value();
+    }
+
+    return Value(result);
+}
+
+void SerializedValue::readProperties(ExecutionState& state, SerializerReadData& data, Object* obj)
+{
+    Tag keyTag;
+    while ((keyTag = data.read<Tag>()) != EndTag) {
+        Value key = readValue(state, data, keyTag);
+        Value value = readValue(state, data);
+        obj->defineOwnPropertyThrowsException(state, ObjectPropertyName(state, key), ObjectPropertyDescriptor(value, ObjectPropertyDescriptor::AllPresent));
+    }
+}
+} // namespace Escargot
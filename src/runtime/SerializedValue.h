@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2021-present Samsung Electronics Co., Ltd
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+ */
+
+#ifndef __EscargotSerializedValue__
+#define __EscargotSerializedValue__
+
+#include "runtime/Value.h"
+
+namespace Escargot {
+
+class Object;
+class BackingStore;
+struct SerializerWriteData;
+struct SerializerReadData;
+
+// Structured clone of a js value (https://html.spec.whatwg.org/multipage/structured-data.html)
+// Serialized data does not refer to any object or string of the source Context,
+// so it can be deserialized in another VMInstance, even on another thread.
+// Supported types are primitives (except Symbol), plain objects, arrays, Map, Set, ArrayBuffer, SharedArrayBuffer, Date and RegExp.
+// Backing stores of transferred ArrayBuffers are moved into SerializedValue without copy,
+// except data allocated by Platform of the source VMInstance, which is copied once into a backing store freeing it by itself.
+// Backing stores of SharedArrayBuffers are shared by every deserialized copy.
+class SerializedValue : public gc {
+public:
+    // throws TypeError (DataCloneError) if value has an object which cannot be cloned
+    // ArrayBuffers in transferList are detached only when the serialization succeeds
+    static SerializedValue* serialize(ExecutionState& state, const Value& value, const ValueVector& transferList);
+
+    // create a copy of the serialized value in the Context of state
+    // transferred backing stores are handed over to the first deserialization, so the second one throws TypeError
+    Value deserialize(ExecutionState& state);
+
+    size_t byteLength() const
+    {
+        return m_data.size();
+    }
+
+private:
+    SerializedValue() {}
+
+    enum Tag : uint8_t {
+        UndefinedTag,
+        NullTag,
+        TrueTag,
+        FalseTag,
+        Int32Tag,
+        DoubleTag,
+        Latin1StringTag,
+        UTF16StringTag,
+        BigIntTag,
+        // index of an object which is already read
+        ObjectReferenceTag,
+        ObjectTag,
+        ArrayTag,
+        MapTag,
+        SetTag,
+        DateTag,
+        RegExpTag,
+        ArrayBufferTag,
+        TransferredArrayBufferTag,
+        // index of m_sharedBackingStores
+        SharedArrayBufferTag,
+        // end of properties of ObjectTag and ArrayTag, or end of entries of MapTag and SetTag
+        EndTag,
+    };
+
+    static void writeValue(ExecutionState& state, SerializerWriteData& data, const Value& value);
+    static void writeObject(ExecutionState& state, SerializerWriteData& data, Object* obj);
+    static void writeProperties(ExecutionState& state, SerializerWriteData& data, Object* obj);
+    static void writeString(SerializerWriteData& data, String* str);
+
+    static Value readValue(ExecutionState& state, SerializerReadData& data);
+    static Value readValue(ExecutionState& state, SerializerReadData& data, Tag tag);
+    static void readProperties(ExecutionState& state, SerializerReadData& data, Object* obj);
+
+    Vector<uint8_t, GCUtil::gc_malloc_atomic_allocator<uint8_t>> m_data;
+    Vector<BackingStore*, GCUtil::gc_malloc_allocator<BackingStore*>> m_transferredBackingStores;
+    Vector<BackingStore*, GCUtil::gc_malloc_allocator<BackingStore*>> m_sharedBackingStores;
+};
+} // namespace Escargot
+
+#endif
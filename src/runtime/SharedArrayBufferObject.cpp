@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2021-present Samsung Electronics Co., Ltd
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+ */
+
+#include "Escargot.h"
+#include "runtime/SharedArrayBufferObject.h"
+#include "runtime/Context.h"
+#include "runtime/GlobalObject.h"
+
+namespace Escargot {
+
+SharedArrayBufferObject::SharedArrayBufferObject(ExecutionState& state, Object* proto, BackingStore* backingStore)
+    : ArrayBufferObject(state, proto)
+{
+    static_assert(sizeof(SharedArrayBufferObject) == sizeof(ArrayBufferObject), "");
+    // attached backing store is never freed by detachArrayBuffer
+    attachBuffer(backingStore);
+}
+
+SharedArrayBufferObject* SharedArrayBufferObject::allocateSharedArrayBuffer(ExecutionState& state, Object* constructor, uint64_t byteLength)
+{
+    Object* proto = Object::getPrototypeFromConstructor(state, constructor, [](ExecutionState& state, Context* constructorRealm) -> Object* {
+        return constructorRealm->globalObject()->sharedArrayBufferPrototype();
+    });
+
+    if (byteLength >= (uint64_t)ArrayBufferObject::maxArrayBufferSize) {
+        ErrorObject::throwBuiltinError(state, ErrorObject::RangeError, state.context()->staticStrings().SharedArrayBuffer.string(), false, String::emptyString, ErrorObject::Messages::GlobalObject_InvalidArrayBufferSize);
+    }
+
+    // data of shared backing store outlives the VMInstance which allocated it
+    // so it is allocated by calloc instead of the Platform of VMInstance
+    ArrayBufferObject::collectGarbageBeforeAllocatingBuffer(byteLength);
+    return new SharedArrayBufferObject(state, proto, new BackingStore(byteLength));
+}
+} // namespace Escargot
@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2021-present Samsung Electronics Co., Ltd
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+ */
+
+#ifndef __EscargotSharedArrayBufferObject__
+#define __EscargotSharedArrayBufferObject__
+
+#include "runtime/ArrayBufferObject.h"
+
+namespace Escargot {
+
+// ArrayBuffer whose backing store can be referenced by several SharedArrayBufferObjects,
+// even from VMInstances running on other threads (see SerializedValue)
+// so it is never detached, and its data is accessed concurrently through Atomics
+class SharedArrayBufferObject : public ArrayBufferObject {
+public:
+    explicit SharedArrayBufferObject(ExecutionState& state, Object* proto, BackingStore* backingStore);
+
+    // https://tc39.es/ecma262/#sec-allocatesharedarraybuffer
+    static SharedArrayBufferObject* allocateSharedArrayBuffer(ExecutionState& state, Object* constructor, uint64_t byteLength);
+
+    virtual bool isSharedArrayBufferObject() const override
+    {
+        return true;
+    }
+
+    // SharedArrayBufferObject has no additional field, so it shares the allocator of ArrayBufferObject
+};
+} // namespace Escargot
+
+#endif
@@ -35,6 +35,7 @@ void StaticStrings::initStaticStrings()
 
 #define INIT_STATIC_STRING(atomicString, name) atomicString.initStaticString(atomicStringMap, new ASCIIStringFromExternalMemory(name, sizeof(name) - 1))
 
+    INIT_STATIC_STRING(stringAnd, "and");
     INIT_STATIC_STRING(stringBreak, "break");
     INIT_STATIC_STRING(stringCase, "case");
     INIT_STATIC_STRING(stringCatch, "catch");
@@ -54,6 +55,7 @@ void StaticStrings::initStaticStrings()
     INIT_STATIC_STRING(stringIn, "in");
     INIT_STATIC_STRING(stringMutable, "mutable");
     INIT_STATIC_STRING(stringNew, "new");
+    INIT_STATIC_STRING(stringOr, "or");
     INIT_STATIC_STRING(stringPrivate, "private");
     INIT_STATIC_STRING(stringProtected, "protected");
     INIT_STATIC_STRING(stringPublic, "public");
@@ -70,6 +72,7 @@ void StaticStrings::initStaticStrings()
     INIT_STATIC_STRING(stringTypeof, "typeof");
     INIT_STATIC_STRING(stringVoid, "void");
     INIT_STATIC_STRING(stringWhile, "while");
+    INIT_STATIC_STRING(stringXor, "xor");
 
     INIT_STATIC_STRING($Ampersand, "$&");
     INIT_STATIC_STRING($Apostrophe, "$'");
@@ -77,6 +80,8 @@ void StaticStrings::initStaticStrings()
     INIT_STATIC_STRING($PlusSign, "$+");
 
     INIT_STATIC_STRING(NegativeInfinity, "-Infinity");
+    INIT_STATIC_STRING(notEqual, "not-equal");
+    INIT_STATIC_STRING(timedOut, "timed-out");
     INIT_STATIC_STRING(defaultRegExpString, "(?:)");
     INIT_STATIC_STRING(getBaseName, "get baseName");
     INIT_STATIC_STRING(getBuffer, "get buffer");
@@ -42,6 +42,7 @@ namespace Escargot {
     F(AsyncFunction)              \
     F(AsyncGenerator)             \
     F(AsyncGeneratorFunction)     \
+    F(Atomics)                    \
     F(BYTES_PER_ELEMENT)          \
     F(BigInt)                     \
     F(BigInt64Array)              \
@@ -102,6 +103,7 @@ namespace Escargot {
     F(SQRT2)                      \
     F(Set)                        \
     F(SetIterator)                \
+    F(SharedArrayBuffer)          \
     F(String)                     \
     F(StringIterator)             \
     F(Symbol)                     \
@@ -171,6 +173,7 @@ namespace Escargot {
     F(codePointAt)                \
     F(collation)                  \
     F(compare)                    \
+    F(compareExchange)            \
     F(compile)                    \
     F(concat)                     \
     F(configurable)               \
@@ -199,6 +202,7 @@ namespace Escargot {
     F(escape)                     \
     F(eval)                       \
     F(every)                      \
+    F(exchange)                   \
     F(exec)                       \
     F(exp)                        \
     F(extends)                    \
@@ -286,6 +290,7 @@ namespace Escargot {
     F(isFinite)                   \
     F(isFrozen)                   \
     F(isInteger)                  \
+    F(isLockFree)                 \
     F(isNaN)                      \
     F(isPrototypeOf)              \
     F(isSafeInteger)              \
@@ -324,6 +329,7 @@ namespace Escargot {
     F(next)                       \
     F(nextMethod)                 \
     F(normalize)                  \
+    F(notify)                     \
     F(now)                        \
     F(null)                       \
     F(number)                     \
@@ -331,6 +337,7 @@ namespace Escargot {
     F(numeric)                    \
     F(object)                     \
     F(of)                         \
+    F(ok)                         \
     F(ownKeys)                    \
     F(package)                    \
     F(padEnd)                     \
@@ -415,6 +422,7 @@ namespace Escargot {
     F(stack)                      \
     F(startsWith)                 \
     F(sticky)                     \
+    F(store)                      \
     F(strike)                     \
     F(string)                     \
     F(stringify)                  \
@@ -465,6 +473,7 @@ namespace Escargot {
     F(valueOf)                    \
     F(values)                     \
     F(var)                        \
+    F(wait)                       \
     F(with)                       \
     F(writable)                   \
     F(yield)
@@ -763,6 +772,7 @@ public:
     }
 
     // keyword string
+    AtomicString stringAnd;
     AtomicString stringBreak;
     AtomicString stringCase;
     AtomicString stringCatch;
@@ -782,6 +792,7 @@ public:
     AtomicString stringIn;
     AtomicString stringMutable;
     AtomicString stringNew;
+    AtomicString stringOr;
     AtomicString stringPrivate;
     AtomicString stringProtected;
     AtomicString stringPublic;
@@ -798,6 +809,7 @@ public:
     AtomicString stringTypeof;
     AtomicString stringVoid;
     AtomicString stringWhile;
+    AtomicString stringXor;
 
     AtomicString $Ampersand;
     AtomicString $Apostrophe;
@@ -805,6 +817,8 @@ public:
     AtomicString $PlusSign;
 
     AtomicString NegativeInfinity;
+    AtomicString notEqual;
+    AtomicString timedOut;
     AtomicString defaultRegExpString;
     AtomicString getBaseName;
     AtomicString getBuffer;
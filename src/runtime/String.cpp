@@ -45,6 +45,7 @@
 
 #include "Escargot.h"
 #include "String.h"
+#include "StringSearch.h"
 #include "CompressibleString.h"
 #include "Value.h"
 
@@ -776,71 +777,12 @@ uint64_t String::tryToUseAsIndex() const
 
 size_t String::find(String* str, size_t pos)
 {
-    const size_t srcStrLen = str->length();
-    const size_t size = length();
-
-    if (srcStrLen == 0)
-        return pos <= size ? pos : SIZE_MAX;
-
-    if (srcStrLen <= size) {
-        char32_t src0 = str->charAt(0);
-        const auto& data = bufferAccessData();
-        if (data.has8BitContent) {
-            for (; pos <= size - srcStrLen; ++pos) {
-                if (((const LChar*)data.buffer)[pos] == src0) {
-                    bool same = true;
-                    for (size_t k = 1; k < srcStrLen; k++) {
-                        if (((const LChar*)data.buffer)[pos + k] != str->charAt(k)) {
-                            same = false;
-                            break;
-                        }
-                    }
-                    if (same)
-                        return pos;
-                }
-            }
-        } else {
-            for (; pos <= size - srcStrLen; ++pos) {
-                if (((const char16_t*)data.buffer)[pos] == src0) {
-                    bool same = true;
-                    for (size_t k = 1; k < srcStrLen; k++) {
-                        if (((const char16_t*)data.buffer)[pos + k] != str->charAt(k)) {
-                            same = false;
-                            break;
-                        }
-                    }
-                    if (same)
-                        return pos;
-                }
-            }
-        }
-    }
-    return SIZE_MAX;
+    return StringSearch::find(bufferAccessData(), str->bufferAccessData(), pos);
 }
 
 size_t String::rfind(String* str, size_t pos)
 {
-    const size_t srcStrLen = str->length();
-    const size_t size = length();
-    if (srcStrLen == 0)
-        return pos <= size ? pos : -1;
-    if (srcStrLen <= size) {
-        do {
-            bool same = true;
-            if (pos >= size) {
-                continue;
-            }
-            for (size_t k = 0; k < srcStrLen; k++) {
-                if (charAt(pos + k) != str->charAt(k)) {
-                    same = false;
-                    break;
-                }
-            }
-            if (same)
-                return pos;
-        } while (pos-- > 0);
-    }
-    return SIZE_MAX;
+    return StringSearch::findLast(bufferAccessData(), str->bufferAccessData(), pos);
 }
 
 String* String::substring(size_t from, size_t to)
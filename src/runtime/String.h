@@ -198,11 +198,21 @@ protected:
         m_tag = POINTER_VALUE_STRING_TAG_IN_DATA;
     }
 
+#if defined(ESCARGOT_32)
+    static constexpr size_t HashValueBits = 32;
+#else
+    // hash value is kept in the unused bits of StringBufferData on 64-bit
+    static constexpr size_t HashValueBits = 30;
+#endif
+
     struct StringBufferData {
         StringBufferData()
             : has8BitContent(true)
             , hasSpecialImpl(false)
             , length(0)
+#if !defined(ESCARGOT_32)
+            , hash(0)
+#endif
             , buffer(nullptr)
         {
         }
@@ -212,7 +222,9 @@ protected:
 #if defined(ESCARGOT_32)
         size_t length : 30;
 #else
-        size_t length : 62;
+        size_t length : 32;
+        // cache of String::hashValue (0 until it is computed)
+        size_t hash : HashValueBits;
 #endif
         union {
             const void* buffer;
@@ -222,6 +234,9 @@ protected:
         };
 
         COMPILE_ASSERT(STRING_MAXIMUM_LENGTH < (std::numeric_limits<size_t>::max() >> 2), "");
+#if !defined(ESCARGOT_32)
+        COMPILE_ASSERT(STRING_MAXIMUM_LENGTH <= std::numeric_limits<uint32_t>::max(), "");
+#endif
 
         operator StringBufferAccessData() const
         {
@@ -412,32 +427,60 @@ public:
 
     String* substring(size_t from, size_t to);
 
+    // 4 code units are widened to 16-bit lanes of a word and mixed at once, so 8-bit and 16-bit strings
+    // with same content have same hash. the result is finalized with fmix64 of MurmurHash3
     template <typename T>
-    static inline size_t stringHash(T* src, size_t length)
-    {
-        size_t hash = static_cast<size_t>(0xc70f6907UL);
-        for (; length; --length)
-            hash = (hash * 131) + *src++;
+    static inline uint64_t stringHash(const T* src, size_t length)
+    {
+        const uint64_t multiplier = 0x9e3779b97f4a7c15ULL;
+        uint64_t hash = 0xc70f6907ULL ^ length;
+        for (; length >= 4; length -= 4, src += 4) {
+            uint64_t block = static_cast<uint64_t>(src[0]) | (static_cast<uint64_t>(src[1]) << 16)
+                | (static_cast<uint64_t>(src[2]) << 32) | (static_cast<uint64_t>(src[3]) << 48);
+            hash = (((hash << 23) | (hash >> 41)) ^ block) * multiplier;
+        }
+        if (length) {
+            uint64_t block = 0;
+            for (size_t i = 0; i < length; i++) {
+                block |= static_cast<uint64_t>(src[i]) << (16 * i);
+            }
+            hash = (((hash << 23) | (hash >> 41)) ^ block) * multiplier;
+        }
+
+        hash ^= hash >> 33;
+        hash *= 0xff51afd7ed558ccdULL;
+        hash ^= hash >> 33;
+        hash *= 0xc4ceb9fe1a85ec53ULL;
+        hash ^= hash >> 33;
         return hash;
     }
 
-    size_t hashValue() const
+    // full width hash of the content which is not cached (e.g. for the key of code cache)
+    uint64_t computeHash() const
     {
         const auto& data = bufferAccessData();
-        size_t len = data.length;
-        size_t hash;
         if (LIKELY(data.has8BitContent)) {
-            auto ptr = (const LChar*)data.buffer;
-            hash = stringHash(ptr, len);
-        } else {
-            auto ptr = (const char16_t*)data.buffer;
-            hash = stringHash(ptr, len);
+            return stringHash((const LChar*)data.buffer, data.length);
         }
+        return stringHash((const char16_t*)data.buffer, data.length);
+    }
 
+    // hash for hash tables. it is computed once and cached in the string on 64-bit
+    size_t hashValue() const
+    {
+#if !defined(ESCARGOT_32)
+        if (LIKELY(m_bufferData.hash)) {
+            return m_bufferData.hash;
+        }
+#endif
+        size_t hash = static_cast<size_t>(computeHash() & ((1ULL << HashValueBits) - 1));
+        // never 0 so that 0 can be used as an empty mark
         if (UNLIKELY((hash % sizeof(size_t)) == 0)) {
             hash++;
         }
-
+#if !defined(ESCARGOT_32)
+        const_cast<String*>(this)->m_bufferData.hash = hash;
+#endif
         return hash;
     }
 
@@ -0,0 +1,221 @@
+/*
+ * Copyright (c) 2021-present Samsung Electronics Co., Ltd
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+ */
+
+#include "Escargot.h"
+#include "StringSearch.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
+namespace Escargot {
+
+template <typename CharType>
+static ALWAYS_INLINE bool equalsChars(const CharType* a, const CharType* b, size_t length)
+{
+    return memcmp(a, b, sizeof(CharType) * length) == 0;
+}
+
+template <typename CharType1, typename CharType2>
+static ALWAYS_INLINE bool equalsChars(const CharType1* a, const CharType2* b, size_t length)
+{
+    for (size_t i = 0; i < length; i++) {
+        if (a[i] != b[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// a needle which has a character out of Latin-1 never appears in 8-bit haystack
+static ALWAYS_INLINE bool canAppearIn8BitString(const LChar* needle, size_t needleLength)
+{
+    return true;
+}
+
+static ALWAYS_INLINE bool canAppearIn8BitString(const char16_t* needle, size_t needleLength)
+{
+    return isAllLatin1(needle, needleLength);
+}
+
+size_t StringSearch::findChar(const LChar* chars, size_t start, size_t length, char16_t ch)
+{
+    if (ch > 0xFF || start >= length) {
+        return SIZE_MAX;
+    }
+    const void* found = memchr(chars + start, ch, length - start);
+    return found ? (const LChar*)found - chars : SIZE_MAX;
+}
+
+size_t StringSearch::findChar(const char16_t* chars, size_t start, size_t length, char16_t ch)
+{
+    // skip blocks which do not have ch, then find the exact position in the remaining characters
+    size_t i = start;
+#if defined(__SSE2__)
+    const __m128i pattern = _mm_set1_epi16(static_cast<short>(ch));
+    for (; i + 8 <= length; i += 8) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(chars + i));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi16(block, pattern))) {
+            break;
+        }
+    }
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    const uint16x8_t pattern = vdupq_n_u16(ch);
+    for (; i + 8 <= length; i += 8) {
+        uint16x8_t equal = vceqq_u16(vld1q_u16(reinterpret_cast<const uint16_t*>(chars + i)), pattern);
+        if (vget_lane_u64(vreinterpret_u64_u8(vmovn_u16(equal)), 0)) {
+            break;
+        }
+    }
+#else
+    const uint64_t ones = 0x0001000100010001ULL;
+    const uint64_t pattern = ones * ch;
+    for (; i + 4 <= length; i += 4) {
+        uint64_t word;
+        memcpy(&word, chars + i, sizeof(uint64_t));
+        word ^= pattern;
+        // high bit of a lane is set if the lane is zero after xor
+        if ((word - ones) & ~word & (ones << 15)) {
+            break;
+        }
+    }
+#endif
+    for (; i < length; i++) {
+        if (chars[i] == ch) {
+            return i;
+        }
+    }
+    return SIZE_MAX;
+}
+
+template <typename HaystackCharType, typename NeedleCharType>
+size_t StringSearch::find(const HaystackCharType* haystack, size_t length, const NeedleCharType* needle, size_t needleLength, size_t start)
+{
+    ASSERT(needleLength && needleLength <= length - start);
+    if (sizeof(HaystackCharType) == 1 && !canAppearIn8BitString(needle, needleLength)) {
+        return SIZE_MAX;
+    }
+
+    if (needleLength >= HorspoolMinimumNeedleLength && length - start >= HorspoolMinimumHaystackLength) {
+        return findWithHorspool(haystack, length, needle, needleLength, start);
+    }
+
+    const size_t lastStart = length - needleLength;
+    const char16_t first = needle[0];
+    size_t pos = start;
+    while (true) {
+        pos = findChar(haystack, pos, lastStart + 1, first);
+        if (pos == SIZE_MAX) {
+            return SIZE_MAX;
+        }
+        if (equalsChars(haystack + pos + 1, needle + 1, needleLength - 1)) {
+            return pos;
+        }
+        pos++;
+    }
+}
+
+template <typename HaystackCharType, typename NeedleCharType>
+size_t StringSearch::findWithHorspool(const HaystackCharType* haystack, size_t length, const NeedleCharType* needle, size_t needleLength, size_t start)
+{
+    // shift for the character at the end of the window, indexed by its low byte.
+    // characters sharing a low byte get the smallest shift of them, which never skips a match
+    const size_t maximumShift = std::min(needleLength, static_cast<size_t>(std::numeric_limits<uint8_t>::max()));
+    uint8_t shifts[256];
+    memset(shifts, static_cast<int>(maximumShift), sizeof(shifts));
+    const size_t lastIndex = needleLength - 1;
+    for (size_t i = 0; i < lastIndex; i++) {
+        shifts[needle[i] & 0xFF] = static_cast<uint8_t>(std::min(lastIndex - i, maximumShift));
+    }
+
+    const NeedleCharType last = needle[lastIndex];
+    const size_t lastStart = length - needleLength;
+    size_t pos = start;
+    while (pos <= lastStart) {
+        const HaystackCharType c = haystack[pos + lastIndex];
+        if (c == last && equalsChars(haystack + pos, needle, lastIndex)) {
+            return pos;
+        }
+        pos += shifts[c & 0xFF];
+    }
+    return SIZE_MAX;
+}
+
+template <typename HaystackCharType, typename NeedleCharType>
+size_t StringSearch::findLast(const HaystackCharType* haystack, const NeedleCharType* needle, size_t needleLength, size_t start)
+{
+    if (sizeof(HaystackCharType) == 1 && !canAppearIn8BitString(needle, needleLength)) {
+        return SIZE_MAX;
+    }
+
+    const NeedleCharType first = needle[0];
+    size_t pos = start + 1;
+    while (pos-- > 0) {
+        if (haystack[pos] == first && equalsChars(haystack + pos + 1, needle + 1, needleLength - 1)) {
+            return pos;
+        }
+    }
+    return SIZE_MAX;
+}
+
+size_t StringSearch::find(const StringBufferAccessData& haystack, const StringBufferAccessData& needle, size_t start)
+{
+    if (needle.length == 0) {
+        return start <= haystack.length ? start : SIZE_MAX;
+    }
+    if (start > haystack.length || needle.length > haystack.length - start) {
+        return SIZE_MAX;
+    }
+
+    if (haystack.has8BitContent) {
+        if (needle.has8BitContent) {
+            return find((const LChar*)haystack.buffer, haystack.length, (const LChar*)needle.buffer, needle.length, start);
+        }
+        return find((const LChar*)haystack.buffer, haystack.length, needle.bufferAs16Bit, needle.length, start);
+    }
+    if (needle.has8BitContent) {
+        return find(haystack.bufferAs16Bit, haystack.length, (const LChar*)needle.buffer, needle.length, start);
+    }
+    return find(haystack.bufferAs16Bit, haystack.length, needle.bufferAs16Bit, needle.length, start);
+}
+
+size_t StringSearch::findLast(const StringBufferAccessData& haystack, const StringBufferAccessData& needle, size_t start)
+{
+    if (needle.length == 0) {
+        return start <= haystack.length ? start : SIZE_MAX;
+    }
+    if (needle.length > haystack.length) {
+        return SIZE_MAX;
+    }
+    start = std::min(start, haystack.length - needle.length);
+
+    if (haystack.has8BitContent) {
+        if (needle.has8BitContent) {
+            return findLast((const LChar*)haystack.buffer, (const LChar*)needle.buffer, needle.length, start);
+        }
+        return findLast((const LChar*)haystack.buffer, needle.bufferAs16Bit, needle.length, start);
+    }
+    if (needle.has8BitContent) {
+        return findLast(haystack.bufferAs16Bit, (const LChar*)needle.buffer, needle.length, start);
+    }
+    return findLast(haystack.bufferAs16Bit, needle.bufferAs16Bit, needle.length, start);
+}
+} // namespace Escargot
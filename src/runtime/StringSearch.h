@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2021-present Samsung Electronics Co., Ltd
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+ */
+
+#ifndef __EscargotStringSearch__
+#define __EscargotStringSearch__
+
+#include "runtime/String.h"
+
+namespace Escargot {
+
+// substring search on string buffers
+// haystack and needle can be 8-bit or 16-bit in any combination, and every position is in code units.
+// characters are found with memchr or SSE2/NEON compares, and long needles in long haystacks use Boyer-Moore-Horspool
+class StringSearch {
+public:
+    // returns the first position of needle which is not less than start or SIZE_MAX
+    static size_t find(const StringBufferAccessData& haystack, const StringBufferAccessData& needle, size_t start);
+    // returns the last position of needle which is not greater than start or SIZE_MAX
+    static size_t findLast(const StringBufferAccessData& haystack, const StringBufferAccessData& needle, size_t start);
+
+    // returns the first position of ch in [start, length) or SIZE_MAX
+    static size_t findChar(const LChar* chars, size_t start, size_t length, char16_t ch);
+    static size_t findChar(const char16_t* chars, size_t start, size_t length, char16_t ch);
+
+private:
+    // Boyer-Moore-Horspool is used when needle and haystack are at least this long
+    // (building its skip table costs more than scanning short haystacks)
+    static constexpr size_t HorspoolMinimumNeedleLength = 8;
+    static constexpr size_t HorspoolMinimumHaystackLength = 512;
+
+    template <typename HaystackCharType, typename NeedleCharType>
+    static size_t find(const HaystackCharType* haystack, size_t length, const NeedleCharType* needle, size_t needleLength, size_t start);
+    template <typename HaystackCharType, typename NeedleCharType>
+    static size_t findWithHorspool(const HaystackCharType* haystack, size_t length, const NeedleCharType* needle, size_t needleLength, size_t start);
+    template <typename HaystackCharType, typename NeedleCharType>
+    static size_t findLast(const HaystackCharType* haystack, const NeedleCharType* needle, size_t needleLength, size_t start);
+};
+} // namespace Escargot
+
+#endif
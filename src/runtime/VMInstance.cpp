@@ -28,7 +28,9 @@
 #include "runtime/CompressibleString.h"
 #include "runtime/ReloadableString.h"
 #include "runtime/Intl.h"
+#include "runtime/ContextSnapshot.h"
 #include "interpreter/ByteCode.h"
+#include "interpreter/ByteCodeOptimizer.h"
 #include "parser/ASTAllocator.h"
 #if defined(ENABLE_CODE_CACHE)
 #include "codecache/CodeCache.h"
@@ -44,22 +46,132 @@ namespace Escargot {
 /////////////////////////////////////////////////
 // VMInstance Global Data
 /////////////////////////////////////////////////
-std::mt19937 VMInstance::g_randEngine((unsigned int)time(NULL));
-bf_context_t VMInstance::g_bfContext;
+ESCARGOT_THREAD_LOCAL std::mt19937 VMInstance::g_randEngine((unsigned int)time(NULL));
+ESCARGOT_THREAD_LOCAL bf_context_t VMInstance::g_bfContext;
 #if defined(ENABLE_WASM)
 #ifndef ESCARGOT_WASM_GC_CHECK_INTERVAL
 #define ESCARGOT_WASM_GC_CHECK_INTERVAL 5000
 #endif
-WASMContext VMInstance::g_wasmContext;
+ESCARGOT_THREAD_LOCAL WASMContext* VMInstance::g_wasmContext;
+
+WASMContext::WASMContext()
+    : engine(wasm_engine_new())
+    , store(wasm_store_new(engine))
+    , lastGCCheckTime(0)
+    , refCount(1)
+#if defined(ENABLE_THREADING)
+    , isOwnerThreadFinished(false)
 #endif
-ASTAllocator* VMInstance::g_astAllocator;
-WTF::BumpPointerAllocator* VMInstance::g_bumpPointerAllocator;
+{
+}
+
+void WASMContext::deref()
+{
+    if (refCount.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        wasm_store_delete(store);
+        wasm_engine_delete(engine);
+        delete this;
+    }
+}
+
+void WASMContext::deleteObject(Deleter deleter, void* ptr)
+{
+#if defined(ENABLE_THREADING)
+    if (VMInstance::g_wasmContext != this) {
+        std::unique_lock<std::mutex> lock(pendingDeletionsMutex);
+        if (!isOwnerThreadFinished) {
+            pendingDeletions.push_back(std::make_pair(deleter, ptr));
+            return;
+        }
+        // finalizers of other threads can run at the same time
+        deleter(ptr);
+        lock.unlock();
+        deref();
+        return;
+    }
+#endif
+    deleter(ptr);
+    deref();
+}
+
+void WASMContext::runPendingDeletions()
+{
+#if defined(ENABLE_THREADING)
+    ASSERT(VMInstance::g_wasmContext == this);
+    std::vector<std::pair<Deleter, void*>> deletions;
+    {
+        std::lock_guard<std::mutex> guard(pendingDeletionsMutex);
+        deletions.swap(pendingDeletions);
+    }
+    // the owner thread holds a reference, so the store is not deleted here
+    for (size_t i = 0; i < deletions.size(); i++) {
+        deletions[i].first(deletions[i].second);
+        deref();
+    }
+#endif
+}
+
+void WASMContext::finishOwnerThread()
+{
+#if defined(ENABLE_THREADING)
+    ASSERT(VMInstance::g_wasmContext == this);
+    // other threads delete wasm objects by themselves after this point
+    // so pending deletions are done under the lock not to race with them
+    std::lock_guard<std::mutex> guard(pendingDeletionsMutex);
+    for (size_t i = 0; i < pendingDeletions.size(); i++) {
+        pendingDeletions[i].first(pendingDeletions[i].second);
+        deref();
+    }
+    pendingDeletions.clear();
+    isOwnerThreadFinished = true;
+#endif
+}
+#endif
+ESCARGOT_THREAD_LOCAL ASTAllocator* VMInstance::g_astAllocator;
+ESCARGOT_THREAD_LOCAL WTF::BumpPointerAllocator* VMInstance::g_bumpPointerAllocator;
 
 void VMInstance::initialize()
+{
+    // String::emptyString is shared by every VMInstance and never modified
+    if (!String::emptyString) {
+        String::emptyString = new (NoGC) ASCIIString("");
+    }
+
+    // initialize PointerValue tag values
+    // tag values should be initialized once and not changed
+    PointerValue::g_objectTag = Object().getTag();
+    PointerValue::g_arrayObjectTag = ArrayObject().getTag();
+    PointerValue::g_arrayPrototypeObjectTag = ArrayPrototypeObject().getTag();
+    PointerValue::g_objectRareDataTag = ObjectRareData(nullptr).getTag();
+    PointerValue::g_doubleInEncodedValueTag = DoubleInEncodedValue(0).getTag();
+
+    initializeThread();
+}
+
+void VMInstance::finalize()
+{
+    // this function should be invoked after full gc (Heap::finalize)
+    // because some registered gc-finalizers could use these global values
+
+    finalizeThread();
+
+    // reset PointerValue tag values
+    PointerValue::g_arrayObjectTag = 0;
+    PointerValue::g_arrayPrototypeObjectTag = 0;
+    PointerValue::g_objectRareDataTag = 0;
+    PointerValue::g_doubleInEncodedValueTag = 0;
+}
+
+void VMInstance::initializeThread()
 {
     // g_randEngine already initialized
+#if defined(ENABLE_THREADING)
+    // threads started at the same time should not share the random sequence
+    g_randEngine.seed((unsigned int)time(NULL) ^ (unsigned int)std::hash<std::thread::id>()(std::this_thread::get_id()));
+#endif
 
     // g_bfContext
+    // limbs are allocated with libc realloc, BigInt finalizer depends on this
     bf_context_init(&g_bfContext, [](void* opaque, void* ptr, size_t size) -> void* {
         return realloc(ptr, size);
     },
@@ -67,9 +179,7 @@ void VMInstance::initialize()
 
 #if defined(ENABLE_WASM)
     // g_wasmContext
-    g_wasmContext.engine = wasm_engine_new();
-    g_wasmContext.store = wasm_store_new(g_wasmContext.engine);
-    g_wasmContext.lastGCCheckTime = 0;
+    g_wasmContext = new WASMContext();
 #endif
 
     // g_astAllocator
@@ -77,20 +187,10 @@ void VMInstance::initialize()
 
     // g_bumpPointerAllocator
     g_bumpPointerAllocator = new WTF::BumpPointerAllocator();
-
-    // initialize PointerValue tag values
-    // tag values should be initialized once and not changed
-    PointerValue::g_arrayObjectTag = ArrayObject().getTag();
-    PointerValue::g_arrayPrototypeObjectTag = ArrayPrototypeObject().getTag();
-    PointerValue::g_objectRareDataTag = ObjectRareData(nullptr).getTag();
-    PointerValue::g_doubleInEncodedValueTag = DoubleInEncodedValue(0).getTag();
 }
 
-void VMInstance::finalize()
+void VMInstance::finalizeThread()
 {
-    // this function should be invoked after full gc (Heap::finalize)
-    // because some registered gc-finalizers could use these global values
-
     // g_randEngine does not need finalization
 
     // g_bfContext
@@ -98,11 +198,10 @@ void VMInstance::finalize()
 
 #if defined(ENABLE_WASM)
     // g_wasmContext
-    wasm_store_delete(g_wasmContext.store);
-    wasm_engine_delete(g_wasmContext.engine);
-    g_wasmContext.store = nullptr;
-    g_wasmContext.engine = nullptr;
-    g_wasmContext.lastGCCheckTime = 0;
+    // wasm objects still alive keep the store until they are finalized
+    g_wasmContext->finishOwnerThread();
+    g_wasmContext->deref();
+    g_wasmContext = nullptr;
 #endif
 
     // g_astAllocator
@@ -112,12 +211,6 @@ void VMInstance::finalize()
     // g_bumpPointerAllocator
     delete g_bumpPointerAllocator;
     g_bumpPointerAllocator = nullptr;
-
-    // reset PointerValue tag values
-    PointerValue::g_arrayObjectTag = 0;
-    PointerValue::g_arrayPrototypeObjectTag = 0;
-    PointerValue::g_objectRareDataTag = 0;
-    PointerValue::g_doubleInEncodedValueTag = 0;
 }
 /////////////////////////////////////////////////
 
@@ -216,55 +309,72 @@ void VMInstance::gcEventCallback(GC_EventType t, void* data)
 {
     VMInstance* self = (VMInstance*)data;
 
+#if defined(ENABLE_THREADING)
+    // gc is process-wide, so callbacks of every VMInstance are called on the thread which triggered gc
+    // caches and ByteCodeBlocks of other threads are used without lock, so leave them to their own thread
+    if (self->m_ownerThreadID != std::this_thread::get_id()) {
+        return;
+    }
+#endif
+
 #ifdef ESCARGOT_DEBUGGER
     const bool debuggerEnabled = self->m_debuggerEnabled;
 #else /* !ESCARGOT_DEBUGGER */
     const bool debuggerEnabled = false;
 #endif /* ESCARGOT_DEBUGGER */
 
-    if (t == GC_EventType::GC_EVENT_MARK_START && LIKELY(!debuggerEnabled)) {
-        if (self->m_regexpCache->size() > REGEXP_CACHE_SIZE_MAX || UNLIKELY(self->m_inEnterIdleMode)) {
-            self->m_regexpCache->clear();
-        }
-
-        auto& currentCodeSizeTotal = self->compiledByteCodeSize();
-        if (currentCodeSizeTotal > SCRIPT_FUNCTION_OBJECT_BYTECODE_SIZE_MAX || UNLIKELY(self->m_inEnterIdleMode)) {
-            currentCodeSizeTotal = std::numeric_limits<size_t>::max();
-            auto& v = self->compiledByteCodeBlocks();
-            for (size_t i = 0; i < v.size(); i++) {
-                auto cb = v[i]->m_codeBlock;
-                if (LIKELY(!cb->isAsync() && !cb->isGenerator())) {
-                    v[i]->m_codeBlock->m_byteCodeBlock = nullptr;
-                }
-            }
+    // MARK_START is reported by each stop-the-world marking step
+    // in incremental mode, the last step of a collection reports it after objects could be marked already,
+    // but the step which starts the collection reports it before marking, so release caches only on the first one
+    // (GC number increases once per collection, after its last marking step)
+    if (t == GC_EventType::GC_EVENT_MARK_START) {
+        size_t gcNumber = GC_get_gc_no();
+        if (self->m_cachesReleasedGCNumber != gcNumber) {
+            self->m_cachesReleasedGCNumber = gcNumber;
+            self->releaseCachesBeforeMarking(debuggerEnabled);
         }
     } else if (t == GC_EventType::GC_EVENT_RECLAIM_END) {
 #if defined(ENABLE_COMPRESSIBLE_STRING) || defined(ENABLE_WASM)
         auto currentTick = fastTickCount();
 #if defined(ENABLE_COMPRESSIBLE_STRING)
         if (currentTick - self->m_lastCompressibleStringsTestTime > ESCARGOT_COMPRESSIBLE_COMPRESS_GC_CHECK_INTERVAL) {
-            self->compressStringsIfNeeds(currentTick);
-            self->m_lastCompressibleStringsTestTime = currentTick;
+            RegistryLocker locker(self, RegistryLocker::TryLock);
+            if (locker.isLocked()) {
+                self->compressStringsIfNeeds(currentTick);
+                self->m_lastCompressibleStringsTestTime = currentTick;
+            }
         }
 #endif
 #if defined(ENABLE_WASM)
-        if (currentTick - g_wasmContext.lastGCCheckTime > ESCARGOT_WASM_GC_CHECK_INTERVAL) {
-            wasm_store_gc(g_wasmContext.store);
-            g_wasmContext.lastGCCheckTime = currentTick;
+        if (g_wasmContext) {
+            // wasm objects finalized on other threads
+            g_wasmContext->runPendingDeletions();
+        }
+        if (g_wasmContext && currentTick - g_wasmContext->lastGCCheckTime > ESCARGOT_WASM_GC_CHECK_INTERVAL) {
+            wasm_store_gc(g_wasmContext->store);
+            g_wasmContext->lastGCCheckTime = currentTick;
         }
 #endif
 #endif
-        auto& currentCodeSizeTotal = self->compiledByteCodeSize();
-
-        if (currentCodeSizeTotal == std::numeric_limits<size_t>::max()) {
+        if (self->m_didFlushByteCodeBlocks) {
+            // finalizers take the registry lock by themselves
             GC_invoke_finalizers();
 
             // we need to check this because ~VMInstance can be called by GC_invoke_finalizers
-            if (!self->m_isFinalized) {
+            RegistryLocker locker(self, RegistryLocker::TryLock);
+            if (!self->m_isFinalized && locker.isLocked()) {
+                self->m_didFlushByteCodeBlocks = false;
+                auto& currentCodeSizeTotal = self->compiledByteCodeSize();
                 currentCodeSizeTotal = 0;
                 auto& v = self->compiledByteCodeBlocks();
                 for (size_t i = 0; i < v.size(); i++) {
-                    v[i]->m_codeBlock->m_byteCodeBlock = v[i];
+                    // flushed ByteCodeBlock which is still in use survives GC
+                    // (in incremental mode, the function could be compiled again while the collection is in progress)
+                    InterpretedCodeBlock* codeBlock = v[i]->m_codeBlock;
+                    if (!codeBlock->m_byteCodeBlock) {
+                        codeBlock->m_byteCodeBlock = v[i];
+                        codeBlock->m_isByteCodeBlockFlushed = false;
+                    }
                     currentCodeSizeTotal += v[i]->memoryAllocatedSize();
                 }
             }
@@ -279,6 +389,84 @@ void VMInstance::gcEventCallback(GC_EventType t, void* data)
     */
 }
 
+void VMInstance::releaseCachesBeforeMarking(bool debuggerEnabled)
+{
+    // structures in megamorphic inline cache can be reclaimed by the coming marking
+    m_megamorphicInlineCache->clear();
+
+    if (UNLIKELY(debuggerEnabled)) {
+        return;
+    }
+
+    if (m_regexpCache->size() > REGEXP_CACHE_SIZE_MAX || UNLIKELY(m_inEnterIdleMode)) {
+        m_regexpCache->clear();
+    }
+
+    RegistryLocker locker(this, RegistryLocker::TryLock);
+    if (locker.isLocked()) {
+        // record which ByteCodeBlocks are executed in the last GC cycle
+        size_t epoch = ++m_compiledByteCodeEpoch;
+        auto& v = compiledByteCodeBlocks();
+        for (size_t i = 0; i < v.size(); i++) {
+            if (v[i]->m_isExecutedSinceLastGC) {
+                v[i]->m_isExecutedSinceLastGC = false;
+                v[i]->m_lastExecutedEpoch = epoch;
+            }
+        }
+
+        // detached ByteCodeBlocks are attached again on RECLAIM_END if they survive
+        // compiledByteCodeSize keeps counting until then, because the mutator can run between incremental slices
+        if (compiledByteCodeSize() > m_maxCompiledByteCodeSize || UNLIKELY(m_inEnterIdleMode)) {
+            if (flushByteCodeBlocks(m_inEnterIdleMode)) {
+                m_didFlushByteCodeBlocks = true;
+            }
+        }
+    }
+}
+
+bool VMInstance::flushByteCodeBlocks(bool flushAll)
+{
+    auto& v = compiledByteCodeBlocks();
+    std::vector<ByteCodeBlock*> candidates;
+    candidates.reserve(v.size());
+    for (size_t i = 0; i < v.size(); i++) {
+        auto cb = v[i]->m_codeBlock;
+        if (UNLIKELY(cb->isAsync() || cb->isGenerator())) {
+            continue;
+        }
+        if (flushAll || m_compiledByteCodeEpoch - v[i]->m_lastExecutedEpoch >= SCRIPT_FUNCTION_OBJECT_BYTECODE_COLD_AGE) {
+            candidates.push_back(v[i]);
+        }
+    }
+
+    // flush the least recently executed block first
+    // bigger block first among blocks executed in the same epoch
+    std::sort(candidates.begin(), candidates.end(), [](ByteCodeBlock* a, ByteCodeBlock* b) -> bool {
+        if (a->m_lastExecutedEpoch != b->m_lastExecutedEpoch) {
+            return a->m_lastExecutedEpoch < b->m_lastExecutedEpoch;
+        }
+        return a->memoryAllocatedSize() > b->memoryAllocatedSize();
+    });
+
+    size_t remainSize = m_compiledByteCodeSize;
+    size_t flushedCount = 0;
+    for (size_t i = 0; i < candidates.size(); i++) {
+        if (!flushAll && remainSize <= m_maxCompiledByteCodeSize) {
+            break;
+        }
+        InterpretedCodeBlock* cb = candidates[i]->m_codeBlock;
+        if (cb->m_byteCodeBlock == candidates[i]) {
+            cb->m_byteCodeBlock = nullptr;
+            cb->m_isByteCodeBlockFlushed = true;
+            flushedCount++;
+            remainSize -= std::min(remainSize, candidates[i]->memoryAllocatedSize());
+        }
+    }
+
+    m_flushedByteCodeBlockCount += flushedCount;
+    return flushedCount > 0;
+}
+
 void* VMInstance::operator new(size_t size)
 {
     static bool typeInited = false;
@@ -311,10 +499,12 @@ void* VMInstance::operator new(size_t size)
         GC_set_bit(desc, GC_WORD_OFFSET(VMInstance, m_defaultStructureForRegExpObject));
         GC_set_bit(desc, GC_WORD_OFFSET(VMInstance, m_defaultStructureForMappedArgumentsObject));
         GC_set_bit(desc, GC_WORD_OFFSET(VMInstance, m_defaultStructureForUnmappedArgumentsObject));
+        GC_set_bit(desc, GC_WORD_OFFSET(VMInstance, m_contextSnapshot));
         GC_set_bit(desc, GC_WORD_OFFSET(VMInstance, m_onVMInstanceDestroyData));
         GC_set_bit(desc, GC_WORD_OFFSET(VMInstance, m_toStringRecursionPreventer.m_registeredItems));
         GC_set_bit(desc, GC_WORD_OFFSET(VMInstance, m_regexpCache));
         GC_set_bit(desc, GC_WORD_OFFSET(VMInstance, m_regexpOptionStringCache));
+        GC_set_bit(desc, GC_WORD_OFFSET(VMInstance, m_megamorphicInlineCache));
         GC_set_bit(desc, GC_WORD_OFFSET(VMInstance, m_cachedUTC));
         GC_set_bit(desc, GC_WORD_OFFSET(VMInstance, m_platform));
         GC_set_bit(desc, GC_WORD_OFFSET(VMInstance, m_jobQueue));
@@ -334,6 +524,7 @@ void* VMInstance::operator new(size_t size)
 VMInstance::~VMInstance()
 {
     {
+        RegistryLocker locker(this);
         auto& v = compiledByteCodeBlocks();
         for (size_t i = 0; i < v.size(); i++) {
             v[i]->m_isOwnerMayFreed = true;
@@ -341,6 +532,7 @@ VMInstance::~VMInstance()
     }
 #if defined(ENABLE_COMPRESSIBLE_STRING)
     {
+        RegistryLocker locker(this);
         auto& v = compressibleStrings();
         for (size_t i = 0; i < v.size(); i++) {
             v[i]->m_isOwnerMayFreed = true;
@@ -349,6 +541,7 @@ VMInstance::~VMInstance()
 #endif
 #if defined(ENABLE_RELOADABLE_STRING)
     {
+        RegistryLocker locker(this);
         auto& v = reloadableStrings();
         for (size_t i = 0; i < v.size(); i++) {
             v[i]->m_isOwnerMayFreed = true;
@@ -365,6 +558,14 @@ VMInstance::~VMInstance()
     vzone_close(m_timezone);
 #endif
 
+#ifndef NDEBUG
+    char* dumpOptimizerStatistics = getenv("DUMP_BYTECODE_OPTIMIZER_STATISTICS");
+    if (dumpOptimizerStatistics && (strcmp(dumpOptimizerStatistics, "1") == 0)) {
+        m_byteCodeOptimizerStatistics->dump();
+    }
+#endif
+    delete m_byteCodeOptimizerStatistics;
+
 #if defined(ENABLE_CODE_CACHE)
     delete m_codeCache;
 #endif
@@ -373,13 +574,26 @@ VMInstance::~VMInstance()
 VMInstance::VMInstance(Platform* platform, const char* locale, const char* timezone, const char* baseCacheDir)
     : m_staticStrings(&m_atomicStringMap)
     , m_currentSandBox(nullptr)
+#if defined(ENABLE_THREADING)
+    , m_ownerThreadID(std::this_thread::get_id())
+#endif
     , m_isFinalized(false)
     , m_inEnterIdleMode(false)
+    , m_cachesReleasedGCNumber(SIZE_MAX)
+    , m_didFlushByteCodeBlocks(false)
     , m_didSomePrototypeObjectDefineIndexedProperty(false)
 #ifdef ESCARGOT_DEBUGGER
     , m_debuggerEnabled(false)
 #endif /* ESCARGOT_DEBUGGER */
+    , m_contextSnapshot(nullptr)
+    , m_isContextSnapshotEnabled(true)
     , m_compiledByteCodeSize(0)
+    , m_maxCompiledByteCodeSize(SCRIPT_FUNCTION_OBJECT_BYTECODE_SIZE_MAX)
+    , m_compiledByteCodeEpoch(0)
+    , m_flushedByteCodeBlockCount(0)
+    , m_regeneratedByteCodeBlockCount(0)
+    , m_codeCacheLoadedByteCodeBlockCount(0)
+    , m_enabledByteCodeOptimizationPasses(BYTECODE_OPTIMIZATION_ALL_PASSES)
 #if defined(ENABLE_COMPRESSIBLE_STRING)
     , m_lastCompressibleStringsTestTime(0)
     , m_compressibleStringsUncomressedBufferSize(0)
@@ -408,15 +622,16 @@ VMInstance::VMInstance(Platform* platform, const char* locale, const char* timez
     // test stack base property aligned
     RELEASE_ASSERT(((size_t)m_stackStartAddress) % sizeof(size_t) == 0);
 
-    if (!String::emptyString) {
-        String::emptyString = new (NoGC) ASCIIString("");
-    }
+    ASSERT(!!String::emptyString);
     m_staticStrings.initStaticStrings();
 
     m_regexpCache = new (GC) RegExpCacheMap();
     m_regexpOptionStringCache = (ASCIIString**)GC_MALLOC(64 * sizeof(ASCIIString*));
     memset(m_regexpOptionStringCache, 0, 64 * sizeof(ASCIIString*));
 
+    m_megamorphicInlineCache = new MegamorphicInlineCache();
+    m_byteCodeOptimizerStatistics = new ByteCodeOptimizerStatistics();
+
 #ifdef ENABLE_ICU
     m_timezone = nullptr;
     if (timezone) {
@@ -569,9 +784,24 @@ DateObject* VMInstance::cachedUTC(ExecutionState& state)
     return m_cachedUTC;
 }
 
+void VMInstance::ensureContextSnapshot(ExecutionState& state, GlobalObject* globalObject)
+{
+    if (!m_isContextSnapshotEnabled || m_contextSnapshot) {
+        return;
+    }
+
+    m_contextSnapshot = ContextSnapshot::create(state, globalObject);
+    if (!m_contextSnapshot) {
+        // builtins has some object which cannot be copied
+        // every Context installs its own builtins from now on
+        m_isContextSnapshotEnabled = false;
+    }
+}
+
 void VMInstance::clearCachesRelatedWithContext()
 {
     m_regexpCache->clear();
+    m_megamorphicInlineCache->clear();
     globalSymbolRegistry().clear();
 #if defined(ENABLE_CODE_CACHE)
     // CodeCache should be cleared here because CodeCache holds a lock of cache directory
@@ -587,11 +817,20 @@ void VMInstance::enterIdleMode()
 
     // user can call this function many times without many performance concern
     if (GC_get_bytes_since_gc() > 4096) {
-        GC_gcollect_and_unmap();
-        GC_gcollect_and_unmap();
-        GC_gcollect_and_unmap();
+        // bdwgc sweeps lazily, so garbage found by a collection is reclaimed and unmapped by the next one
+        // collect again only while it returns memory to the system (at most three times)
+        size_t heapSize = GC_get_heap_size();
+        for (size_t i = 0; i < 3; i++) {
+            GC_gcollect_and_unmap();
+            size_t newHeapSize = GC_get_heap_size();
+            if (i && newHeapSize >= heapSize) {
+                break;
+            }
+            heapSize = newHeapSize;
+        }
     }
 
+    RegistryLocker locker(this);
 #if defined(ENABLE_COMPRESSIBLE_STRING)
     // ESCARGOT_LOG_INFO("compressibleStringsUncomressedBufferSize before %lfKB\n", m_compressibleStringsUncomressedBufferSize/1024.f);
     auto& currentAllocatedCompressibleStrings = compressibleStrings();
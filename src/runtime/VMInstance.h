@@ -24,14 +24,44 @@
 #include "runtime/AtomicString.h"
 #include "runtime/StaticStrings.h"
 #include "runtime/ToStringRecursionPreventer.h"
+#include "runtime/MegamorphicInlineCache.h"
 
 #if defined(ENABLE_WASM)
 struct wasm_engine_t;
 struct wasm_store_t;
+// wasm engine and store of a thread
+// the creating thread and each wasm object allocated in the store hold a reference,
+// because wasm objects can be finalized on another thread after the creating thread finished
 struct WASMContext {
+    typedef void (*Deleter)(void* ptr);
+
+    WASMContext();
+    void ref()
+    {
+        refCount.fetch_add(1, std::memory_order_relaxed);
+    }
+    // deletes the store and engine when the last reference is released
+    void deref();
+
+    // delete a wasm object of this store and release its reference
+    // the store is not thread-safe, so deletion requested on another thread is queued
+    // and done by the owner thread on its next gc or when it finishes
+    void deleteObject(Deleter deleter, void* ptr);
+    // called on the owner thread
+    void runPendingDeletions();
+    // called by the owner thread before it releases its reference
+    void finishOwnerThread();
+
     wasm_engine_t* engine;
     wasm_store_t* store;
     uint64_t lastGCCheckTime;
+    std::atomic<size_t> refCount;
+#if defined(ENABLE_THREADING)
+    std::mutex pendingDeletionsMutex;
+    std::vector<std::pair<Deleter, void*>> pendingDeletions;
+    // after the owner thread finished, deletion is done on the finalizing thread under pendingDeletionsMutex
+    bool isOwnerThreadFinished;
+#endif
 };
 #endif
 
@@ -47,6 +77,9 @@ class CodeBlock;
 class JobQueue;
 class Job;
 class ASTAllocator;
+class GlobalObject;
+class ContextSnapshot;
+struct ByteCodeOptimizerStatistics;
 class Symbol;
 class String;
 #if defined(ENABLE_COMPRESSIBLE_STRING)
@@ -90,20 +123,24 @@ typedef Vector<GlobalSymbolRegistryItem, GCUtil::gc_malloc_allocator<GlobalSymbo
 class VMInstance : public gc {
     friend class Context;
     friend class VMInstanceRef;
+#if defined(ENABLE_WASM)
+    friend struct WASMContext;
+#endif
     friend class ScriptParser;
     friend class SandBox;
 
     /////////////////////////////////
     // Global Data
     // global values which should be initialized once and shared during the runtime
-    static std::mt19937 g_randEngine;
-    static bf_context_t g_bfContext;
+    // they are kept per thread when threading is enabled (see initializeThread)
+    static ESCARGOT_THREAD_LOCAL std::mt19937 g_randEngine;
+    static ESCARGOT_THREAD_LOCAL bf_context_t g_bfContext;
 #if defined(ENABLE_WASM)
-    static WASMContext g_wasmContext;
+    static ESCARGOT_THREAD_LOCAL WASMContext* g_wasmContext;
 #endif
 
-    static ASTAllocator* g_astAllocator;
-    static WTF::BumpPointerAllocator* g_bumpPointerAllocator;
+    static ESCARGOT_THREAD_LOCAL ASTAllocator* g_astAllocator;
+    static ESCARGOT_THREAD_LOCAL WTF::BumpPointerAllocator* g_bumpPointerAllocator;
     /////////////////////////////////
 
 public:
@@ -111,6 +148,10 @@ public:
     // Global Data Static Function
     static void initialize();
     static void finalize();
+    // initialize or finalize global data of the current thread
+    // initialize and finalize do this for the thread which calls them
+    static void initializeThread();
+    static void finalizeThread();
     static std::mt19937& randEngine()
     {
         return g_randEngine;
@@ -121,10 +162,14 @@ public:
         return &g_bfContext;
     }
 #if defined(ENABLE_WASM)
+    static WASMContext* wasmContext()
+    {
+        ASSERT(!!g_wasmContext);
+        return g_wasmContext;
+    }
     static wasm_store_t* wasmStore()
     {
-        ASSERT(!!g_wasmContext.store);
-        return g_wasmContext.store;
+        return wasmContext()->store;
     }
 #endif
     static ASTAllocator* astAllocator()
@@ -181,6 +226,28 @@ public:
 #endif
     DateObject* cachedUTC(ExecutionState& state);
 
+    // builtins of the first Context are recorded here and copied into every later Context
+    // returns nullptr if there is no snapshot yet or it is disabled
+    ContextSnapshot* contextSnapshot()
+    {
+        return m_isContextSnapshotEnabled ? m_contextSnapshot : nullptr;
+    }
+
+    void ensureContextSnapshot(ExecutionState& state, GlobalObject* globalObject);
+
+    bool isContextSnapshotEnabled()
+    {
+        return m_isContextSnapshotEnabled;
+    }
+
+    void setContextSnapshotEnabled(bool enabled)
+    {
+        m_isContextSnapshotEnabled = enabled;
+        if (!enabled) {
+            m_contextSnapshot = nullptr;
+        }
+    }
+
     // object
     // []
 
@@ -220,6 +287,42 @@ public:
     bool hasPendingJob();
     SandBox::SandBoxResult executePendingJob();
 
+    // registries below (compiledByteCodeBlocks, compressibleStrings, reloadableStrings) are modified by gc finalizers
+    // finalizers can run on any thread which triggers gc, so access them while holding this lock
+    class RegistryLocker {
+    public:
+        enum TryLockTag { TryLock };
+
+        explicit RegistryLocker(VMInstance* instance)
+#if defined(ENABLE_THREADING)
+            : m_lock(instance->m_registryMutex)
+#endif
+        {
+        }
+
+        // gc callback should not wait for the lock because a thread stopped by gc can hold it
+        RegistryLocker(VMInstance* instance, TryLockTag)
+#if defined(ENABLE_THREADING)
+            : m_lock(instance->m_registryMutex, std::try_to_lock)
+#endif
+        {
+        }
+
+        bool isLocked() const
+        {
+#if defined(ENABLE_THREADING)
+            return m_lock.owns_lock();
+#else
+            return true;
+#endif
+        }
+
+    private:
+#if defined(ENABLE_THREADING)
+        std::unique_lock<std::recursive_mutex> m_lock;
+#endif
+    };
+
     std::vector<ByteCodeBlock*>& compiledByteCodeBlocks()
     {
         return m_compiledByteCodeBlocks;
@@ -230,6 +333,54 @@ public:
         return m_compiledByteCodeSize;
     }
 
+    // compiled bytecode more than this size is flushed from cold ByteCodeBlocks on GC
+    size_t maxCompiledByteCodeSize()
+    {
+        return m_maxCompiledByteCodeSize;
+    }
+
+    void setMaxCompiledByteCodeSize(size_t size)
+    {
+        m_maxCompiledByteCodeSize = size;
+    }
+
+    // increased on every GC
+    size_t compiledByteCodeEpoch()
+    {
+        return m_compiledByteCodeEpoch;
+    }
+
+    size_t& flushedByteCodeBlockCount()
+    {
+        return m_flushedByteCodeBlockCount;
+    }
+
+    size_t& regeneratedByteCodeBlockCount()
+    {
+        return m_regeneratedByteCodeBlockCount;
+    }
+
+    size_t& codeCacheLoadedByteCodeBlockCount()
+    {
+        return m_codeCacheLoadedByteCodeBlockCount;
+    }
+
+    ByteCodeOptimizerStatistics& byteCodeOptimizerStatistics()
+    {
+        return *m_byteCodeOptimizerStatistics;
+    }
+
+    // bit (1 << ByteCodeOptimizationPassKind) of each pass applied to newly generated ByteCode
+    uint32_t enabledByteCodeOptimizationPasses()
+    {
+        return m_enabledByteCodeOptimizationPasses;
+    }
+
+    void setEnabledByteCodeOptimizationPasses(uint32_t passes)
+    {
+        m_enabledByteCodeOptimizationPasses = passes;
+    }
+
 #if defined(ENABLE_COMPRESSIBLE_STRING)
     std::vector<CompressibleString*>& compressibleStrings()
     {
@@ -269,6 +420,11 @@ public:
         return m_regexpOptionStringCache;
     }
 
+    MegamorphicInlineCache* megamorphicInlineCache()
+    {
+        return m_megamorphicInlineCache;
+    }
+
 
     void setOnDestroyCallback(void (*onVMInstanceDestroy)(VMInstance* instance, void* data), void* data)
     {
@@ -300,8 +456,20 @@ private:
     GlobalSymbolRegistryVector m_globalSymbolRegistry;
     SandBox* m_currentSandBox;
 
+#if defined(ENABLE_THREADING)
+    // gc maintenance of gcEventCallback runs only on this thread
+    std::thread::id m_ownerThreadID;
+    // recursive, because gc can be triggered on the owner thread while it holds this lock
+    std::recursive_mutex m_registryMutex;
+#endif
+
     bool m_isFinalized;
     bool m_inEnterIdleMode;
+    // GC_get_gc_no() of the collection whose caches are released already
+    // (RECLAIM_END could be reported on another thread, so a flag cleared there could be left set)
+    size_t m_cachesReleasedGCNumber;
+    // some ByteCodeBlocks are detached in this collection and should be attached again on RECLAIM_END if they survive
+    bool m_didFlushByteCodeBlocks;
     // this flag should affect VM-wide array object
     bool m_didSomePrototypeObjectDefineIndexedProperty;
 #ifdef ESCARGOT_DEBUGGER
@@ -321,8 +489,25 @@ private:
     ObjectStructure* m_defaultStructureForMappedArgumentsObject;
     ObjectStructure* m_defaultStructureForUnmappedArgumentsObject;
 
+    ContextSnapshot* m_contextSnapshot;
+    bool m_isContextSnapshotEnabled;
+
     std::vector<ByteCodeBlock*> m_compiledByteCodeBlocks;
     size_t m_compiledByteCodeSize;
+    size_t m_maxCompiledByteCodeSize;
+    size_t m_compiledByteCodeEpoch;
+    size_t m_flushedByteCodeBlockCount;
+    size_t m_regeneratedByteCodeBlockCount;
+    size_t m_codeCacheLoadedByteCodeBlockCount;
+    ByteCodeOptimizerStatistics* m_byteCodeOptimizerStatistics;
+    uint32_t m_enabledByteCodeOptimizationPasses;
+
+    // release caches and cold ByteCodeBlocks before marking of a collection starts
+    // called on the first MARK_START of each collection
+    void releaseCachesBeforeMarking(bool debuggerEnabled);
+    // detach ByteCodeBlocks from CodeBlocks starting from the least recently executed one
+    // returns true if any ByteCodeBlock is detached
+    bool flushByteCodeBlocks(bool flushAll);
 
 #if defined(ENABLE_COMPRESSIBLE_STRING)
     uint64_t m_lastCompressibleStringsTestTime;
@@ -347,6 +532,8 @@ private:
     RegExpCacheMap* m_regexpCache;
     ASCIIString** m_regexpOptionStringCache;
 
+    MegamorphicInlineCache* m_megamorphicInlineCache;
+
 // date object data
 #ifdef ENABLE_ICU
     std::string m_locale;
@@ -19,6 +19,14 @@
 
 #include <string.h>
 #include <vector>
+#include <algorithm>
+#include <memory>
+#if defined(ENABLE_THREADING)
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#endif
 
 #include "api/EscargotPublic.h"
 #include "malloc.h"
@@ -236,6 +244,57 @@ static ValueRef* builtinRead(ExecutionStateRef* state, ValueRef* thisValue, size
     }
 }
 
+static FILE* builtinHelperFileOpen(ExecutionStateRef* state, const char* fileName, const char* mode, const char* builtinName)
+{
+    FILE* fp = fopen(fileName, mode);
+    if (!fp) {
+        char msg[1024];
+        snprintf(msg, sizeof(msg), "GlobalObject.%s: cannot open file %s", builtinName, fileName);
+        state->throwException(URIErrorObjectRef::create(state, StringRef::createFromUTF8(msg, strnlen(msg, sizeof msg))));
+    }
+    return fp;
+}
+
+struct ReadJSONData {
+    FILE* m_file;
+    ValueRef* m_callback;
+};
+
+// readJSON(fileName, callback)
+// callback is called with each element of the top-level array of the file (or the top-level value if it is not an array)
+// returning false from callback stops reading
+static ValueRef* builtinReadJSON(ExecutionStateRef* state, ValueRef* thisValue, size_t argc, ValueRef** argv, bool isConstructCall)
+{
+    if (argc < 2 || !argv[1]->isCallable()) {
+        state->throwException(TypeErrorObjectRef::create(state, StringRef::createFromASCII("GlobalObject.readJSON: callback is not callable")));
+    }
+
+    auto f = argv[0]->toString(state)->toStdUTF8String();
+    std::unique_ptr<FILE, int (*)(FILE*)> file(builtinHelperFileOpen(state, f.data(), "rb", "readJSON"), fclose);
+    ReadJSONData data = { file.get(), argv[1] };
+    JSONRef::parse(state, [](char* buffer, size_t bufferSize, void* data) -> size_t {
+        return fread(buffer, 1, bufferSize, ((ReadJSONData*)data)->m_file);
+    },
+                   [](ExecutionStateRef* state, ValueRef* element, void* data) -> bool {
+                       return !((ReadJSONData*)data)->m_callback->call(state, ValueRef::createUndefined(), 1, &element)->isFalse();
+                   },
+                   &data);
+    return ValueRef::createUndefined();
+}
+
+// writeJSON(fileName, value)
+// writes JSON.stringify(value) to the file without creating the whole string
+static ValueRef* builtinWriteJSON(ExecutionStateRef* state, ValueRef* thisValue, size_t argc, ValueRef** argv, bool isConstructCall)
+{
+    auto f = argc >= 1 ? argv[0]->toString(state)->toStdUTF8String() : std::string();
+    std::unique_ptr<FILE, int (*)(FILE*)> file(builtinHelperFileOpen(state, f.data(), "wb", "writeJSON"), fclose);
+    bool written = JSONRef::stringify(state, argc >= 2 ? argv[1] : ValueRef::createUndefined(), [](const char* chunk, size_t length, void* data) {
+        fwrite(chunk, 1, length, (FILE*)data);
+    },
+                                      file.get());
+    return ValueRef::create(written);
+}
+
 static ValueRef* builtinRun(ExecutionStateRef* state, ValueRef* thisValue, size_t argc, ValueRef** argv, bool isConstructCall)
 {
     if (argc >= 1) {
@@ -309,7 +368,7 @@ static ValueRef* builtin262CreateRealm(ExecutionStateRef* state, ValueRef* thisV
 
 static ValueRef* builtin262DetachArrayBuffer(ExecutionStateRef* state, ValueRef* thisValue, size_t argc, ValueRef** argv, bool isConstructCall)
 {
-    if (argv[0]->isArrayBufferObject()) {
+    if (argv[0]->isArrayBufferObject() && !argv[0]->isSharedArrayBufferObject()) {
         argv[0]->asArrayBufferObject()->detachArrayBuffer();
     }
 
@@ -329,6 +388,9 @@ static ValueRef* builtin262IsHTMLDDA(ExecutionStateRef* state, ValueRef* thisVal
 }
 #endif
 
+#if defined(ENABLE_THREADING)
+static ValueRef* builtinWorker(ExecutionStateRef* state, ValueRef* thisValue, size_t argc, ValueRef** argv, bool isConstructCall);
+#endif
 
 PersistentRefHolder<ContextRef> createEscargotContext(VMInstanceRef* instance)
 {
@@ -361,6 +423,18 @@ PersistentRefHolder<ContextRef> createEscargotContext(VMInstanceRef* instance)
             context->globalObject()->defineDataProperty(state, StringRef::createFromASCII("read"), buildFunctionObjectRef, true, true, true);
         }
 
+        {
+            FunctionObjectRef::NativeFunctionInfo nativeFunctionInfo(AtomicStringRef::create(context, "readJSON"), builtinReadJSON, 2, true, false);
+            FunctionObjectRef* buildFunctionObjectRef = FunctionObjectRef::create(state, nativeFunctionInfo);
+            context->globalObject()->defineDataProperty(state, StringRef::createFromASCII("readJSON"), buildFunctionObjectRef, true, true, true);
+        }
+
+        {
+            FunctionObjectRef::NativeFunctionInfo nativeFunctionInfo(AtomicStringRef::create(context, "writeJSON"), builtinWriteJSON, 2, true, false);
+            FunctionObjectRef* buildFunctionObjectRef = FunctionObjectRef::create(state, nativeFunctionInfo);
+            context->globalObject()->defineDataProperty(state, StringRef::createFromASCII("writeJSON"), buildFunctionObjectRef, true, true, true);
+        }
+
         {
             FunctionObjectRef::NativeFunctionInfo nativeFunctionInfo(AtomicStringRef::create(context, "run"), builtinRun, 1, true, false);
             FunctionObjectRef* buildFunctionObjectRef = FunctionObjectRef::create(state, nativeFunctionInfo);
@@ -373,6 +447,14 @@ PersistentRefHolder<ContextRef> createEscargotContext(VMInstanceRef* instance)
             context->globalObject()->defineDataProperty(state, StringRef::createFromASCII("gc"), buildFunctionObjectRef, true, true, true);
         }
 
+#if defined(ENABLE_THREADING)
+        {
+            FunctionObjectRef::NativeFunctionInfo nativeFunctionInfo(AtomicStringRef::create(context, "Worker"), builtinWorker, 1, true, true);
+            FunctionObjectRef* buildFunctionObjectRef = FunctionObjectRef::create(state, nativeFunctionInfo);
+            context->globalObject()->defineDataProperty(state, StringRef::createFromASCII("Worker"), buildFunctionObjectRef, true, false, true);
+        }
+#endif
+
 #if defined(ESCARGOT_ENABLE_TEST)
         // There is no specific standard for the [@@toStringTag] property of global object.
         // But "global" string is added here to pass legacy TCs
@@ -622,6 +704,279 @@ static bool evalScript(ContextRef* context, StringRef* source, StringRef* srcNam
     return result;
 }
 
+#if defined(ENABLE_THREADING)
+// messages between threads are SerializedValueRef, so no js object is shared by two VMInstances
+class ShellMessageQueue {
+public:
+    ShellMessageQueue()
+        : m_isClosed(false)
+    {
+    }
+
+    void push(SerializedValueRef* message)
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        if (!m_isClosed) {
+            m_messages.push_back(PersistentRefHolder<SerializedValueRef>(message));
+            m_condition.notify_one();
+        }
+    }
+
+    // blocks until a message arrives
+    // returns nullptr when the queue is closed and there is no remaining message
+    SerializedValueRef* pop()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_condition.wait(lock, [this]() { return m_isClosed || !m_messages.empty(); });
+        if (m_messages.empty()) {
+            return nullptr;
+        }
+        // the caller should keep the message on its stack
+        SerializedValueRef* message = m_messages.front().release();
+        m_messages.pop_front();
+        return message;
+    }
+
+    void close()
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        m_isClosed = true;
+        m_condition.notify_all();
+    }
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::deque<PersistentRefHolder<SerializedValueRef>> m_messages;
+    bool m_isClosed;
+};
+
+// `new Worker(fileName)` runs the file in a new VMInstance on its own thread
+// worker.postMessage(value, [transferList]) calls `onmessage(value)` of the worker
+// `postMessage(value, [transferList])` in the worker sends value back, and worker.getMessage() waits for it
+// worker.terminate() lets the worker thread exit after handling the messages already sent
+class ShellWorker {
+public:
+    explicit ShellWorker(const std::string& fileName)
+    {
+        m_thread = std::thread(&ShellWorker::run, this, fileName);
+    }
+
+    ShellMessageQueue& messagesToWorker()
+    {
+        return m_messagesToWorker;
+    }
+
+    ShellMessageQueue& messagesToParent()
+    {
+        return m_messagesToParent;
+    }
+
+    void terminate()
+    {
+        m_messagesToWorker.close();
+    }
+
+    void join()
+    {
+        if (m_thread.joinable()) {
+            m_thread.join();
+        }
+    }
+
+    static ShellWorker* currentWorker()
+    {
+        return g_currentWorker;
+    }
+
+    // workers can be created on any thread (workers can create workers too)
+    static void registerWorker(ShellWorker* worker)
+    {
+        std::lock_guard<std::mutex> guard(workersMutex());
+        workers().push_back(worker);
+    }
+
+    // extraData of a js object can be set by others, so check it before casting
+    static ShellWorker* fromExtraData(void* extraData)
+    {
+        std::lock_guard<std::mutex> guard(workersMutex());
+        auto iter = std::find(workers().begin(), workers().end(), extraData);
+        return iter != workers().end() ? *iter : nullptr;
+    }
+
+    // every worker is joined at the end of the program
+    // workers which are created while joining are joined too
+    static void joinAll()
+    {
+        while (true) {
+            ShellWorker* worker;
+            {
+                std::lock_guard<std::mutex> guard(workersMutex());
+                if (workers().empty()) {
+                    break;
+                }
+                worker = workers().back();
+                workers().pop_back();
+            }
+            worker->terminate();
+            worker->join();
+            delete worker;
+        }
+    }
+
+private:
+    void run(std::string fileName);
+
+    static std::mutex& workersMutex()
+    {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    static std::vector<ShellWorker*>& workers()
+    {
+        static std::vector<ShellWorker*> workers;
+        return workers;
+    }
+
+    static thread_local ShellWorker* g_currentWorker;
+    ShellMessageQueue m_messagesToWorker;
+    ShellMessageQueue m_messagesToParent;
+    std::thread m_thread;
+};
+
+thread_local ShellWorker* ShellWorker::g_currentWorker;
+
+static ValueVectorRef* builtinHelperTransferList(ExecutionStateRef* state, size_t argc, ValueRef** argv)
+{
+    ValueVectorRef* transferList = ValueVectorRef::create();
+    if (argc >= 2 && argv[1]->isObject()) {
+        ObjectRef* list = argv[1]->asObject();
+        uint64_t length = list->length(state);
+        for (uint64_t i = 0; i < length; i++) {
+            transferList->pushBack(list->get(state, ValueRef::create(i)));
+        }
+    }
+    return transferList;
+}
+
+static ValueRef* builtinWorkerSelfPostMessage(ExecutionStateRef* state, ValueRef* thisValue, size_t argc, ValueRef** argv, bool isConstructCall)
+{
+    ValueRef* value = argc ? argv[0] : ValueRef::createUndefined();
+    ShellWorker::currentWorker()->messagesToParent().push(SerializedValueRef::serialize(state, value, builtinHelperTransferList(state, argc, argv)));
+    return ValueRef::createUndefined();
+}
+
+static ShellWorker* builtinHelperThisWorker(ExecutionStateRef* state, ValueRef* thisValue, const char* builtinName)
+{
+    ShellWorker* worker = thisValue->isObject() ? ShellWorker::fromExtraData(thisValue->asObject()->extraData()) : nullptr;
+    if (!worker) {
+        char msg[128];
+        snprintf(msg, sizeof(msg), "Worker.%s: this value is not a Worker", builtinName);
+        state->throwException(TypeErrorObjectRef::create(state, StringRef::createFromASCII(msg, strnlen(msg, sizeof msg))));
+    }
+    return worker;
+}
+
+static ValueRef* builtinWorkerPostMessage(ExecutionStateRef* state, ValueRef* thisValue, size_t argc, ValueRef** argv, bool isConstructCall)
+{
+    ShellWorker* worker = builtinHelperThisWorker(state, thisValue, "postMessage");
+    ValueRef* value = argc ? argv[0] : ValueRef::createUndefined();
+    worker->messagesToWorker().push(SerializedValueRef::serialize(state, value, builtinHelperTransferList(state, argc, argv)));
+    return ValueRef::createUndefined();
+}
+
+static ValueRef* builtinWorkerGetMessage(ExecutionStateRef* state, ValueRef* thisValue, size_t argc, ValueRef** argv, bool isConstructCall)
+{
+    ShellWorker* worker = builtinHelperThisWorker(state, thisValue, "getMessage");
+    SerializedValueRef* message = worker->messagesToParent().pop();
+    if (!message) {
+        return ValueRef::createUndefined();
+    }
+    return message->deserialize(state);
+}
+
+static ValueRef* builtinWorkerTerminate(ExecutionStateRef* state, ValueRef* thisValue, size_t argc, ValueRef** argv, bool isConstructCall)
+{
+    builtinHelperThisWorker(state, thisValue, "terminate")->terminate();
+    return ValueRef::createUndefined();
+}
+
+static ValueRef* builtinWorker(ExecutionStateRef* state, ValueRef* thisValue, size_t argc, ValueRef** argv, bool isConstructCall)
+{
+    if (!isConstructCall) {
+        state->throwException(TypeErrorObjectRef::create(state, StringRef::createFromASCII("Worker: Constructor requires 'new'")));
+    }
+    std::string fileName = argc ? argv[0]->toString(state)->toStdUTF8String() : std::string();
+
+    ContextRef* context = state->context();
+    ObjectRef* workerObject = ObjectRef::create(state);
+    {
+        FunctionObjectRef::NativeFunctionInfo nativeFunctionInfo(AtomicStringRef::create(context, "postMessage"), builtinWorkerPostMessage, 1, true, false);
+        workerObject->defineDataProperty(state, StringRef::createFromASCII("postMessage"), FunctionObjectRef::create(state, nativeFunctionInfo), true, false, true);
+    }
+    {
+        FunctionObjectRef::NativeFunctionInfo nativeFunctionInfo(AtomicStringRef::create(context, "getMessage"), builtinWorkerGetMessage, 0, true, false);
+        workerObject->defineDataProperty(state, StringRef::createFromASCII("getMessage"), FunctionObjectRef::create(state, nativeFunctionInfo), true, false, true);
+    }
+    {
+        FunctionObjectRef::NativeFunctionInfo nativeFunctionInfo(AtomicStringRef::create(context, "terminate"), builtinWorkerTerminate, 0, true, false);
+        workerObject->defineDataProperty(state, StringRef::createFromASCII("terminate"), FunctionObjectRef::create(state, nativeFunctionInfo), true, false, true);
+    }
+
+    ShellWorker* worker = new ShellWorker(fileName);
+    ShellWorker::registerWorker(worker);
+    workerObject->setExtraData(worker);
+    return workerObject;
+}
+
+void ShellWorker::run(std::string fileName)
+{
+    Globals::initializeThread();
+    g_currentWorker = this;
+    {
+        ShellPlatform* platform = new ShellPlatform();
+        PersistentRefHolder<VMInstanceRef> instance = VMInstanceRef::create(platform);
+        instance->setOnVMInstanceDelete([](VMInstanceRef* instance) {
+            delete instance->platform();
+        });
+        PersistentRefHolder<ContextRef> context = createEscargotContext(instance.get());
+
+        Evaluator::execute(context, [](ExecutionStateRef* state) -> ValueRef* {
+            ContextRef* context = state->context();
+            FunctionObjectRef::NativeFunctionInfo nativeFunctionInfo(AtomicStringRef::create(context, "postMessage"), builtinWorkerSelfPostMessage, 1, true, false);
+            context->globalObject()->defineDataProperty(state, StringRef::createFromASCII("postMessage"), FunctionObjectRef::create(state, nativeFunctionInfo), true, false, true);
+            return ValueRef::createUndefined();
+        });
+
+        OptionalRef<StringRef> source = builtinHelperFileRead(nullptr, fileName.data(), "Worker");
+        if (source && evalScript(context, source.value(), StringRef::createFromUTF8(fileName.data(), fileName.length()), false, false)) {
+            while (SerializedValueRef* message = m_messagesToWorker.pop()) {
+                auto result = Evaluator::execute(context, [](ExecutionStateRef* state, SerializedValueRef* message) -> ValueRef* {
+                    ValueRef* onmessage = state->context()->globalObject()->get(state, StringRef::createFromASCII("onmessage"));
+                    ValueRef* data = message->deserialize(state);
+                    if (onmessage->isCallable()) {
+                        onmessage->call(state, ValueRef::createUndefined(), 1, &data);
+                    }
+                    return ValueRef::createUndefined();
+                },
+                                                 message);
+                if (!result.isSuccessful()) {
+                    fprintf(stderr, "Uncaught %s:\n", result.resultOrErrorToString(context)->toStdUTF8String().data());
+                }
+                while (context->vmInstance()->hasPendingJob()) {
+                    context->vmInstance()->executePendingJob();
+                }
+            }
+        }
+    }
+    g_currentWorker = nullptr;
+    m_messagesToWorker.close();
+    m_messagesToParent.close();
+    Globals::finalizeThread();
+}
+#endif
+
 int main(int argc, char* argv[])
 {
 #ifndef NDEBUG
@@ -655,6 +1010,7 @@ int main(int argc, char* argv[])
     bool runShell = true;
     bool seenModule = false;
     std::string fileName;
+    std::string allocationProfilePath;
 
     for (int i = 1; i < argc; i++) {
         if (strlen(argv[i]) >= 2 && argv[i][0] == '-') { // parse command line option
@@ -671,6 +1027,19 @@ int main(int argc, char* argv[])
                     fileName = argv[i] + sizeof("--filename-as=") - 1;
                     continue;
                 }
+                if (strcmp(argv[i], "--disable-context-snapshot") == 0) {
+                    // Contexts created by script (newGlobal, $262.createRealm) install builtins from scratch
+                    instance->setContextSnapshotEnabled(false);
+                    continue;
+                }
+                // --allocation-profile=<path>: write sampled allocation stacks in folded stack format on exit
+                // bytes are sampled at object creations and string concatenations only,
+                // so other allocations (e.g. strings made by String builtins) are attributed to the next sampled stack
+                if (strstr(argv[i], "--allocation-profile=") == argv[i]) {
+                    allocationProfilePath = argv[i] + sizeof("--allocation-profile=") - 1;
+                    Memory::startAllocationProfiler();
+                    continue;
+                }
                 if (strcmp(argv[i], "--start-debug-server") == 0) {
                     context->initDebugger(nullptr);
                     continue;
@@ -744,6 +1113,14 @@ int main(int argc, char* argv[])
         evalScript(context, str, StringRef::createFromASCII("from shell input"), true, false);
     }
 
+    if (allocationProfilePath.length() && !Memory::stopAllocationProfiler(allocationProfilePath.data())) {
+        fprintf(stderr, "Cannot write allocation profile %s\n", allocationProfilePath.data());
+    }
+
+#if defined(ENABLE_THREADING)
+    ShellWorker::joinAll();
+#endif
+
     context.release();
     instance.release();
 
@@ -364,6 +364,12 @@ public:
         return m_buffer;
     }
 
+    // replace buffer without deallocating the old one
+    void setData(T* buffer)
+    {
+        m_buffer = buffer;
+    }
+
 protected:
     T* m_buffer;
 };
@@ -22,6 +22,7 @@
 #include "Escargot.h"
 #include "wasm.h"
 #include "runtime/Context.h"
+#include "runtime/VMInstance.h"
 #include "runtime/Object.h"
 #include "runtime/ArrayObject.h"
 #include "runtime/NativeFunctionObject.h"
@@ -42,11 +43,16 @@ ExportedFunctionObject::ExportedFunctionObject(ExecutionState& state, NativeFunc
 {
     ASSERT(!!m_function);
 
+    WASMContext* context = VMInstance::wasmContext();
+    context->ref();
     addFinalizer([](Object* obj, void* data) {
         ExportedFunctionObject* self = (ExportedFunctionObject*)obj;
-        wasm_func_delete(self->function());
+        ((WASMContext*)data)->deleteObject([](void* ptr) {
+            wasm_func_delete((wasm_func_t*)ptr);
+        },
+                                           self->function());
     },
-                 nullptr);
+                 context);
 }
 
 void* ExportedFunctionObject::operator new(size_t size)
@@ -22,6 +22,7 @@
 #include "Escargot.h"
 #include "wasm.h"
 #include "runtime/Context.h"
+#include "runtime/VMInstance.h"
 #include "runtime/Object.h"
 #include "runtime/ArrayBufferObject.h"
 #include "wasm/WASMObject.h"
@@ -68,11 +69,16 @@ WASMModuleObject::WASMModuleObject(ExecutionState& state, Object* proto, wasm_mo
 {
     ASSERT(!!m_module);
 
+    WASMContext* context = VMInstance::wasmContext();
+    context->ref();
     addFinalizer([](Object* obj, void* data) {
         WASMModuleObject* self = (WASMModuleObject*)obj;
-        wasm_module_delete(self->module());
+        ((WASMContext*)data)->deleteObject([](void* ptr) {
+            wasm_module_delete((wasm_module_t*)ptr);
+        },
+                                           self->module());
     },
-                 nullptr);
+                 context);
 }
 
 void* WASMModuleObject::operator new(size_t size)
@@ -100,11 +106,16 @@ WASMInstanceObject::WASMInstanceObject(ExecutionState& state, Object* proto, was
 {
     ASSERT(!!m_instance && !!m_exports);
 
+    WASMContext* context = VMInstance::wasmContext();
+    context->ref();
     addFinalizer([](Object* obj, void* data) {
         WASMInstanceObject* self = (WASMInstanceObject*)obj;
-        wasm_instance_delete(self->instance());
+        ((WASMContext*)data)->deleteObject([](void* ptr) {
+            wasm_instance_delete((wasm_instance_t*)ptr);
+        },
+                                           self->instance());
     },
-                 nullptr);
+                 context);
 }
 
 void* WASMInstanceObject::operator new(size_t size)
@@ -133,12 +144,17 @@ WASMMemoryObject::WASMMemoryObject(ExecutionState& state, Object* proto, wasm_me
 {
     ASSERT(!!m_memory && !!m_buffer);
 
+    WASMContext* context = VMInstance::wasmContext();
+    context->ref();
     addFinalizer([](Object* obj, void* data) {
         WASMMemoryObject* self = (WASMMemoryObject*)obj;
-        wasm_memory_delete(self->memory());
         self->buffer()->detachArrayBuffer();
+        ((WASMContext*)data)->deleteObject([](void* ptr) {
+            wasm_memory_delete((wasm_memory_t*)ptr);
+        },
+                                           self->memory());
     },
-                 nullptr);
+                 context);
 }
 
 void* WASMMemoryObject::operator new(size_t size)
@@ -217,11 +233,16 @@ WASMTableObject::WASMTableObject(ExecutionState& state, Object* proto, wasm_tabl
 {
     ASSERT(!!m_table);
 
+    WASMContext* context = VMInstance::wasmContext();
+    context->ref();
     addFinalizer([](Object* obj, void* data) {
         WASMTableObject* self = (WASMTableObject*)obj;
-        wasm_table_delete(self->table());
+        ((WASMContext*)data)->deleteObject([](void* ptr) {
+            wasm_table_delete((wasm_table_t*)ptr);
+        },
+                                           self->table());
     },
-                 nullptr);
+                 context);
 }
 
 void* WASMTableObject::operator new(size_t size)
@@ -275,11 +296,16 @@ WASMGlobalObject::WASMGlobalObject(ExecutionState& state, Object* proto, wasm_gl
 {
     ASSERT(!!m_global);
 
+    WASMContext* context = VMInstance::wasmContext();
+    context->ref();
     addFinalizer([](Object* obj, void* data) {
         WASMGlobalObject* self = (WASMGlobalObject*)obj;
-        wasm_global_delete(self->global());
+        ((WASMContext*)data)->deleteObject([](void* ptr) {
+            wasm_global_delete((wasm_global_t*)ptr);
+        },
+                                           self->global());
     },
-                 nullptr);
+                 context);
 }
 
 void* WASMGlobalObject::operator new(size_t size)
@@ -24,6 +24,14 @@ using namespace Escargot;
 #include "gtest/gtest.h"
 
 #include <vector>
+#if defined(ENABLE_CODE_CACHE)
+#include <dirent.h>
+#include <unistd.h>
+#include "codecache/CodeCacheWorker.h"
+#endif
+#if defined(ENABLE_THREADING)
+#include <thread>
+#endif
 
 static bool stringEndsWith(const std::string& str, const std::string& suffix)
 {
@@ -308,11 +316,15 @@ public:
 
 PersistentRefHolder<VMInstanceRef> g_instance;
 PersistentRefHolder<ContextRef> g_context;
+static bool g_gcMarkerThreadCountApplied;
 
 int main(int argc, char* argv[])
 {
     testing::InitGoogleTest(&argc, argv);
 
+    // mark with several threads even on a single processor machine if parallel marking is supported
+    g_gcMarkerThreadCountApplied = Memory::setGCMarkerThreadCount(2);
+
     Globals::initialize();
 
     Memory::setGCFrequency(24);
@@ -328,6 +340,21 @@ int main(int argc, char* argv[])
     return RUN_ALL_TESTS();
 }
 
+TEST(Memory, GCMarkerThreadCount)
+{
+#if defined(ENABLE_GC_PARALLEL_MARK)
+    EXPECT_TRUE(g_gcMarkerThreadCountApplied);
+#else
+    EXPECT_FALSE(g_gcMarkerThreadCountApplied);
+#endif
+    // marking with the marker threads keeps every object reachable from the stack and the heap
+    auto s = evalScript(g_context.get(), StringRef::createFromASCII("var list = []; for (var i = 0; i < 100000; i++) { list.push({ v: i, s: 'k' + i }) } list.length"), StringRef::createFromASCII("test.js"), false);
+    EXPECT_EQ(s, "100000");
+    Memory::gc();
+    s = evalScript(g_context.get(), StringRef::createFromASCII("var sum = 0; for (var i = 0; i < list.length; i++) { sum += list[i].v + list[i].s.length } list = null; sum"), StringRef::createFromASCII("test.js"), false);
+    EXPECT_EQ(s, "5000538890");
+}
+
 TEST(EvalScript, Run)
 {
     auto s = evalScript(g_context.get(), StringRef::createFromASCII("1 + 1"), StringRef::createFromASCII("test.js"), false);
@@ -352,6 +379,1260 @@ TEST(EvalScript, RuntimeError)
     EXPECT_TRUE(s.find("Uncaught 1") == 0);
 }
 
+// runs `body` (a function of s, e and acc which iterates [s, e) and returns acc) once for all iterations,
+// and again in chunks of fresh functions which never get hot enough to be compiled by JIT.
+// returns the JSON of acc (or the exception) of JIT run, or "mismatch: ..." if results differ
+static std::string compareJITWithInterpreter(const char* init, const char* body, int iterations)
+{
+    std::string src = "(function() { var body = `";
+    src += body;
+    src += "`; function run(step) { var acc = ";
+    src += init;
+    src += "; try { for (var s = 0; s < ";
+    src += std::to_string(iterations);
+    src += "; s += step) { acc = new Function('s', 'e', 'acc', body)(s, Math.min(";
+    src += std::to_string(iterations);
+    src += ", s + step), acc) } } catch (e) { return 'threw ' + e + ' ' + JSON.stringify(acc) } return JSON.stringify(acc) }"
+           "var interpreted = run(400); var jit = run(";
+    src += std::to_string(iterations);
+    src += "); return interpreted === jit ? jit : 'mismatch: ' + interpreted + ' / ' + jit })()";
+    return evalScript(g_context.get(), StringRef::createFromUTF8(src.data(), src.length()), StringRef::createFromASCII("jit.js"), false);
+}
+
+TEST(JIT, Arithmetic)
+{
+    auto s = compareJITWithInterpreter("{ x: 0, y: 0, z: 2147480000, o: 1, d: 0 }",
+                                       "for (var i = s; i < e; i++) {"
+                                       "    acc.x = (acc.x * 31 + i) | 0; if (i % 5 === 0) acc.x ^= i << 3; acc.x = acc.x >>> 1;"
+                                       "    acc.y += i * 0.5; acc.z = acc.z + i; acc.o = acc.o * 2 % 1000003; acc.d = acc.d - i / 3;"
+                                       "} return acc;",
+                                       5000);
+    EXPECT_EQ(s, "{\"x\":1965198693,\"y\":6248750,\"z\":2159977500,\"o\":91278,\"d\":-4165833.3333333335}");
+}
+
+TEST(JIT, Deoptimize)
+{
+    // operands leave the int32 fast path in the middle of a hot loop
+    auto s = compareJITWithInterpreter("{ n: 0, c: 0, cmp: 0, eq: 0 }",
+                                       "for (var i = s; i < e; i++) {"
+                                       "    var v = i < 2000 ? i : (i < 3500 ? i + 0.5 : (i < 4500 ? 'k' + i : null));"
+                                       "    acc.n = acc.n + (typeof v === 'string' ? v.length : +v);"
+                                       "    acc.c = i < 3000 ? acc.c + 1 : acc.c + '';"
+                                       "    acc.cmp += (v < 2500) ? 1 : 0; acc.eq += (v == i) ? 1 : 0;"
+                                       "} return acc;",
+                                       5000);
+    EXPECT_EQ(s, "{\"n\":6129000,\"c\":\"3000\",\"cmp\":3000,\"eq\":2000}");
+}
+
+TEST(JIT, Exception)
+{
+    // exceptions thrown inside a hot loop are caught inside and outside of JIT code
+    auto s = compareJITWithInterpreter("{ sum: 0, caught: [], f: 0 }",
+                                       "function check(v) { if (v % 997 === 0) throw new RangeError('r' + v); return v & 7 }"
+                                       "for (var i = s; i < e; i++) {"
+                                       "    try { acc.sum += check(i) } catch (err) { acc.caught.push(err.message) } finally { acc.f++ }"
+                                       "    if (i === 4321) acc.missing.property;"
+                                       "    acc.sum++;"
+                                       "} return acc;",
+                                       5000);
+    EXPECT_EQ(s.find("mismatch"), std::string::npos) << s;
+    EXPECT_EQ(s.find("threw TypeError"), 0u) << s;
+    EXPECT_NE(s.find("\"caught\":[\"r0\",\"r997\",\"r1994\",\"r2991\",\"r3988\"],\"f\":4322"), std::string::npos) << s;
+}
+
+TEST(JIT, ObjectAccess)
+{
+    // GetObject/SetObject fast paths meet holes, typed arrays, strings, frozen arrays, inherited indexes and accessors
+    auto s = compareJITWithInterpreter("{ arr: [1, , 3], ta: new Int8Array(10), str: 'abcdefghijklmnop', frozen: Object.freeze([1, 2, 3]),"
+                                       "  obj: { _v: 0, set v(x) { this._v = x * 2 % 10007 }, get v() { return this._v } }, proto: Object.create({ 5: 'p' }), sum: 0 }",
+                                       "for (var i = s; i < e; i++) {"
+                                       "    var k = i % 20;"
+                                       "    var o = i % 5 === 0 ? acc.arr : i % 5 === 1 ? acc.ta : i % 5 === 2 ? acc.str : i % 5 === 3 ? acc.frozen : acc.proto;"
+                                       "    var x = o[k];"
+                                       "    acc.sum += typeof x === 'number' ? x : (x === undefined ? -1 : x.charCodeAt(0));"
+                                       "    if (i % 3 === 0) o[k] = i;"
+                                       "    if (i % 7 === 0) o[k + 0.5] = 1;"
+                                       "    acc.obj.v = acc.obj.v + 1;"
+                                       "    if (i % 40 === 39) acc.arr.length = 10;"
+                                       "} return acc;",
+                                       5000);
+    EXPECT_EQ(s.find("mismatch"), std::string::npos) << s;
+    EXPECT_NE(s.find("\"frozen\":[1,2,3],\"obj\":{\"_v\":2500,\"v\":2500}"), std::string::npos) << s;
+    EXPECT_NE(s.find("\"sum\":3970523"), std::string::npos) << s;
+}
+
+// evaluates src in a new VMInstance which applies only the given bytecode optimization passes
+static std::string runWithByteCodeOptimizationPasses(uint32_t passes, const char* src)
+{
+    PersistentRefHolder<VMInstanceRef> instance = VMInstanceRef::create(new ShellPlatform());
+    instance->setOnVMInstanceDelete([](VMInstanceRef* instance) {
+        delete instance->platform();
+    });
+    instance->setEnabledByteCodeOptimizationPasses(passes);
+    EXPECT_EQ(instance->enabledByteCodeOptimizationPasses(), passes);
+
+    PersistentRefHolder<ContextRef> context = ContextRef::create(instance.get());
+    return evalScript(context.get(), StringRef::createFromUTF8(src, strlen(src)), StringRef::createFromASCII("optimizer.js"), false);
+}
+
+static void expectSameResultWithEveryByteCodeOptimizationPass(const char* src, const std::string& expected)
+{
+    EXPECT_EQ(runWithByteCodeOptimizationPasses(VMInstanceRef::NoByteCodeOptimizationPass, src), expected);
+    for (uint32_t pass = VMInstanceRef::JumpThreadingPass; pass <= VMInstanceRef::DeadRegisterEliminationPass; pass <<= 1) {
+        EXPECT_EQ(runWithByteCodeOptimizationPasses(pass, src), expected) << "pass " << pass;
+    }
+    EXPECT_EQ(runWithByteCodeOptimizationPasses(VMInstanceRef::AllByteCodeOptimizationPasses, src), expected);
+}
+
+TEST(ByteCodeOptimizer, JumpThreading)
+{
+    // jumps into jumps, empty branches, labeled break/continue and switch fallthrough
+    const char* src =
+        "(function() {"
+        "    var out = [];"
+        "    outer: for (var i = 0; i < 6; i++) {"
+        "        for (var j = 0; j < 6; j++) {"
+        "            if (j > i) continue outer;"
+        "            if (i + j === 7) break outer;"
+        "            if (j % 2) { if (i % 3) { out.push(i * 10 + j) } else { } } else { continue }"
+        "        }"
+        "    }"
+        "    var k = 0, n = 0;"
+        "    while (true) { if (k++ > 20) break; else if (k % 4) continue; n += k }"
+        "    do { n-- } while (n > 40 && n % 7);"
+        "    switch (n % 5) { case 0: n += 100; case 1: n += 10; break; case 2: default: n += 1 }"
+        "    return out.join(',') + '|' + n + '|' + k;"
+        "})()";
+    EXPECT_EQ(runWithByteCodeOptimizationPasses(VMInstanceRef::NoByteCodeOptimizationPass, src), "11,21,41|66|22");
+    EXPECT_EQ(runWithByteCodeOptimizationPasses(VMInstanceRef::JumpThreadingPass, src), "11,21,41|66|22");
+    EXPECT_EQ(runWithByteCodeOptimizationPasses(VMInstanceRef::AllByteCodeOptimizationPasses, src), "11,21,41|66|22");
+}
+
+TEST(ByteCodeOptimizer, ConstantFolding)
+{
+    // int32 overflow, -0, NaN and string concatenation must keep their semantics
+    const char* src =
+        "(function() {"
+        "    var r = [1 + 2 * 3, (4 - 10) / 4, 7 % 3, -7 % 3, 2 ** 10, 2147483647 + 1, -2147483648 - 1, 1 / (0 * -1), 1 / (0 - 0),"
+        "             0.1 + 0.2, 5 / 0, 0 / 0, 1 << 31, -1 >>> 0, 6 & 3 | 8 ^ 1, '1' + 2, 1 + 2 + '3', 1e21 * 10, -(3 - 3)];"
+        "    var x = 3; x = x * 2 + 1 - 0.5;"
+        "    return r.map(function(v) { return Object.is(v, -0) ? '-0' : String(v) }).join(',') + '|' + x;"
+        "})()";
+    EXPECT_EQ(runWithByteCodeOptimizationPasses(VMInstanceRef::NoByteCodeOptimizationPass, src), "7,-1.5,1,-1,1024,2147483648,-2147483649,-Infinity,Infinity,0.30000000000000004,Infinity,NaN,-2147483648,4294967295,11,12,33,1e+22,-0|6.5");
+    EXPECT_EQ(runWithByteCodeOptimizationPasses(VMInstanceRef::ConstantFoldingPass, src), "7,-1.5,1,-1,1024,2147483648,-2147483649,-Infinity,Infinity,0.30000000000000004,Infinity,NaN,-2147483648,4294967295,11,12,33,1e+22,-0|6.5");
+    EXPECT_EQ(runWithByteCodeOptimizationPasses(VMInstanceRef::AllByteCodeOptimizationPasses, src), "7,-1.5,1,-1,1024,2147483648,-2147483649,-Infinity,Infinity,0.30000000000000004,Infinity,NaN,-2147483648,4294967295,11,12,33,1e+22,-0|6.5");
+}
+
+TEST(ByteCodeOptimizer, CompareBranchFusion)
+{
+    // valueOf of both operands is still called in the source order, and NaN is never fulfilled
+    const char* src =
+        "(function() {"
+        "    var log = [];"
+        "    var a = { valueOf: function() { log.push('a'); return 1 } };"
+        "    var b = { valueOf: function() { log.push('b'); return 2 } };"
+        "    var r = [];"
+        "    if (a < b) r.push('lt'); if (b > a) r.push('gt'); if (a <= 1) r.push('le'); if (!(a >= b)) r.push('nge');"
+        "    if (NaN < 1 || NaN >= 1) r.push('nan'); if (!(NaN == NaN)) r.push('nan!=');"
+        "    if (null == undefined) r.push('nullish'); if (null !== undefined) r.push('strict');"
+        "    if ('10' < '9') r.push('str'); if ('10' < 9) r.push('num'); if (1 == '1') r.push('coerce');"
+        "    var i = 0, c = 0; while (i !== 10) { if (i < 5 === i % 2 > 0) c++; i++ }"
+        "    for (var j = 10; j >= -2; j -= 3) { if (j == 4) c += 100; else if (j != 1) c += 1 }"
+        "    return r.join(',') + '|' + log.join('') + '|' + c;"
+        "})()";
+    EXPECT_EQ(runWithByteCodeOptimizationPasses(VMInstanceRef::NoByteCodeOptimizationPass, src), "lt,gt,le,nge,nan!=,nullish,strict,str,coerce|abbaaab|107");
+    EXPECT_EQ(runWithByteCodeOptimizationPasses(VMInstanceRef::CompareBranchFusionPass, src), "lt,gt,le,nge,nan!=,nullish,strict,str,coerce|abbaaab|107");
+    EXPECT_EQ(runWithByteCodeOptimizationPasses(VMInstanceRef::AllByteCodeOptimizationPasses, src), "lt,gt,le,nge,nan!=,nullish,strict,str,coerce|abbaaab|107");
+}
+
+TEST(ByteCodeOptimizer, RedundantMoveElimination)
+{
+    // self assignment, chained assignment and variables captured by closures
+    const char* src =
+        "(function() {"
+        "    var x = 1, y = 2, z;"
+        "    x = y; y = x; z = x = y = 7; x = x;"
+        "    var fns = [];"
+        "    for (let i = 0; i < 3; i++) { let v = i; v = v; fns.push(function() { return v + x }) }"
+        "    var a, b, c; a = b = c = 'q'; b = a; c = b + c;"
+        "    function swap(p, q) { var t = p; p = q; q = t; return [p, q] }"
+        "    return fns.map(function(f) { return f() }).join(',') + '|' + z + '|' + a + b + c + '|' + swap(1, 2);"
+        "})()";
+    EXPECT_EQ(runWithByteCodeOptimizationPasses(VMInstanceRef::NoByteCodeOptimizationPass, src), "7,8,9|7|qqqq|2,1");
+    EXPECT_EQ(runWithByteCodeOptimizationPasses(VMInstanceRef::RedundantMoveEliminationPass, src), "7,8,9|7|qqqq|2,1");
+    EXPECT_EQ(runWithByteCodeOptimizationPasses(VMInstanceRef::AllByteCodeOptimizationPasses, src), "7,8,9|7|qqqq|2,1");
+}
+
+TEST(ByteCodeOptimizer, DeadRegisterElimination)
+{
+    // temporaries of comma, logical, conditional and optional chaining expressions
+    const char* src =
+        "(function() {"
+        "    function f(p, q, r) { return (p, q) ? r : p }"
+        "    function g(p) { var t = p || (p === 0 && 'zero') || 'none'; return t }"
+        "    function h(o) { return o?.a?.b ?? (o ? 'no b' : 'no o') }"
+        "    var unused = 1 + 2; unused = 5; var s = 0;"
+        "    for (var i = 0; i < 5; i++) { var tmp = i * 2; tmp = i; s += tmp ? tmp : -1 }"
+        "    return [f(1, 0, 3), f(1, 2, 3), g(0), g(''), g(4), h({ a: { b: 1 } }), h({ a: {} }), h(null), s].join(',');"
+        "})()";
+    EXPECT_EQ(runWithByteCodeOptimizationPasses(VMInstanceRef::NoByteCodeOptimizationPass, src), "1,3,zero,none,4,1,no b,no o,9");
+    EXPECT_EQ(runWithByteCodeOptimizationPasses(VMInstanceRef::DeadRegisterEliminationPass, src), "1,3,zero,none,4,1,no b,no o,9");
+    EXPECT_EQ(runWithByteCodeOptimizationPasses(VMInstanceRef::AllByteCodeOptimizationPasses, src), "1,3,zero,none,4,1,no b,no o,9");
+}
+
+TEST(ByteCodeOptimizer, TryFinally)
+{
+    // return, break and continue through finally blocks
+    const char* src =
+        "(function() {"
+        "    var log = [];"
+        "    function f1() { try { return 'try' } finally { log.push('f1') } }"
+        "    function f2() { try { throw 1 } catch (e) { return 'catch' + e } finally { log.push('f2') } }"
+        "    function f3() { try { return 'try' } finally { return 'finally' } }"
+        "    function f4() { for (var i = 0; i < 5; i++) { try { if (i == 1) continue; if (i == 3) break; log.push('b' + i) } finally { log.push('f' + i) } } return i }"
+        "    function f5() { var x = 1 + 1; try { x = x * 3; throw x } catch (e) { x = e + 1 } finally { x = x * 10 } return x }"
+        "    function f6() { outer: for (var i = 0; i < 3; i++) { for (;;) { try { if (i == 1) break outer; break } finally { log.push('g' + i) } } } return i }"
+        "    function f7() { var n = 0; while (true) { try { n++; if (n < 3) continue; return n } finally { if (n == 3) n = 100 } } }"
+        "    return [f1(), f2(), f3(), f4(), f5(), f6(), f7()].join(',') + '|' + log.join(',');"
+        "})()";
+    expectSameResultWithEveryByteCodeOptimizationPass(src, "try,catch1,finally,3,70,1,3|f1,f2,b0,f0,f1,b2,f2,f3,g0,g1");
+}
+
+TEST(ByteCodeOptimizer, Generator)
+{
+    // yield inside loops and finally blocks, and yield*
+    const char* src =
+        "(function() {"
+        "    function* gen(n) {"
+        "        var acc = 0;"
+        "        for (var i = 0; i < n; i++) {"
+        "            if (i % 2) continue;"
+        "            try { acc += yield i * 2 + 1 } finally { acc += 100 }"
+        "            if (acc > 400) return 'done' + acc;"
+        "        }"
+        "        return acc < 2 ? 'small' : 'end' + acc;"
+        "    }"
+        "    var out = [];"
+        "    var it = gen(10), r = it.next();"
+        "    while (!r.done) { out.push(r.value); r = it.next(r.value) }"
+        "    out.push(r.value);"
+        "    var it2 = gen(10); it2.next(); out.push(JSON.stringify(it2.return('early')));"
+        "    function* delegating() { var x = 1 + 2; x = yield* gen(3); yield x; yield x === undefined ? 'u' : x }"
+        "    out.push(Array.from(delegating()).join('/'));"
+        "    return out.join(',');"
+        "})()";
+    expectSameResultWithEveryByteCodeOptimizationPass(src, "1,5,9,13,done428,{\"value\":\"early\",\"done\":true},1/5/endNaN/endNaN");
+}
+
+TEST(ByteCodeOptimizer, RegistersAcrossJumps)
+{
+    // temporary registers defined on one branch and read after the branches join
+    const char* src =
+        "(function() {"
+        "    function pick(a, b, flag) { var t = flag ? a + 1 : b - 1; var u = t; if (u > 5) { u = t * 2 } else { u = t - 2 } return u + t }"
+        "    function loop(n) { var x = 0, y = 1; for (var i = 0; i < n; i++) { var t = x; x = y; y = t + y; if (y > 50) break } return x + ':' + y }"
+        "    function cond(a) { var r = a > 0 ? (a > 10 ? 'big' : 'small') : (a < 0 ? 'neg' : 'zero'); return r + (a && a.toString()) }"
+        "    function logical(a, b) { var v = a && b || !a && 'na'; return v }"
+        "    var arr = []; for (var i = 0; i < 3; i++) arr.push(pick(i, i * 5, i % 2), cond(i * 7 - 7), logical(i, i * 2));"
+        "    return arr.join(',') + '|' + loop(5) + '|' + loop(100);"
+        "})()";
+    expectSameResultWithEveryByteCodeOptimizationPass(src, "-4,neg-7,na,2,zero0,2,27,small7,4|5:8|34:55");
+}
+
+TEST(ByteCodeOptimizer, ErrorLocation)
+{
+    // location info is computed again on the optimized stream, so it should be same with the unoptimized one
+    const char* src =
+        "function f(o) {\n"
+        "    var a = 1 + 2 * 3, b = a; b = b;\n"
+        "    for (var i = 0; i < 3; i++) { if (i < a) { continue } }\n"
+        "    return o.x.y + b;\n"
+        "}\n"
+        "f({ x: 1 }); f({});\n";
+    std::string expected = runWithByteCodeOptimizationPasses(VMInstanceRef::NoByteCodeOptimizationPass, src);
+    EXPECT_EQ(expected.find("Uncaught TypeError"), 0u) << expected;
+    expectSameResultWithEveryByteCodeOptimizationPass(src, expected);
+}
+
+TEST(VMInstance, FlushByteCode)
+{
+    VMInstanceRef* instance = g_context->vmInstance();
+    size_t maxCompiledByteCodeSize = instance->maxCompiledByteCodeSize();
+    size_t flushedCount = instance->flushedByteCodeBlockCount();
+
+    auto s = evalScript(g_context.get(), StringRef::createFromASCII("function coldFunction() { return 1 } function hotFunction() { return 2 } coldFunction() + hotFunction()"), StringRef::createFromASCII("test.js"), false);
+    EXPECT_EQ(s, "3");
+
+    // only cold functions are flushed
+    instance->setMaxCompiledByteCodeSize(0);
+    for (int i = 0; i < 4; i++) {
+        s = evalScript(g_context.get(), StringRef::createFromASCII("hotFunction()"), StringRef::createFromASCII("test.js"), false);
+        EXPECT_EQ(s, "2");
+        Memory::gc();
+    }
+    EXPECT_TRUE(instance->flushedByteCodeBlockCount() > flushedCount);
+
+    s = evalScript(g_context.get(), StringRef::createFromASCII("coldFunction() + hotFunction()"), StringRef::createFromASCII("test.js"), false);
+    EXPECT_EQ(s, "3");
+
+    instance->setMaxCompiledByteCodeSize(maxCompiledByteCodeSize);
+}
+
+#if defined(ENABLE_CODE_CACHE)
+// long enough to be cached (CODE_CACHE_MIN_SOURCE_LENGTH), and each function is compiled on its first call
+static std::string codeCacheTestSource()
+{
+    std::string src = "/*" + std::string(5000, '*') + "*/\n";
+    src += "function lazyAdd(a, b) { return a + b }\n"
+           "function lazyConcat(list) { var s = ''; for (var i = 0; i < list.length; i++) { s += list[i] } return s }\n"
+           "function lazyClosure(n) { return function(x) { return x * n } }\n"
+           "function lazyExtra() { return ':extra' }\n"
+           "lazyAdd(1, 2) + ':' + lazyConcat(['a', 'b', 'c']) + ':' + lazyClosure(3)(4) + (globalThis.callLazyExtra ? lazyExtra() : '')";
+    return src;
+}
+
+// runs codeCacheTestSource on each of `contextCount` Contexts of a fresh VMInstance using baseCacheDir
+static std::string runCodeCacheTestSource(const char* baseCacheDir, size_t contextCount, bool callLazyExtra, size_t& loadedCount)
+{
+    PersistentRefHolder<VMInstanceRef> instance = VMInstanceRef::create(new ShellPlatform(), nullptr, nullptr, baseCacheDir);
+    instance->setOnVMInstanceDelete([](VMInstanceRef* instance) {
+        delete instance->platform();
+    });
+
+    std::string src = codeCacheTestSource();
+    std::string result;
+    for (size_t i = 0; i < contextCount; i++) {
+        PersistentRefHolder<ContextRef> context = ContextRef::create(instance.get());
+        if (callLazyExtra) {
+            evalScript(context.get(), StringRef::createFromASCII("globalThis.callLazyExtra = true"), StringRef::createFromASCII("test.js"), false);
+        }
+        result += evalScript(context.get(), StringRef::createFromUTF8(src.data(), src.length()), StringRef::createFromASCII("codecache.js"), false);
+        result += ";";
+    }
+    loadedCount = instance->codeCacheLoadedByteCodeBlockCount();
+
+    // finish file writing and release the lock of cache directory for the next VMInstance
+    instance->clearCachesRelatedWithContext();
+    return result;
+}
+
+// the only cache data file of the cache directory
+static std::string codeCacheDataFilePath(const std::string& baseCacheDir)
+{
+    std::string cacheDir = baseCacheDir + "/Escargot-cache/";
+    std::string path;
+    DIR* dir = opendir(cacheDir.data());
+    if (dir) {
+        while (struct dirent* entry = readdir(dir)) {
+            std::string name = entry->d_name;
+            if (name != "." && name != ".." && name != "cache_list" && name.find('.') == std::string::npos) {
+                path = cacheDir + name;
+            }
+        }
+        closedir(dir);
+    }
+    return path;
+}
+
+static void removeCodeCacheTestDir(const std::string& baseCacheDir)
+{
+    std::string cacheDir = baseCacheDir + "/Escargot-cache/";
+    DIR* dir = opendir(cacheDir.data());
+    if (dir) {
+        while (struct dirent* entry = readdir(dir)) {
+            std::string name = entry->d_name;
+            if (name != "." && name != "..") {
+                unlink((cacheDir + name).data());
+            }
+        }
+        closedir(dir);
+    }
+    rmdir(cacheDir.data());
+    rmdir(baseCacheDir.data());
+}
+
+static long fileSize(const std::string& path)
+{
+    FILE* fp = fopen(path.data(), "rb");
+    if (!fp) {
+        return -1;
+    }
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    fclose(fp);
+    return size;
+}
+
+TEST(CodeCache, FunctionByteCode)
+{
+    char baseCacheDir[] = "/tmp/escargot-cctest-XXXXXX";
+    ASSERT_TRUE(mkdtemp(baseCacheDir));
+    size_t loadedCount;
+
+    // the first run stores the Script, then ByteCode of each function is appended when it is compiled
+    EXPECT_EQ(runCodeCacheTestSource(baseCacheDir, 1, false, loadedCount), "3:abc:12;");
+    EXPECT_EQ(loadedCount, 0u);
+    std::string dataFile = codeCacheDataFilePath(baseCacheDir);
+    ASSERT_FALSE(dataFile.empty());
+    long validSize = fileSize(dataFile);
+
+    // lazyAdd, lazyConcat, lazyClosure and the closure in it are loaded instead of being compiled
+    EXPECT_EQ(runCodeCacheTestSource(baseCacheDir, 1, false, loadedCount), "3:abc:12;");
+    EXPECT_EQ(loadedCount, 4u);
+    EXPECT_EQ(fileSize(dataFile), validSize);
+
+    // truncated tail record is discarded, and the function is compiled and stored again
+    ASSERT_EQ(truncate(dataFile.data(), validSize - 3), 0);
+    EXPECT_EQ(runCodeCacheTestSource(baseCacheDir, 1, false, loadedCount), "3:abc:12;");
+    EXPECT_EQ(loadedCount, 3u);
+    EXPECT_EQ(fileSize(dataFile), validSize);
+    EXPECT_EQ(runCodeCacheTestSource(baseCacheDir, 1, false, loadedCount), "3:abc:12;");
+    EXPECT_EQ(loadedCount, 4u);
+
+    // garbage after the last record is discarded
+    FILE* fp = fopen(dataFile.data(), "ab");
+    ASSERT_TRUE(fp);
+    std::string garbage(64, '\xa5');
+    fwrite(garbage.data(), 1, garbage.length(), fp);
+    fclose(fp);
+    EXPECT_EQ(runCodeCacheTestSource(baseCacheDir, 1, false, loadedCount), "3:abc:12;");
+    EXPECT_EQ(loadedCount, 4u);
+    EXPECT_EQ(fileSize(dataFile), validSize);
+
+    // broken data of a record with a valid header is detected by its checksum
+    fp = fopen(dataFile.data(), "r+b");
+    ASSERT_TRUE(fp);
+    fseek(fp, validSize - 2, SEEK_SET);
+    int ch = fgetc(fp);
+    fseek(fp, validSize - 2, SEEK_SET);
+    fputc(ch ^ 0xff, fp);
+    fclose(fp);
+    EXPECT_EQ(runCodeCacheTestSource(baseCacheDir, 1, false, loadedCount), "3:abc:12;");
+    EXPECT_EQ(loadedCount, 3u);
+    EXPECT_GT(fileSize(dataFile), validSize);
+    EXPECT_EQ(runCodeCacheTestSource(baseCacheDir, 1, false, loadedCount), "3:abc:12;");
+    EXPECT_EQ(loadedCount, 4u);
+
+    removeCodeCacheTestDir(baseCacheDir);
+}
+
+TEST(CodeCache, RemapGrownFile)
+{
+    char baseCacheDir[] = "/tmp/escargot-cctest-XXXXXX";
+    ASSERT_TRUE(mkdtemp(baseCacheDir));
+    size_t loadedCount;
+
+    EXPECT_EQ(runCodeCacheTestSource(baseCacheDir, 1, false, loadedCount), "3:abc:12;");
+    EXPECT_EQ(loadedCount, 0u);
+    std::string dataFile = codeCacheDataFilePath(baseCacheDir);
+    long sizeBefore = fileSize(dataFile);
+
+    // the first Context maps the data file and appends lazyExtra after that,
+    // then the second Context loads lazyExtra by mapping the grown file again
+    EXPECT_EQ(runCodeCacheTestSource(baseCacheDir, 2, true, loadedCount), "3:abc:12:extra;3:abc:12:extra;");
+    EXPECT_EQ(loadedCount, 4u + 5u);
+    EXPECT_GT(fileSize(dataFile), sizeBefore);
+
+    EXPECT_EQ(runCodeCacheTestSource(baseCacheDir, 1, true, loadedCount), "3:abc:12:extra;");
+    EXPECT_EQ(loadedCount, 5u);
+
+    removeCodeCacheTestDir(baseCacheDir);
+}
+
+static std::string readTestFile(const std::string& path)
+{
+    std::string content;
+    FILE* fp = fopen(path.data(), "rb");
+    if (fp) {
+        char buf[512];
+        size_t readSize;
+        while ((readSize = fread(buf, 1, sizeof(buf), fp)) > 0) {
+            content.append(buf, readSize);
+        }
+        fclose(fp);
+    }
+    return content;
+}
+
+static void postCodeCacheWorkerTask(CodeCacheWorker& worker, CodeCacheWorker::TaskType type, const std::string& path, const std::string& data)
+{
+    CodeCacheWorker::Task task(type, path);
+    task.m_data.assign(data.begin(), data.end());
+    worker.postTask(std::move(task));
+}
+
+TEST(CodeCache, Worker)
+{
+    char dir[] = "/tmp/escargot-cctest-XXXXXX";
+    ASSERT_TRUE(mkdtemp(dir));
+    std::string fileA = std::string(dir) + "/a";
+    std::string fileB = std::string(dir) + "/b";
+    std::string fileC = std::string(dir) + "/c";
+
+    std::string expectedA = "header;";
+    std::string expectedB;
+    {
+        CodeCacheWorker worker;
+        postCodeCacheWorkerTask(worker, CodeCacheWorker::TaskType::WRITE_FILE, fileA, "header;");
+        // appends to different files are not merged, so posting blocks whenever the queue is full
+        for (size_t i = 0; i < 40; i++) {
+            std::string data = std::to_string(i) + ",";
+            if (i % 2) {
+                expectedB += data;
+            } else {
+                expectedA += data;
+            }
+            postCodeCacheWorkerTask(worker, CodeCacheWorker::TaskType::APPEND_FILE, i % 2 ? fileB : fileA, data);
+        }
+        postCodeCacheWorkerTask(worker, CodeCacheWorker::TaskType::WRITE_FILE, fileC, "removed");
+        postCodeCacheWorkerTask(worker, CodeCacheWorker::TaskType::REMOVE_FILE, fileC, "");
+
+        worker.waitForIdle();
+        EXPECT_EQ(readTestFile(fileA), expectedA);
+        EXPECT_EQ(readTestFile(fileB), expectedB);
+        EXPECT_NE(access(fileC.data(), F_OK), 0);
+        EXPECT_FALSE(worker.hasFailed());
+
+        // large appends are queued as separate tasks instead of growing one task without limit
+        // (each append is larger than half of CODE_CACHE_WORKER_MERGED_TASK_SIZE_MAX, and there are more than CODE_CACHE_WORKER_QUEUE_SIZE)
+        for (size_t i = 0; i < 40; i++) {
+            std::string data(1024 * 200, 'a' + (i % 26));
+            expectedB += data;
+            postCodeCacheWorkerTask(worker, CodeCacheWorker::TaskType::APPEND_FILE, fileB, data);
+        }
+        worker.waitForIdle();
+        EXPECT_EQ(readTestFile(fileB), expectedB);
+        EXPECT_FALSE(worker.hasFailed());
+
+        // consecutive appends to the same file are merged, and stop finishes them before joining
+        for (size_t i = 0; i < 40; i++) {
+            std::string data = std::to_string(i) + ";";
+            expectedB += data;
+            postCodeCacheWorkerTask(worker, CodeCacheWorker::TaskType::APPEND_FILE, fileB, data);
+        }
+        worker.stop();
+        EXPECT_EQ(readTestFile(fileA), expectedA);
+        EXPECT_EQ(readTestFile(fileB), expectedB);
+        EXPECT_FALSE(worker.hasFailed());
+
+        // worker is launched again by a new task
+        expectedA += "restarted";
+        postCodeCacheWorkerTask(worker, CodeCacheWorker::TaskType::APPEND_FILE, fileA, "restarted");
+        worker.waitForIdle();
+        EXPECT_EQ(readTestFile(fileA), expectedA);
+
+        postCodeCacheWorkerTask(worker, CodeCacheWorker::TaskType::APPEND_FILE, std::string(dir) + "/nonexistent/d", "fail");
+        worker.waitForIdle();
+        EXPECT_TRUE(worker.hasFailed());
+    }
+
+    unlink(fileA.data());
+    unlink(fileB.data());
+    rmdir(dir);
+}
+#endif
+
+// bdwgc cannot leave incremental mode once entered, so IncrementalGC tests run in a separate process
+// (tools/run-tests.py runs them with --gtest_filter=IncrementalGC.*) and other tests keep stop-the-world collections
+TEST(IncrementalGC, FlushByteCode)
+{
+    VMInstanceRef* instance = g_context->vmInstance();
+    size_t maxCompiledByteCodeSize = instance->maxCompiledByteCodeSize();
+
+    auto s = evalScript(g_context.get(), StringRef::createFromASCII("function coldIncrementalFunction() { var a = [1, 2, 3]; return a.map(function(v) { return v * 2 }).join() } function hotIncrementalFunction() { return 2 }"
+                                                                  "coldIncrementalFunction() + hotIncrementalFunction()"),
+                        StringRef::createFromASCII("test.js"), false);
+    EXPECT_EQ(s, "2,4,62");
+
+    Memory::setGCPauseBudget(1000);
+    instance->setMaxCompiledByteCodeSize(0);
+    size_t flushedCount = instance->flushedByteCodeBlockCount();
+    size_t regeneratedCount = instance->regeneratedByteCodeBlockCount();
+
+    // blocks are detached on the first MARK_START of each collection, before any slice marks them
+    // (Memory::gc is not used here to check collections which are done only in slices)
+    for (int i = 0; i < 6; i++) {
+        s = evalScript(g_context.get(), StringRef::createFromASCII("var garbage; for (var i = 0; i < 100000; i++) { garbage = { v: i, s: 'g' + i } } hotIncrementalFunction()"),
+                       StringRef::createFromASCII("test.js"), false);
+        EXPECT_EQ(s, "2");
+        bool inProgress = true;
+        for (int j = 0; j < 1000 && inProgress; j++) {
+            inProgress = Memory::performIdleGCWork(std::chrono::steady_clock::now() + std::chrono::milliseconds(10));
+        }
+    }
+    EXPECT_TRUE(instance->flushedByteCodeBlockCount() > flushedCount);
+
+    // reclaimed bytecode is generated again
+    s = evalScript(g_context.get(), StringRef::createFromASCII("coldIncrementalFunction() + hotIncrementalFunction()"), StringRef::createFromASCII("test.js"), false);
+    EXPECT_EQ(s, "2,4,62");
+    EXPECT_TRUE(instance->regeneratedByteCodeBlockCount() > regeneratedCount);
+
+    instance->setMaxCompiledByteCodeSize(maxCompiledByteCodeSize);
+}
+
+TEST(VMInstance, ContextSnapshot)
+{
+    VMInstanceRef* instance = g_context->vmInstance();
+    EXPECT_TRUE(instance->isContextSnapshotEnabled());
+    // builtins of g_context were recorded, so later Contexts are copied from the snapshot
+    EXPECT_TRUE(instance->hasContextSnapshot());
+
+    const char* check = "Object.getPrototypeOf([]) === Array.prototype && Object.getPrototypeOf(Array) === Function.prototype"
+                        " && Array.prototype.map.call([1, 2], function(v) { return v * 2 }).join() === '2,4'"
+                        " && new Map([[1, 2]]).get(1) === 2 && String.prototype.length === 0 && Object(Symbol.iterator) instanceof Symbol"
+                        " && typeof Object.getOwnPropertyDescriptor(Function.prototype, 'caller').get === 'function'"
+                        " && Object.getOwnPropertyDescriptor(Function.prototype, 'caller').get === Object.getOwnPropertyDescriptor(Function.prototype, 'arguments').get"
+                        " && Reflect.ownKeys(globalThis).length";
+
+    auto expected = evalScript(g_context.get(), StringRef::createFromASCII(check), StringRef::createFromASCII("test.js"), false);
+
+    // builtins of a copied Context should not be shared with others
+    PersistentRefHolder<ContextRef> copied = ContextRef::create(instance);
+    auto s = evalScript(copied.get(), StringRef::createFromASCII(check), StringRef::createFromASCII("test.js"), false);
+    EXPECT_EQ(s, expected);
+    s = evalScript(copied.get(), StringRef::createFromASCII("Array.prototype.foo = 1; Math.bar = 2; Array.prototype.foo + Math.bar"), StringRef::createFromASCII("test.js"), false);
+    EXPECT_EQ(s, "3");
+    s = evalScript(g_context.get(), StringRef::createFromASCII("typeof Array.prototype.foo + typeof Math.bar"), StringRef::createFromASCII("test.js"), false);
+    EXPECT_EQ(s, "undefinedundefined");
+    PersistentRefHolder<ContextRef> another = ContextRef::create(instance);
+    s = evalScript(another.get(), StringRef::createFromASCII("typeof Array.prototype.foo + typeof Math.bar + [1, 2].map(function(v) { return v + 1 })"), StringRef::createFromASCII("test.js"), false);
+    EXPECT_EQ(s, "undefinedundefined2,3");
+
+    // every builtin constructor is present and owned by each Context
+    const char* builtins = "['Object', 'Function', 'Array', 'String', 'Number', 'Boolean', 'Symbol', 'BigInt', 'Date', 'RegExp', 'Error', 'TypeError',"
+                           " 'Promise', 'Proxy', 'Map', 'Set', 'WeakMap', 'WeakRef', 'ArrayBuffer', 'Uint8Array', 'DataView']"
+                           ".filter(function(name) { return typeof globalThis[name] === 'function' && globalThis[name].prototype !== undefined"
+                           " && globalThis[name].name === name }).length + ',' + typeof JSON.parse + typeof Math.max + typeof Reflect.ownKeys";
+    expected = evalScript(g_context.get(), StringRef::createFromASCII(builtins), StringRef::createFromASCII("test.js"), false);
+    EXPECT_EQ(expected, "21,functionfunctionfunction");
+    s = evalScript(copied.get(), StringRef::createFromASCII(builtins), StringRef::createFromASCII("test.js"), false);
+    EXPECT_EQ(s, expected);
+
+    auto arrayPrototypeOf = [](ContextRef* context) -> ValueRef* {
+        return Evaluator::execute(context, [](ExecutionStateRef* state) -> ValueRef* {
+                   ObjectRef* array = state->context()->globalObject()->get(state, StringRef::createFromASCII("Array"))->asObject();
+                   return array->get(state, StringRef::createFromASCII("prototype"));
+               })
+            .result;
+    };
+    ValueRef* originalArrayPrototype = arrayPrototypeOf(g_context.get());
+    ValueRef* copiedArrayPrototype = arrayPrototypeOf(copied.get());
+    EXPECT_TRUE(originalArrayPrototype->isObject());
+    EXPECT_TRUE(copiedArrayPrototype->isObject());
+    EXPECT_NE(originalArrayPrototype, copiedArrayPrototype);
+    EXPECT_NE(copiedArrayPrototype, arrayPrototypeOf(another.get()));
+
+    instance->setContextSnapshotEnabled(false);
+    EXPECT_FALSE(instance->hasContextSnapshot());
+    PersistentRefHolder<ContextRef> installed = ContextRef::create(instance);
+    s = evalScript(installed.get(), StringRef::createFromASCII(check), StringRef::createFromASCII("test.js"), false);
+    EXPECT_EQ(s, evalScript(g_context.get(), StringRef::createFromASCII(check), StringRef::createFromASCII("test.js"), false));
+    s = evalScript(installed.get(), StringRef::createFromASCII(builtins), StringRef::createFromASCII("test.js"), false);
+    EXPECT_EQ(s, expected);
+
+    // the next Context records the snapshot again
+    instance->setContextSnapshotEnabled(true);
+    PersistentRefHolder<ContextRef> recorded = ContextRef::create(instance);
+    EXPECT_TRUE(instance->hasContextSnapshot());
+}
+
+TEST(EncodedValue, Number)
+{
+    // numbers stored in object slots, array elements and environment records
+    const char* src = "var numberTest = { a: 0.5, b: -0, c: NaN, d: 2147483648, e: -1 };"
+                      "var numberArray = [0.5, -0, NaN, Infinity, 1 << 30];"
+                      "function numberClosure() { var x = 0.25; return function() { x += 0.5; return x } }"
+                      "var numberCounter = numberClosure(); numberCounter(); numberCounter();"
+                      "numberTest.a += 1; numberArray[0] *= 3;"
+                      "[numberTest.a, 1 / numberTest.b, numberTest.c, numberTest.d, numberTest.e, numberArray[0], 1 / numberArray[1], numberArray[2], numberArray[3], numberArray[4], numberCounter()].join()";
+    auto s = evalScript(g_context.get(), StringRef::createFromASCII(src), StringRef::createFromASCII("test.js"), false);
+    EXPECT_EQ(s, "1.5,-Infinity,NaN,2147483648,-1,1.5,-Infinity,NaN,Infinity,1073741824,1.75");
+
+    ValueRef* d = ValueRef::create(0.5);
+    EXPECT_TRUE(d->isNumber());
+    EXPECT_EQ(d->asNumber(), 0.5);
+    auto result = Evaluator::execute(g_context.get(), [](ExecutionStateRef* state) -> ValueRef* {
+        // the closure value lives in an environment record
+        ValueRef* counter = state->context()->globalObject()->get(state, StringRef::createFromASCII("numberCounter"));
+        return counter->call(state, ValueRef::createUndefined(), 0, nullptr);
+    });
+    EXPECT_TRUE(result.isSuccessful());
+    ValueRef* r = result.result;
+    EXPECT_EQ(r->asNumber(), 2.25);
+    if (sizeof(void*) == 8) {
+        // doubles are NaN-boxed in EncodedValue (registers, call results and ValueRef) on every 64-bit build
+        // object slots and environment records still box doubles with ESCARGOT_USE_32BIT_IN_64BIT (EncodedSmallValue is 32 bits wide)
+        // so this checks values which are passed as EncodedValue only
+        EXPECT_FALSE(d->isStoredInHeap());
+        EXPECT_FALSE(r->isStoredInHeap());
+        EXPECT_FALSE(ValueRef::create(std::numeric_limits<double>::quiet_NaN())->isStoredInHeap());
+    } else {
+        EXPECT_TRUE(d->isStoredInHeap());
+    }
+    ValueRef* i = ValueRef::create(-7);
+    EXPECT_TRUE(i->isInt32());
+    EXPECT_EQ(i->asInt32(), -7);
+    EXPECT_FALSE(i->isStoredInHeap());
+}
+
+TEST(ValueVectorRef, Number)
+{
+    // ValueVectorRef elements can be narrower than ValueRef, so values are converted in both directions
+    ValueVectorRef* v = ValueVectorRef::create();
+    v->pushBack(ValueRef::create(0.5));
+    v->pushBack(ValueRef::create(-7));
+    v->insert(0, ValueRef::create(2147483648.0));
+    v->pushBack(ValueRef::create(std::numeric_limits<double>::quiet_NaN()));
+    v->set(3, ValueRef::create(1 << 30));
+    v->pushBack(StringRef::createFromASCII("str"));
+
+    EXPECT_EQ(v->size(), 5u);
+    EXPECT_TRUE(v->at(0)->isNumber());
+    EXPECT_EQ(v->at(0)->asNumber(), 2147483648.0);
+    EXPECT_TRUE(v->at(1)->isNumber());
+    EXPECT_EQ(v->at(1)->asNumber(), 0.5);
+    EXPECT_TRUE(v->at(2)->isInt32());
+    EXPECT_EQ(v->at(2)->asInt32(), -7);
+    EXPECT_TRUE(v->at(3)->isInt32());
+    EXPECT_EQ(v->at(3)->asInt32(), 1 << 30);
+    EXPECT_TRUE(v->at(4)->isString());
+    EXPECT_EQ(v->at(4)->asString()->toStdUTF8String(), "str");
+
+    v->pushBack(ValueRef::create(std::numeric_limits<double>::quiet_NaN()));
+    EXPECT_TRUE(v->at(5)->isNumber());
+    EXPECT_TRUE(std::isnan(v->at(5)->asNumber()));
+}
+
+TEST(ArrayObject, ElementKind)
+{
+    // element kind changes int32 -> double -> generic while values and holes are kept
+    const char* src = "var kindArray = [1, 2, 3]; kindArray[5] = 4;"
+                      "kindArray[1] = -2147483648; kindArray[2] = 0.5; kindArray[6] = NaN; kindArray[7] = -0;"
+                      "var kindResult = [kindArray.length, 3 in kindArray, kindArray[1], kindArray[2], kindArray[6], 1 / kindArray[7]];"
+                      "kindArray[0] = 'str'; delete kindArray[5];"
+                      "kindResult.push(kindArray[0], 5 in kindArray, kindArray[2]);"
+                      "var kindSorted = [3.5, 1, 2].sort(); var kindSpread = [0, ...kindSorted, 4];"
+                      "kindResult.push(kindSorted.join(':'), kindSpread.join(':'), Math.max(...kindSpread));"
+                      "kindResult.join()";
+    auto s = evalScript(g_context.get(), StringRef::createFromASCII(src), StringRef::createFromASCII("test.js"), false);
+    EXPECT_EQ(s, "8,false,-2147483648,0.5,NaN,-Infinity,str,false,0.5,1:2:3.5,0:1:2:3.5:4,4");
+}
+
+TEST(String, Search)
+{
+    // indexOf, lastIndexOf and split are compared with naive search on 8-bit and 16-bit strings
+    // long needles in long strings are searched with Boyer-Moore-Horspool
+    const char* src = "function searchIndexOf(s, t, from) { for (var i = from; i + t.length <= s.length; i++) if (s.substring(i, i + t.length) === t) return i; return -1; }"
+                      "function searchLastIndexOf(s, t, from) { for (var i = Math.min(from, s.length - t.length); i >= 0; i--) if (s.substring(i, i + t.length) === t) return i; return -1; }"
+                      "var searchHaystack = 'ab'.repeat(400) + 'abcabd\\u00e9' + 'x'.repeat(600) + 'abcabdabcabd\\u00e9' + 'ab'.repeat(10);"
+                      "var searchHaystacks = [searchHaystack, searchHaystack + '\\u0100', searchHaystack.substring(0, 30), '\\u0100abab\\u0101'.substring(0, 5)];"
+                      "var searchNeedles = ['abd', 'abcabdabcabd\\u00e9', 'xxxxxxxxxxab', '\\u0100', '\\u0100a', 'ab\\u0100'.substring(0, 2), 'x', 'y', '', 'bab', '\\u00e9x'];"
+                      "var searchFailures = 0;"
+                      "searchHaystacks.forEach(function(s) { searchNeedles.forEach(function(t) {"
+                      "    [0, 1, 5, 799, 800, 806, s.length - 3, s.length, s.length + 1].forEach(function(from) {"
+                      "        if (s.indexOf(t, from) !== searchIndexOf(s, t, Math.min(from, s.length))) searchFailures++;"
+                      "        if (s.lastIndexOf(t, from) !== searchLastIndexOf(s, t, from)) searchFailures++;"
+                      "    });"
+                      "    if (t.length && s.split(t).join(t) !== s) searchFailures++;"
+                      "    if (s.includes(t) !== (searchIndexOf(s, t, 0) >= 0)) searchFailures++;"
+                      "}); });"
+                      "[searchFailures, 'abcab'.split('ab').length, 'abc'.split('').join(), ''.split('').length, ''.split('a').length, 'a\\u0100ba'.replaceAll('a', '-')].join()";
+    auto s = evalScript(g_context.get(), StringRef::createFromASCII(src), StringRef::createFromASCII("test.js"), false);
+    EXPECT_EQ(s, "0,3,a,b,c,0,1,-\xc4\x80" "b-");
+}
+
+TEST(AtomicString, Map)
+{
+    // property names are interned through the atomic string map while it grows,
+    // and 16-bit strings find 8-bit atomic strings with same content
+    const char* src = "var atomicObject = {}; for (var i = 0; i < 30000; i++) atomicObject['atomicKey' + i] = i;"
+                      "var atomicSum = 0; for (var i = 0; i < 30000; i++) atomicSum += atomicObject['atomicKey' + i];"
+                      "var atomicWide = 'atomicKey12345\\u0100'.substring(0, 14);"
+                      "atomicObject.latin1\\u00e9 = 'x';"
+                      "var atomicResult = [atomicSum, atomicObject[atomicWide], atomicObject['latin1\\u00e9\\u0100'.substring(0, 7)], Object.keys(atomicObject).length];"
+                      "atomicObject = undefined; atomicResult.join()";
+    auto s = evalScript(g_context.get(), StringRef::createFromASCII(src), StringRef::createFromASCII("test.js"), false);
+    EXPECT_EQ(s, "449985000,12345,x,30001");
+}
+
+TEST(JSON, Parse)
+{
+    // objects of the same depth share property names and structure, so differences should not leak between them
+    const char* src = "var jsonRecords = JSON.parse('[{\"a\":1,\"b\":{\"c\":[1,2.5,\"s\"]}},{\"a\":2,\"b\":{\"c\":[]}},{\"b\":3,\"a\":4},{\"a\":5,\"a\":6},{\"a\":7,\"b\":8,\"c\":9}]');"
+                      "var jsonResult = jsonRecords.map(function(r) { return Object.keys(r).join('') + '=' + JSON.stringify(r) });"
+                      "var jsonSpecial = JSON.parse('{\"__proto__\":1,\"0\":2,\"\\u00e9\\uac00\":3}');"
+                      "jsonResult.push(Object.getPrototypeOf(jsonSpecial) === Object.prototype, jsonSpecial.__proto__, jsonSpecial[0], jsonSpecial['\\u00e9\\uac00']);"
+                      "jsonResult.push(JSON.parse(' [\"\\uac00\", 9007199254740993, -0]').map(function(v) { return typeof v == 'string' ? v.charCodeAt(0) : v }).join(':'));"
+                      "jsonResult.push(JSON.parse(Array(100001).join('[') + Array(100001).join(']')).length);"
+                      "jsonResult.push(JSON.stringify(JSON.parse('[1,[2,{\"a\":3}]]', function(k, v) { return typeof v == 'number' ? v * 2 : v })));"
+                      "try { JSON.parse(Array(100001).join('[') + Array(100001).join(']'), function(k, v) { return v }) } catch (e) { jsonResult.push(e instanceof RangeError) }"
+                      "try { JSON.parse('{\"a\":1,}') } catch (e) { jsonResult.push(e instanceof SyntaxError) }"
+                      "jsonResult.join()";
+    auto s = evalScript(g_context.get(), StringRef::createFromASCII(src), StringRef::createFromASCII("test.js"), false);
+    EXPECT_EQ(s, "ab={\"a\":1,\"b\":{\"c\":[1,2.5,\"s\"]}},ab={\"a\":2,\"b\":{\"c\":[]}},ba={\"b\":3,\"a\":4},a={\"a\":6},abc={\"a\":7,\"b\":8,\"c\":9},"
+                 "true,1,2,3,44032:9007199254740992:0,1,[2,[4,{\"a\":6}]],true,true");
+}
+
+TEST(JSON, Stringify)
+{
+    // anything which can run user code or reorder keys should give the same result with the generic steps
+    const char* src = "var jsonOut = [];"
+                      "jsonOut.push(JSON.stringify([{ a: 1, b: 'x\"y\\\\z\\n\\u0001\\u00e9', c: [1.5, , NaN, undefined, null] }, { a: -0, b: '\\uac00long string without escape', c: [] }]));"
+                      "jsonOut.push(JSON.stringify({ b: 1, 2: 2, 1: 1, f: function() { }, s: Symbol(), u: undefined, n: { d: new Date(0), g: { get v() { return 3 } } } }));"
+                      "var jsonHidden = { v: 1 }; Object.defineProperty(jsonHidden, 'h', { value: 2, enumerable: false });"
+                      "jsonOut.push(JSON.stringify([jsonHidden, { v: 2, toJSON: function() { return 'own' } }]));"
+                      "Array.prototype[1] = 'proto';"
+                      "jsonOut.push(JSON.stringify([0, , 2]));"
+                      "delete Array.prototype[1];"
+                      "var jsonLate = { toJSON: function() { Object.prototype.toJSON = function() { return 'late' }; return 1 } };"
+                      "jsonOut.push(JSON.stringify([{ x: 1 }, jsonLate, { x: 2 }]));"
+                      "delete Object.prototype.toJSON;"
+                      "var jsonCycle = { a: [] }; jsonCycle.a.push(jsonCycle);"
+                      "try { JSON.stringify(jsonCycle) } catch (e) { jsonOut.push(e instanceof TypeError) }"
+                      "jsonOut.join('|')";
+    auto s = evalScript(g_context.get(), StringRef::createFromASCII(src), StringRef::createFromASCII("test.js"), false);
+    EXPECT_EQ(s, "[{\"a\":1,\"b\":\"x\\\"y\\\\z\\n\\u0001\xc3\xa9\",\"c\":[1.5,null,null,null,null]},{\"a\":0,\"b\":\"\xea\xb0\x80long string without escape\",\"c\":[]}]|"
+                 "{\"1\":1,\"2\":2,\"b\":1,\"n\":{\"d\":\"1970-01-01T00:00:00.000Z\",\"g\":{\"v\":3}}}|"
+                 "[{\"v\":1},\"own\"]|"
+                 "[0,\"proto\",2]|"
+                 "[{\"x\":1},1,\"late\"]|"
+                 "true");
+}
+
+struct JSONStreamTestData {
+    std::string m_input;
+    size_t m_position;
+    std::string m_output;
+    size_t m_chunkCount;
+};
+
+TEST(JSON, Stream)
+{
+    // input is given 5 bytes at a time, so tokens and UTF-8 sequences are split between chunks
+    JSONStreamTestData data = { "[{\"id\":1,\"s\":\"\xea\xb0\x80\xea\xb0\x80\"},{\"id\":2,\"s\":[true,null]}, 3.5 ,\"end\"]", 0, std::string(), 0 };
+    auto r = Evaluator::execute(g_context.get(), [](ExecutionStateRef* state, JSONStreamTestData* data) -> ValueRef* {
+        JSONRef::parse(state, [](char* buffer, size_t bufferSize, void* data) -> size_t {
+            JSONStreamTestData* testData = (JSONStreamTestData*)data;
+            size_t length = std::min(std::min(bufferSize, (size_t)5), testData->m_input.length() - testData->m_position);
+            memcpy(buffer, testData->m_input.data() + testData->m_position, length);
+            testData->m_position += length;
+            return length;
+        },
+                       [](ExecutionStateRef* state, ValueRef* element, void* data) -> bool {
+                           JSONStreamTestData* testData = (JSONStreamTestData*)data;
+                           JSONRef::stringify(state, element, [](const char* chunk, size_t length, void* data) {
+                               ((JSONStreamTestData*)data)->m_output.append(chunk, length);
+                           },
+                                              data);
+                           testData->m_output += '|';
+                           return true;
+                       },
+                       data);
+        return ValueRef::createUndefined();
+    },
+                                &data);
+    EXPECT_TRUE(r.isSuccessful());
+    EXPECT_EQ(data.m_output, "{\"id\":1,\"s\":\"\xea\xb0\x80\xea\xb0\x80\"}|{\"id\":2,\"s\":[true,null]}|3.5|\"end\"|");
+
+    // large output is written in several chunks which are same with JSON.stringify when joined
+    data.m_output.clear();
+    r = Evaluator::execute(g_context.get(), [](ExecutionStateRef* state, JSONStreamTestData* data) -> ValueRef* {
+        auto script = state->context()->scriptParser()->initializeScript(StringRef::createFromASCII("var jsonStreamValue = []; for (var i = 0; i < 20000; i++) jsonStreamValue.push({ i: i, s: 'item' + i });"
+                                                                                                     "jsonStreamValue"),
+                                                                         StringRef::createFromASCII("test.js"), false)
+                          .fetchScriptThrowsExceptionIfParseError(state);
+        JSONRef::stringify(state, script->execute(state), [](const char* chunk, size_t length, void* data) {
+            ((JSONStreamTestData*)data)->m_output.append(chunk, length);
+            ((JSONStreamTestData*)data)->m_chunkCount++;
+        },
+                           data);
+        return ValueRef::createUndefined();
+    },
+                           &data);
+    EXPECT_TRUE(r.isSuccessful());
+    EXPECT_GT(data.m_chunkCount, 1u);
+    EXPECT_EQ(data.m_output, evalScript(g_context.get(), StringRef::createFromASCII("JSON.stringify(jsonStreamValue)"), StringRef::createFromASCII("test.js"), false));
+    evalScript(g_context.get(), StringRef::createFromASCII("jsonStreamValue = undefined"), StringRef::createFromASCII("test.js"), false);
+
+    // syntax error is thrown after the elements before it are given
+    data.m_input = "[1, 2, }";
+    data.m_position = 0;
+    data.m_output.clear();
+    r = Evaluator::execute(g_context.get(), [](ExecutionStateRef* state, JSONStreamTestData* data) -> ValueRef* {
+        JSONRef::parse(state, [](char* buffer, size_t bufferSize, void* data) -> size_t {
+            JSONStreamTestData* testData = (JSONStreamTestData*)data;
+            size_t length = std::min(bufferSize, testData->m_input.length() - testData->m_position);
+            memcpy(buffer, testData->m_input.data() + testData->m_position, length);
+            testData->m_position += length;
+            return length;
+        },
+                       [](ExecutionStateRef* state, ValueRef* element, void* data) -> bool {
+                           ((JSONStreamTestData*)data)->m_output += element->toString(state)->toStdUTF8String();
+                           return true;
+                       },
+                       data);
+        return ValueRef::createUndefined();
+    },
+                           &data);
+    EXPECT_FALSE(r.isSuccessful());
+    EXPECT_EQ(data.m_output, "12");
+}
+
+TEST(Memory, AllocationCache)
+{
+    // objects from cached free lists should survive gc like others
+    auto s = evalScript(g_context.get(), StringRef::createFromASCII("var allocationCacheTest = []; for (var i = 0; i < 10000; i++) { allocationCacheTest.push({ v: i + 0.5 }, [i], function() { return i }) } allocationCacheTest.length"), StringRef::createFromASCII("test.js"), false);
+    EXPECT_EQ(s, "30000");
+    for (int i = 0; i < 3; i++) {
+        evalScript(g_context.get(), StringRef::createFromASCII("for (var i = 0; i < 10000; i++) { ({ v: i + 0.5 }); [i] }"), StringRef::createFromASCII("test.js"), false);
+        Memory::gc();
+    }
+    s = evalScript(g_context.get(), StringRef::createFromASCII("allocationCacheTest[29997].v + allocationCacheTest[29998][0] + allocationCacheTest[29999]()"), StringRef::createFromASCII("test.js"), false);
+    EXPECT_EQ(s, "29998.5");
+    evalScript(g_context.get(), StringRef::createFromASCII("allocationCacheTest = undefined"), StringRef::createFromASCII("test.js"), false);
+}
+
+TEST(Memory, HeapSnapshot)
+{
+    evalScript(g_context.get(), StringRef::createFromASCII("class HeapSnapshotTest { }; var heapSnapshotTest = [new HeapSnapshotTest(), new HeapSnapshotTest()]"), StringRef::createFromASCII("test.js"), false);
+
+    const char* path = "heap_snapshot_test.txt";
+    EXPECT_TRUE(Memory::takeHeapSnapshot(path));
+
+    FILE* fp = fopen(path, "r");
+    ASSERT_TRUE(fp);
+    char line[1024];
+    ASSERT_TRUE(fgets(line, sizeof(line), fp));
+    EXPECT_STREQ(line, "escargot-heap-snapshot 1\n");
+    size_t instanceCount = 0;
+    size_t edgeCount = 0;
+    while (fgets(line, sizeof(line), fp)) {
+        if (strstr(line, " Object HeapSnapshotTest\n")) {
+            instanceCount++;
+        } else if (!strncmp(line, "edge ", 5)) {
+            edgeCount++;
+        }
+    }
+    fclose(fp);
+    remove(path);
+
+    EXPECT_EQ(instanceCount, 2u);
+    EXPECT_GT(edgeCount, 0u);
+    evalScript(g_context.get(), StringRef::createFromASCII("heapSnapshotTest = undefined"), StringRef::createFromASCII("test.js"), false);
+}
+
+TEST(Memory, AllocationProfiler)
+{
+    Memory::startAllocationProfiler(1024);
+    evalScript(g_context.get(), StringRef::createFromASCII("function allocationProfilerTest() { var r = []; for (var i = 0; i < 10000; i++) { r.push([i, i + 1]) } return r.length } allocationProfilerTest()"), StringRef::createFromASCII("profiler.js"), false);
+    evalScript(g_context.get(), StringRef::createFromASCII("function stringProfilerTest() { var s = ''; for (var i = 0; i < 20000; i++) { s += 'abcdefghijklmnopqrstuvwxyz' } return s.length } stringProfilerTest()"), StringRef::createFromASCII("profiler.js"), false);
+
+    const char* path = "allocation_profile_test.txt";
+    EXPECT_TRUE(Memory::stopAllocationProfiler(path));
+    EXPECT_FALSE(Memory::stopAllocationProfiler(path));
+
+    FILE* fp = fopen(path, "r");
+    ASSERT_TRUE(fp);
+    char line[1024];
+    size_t sampledBytes = 0;
+    size_t sampledStringBytes = 0;
+    while (fgets(line, sizeof(line), fp)) {
+        // e.g. "(global) (profiler.js:1);allocationProfilerTest (profiler.js:1);[Array] 1056"
+        if (strstr(line, ";allocationProfilerTest (profiler.js:1);[Array] ")) {
+            sampledBytes += strtoul(strrchr(line, ' ') + 1, nullptr, 10);
+        }
+        // string concatenation is sampled even though the loop creates no object
+        if (strstr(line, ";stringProfilerTest (profiler.js:1);[String] ")) {
+            sampledStringBytes += strtoul(strrchr(line, ' ') + 1, nullptr, 10);
+        }
+    }
+    fclose(fp);
+    remove(path);
+
+    EXPECT_GT(sampledBytes, 0u);
+    EXPECT_GT(sampledStringBytes, 0u);
+}
+
+TEST(IncrementalGC, Basic)
+{
+    Memory::setGCPauseBudget(1000);
+
+    auto s = evalScript(g_context.get(), StringRef::createFromASCII("var incrementalGCTest = []; for (var i = 0; i < 100000; i++) { incrementalGCTest.push({ v: i, s: 'item' + i }) } incrementalGCTest.length"), StringRef::createFromASCII("test.js"), false);
+    EXPECT_EQ(s, "100000");
+
+    bool inProgress = true;
+    for (int i = 0; i < 1000 && inProgress; i++) {
+        inProgress = Memory::performIdleGCWork(std::chrono::steady_clock::now() + std::chrono::milliseconds(10));
+        evalScript(g_context.get(), StringRef::createFromASCII("incrementalGCTest[100].x = { y: 1 }"), StringRef::createFromASCII("test.js"), false);
+    }
+    EXPECT_FALSE(inProgress);
+
+    // objects written between slices should survive
+    s = evalScript(g_context.get(), StringRef::createFromASCII("incrementalGCTest[100].x.y + incrementalGCTest[99999].s"), StringRef::createFromASCII("test.js"), false);
+    EXPECT_EQ(s, "1item99999");
+    evalScript(g_context.get(), StringRef::createFromASCII("incrementalGCTest = undefined"), StringRef::createFromASCII("test.js"), false);
+
+    // 0 clears the time limit only, gc stays in incremental mode
+    Memory::setGCPauseBudget(0);
+    Memory::gc();
+}
+
+#if defined(ENABLE_THREADING)
+TEST(VMInstance, Threads)
+{
+    const int threadCount = 4;
+    std::vector<std::string> results(threadCount);
+    std::vector<std::thread> threads;
+
+    for (int i = 0; i < threadCount; i++) {
+        threads.push_back(std::thread([i, &results]() {
+            Globals::initializeThread();
+            {
+                PersistentRefHolder<VMInstanceRef> instance = VMInstanceRef::create(new ShellPlatform());
+                instance->setOnVMInstanceDelete([](VMInstanceRef* instance) {
+                    delete instance->platform();
+                });
+                PersistentRefHolder<ContextRef> context = ContextRef::create(instance.get());
+
+                // each thread runs its own garbage-producing kernel without any lock
+                results[i] = evalScript(context.get(), StringRef::createFromASCII("var sum = 0; for (var i = 0; i < 200000; i++) { var o = { v: i, s: 'a' + (i % 10) }; sum = (sum + o.v * o.s.length) % 1000003 } sum"),
+                                        StringRef::createFromASCII("test.js"), false);
+            }
+            Globals::finalizeThread();
+        }));
+    }
+
+    auto expected = evalScript(g_context.get(), StringRef::createFromASCII("var sum = 0; for (var i = 0; i < 200000; i++) { var o = { v: i, s: 'a' + (i % 10) }; sum = (sum + o.v * o.s.length) % 1000003 } sum"),
+                               StringRef::createFromASCII("test.js"), false);
+    for (int i = 0; i < threadCount; i++) {
+        threads[i].join();
+        EXPECT_EQ(results[i], expected);
+    }
+}
+
+TEST(VMInstance, FinalizeAfterThreadExit)
+{
+    // BigInts and wasm objects created on a worker thread are finalized by a GC on this thread
+    // after per-thread data (bf_context_t, wasm store) of the worker was finalized
+    std::string result;
+    std::thread worker([&result]() {
+        Globals::initializeThread();
+        {
+            PersistentRefHolder<VMInstanceRef> instance = VMInstanceRef::create(new ShellPlatform());
+            instance->setOnVMInstanceDelete([](VMInstanceRef* instance) {
+                delete instance->platform();
+            });
+            PersistentRefHolder<ContextRef> context = ContextRef::create(instance.get());
+
+            result = evalScript(context.get(), StringRef::createFromASCII("var arr = []; for (var i = 0; i < 1000; i++) { arr.push(2n ** 200n + BigInt(i)) }"
+                                                                          "if (typeof WebAssembly !== 'undefined') { var m = new WebAssembly.Module(new Uint8Array([0, 97, 115, 109, 1, 0, 0, 0])); arr.push(new WebAssembly.Instance(m)) }"
+                                                                          "String(arr[999] - arr[0])"),
+                                StringRef::createFromASCII("test.js"), false);
+        }
+        Globals::finalizeThread();
+    });
+    worker.join();
+    EXPECT_EQ(result, "999");
+
+    Memory::gc();
+    Memory::gc();
+
+    auto s = evalScript(g_context.get(), StringRef::createFromASCII("String(2n ** 100n + 1n)"), StringRef::createFromASCII("test.js"), false);
+    EXPECT_EQ(s, "1267650600228229401496703205377");
+}
+#endif
+
+TEST(GlobalObject, LazyBuiltins)
+{
+    PersistentRefHolder<ContextRef> context = ContextRef::create(g_context->vmInstance());
+
+    auto s = evalScript(context.get(), StringRef::createFromASCII("var d = Object.getOwnPropertyDescriptor(globalThis, 'Int8Array');"
+                                                                  "d.writable && !d.enumerable && d.configurable && typeof d.value === 'function'"
+                                                                  " && Object.getPrototypeOf(Int8Array) === Object.getPrototypeOf(Uint8Array) && new Uint8Array(2).length"),
+                        StringRef::createFromASCII("test.js"), false);
+    EXPECT_EQ(s, "2");
+
+    // assignment before the first access replaces the builtin
+    s = evalScript(context.get(), StringRef::createFromASCII("Reflect = 1; Reflect"), StringRef::createFromASCII("test.js"), false);
+    EXPECT_EQ(s, "1");
+    s = evalScript(context.get(), StringRef::createFromASCII("typeof Proxy + new Date(0).getTime() + Object.keys(globalThis).indexOf('Date')"), StringRef::createFromASCII("test.js"), false);
+    EXPECT_EQ(s, "function0-1");
+
+    // installing a builtin by its internal slot doesn't bring back deleted or redefined globals
+    context = ContextRef::create(g_context->vmInstance());
+    s = evalScript(context.get(), StringRef::createFromASCII("delete globalThis.Date; delete globalThis.Int8Array; Uint8Array = 'mine';"
+                                                             "Object.defineProperty(globalThis, 'Int16Array', { get: function() { return 'getter' }, configurable: true })"),
+                   StringRef::createFromASCII("test.js"), false);
+    EXPECT_TRUE(context->globalObject()->datePrototype()->isObject());
+    EXPECT_TRUE(context->globalObject()->uint8ArrayPrototype()->isObject());
+    s = evalScript(context.get(), StringRef::createFromASCII("[typeof Date, 'Date' in globalThis, 'Int8Array' in globalThis, Uint8Array, Int16Array,"
+                                                             " typeof Int32Array, Object.getOwnPropertyDescriptor(globalThis, 'Int16Array').get !== undefined].join()"),
+                   StringRef::createFromASCII("test.js"), false);
+    EXPECT_EQ(s, "undefined,false,false,mine,getter,function,true");
+}
+
+TEST(SerializedValue, Basic)
+{
+    PersistentRefHolder<VMInstanceRef> instance = VMInstanceRef::create(new ShellPlatform());
+    instance->setOnVMInstanceDelete([](VMInstanceRef* instance) {
+        delete instance->platform();
+    });
+    PersistentRefHolder<ContextRef> context = ContextRef::create(instance.get());
+
+    auto r = Evaluator::execute(g_context.get(), [](ExecutionStateRef* state) -> ValueRef* {
+        auto script = state->context()->scriptParser()->initializeScript(StringRef::createFromASCII("var buf = new ArrayBuffer(4); new Uint8Array(buf)[0] = 7;"
+                                                                                                     "var o = { a: 1.5, s: 'str\\u3042', b: 12n, arr: [1, , 'x'], m: new Map([[1, 'one']]), st: new Set(['v']),"
+                                                                                                     " d: new Date(1000), re: /ab+c/gi, buf: buf, copied: new ArrayBuffer(2) }; o.self = o; o"),
+                                                                         StringRef::createFromASCII("test.js"), false)
+                          .fetchScriptThrowsExceptionIfParseError(state);
+        ValueRef* value = script->execute(state);
+        ValueVectorRef* transferList = ValueVectorRef::create();
+        transferList->pushBack(value->asObject()->get(state, StringRef::createFromASCII("buf")));
+        ValueRef* copy = SerializedValueRef::serialize(state, value, transferList)->deserialize(state);
+        state->context()->globalObject()->set(state, StringRef::createFromASCII("copy"), copy);
+        return copy;
+    });
+    EXPECT_TRUE(r.isSuccessful());
+
+    auto s = evalScript(g_context.get(), StringRef::createFromASCII("buf.byteLength + ',' + copy.buf.byteLength + ',' + new Uint8Array(copy.buf)[0]"), StringRef::createFromASCII("test.js"), false);
+    EXPECT_EQ(s, "0,4,7");
+
+    // deserialize into a Context of another VMInstance
+    PersistentRefHolder<SerializedValueRef> serialized;
+    r = Evaluator::execute(g_context.get(), [](ExecutionStateRef* state, PersistentRefHolder<SerializedValueRef>* serialized) -> ValueRef* {
+        serialized->reset(SerializedValueRef::serialize(state, state->context()->globalObject()->get(state, StringRef::createFromASCII("copy"))));
+        return ValueRef::createUndefined();
+    },
+                           &serialized);
+    EXPECT_TRUE(r.isSuccessful());
+    r = Evaluator::execute(context.get(), [](ExecutionStateRef* state, SerializedValueRef* serialized) -> ValueRef* {
+        state->context()->globalObject()->set(state, StringRef::createFromASCII("o"), serialized->deserialize(state));
+        return ValueRef::createUndefined();
+    },
+                           serialized.get());
+    EXPECT_TRUE(r.isSuccessful());
+    s = evalScript(context.get(), StringRef::createFromASCII("o.self === o && o.a + o.s + o.b + o.arr.length + (1 in o.arr) + o.arr[2] + o.m.get(1) + o.st.has('v')"
+                                                              " + o.d.getTime() + o.re.source + o.re.flags + o.copied.byteLength + (o.buf.byteLength === 4)"),
+                   StringRef::createFromASCII("test.js"), false);
+    EXPECT_EQ(s, "1.5str\u3042123falsexonetrue1000ab+cgi2true");
+
+    r = Evaluator::execute(g_context.get(), [](ExecutionStateRef* state) -> ValueRef* {
+        SerializedValueRef::serialize(state, state->context()->globalObject()->get(state, StringRef::createFromASCII("Object")));
+        return ValueRef::createUndefined();
+    });
+    EXPECT_FALSE(r.isSuccessful());
+}
+
+TEST(SerializedValue, NotCloneable)
+{
+    // only supported kinds of object are cloned, others throw DataCloneError instead of becoming plain objects
+    const char* sources[] = {
+        "(function* gen() { yield 1 })()",
+        "new Number(1)",
+        "new String('str')",
+        "new Error('error')",
+        "(function() { return arguments })(1, 2)",
+        "[1, 2][Symbol.iterator]()",
+        "new Proxy({}, {})",
+        "({ nested: new Boolean(true) })",
+    };
+    for (size_t i = 0; i < sizeof(sources) / sizeof(sources[0]); i++) {
+        auto r = Evaluator::execute(g_context.get(), [](ExecutionStateRef* state, const char* source) -> ValueRef* {
+            auto script = state->context()->scriptParser()->initializeScript(StringRef::createFromASCII(source), StringRef::createFromASCII("test.js"), false).fetchScriptThrowsExceptionIfParseError(state);
+            SerializedValueRef::serialize(state, script->execute(state));
+            return ValueRef::createUndefined();
+        },
+                                    sources[i]);
+        EXPECT_FALSE(r.isSuccessful()) << sources[i];
+        EXPECT_TRUE(r.resultOrErrorToString(g_context.get())->toStdUTF8String().find("DataCloneError") != std::string::npos) << sources[i];
+    }
+}
+
+TEST(SharedArrayBuffer, Atomics)
+{
+    auto s = evalScript(g_context.get(), StringRef::createFromASCII("var sab = new SharedArrayBuffer(16); var ia = new Int32Array(sab); Atomics.store(ia, 0, 5); Atomics.add(ia, 0, 3); Atomics.sub(ia, 0, 1);"
+                                                                    "[Atomics.load(ia, 0), Atomics.exchange(ia, 0, 1), Atomics.compareExchange(ia, 0, 1, 9), Atomics.compareExchange(ia, 0, 1, 2),"
+                                                                    " Atomics.and(ia, 0, 3), Atomics.or(ia, 0, 4), Atomics.xor(ia, 0, 1), Atomics.load(ia, 0), Atomics.notify(ia, 0),"
+                                                                    " Object.prototype.toString.call(sab), sab instanceof ArrayBuffer, Atomics.add(new BigInt64Array(sab), 1, 2n)] + ''"),
+                        StringRef::createFromASCII("test.js"), false);
+    EXPECT_EQ(s, "7,7,1,9,9,1,5,4,0,[object SharedArrayBuffer],false,0");
+
+    s = evalScript(g_context.get(), StringRef::createFromASCII("var e = []; try { Atomics.wait(new Int32Array(4), 0, 0, 0) } catch (err) { e.push(err.name) }"
+                                                               " try { Atomics.add(new Float64Array(sab), 0, 1) } catch (err) { e.push(err.name) }"
+                                                               " try { Atomics.load(ia, 4) } catch (err) { e.push(err.name) }"
+                                                               " try { ArrayBuffer.prototype.slice.call(sab) } catch (err) { e.push(err.name) } e + ''"),
+                   StringRef::createFromASCII("test.js"), false);
+    EXPECT_EQ(s, "TypeError,TypeError,RangeError,TypeError");
+
+    // another VMInstance shares the backing store through SerializedValue
+    PersistentRefHolder<VMInstanceRef> instance = VMInstanceRef::create(new ShellPlatform());
+    instance->setOnVMInstanceDelete([](VMInstanceRef* instance) {
+        delete instance->platform();
+    });
+    PersistentRefHolder<ContextRef> context = ContextRef::create(instance.get());
+
+    PersistentRefHolder<SerializedValueRef> serialized;
+    auto r = Evaluator::execute(g_context.get(), [](ExecutionStateRef* state, PersistentRefHolder<SerializedValueRef>* serialized) -> ValueRef* {
+        serialized->reset(SerializedValueRef::serialize(state, state->context()->globalObject()->get(state, StringRef::createFromASCII("sab"))));
+        return ValueRef::createUndefined();
+    },
+                                &serialized);
+    EXPECT_TRUE(r.isSuccessful());
+    r = Evaluator::execute(context.get(), [](ExecutionStateRef* state, SerializedValueRef* serialized) -> ValueRef* {
+        ValueRef* sab = serialized->deserialize(state);
+        EXPECT_TRUE(sab->isSharedArrayBufferObject());
+        state->context()->globalObject()->set(state, StringRef::createFromASCII("sab"), sab);
+        return ValueRef::createUndefined();
+    },
+                           serialized.get());
+    EXPECT_TRUE(r.isSuccessful());
+    s = evalScript(context.get(), StringRef::createFromASCII("Atomics.add(new Int32Array(sab), 3, 10)"), StringRef::createFromASCII("test.js"), false);
+    EXPECT_EQ(s, "0");
+    s = evalScript(g_context.get(), StringRef::createFromASCII("Atomics.load(ia, 3)"), StringRef::createFromASCII("test.js"), false);
+    EXPECT_EQ(s, "10");
+}
+
+#if defined(ENABLE_THREADING)
+TEST(SharedArrayBuffer, WaitNotify)
+{
+    PersistentRefHolder<SerializedValueRef> serialized;
+    auto r = Evaluator::execute(g_context.get(), [](ExecutionStateRef* state, PersistentRefHolder<SerializedValueRef>* serialized) -> ValueRef* {
+        SharedArrayBufferObjectRef* sab = SharedArrayBufferObjectRef::create(state, 8);
+        state->context()->globalObject()->set(state, StringRef::createFromASCII("waitBuffer"), sab);
+        serialized->reset(SerializedValueRef::serialize(state, sab));
+        return ValueRef::createUndefined();
+    },
+                                &serialized);
+    EXPECT_TRUE(r.isSuccessful());
+
+    std::thread notifier([&serialized]() {
+        Globals::initializeThread();
+        {
+            PersistentRefHolder<VMInstanceRef> instance = VMInstanceRef::create(new ShellPlatform());
+            instance->setOnVMInstanceDelete([](VMInstanceRef* instance) {
+                delete instance->platform();
+            });
+            PersistentRefHolder<ContextRef> context = ContextRef::create(instance.get());
+            Evaluator::execute(context.get(), [](ExecutionStateRef* state, SerializedValueRef* serialized) -> ValueRef* {
+                state->context()->globalObject()->set(state, StringRef::createFromASCII("waitBuffer"), serialized->deserialize(state));
+                return ValueRef::createUndefined();
+            },
+                               serialized.get());
+            evalScript(context.get(), StringRef::createFromASCII("var ia = new Int32Array(waitBuffer); Atomics.store(ia, 0, 1); Atomics.notify(ia, 0)"),
+                       StringRef::createFromASCII("test.js"), false);
+        }
+        Globals::finalizeThread();
+    });
+
+    // notifier can store the value before this thread starts waiting
+    auto s = evalScript(g_context.get(), StringRef::createFromASCII("var ia = new Int32Array(waitBuffer); var result = Atomics.wait(ia, 0, 0);"
+                                                                    "(result === 'ok' || result === 'not-equal') + ',' + Atomics.load(ia, 0) + ',' + Atomics.wait(ia, 1, 0, 10)"),
+                        StringRef::createFromASCII("test.js"), false);
+    notifier.join();
+    EXPECT_EQ(s, "true,1,timed-out");
+}
+#endif
+
 TEST(ObjectTemplate, Basic1)
 {
     ObjectTemplateRef* tpl = ObjectTemplateRef::create();
@@ -585,6 +1866,117 @@ TEST(ObjectTemplate, Basic3)
                        obj, data2, tpl);
 }
 
+TEST(InlineCache, Megamorphic)
+{
+    // a site goes monomorphic -> polymorphic -> megamorphic, then properties of cached structures change
+    const char* src =
+        "(function() {"
+        "    function get(o) { return o.x }"
+        "    function set(o, v) { o.x = v }"
+        "    var out = [];"
+        "    var mono = { x: 1 };"
+        "    for (var i = 0; i < 10; i++) get(mono);"
+        "    out.push(get(mono));"
+        "    Object.setPrototypeOf(mono, { x: 'monoProto' }); delete mono.x;"
+        "    out.push(get(mono));"
+        "    var poly = [{ x: 'a' }, { y: 0, x: 'b' }, { z: 0, x: 'c' }];"
+        "    for (var i = 0; i < 10; i++) poly.forEach(get);"
+        "    out.push(poly.map(get).join(''));"
+        "    var proto = { x: 'proto' };"
+        "    var mega = [];"
+        "    for (var i = 0; i < 40; i++) {"
+        "        var o = Object.create(proto);"
+        "        o['p' + i] = i;"
+        "        if (i % 2) o.x = i;"
+        "        mega.push(o);"
+        "    }"
+        "    for (var k = 0; k < 5; k++) mega.forEach(get);"
+        "    out.push(get(mega[0]) + get(mega[1]));"
+        "    proto.x = 'changed';"
+        "    out.push(get(mega[2]));"
+        "    delete proto.x;"
+        "    out.push(get(mega[2]));"
+        "    Object.defineProperty(proto, 'x', { get: function() { return 'getter' + this.p4 }, set: function(v) { this.fromSetter = v }, configurable: true });"
+        "    out.push(get(mega[4]));"
+        "    Object.setPrototypeOf(mega[6], { x: 'other' });"
+        "    out.push(get(mega[6]));"
+        "    delete mega[3].x;"
+        "    out.push(get(mega[3]));"
+        "    mega[8].x = 'own';"
+        "    out.push(get(mega[8]));"
+        "    for (var k = 0; k < 5; k++) mega.forEach(function(o, i) { set(o, i * 10) });"
+        "    out.push(get(mega[5]) + ',' + get(mega[10]) + ',' + mega[10].fromSetter);"
+        "    Object.defineProperty(mega[7], 'x', { writable: false });"
+        "    set(mega[7], 'ignored');"
+        "    Object.freeze(mega[9]);"
+        "    set(mega[9], 'ignored');"
+        "    set(mega[11], 'set');"
+        "    out.push(get(mega[7]) + ',' + get(mega[9]) + ',' + get(mega[11]));"
+        "    return out.join('|');"
+        "})()";
+    auto s = evalScript(g_context.get(), StringRef::createFromUTF8(src, strlen(src)), StringRef::createFromASCII("test.js"), false);
+    EXPECT_EQ(s, "1|monoProto|abc|proto1|changed||getter4|other|getterundefined|getterundefined|50,getterundefined,100|70,90,set");
+}
+
+TEST(InlineCache, Keyed)
+{
+    // keys of computed property sites change between string, symbol and index,
+    // and cached structures are changed by delete, accessors and non-writable properties
+    const char* src =
+        "(function() {"
+        "    function get(o, k) { return o[k] }"
+        "    function set(o, k, v) { o[k] = v }"
+        "    var out = [];"
+        "    var sym = Symbol('a'), sym2 = Symbol('b');"
+        "    var o = { a: 1, b: 2, 1: 'one' };"
+        "    o[sym] = 's1'; o[sym2] = 's2';"
+        "    var s = '';"
+        "    for (var i = 0; i < 10; i++) s += get(o, i % 2 ? 'a' : 'b');"
+        "    out.push(s);"
+        "    s = '';"
+        "    for (var i = 0; i < 10; i++) s += get(o, i % 2 ? sym : sym2);"
+        "    out.push(s);"
+        "    var arr = [10, 20, 30];"
+        "    var ta = new Int16Array([-1, 2, 3]);"
+        "    s = '';"
+        "    for (var i = 0; i < 10; i++) s += get(i % 2 ? arr : ta, i % 3) + ',';"
+        "    out.push(s + get(o, 1) + get(o, '1') + get(o, 'a') + get(o, sym));"
+        "    for (var i = 0; i < 10; i++) set(o, i % 2 ? 'a' : sym, i);"
+        "    out.push(o.a + ',' + o[sym]);"
+        "    delete o.a;"
+        "    out.push(get(o, 'a') + ',' + get(o, 'b'));"
+        "    Object.defineProperty(o, 'b', { get: function() { return 'getter' }, set: function(v) { this.c = v }, configurable: true });"
+        "    set(o, 'b', 'viaSetter');"
+        "    out.push(get(o, 'b') + ',' + o.c);"
+        "    Object.defineProperty(o, sym, { writable: false });"
+        "    set(o, sym, 'ignored');"
+        "    out.push(get(o, sym));"
+        "    var p = Object.create({ inherited: 'proto' });"
+        "    for (var i = 0; i < 10; i++) get(p, 'inherited');"
+        "    p.inherited = 'own';"
+        "    out.push(get(p, 'inherited'));"
+        "    delete p.inherited;"
+        "    out.push(get(p, 'inherited'));"
+        "    var typed = [new Int8Array(4), new Float64Array(4), new Uint8ClampedArray(4), new Uint32Array(4), new BigInt64Array(4)];"
+        "    for (var k = 0; k < 3; k++) {"
+        "        typed.forEach(function(t, j) { if (j < 4) set(t, k, 300.7 - k * 400); else set(t, k, BigInt(k) - 1n) })"
+        "    }"
+        "    out.push(typed.map(function(t) { return [get(t, 0), get(t, 1), get(t, 2), get(t, 3), get(t, 4)].join(' ') }).join(';'));"
+        "    var buf = new ArrayBuffer(8), view = new Uint8Array(buf);"
+        "    for (var i = 0; i < 10; i++) set(view, i % 8, i);"
+        "    out.push(get(view, 7) + ',' + get(view, 8));"
+        "    var proxy = new Proxy({}, { get: function(t, k) { return 'trap:' + String(k) }, set: function(t, k, v) { out.push('set:' + String(k) + '=' + v); return true } });"
+        "    for (var i = 0; i < 5; i++) get(proxy, 'x');"
+        "    set(proxy, 'y', 1);"
+        "    out.push(get(proxy, 'x') + ',' + get(proxy, sym));"
+        "    var str = 'abc';"
+        "    out.push(get(str, 1) + get(str, 'length') + get(1.5, 'toFixed').name);"
+        "    return out.join('|');"
+        "})()";
+    auto s = evalScript(g_context.get(), StringRef::createFromUTF8(src, strlen(src)), StringRef::createFromASCII("test.js"), false);
+    EXPECT_EQ(s, "2121212121|s2s1s2s1s2s1s2s1s2s1|-1,20,3,10,2,30,-1,20,3,10,oneone1s1|9,8|undefined,2|getter,viaSetter|8|own|proto|44 -99 13 0 ;300.7 -99.30000000000001 -499.3 0 ;255 0 0 0 ;300 4294967197 4294966797 0 ;-1 0 1 0 |7,undefined|set:y=1|trap:x,trap:Symbol(a)|b3toFixed");
+}
+
 TEST(ObjectTemplate, Basic4)
 {
     ObjectTemplateRef* tpl = ObjectTemplateRef::create();
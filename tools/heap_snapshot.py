@@ -0,0 +1,196 @@
+#!/usr/bin/env python
+
+# Copyright 2021-present Samsung Electronics Co., Ltd.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Retained size analysis of a heap snapshot written by Memory::takeHeapSnapshot
+#
+# File format (one record per line)
+#   escargot-heap-snapshot 1
+#   node <id> <address> <size> <type> [<name>]
+#   root <id>
+#   edge <from> <to>
+#
+# <type> is Object or Function for JS objects (<name> is the class or function name),
+# otherwise the bdwgc kind of the object (Normal, Atomic, Typed, ArrayObject...)
+# Only uncollectable objects are written as roots. Objects referred by stack or static data are unknown,
+# so objects without any referrer (and cycles which are not reachable from roots) are treated as roots too.
+
+from __future__ import print_function
+
+import sys
+from argparse import ArgumentParser
+from collections import defaultdict
+
+
+class Snapshot(object):
+    def __init__(self):
+        self.sizes = []
+        self.labels = []
+        self.edges = []
+        self.roots = []
+
+    def load(self, path):
+        with open(path) as f:
+            header = f.readline().split()
+            if header != ['escargot-heap-snapshot', '1']:
+                raise ValueError('%s is not a heap snapshot' % path)
+            for line in f:
+                record = line.rstrip('\n').split(' ', 5)
+                if record[0] == 'edge':
+                    self.edges[int(record[1])].append(int(record[2]))
+                elif record[0] == 'node':
+                    assert int(record[1]) == len(self.sizes)
+                    self.sizes.append(int(record[3]))
+                    self.labels.append(' '.join(record[4:]))
+                    self.edges.append([])
+                elif record[0] == 'root':
+                    self.roots.append(int(record[1]))
+
+    def __len__(self):
+        return len(self.sizes)
+
+
+def reverse_post_order(snapshot):
+    # returns nodes in reverse post order from a virtual root (index len(snapshot)) and the parents of each node
+    count = len(snapshot)
+    virtual_root = count
+    has_referrer = [False] * count
+    for edges in snapshot.edges:
+        for to in edges:
+            has_referrer[to] = True
+
+    visited = [False] * count
+    parents = [[] for _ in range(count + 1)]
+    post_order = []
+
+    def visit(start):
+        parents[start].append(virtual_root)
+        if visited[start]:
+            return
+        visited[start] = True
+        stack = [(start, iter(snapshot.edges[start]))]
+        while stack:
+            node, children = stack[-1]
+            pushed = False
+            for child in children:
+                parents[child].append(node)
+                if not visited[child]:
+                    visited[child] = True
+                    stack.append((child, iter(snapshot.edges[child])))
+                    pushed = True
+                    break
+            if not pushed:
+                stack.pop()
+                post_order.append(node)
+
+    for root in snapshot.roots:
+        visit(root)
+    for i in range(count):
+        if not has_referrer[i]:
+            visit(i)
+    # cycles which are kept alive by stack or static data
+    for i in range(count):
+        if not visited[i]:
+            visit(i)
+    post_order.append(virtual_root)
+
+    post_order.reverse()
+    return post_order, parents
+
+
+def dominators(snapshot):
+    # "A Simple, Fast Dominance Algorithm" (Cooper, Harvey, Kennedy)
+    order, parents = reverse_post_order(snapshot)
+    virtual_root = len(snapshot)
+    position = [0] * (virtual_root + 1)
+    for i, node in enumerate(order):
+        position[node] = i
+
+    idom = [None] * (virtual_root + 1)
+    idom[virtual_root] = virtual_root
+
+    def intersect(a, b):
+        while a != b:
+            while position[a] > position[b]:
+                a = idom[a]
+            while position[b] > position[a]:
+                b = idom[b]
+        return a
+
+    changed = True
+    while changed:
+        changed = False
+        for node in order[1:]:
+            new_idom = None
+            for parent in parents[node]:
+                if idom[parent] is None:
+                    continue
+                new_idom = parent if new_idom is None else intersect(parent, new_idom)
+            if idom[node] != new_idom:
+                idom[node] = new_idom
+                changed = True
+    return order, idom
+
+
+def retained_sizes(snapshot, order, idom):
+    virtual_root = len(snapshot)
+    retained = list(snapshot.sizes) + [0]
+    for node in reversed(order):
+        if node != virtual_root:
+            retained[idom[node]] += retained[node]
+    return retained
+
+
+def main():
+    parser = ArgumentParser(description='Find objects which retain most of memory in an escargot heap snapshot')
+    parser.add_argument('snapshot', help='file written by Memory::takeHeapSnapshot')
+    parser.add_argument('--top', type=int, default=20, help='number of entries to print (default: 20)')
+    args = parser.parse_args()
+
+    snapshot = Snapshot()
+    snapshot.load(args.snapshot)
+    order, idom = dominators(snapshot)
+    retained = retained_sizes(snapshot, order, idom)
+    count = len(snapshot)
+
+    print('%d objects, %d bytes' % (count, sum(snapshot.sizes)))
+    print()
+
+    # retained size of a type counts only objects not dominated by the same type
+    # so nested objects (like linked lists) are not counted twice
+    by_label = defaultdict(lambda: [0, 0, 0])
+    for node in range(count):
+        label = snapshot.labels[node]
+        item = by_label[label]
+        item[0] += 1
+        item[1] += snapshot.sizes[node]
+        dominator = idom[node]
+        while dominator != count and snapshot.labels[dominator] != label:
+            dominator = idom[dominator]
+        if dominator == count:
+            item[2] += retained[node]
+
+    print('%10s %14s %14s  %s' % ('count', 'shallow', 'retained', 'type'))
+    for label, item in sorted(by_label.items(), key=lambda e: -e[1][2])[:args.top]:
+        print('%10d %14d %14d  %s' % (item[0], item[1], item[2], label))
+    print()
+
+    print('%10s %14s %14s  %s' % ('id', 'shallow', 'retained', 'type'))
+    for node in sorted(range(count), key=lambda n: -retained[n])[:args.top]:
+        print('%10d %14d %14d  %s' % (node, snapshot.sizes[node], retained[node], snapshot.labels[node]))
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -158,6 +158,23 @@ def run_octane_loading(engine, arch):
          cwd=OCTANE_DIR)
 
 
+@runner('allocation-benchmark', default=False)
+def run_allocation_benchmark(engine, arch):
+    run([engine, join(PROJECT_SOURCE_DIR, 'tools', 'test', 'benchmark', 'allocation.js')])
+
+
+@runner('context-creation-benchmark', default=False)
+def run_context_creation_benchmark(engine, arch):
+    benchmark = join(PROJECT_SOURCE_DIR, 'tools', 'test', 'benchmark', 'context-creation.js')
+    run([engine, benchmark])
+    run([engine, '--disable-context-snapshot', benchmark])
+
+
+@runner('string-search-benchmark', default=False)
+def run_string_search_benchmark(engine, arch):
+    run([engine, join(PROJECT_SOURCE_DIR, 'tools', 'test', 'benchmark', 'string-search.js')])
+
+
 @runner('modifiedVendorTest', default=True)
 def run_internal_test(engine, arch):
     INTERNAL_OVERRIDE_DIR = join(PROJECT_SOURCE_DIR, 'tools', 'test', 'ModifiedVendorTest')
@@ -583,11 +600,13 @@ def run_wasm_js(engine, arch):
 def run_cctest(engine, arch):
     if engine == "escargot":
         engine = "cctest"
-    proc = Popen([engine], stdout=PIPE)
-    stdout, _ = proc.communicate()
-    print(stdout)
-    if 'FAILED' in stdout:
-        raise Exception('Not all tests succeeded')
+    # gc cannot leave incremental mode once entered, so incremental gc tests run in their own process
+    for gtest_filter in ['-IncrementalGC.*', 'IncrementalGC.*']:
+        proc = Popen([engine, '--gtest_filter=' + gtest_filter], stdout=PIPE)
+        stdout, _ = proc.communicate()
+        print(stdout)
+        if 'FAILED' in stdout:
+            raise Exception('Not all tests succeeded')
 
 @runner('debugger-server-source', default=True)
 def run_escargot_debugger(engine, arch):
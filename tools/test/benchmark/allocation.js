@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2021-present Samsung Electronics Co., Ltd
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+ */
+
+// allocation rate of short-lived objects
+// prints allocations per millisecond of each case
+
+var iterations = 1000000;
+
+function objectLiteral(i) {
+    return { x: i, y: i + 1 };
+}
+
+function closure(i) {
+    return function() { return i; };
+}
+
+function arrayLiteral(i) {
+    return [i, i + 1, i + 2];
+}
+
+function boxedDouble(i) {
+    var o = { v: 0 };
+    o.v = i + 0.5;
+    return o;
+}
+
+var cases = [objectLiteral, closure, arrayLiteral, boxedDouble];
+var total = 0;
+
+for (var c = 0; c < cases.length; c++) {
+    var fn = cases[c];
+    var keep = null;
+    var start = Date.now();
+    for (var i = 0; i < iterations; i++) {
+        keep = fn(i);
+    }
+    var elapsed = Math.max(Date.now() - start, 1);
+    total += elapsed;
+    print(fn.name + ': ' + Math.round(iterations / elapsed) + ' allocations/ms (' + elapsed + 'ms)');
+}
+
+print('total: ' + total + 'ms');
@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2021-present Samsung Electronics Co., Ltd
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+ */
+
+// cold Context creation
+// prints created Contexts per millisecond
+// run with --disable-context-snapshot to compare with installing every builtin from scratch
+
+var count = 300;
+var keep = null;
+
+// the first Context of the VMInstance records the snapshot, so every Context created here is copied from it
+var start = Date.now();
+for (var i = 0; i < count; i++) {
+    keep = newGlobal();
+}
+var elapsed = Math.max(Date.now() - start, 1);
+print('create: ' + Math.round(count * 1000 / elapsed) / 1000 + ' contexts/ms (' + elapsed + 'ms)');
+
+// creating a Context and touching a few builtins, like a realm used for a small script
+start = Date.now();
+for (var i = 0; i < count; i++) {
+    keep = newGlobal();
+    keep.Array.prototype.map.call([1, 2, 3], keep.Math.sqrt);
+    keep.JSON.stringify(new keep.Map([[1, 2]]).size);
+}
+elapsed = Math.max(Date.now() - start, 1);
+print('create and use: ' + Math.round(count * 1000 / elapsed) / 1000 + ' contexts/ms (' + elapsed + 'ms)');
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2021-present Samsung Electronics Co., Ltd
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+ */
+
+// String search primitives on long log-like lines
+// prints search operations per millisecond of each case
+
+function repeat(unit, count) {
+    var result = '';
+    for (var i = 0; i < count; i++) {
+        result += unit + i + ' ';
+    }
+    return result;
+}
+
+// Latin-1 haystack, and UTF-16 one with same text and a non Latin-1 character in front
+var latin1 = repeat('GET /index.html 200 user=caf\u00e9 latency=', 2000);
+var utf16 = '\u4e16' + latin1;
+var longNeedle = 'latency=1999 ';
+
+var cases = [
+    ['indexOf char (latin1)', function() { return latin1.indexOf('#'); }],
+    ['indexOf char (utf16)', function() { return utf16.indexOf('#'); }],
+    ['indexOf frequent first char', function() { return latin1.indexOf('latency=x'); }],
+    ['indexOf long needle (latin1)', function() { return latin1.indexOf(longNeedle); }],
+    ['indexOf long needle (utf16)', function() { return utf16.indexOf(longNeedle); }],
+    ['indexOf utf16 needle in latin1', function() { return latin1.indexOf('\u4e16 latency'); }],
+    ['lastIndexOf', function() { return latin1.lastIndexOf('GET /index.html 200 user=caf\u00e9 latency=0 '); }],
+    ['includes', function() { return utf16.includes('user=none'); }],
+    ['split', function() { return latin1.split(' latency=').length; }],
+    ['replaceAll', function() { return latin1.replaceAll('user=', 'u=').length; }]
+];
+
+var iterations = 2000;
+var total = 0;
+
+for (var c = 0; c < cases.length; c++) {
+    var name = cases[c][0];
+    var fn = cases[c][1];
+    var start = Date.now();
+    for (var i = 0; i < iterations; i++) {
+        fn();
+    }
+    var elapsed = Math.max(Date.now() - start, 1);
+    total += elapsed;
+    print(name + ': ' + Math.round(iterations / elapsed) + ' ops/ms (' + elapsed + 'ms)');
+}
+
+print('total: ' + total + 'ms');